@@ -26,6 +26,7 @@
 #ifndef _IJKIO_
 #define _IJKIO_
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <string>
@@ -488,10 +489,11 @@ namespace IJK {
   /// @param front_color Array of front colors, 4 entries (RGBA) per vertex
   /// @parm back_color Array of backface colors, 4 entries (RGBA) per vertex
   ///                  May be NULL.
-  template <typename T, typename COLOR_TYPE> void ijkoutColorVertOFF
+  template <typename T, typename VTYPE, typename COLOR_TYPE>
+  void ijkoutColorVertOFF
   (std::ostream & out, const int dim, const int numv_per_simplex,   
    const T * coord, const int numv,
-   const int * simplex_vert, const int nums,
+   const VTYPE * simplex_vert, const int nums,
    const COLOR_TYPE * front_color, const COLOR_TYPE * back_color)
   {
     IJK::PROCEDURE_ERROR error("ijkoutColorVertOFF");
@@ -512,10 +514,11 @@ namespace IJK {
   }
 
   /// Output Geomview .off file to standard output. Color vertices.
-  template <typename T, typename COLOR_TYPE> void ijkoutColorVertOFF
+  template <typename T, typename VTYPE, typename COLOR_TYPE>
+  void ijkoutColorVertOFF
   (const int dim, const int numv_per_simplex,
    const T * coord, const int numv,
-   const int * simplex_vert, const int nums,
+   const VTYPE * simplex_vert, const int nums,
    const COLOR_TYPE * front_color, const COLOR_TYPE * back_color)
   {
     ijkoutColorVertOFF
@@ -540,10 +543,11 @@ namespace IJK {
 
   /// Output Geomview .off file. Color vertices.
   /// C++ STL vector format for front_color[] and back_color[].
-  template <typename T, typename COLOR_TYPE> void ijkoutColorVertOFF
+  template <typename T, typename VTYPE, typename COLOR_TYPE>
+  void ijkoutColorVertOFF
   (std::ostream & out, const int dim, const int numv_per_simplex,   
    const T * coord, const int numv,
-   const int * simplex_vert, const int nums,
+   const VTYPE * simplex_vert, const int nums,
    const std::vector<COLOR_TYPE> & front_color, 
    const std::vector<COLOR_TYPE> & back_color)
   {
@@ -688,10 +692,11 @@ namespace IJK {
   /// @param front_color Array of front colors, 4 entries (RGBA) per simplex.
   /// @parm back_color Array of backface colors, 4 entries (RGBA) per simplex.
   ///                  May be NULL.
-  template <typename T, typename COLOR_TYPE> void ijkoutColorFacesOFF
+  template <typename T, typename VTYPE, typename COLOR_TYPE>
+  void ijkoutColorFacesOFF
   (std::ostream & out, const int dim, const int numv_per_simplex,
    const T * coord, const int numv,
-   const int * simplex_vert, const int nums,
+   const VTYPE * simplex_vert, const int nums,
    const COLOR_TYPE * front_color, const COLOR_TYPE * back_color)
   {
     IJK::PROCEDURE_ERROR error("ijkoutColorFacesOFF");
@@ -773,10 +778,11 @@ namespace IJK {
   }
 
   /// Output Geomview .off file to standard output. Color simplices.
-  template <typename T, typename COLOR_TYPE> void ijkoutColorFacesOFF
+  template <typename T, typename VTYPE, typename COLOR_TYPE>
+  void ijkoutColorFacesOFF
   (const int dim, const int numv_per_simplex, 
    const T * coord, const int numv,
-   const int * simplex_vert, const int nums,
+   const VTYPE * simplex_vert, const int nums,
    const COLOR_TYPE * front_color, const COLOR_TYPE * back_color)
   {
     ijkoutColorFacesOFF
@@ -801,10 +807,11 @@ namespace IJK {
 
   /// Output Geomview .off file. Color simplices.
   /// C++ STL vector format for front_color[] and back_color[].
-  template <typename T, typename COLOR_TYPE> void ijkoutColorFacesOFF
+  template <typename T, typename VTYPE, typename COLOR_TYPE>
+  void ijkoutColorFacesOFF
   (std::ostream & out, const int dim, const int numv_per_simplex,
    const T * coord, const int numv,
-   const int * simplex_vert, const int nums,
+   const VTYPE * simplex_vert, const int nums,
    const std::vector<COLOR_TYPE> & front_color, 
    const std::vector<COLOR_TYPE> & back_color)
   {
@@ -2463,6 +2470,88 @@ namespace IJK {
 
 
 
+  // ******************************************
+  // Write binary meshlet file
+  // ******************************************
+
+  /// Write array to binary output stream.
+  /// - Each element is converted to type OTYPE.
+  /// - Native byte order.
+  template <typename OTYPE, typename T, typename NTYPE>
+  void ijkoutBinaryArray
+  (std::ostream & out, const T * a, const NTYPE n)
+  {
+    if (n <= 0) { return; }
+
+    std::vector<OTYPE> buffer(n);
+    for (NTYPE i = 0; i < n; i++)
+      { buffer[i] = OTYPE(a[i]); }
+    out.write(reinterpret_cast<const char *>(&(buffer.front())), 
+              n*sizeof(OTYPE));
+  }
+
+  /// Write binary meshlet file.
+  /// - Triangle mesh partitioned into meshlets.
+  /// - Format (native byte order):
+  ///   - char[8]: "IJKMLT01".
+  ///   - uint32: dim, numv, num_meshlets, 
+  ///             num meshlet vertices, num meshlet triangles.
+  ///   - float[dim*numv]: Vertex coordinates.
+  ///   - uint32[4*num_meshlets]: first vertex, number of vertices,
+  ///       first triangle, number of triangles of each meshlet.
+  ///   - uint32[num meshlet vertices]: Global vertex indices.
+  ///   - uint8[3*num meshlet triangles]: Triangle vertices
+  ///       as indices into the meshlet vertex list.
+  /// @param out Output stream.  Should be opened in binary mode.
+  /// @param meshlet[] Meshlets.  MESHLET_TYPE has members
+  ///   first_vert, num_vert, first_tri and num_tri.
+  template <typename CTYPE, typename MESHLET_TYPE, 
+            typename VTYPE, typename LTYPE>
+  void ijkoutMeshletBinary
+  (std::ostream & out, const int dim, const std::vector<CTYPE> & coord,
+   const std::vector<MESHLET_TYPE> & meshlet,
+   const std::vector<VTYPE> & meshlet_vert,
+   const std::vector<LTYPE> & meshlet_tri_vert)
+  {
+    const int NUM_VERT_PER_TRI = 3;
+    const char magic[8] = { 'I', 'J', 'K', 'M', 'L', 'T', '0', '1' };
+    IJK::PROCEDURE_ERROR error("ijkoutMeshletBinary");
+
+    for (std::size_t i = 0; i < meshlet.size(); i++) {
+      if (meshlet[i].num_vert > 256) {
+        error.AddMessage("Meshlet ", i, " has ", meshlet[i].num_vert, 
+                         " vertices.");
+        error.AddMessage
+          ("  Binary meshlet format allows at most 256 vertices per meshlet.");
+        throw error;
+      }
+    }
+
+    const std::uint32_t header[5] = 
+      { std::uint32_t(dim), std::uint32_t(coord.size()/dim), 
+        std::uint32_t(meshlet.size()), std::uint32_t(meshlet_vert.size()),
+        std::uint32_t(meshlet_tri_vert.size()/NUM_VERT_PER_TRI) };
+
+    out.write(magic, sizeof(magic));
+    ijkoutBinaryArray<std::uint32_t>(out, header, 5);
+    ijkoutBinaryArray<float>(out, vector2pointer(coord), coord.size());
+
+    for (std::size_t i = 0; i < meshlet.size(); i++) {
+      const std::uint32_t m[4] = 
+        { std::uint32_t(meshlet[i].first_vert), 
+          std::uint32_t(meshlet[i].num_vert),
+          std::uint32_t(meshlet[i].first_tri), 
+          std::uint32_t(meshlet[i].num_tri) };
+      ijkoutBinaryArray<std::uint32_t>(out, m, 4);
+    }
+
+    ijkoutBinaryArray<std::uint32_t>
+      (out, vector2pointer(meshlet_vert), meshlet_vert.size());
+    ijkoutBinaryArray<std::uint8_t>
+      (out, vector2pointer(meshlet_tri_vert), meshlet_tri_vert.size());
+  }
+
+
   // ******************************************
   // Fig file
   // ******************************************
@@ -3,21 +3,15 @@
 #ifndef _IJKNRRD_
 #define _IJKNRRD_
 
+#include <algorithm>
 #include <iostream>
 
 #include "NrrdIO.h"
 
 namespace {
 
-  template <typename T> void nrrd2scalar( Nrrd *nrrd, T * sdata)
-  {
-    std::cerr << "Programming error: Illegal instantiation of template nrrd2scalar."
-	      << std::endl;
-    exit(60);
-  }
-
   template <typename T> 
-  void nrrd_check_null(const int numv, T * sdata)
+  void nrrd_check_null(const size_t numv, T * sdata)
   {
     if (numv > 0 && sdata == NULL) {
       std::cerr << "Programming error detected in nrrd2scalar." << std::endl;
@@ -26,7 +20,50 @@ namespace {
     }
   }
 
-  template <> void nrrd2scalar<float>( Nrrd *nrrd, float * sdata )
+  // Nrrd type storing T without conversion.
+  // nrrdTypeUnknown if nrrd data of any type is converted to T.
+  template <typename T> struct NRRD_SCALAR_TYPE
+  { static const int value = nrrdTypeUnknown; };
+
+  template <> struct NRRD_SCALAR_TYPE<unsigned char>
+  { static const int value = nrrdTypeUChar; };
+
+  template <> struct NRRD_SCALAR_TYPE<short>
+  { static const int value = nrrdTypeShort; };
+
+  template <> struct NRRD_SCALAR_TYPE<unsigned short>
+  { static const int value = nrrdTypeUShort; };
+
+  template <typename T> void nrrd2scalar( Nrrd *nrrd, T * sdata)
+  // copy nrrd data to <T> data and store in sdata
+  // nrrd = nrrd data structure
+  //   nrrd->type must equal NRRD_SCALAR_TYPE<T>::value
+  //   Callers check the nrrd type.  Data is never rounded or clamped.
+  // sdata = array of T
+  //   Must be preallocated to size at least nrrdElementNumber(nrrd)
+  {
+    const int nrrd_type = NRRD_SCALAR_TYPE<T>::value;
+
+    if (nrrd_type == nrrdTypeUnknown) {
+      std::cerr << "Programming error: Illegal instantiation of template nrrd2scalar."
+                << std::endl;
+      exit(60);
+    }
+
+    if (nrrd->type != nrrd_type) {
+      std::cerr << "Programming error detected in nrrd2scalar." << std::endl;
+      std::cerr << "  Nrrd type does not match scalar type." << std::endl;
+      exit(80);
+    }
+
+    size_t numv = nrrdElementNumber(nrrd);
+    nrrd_check_null(numv, sdata);
+
+    const T * nrrd_sdata = (const T *)(nrrd->data);
+    std::copy(nrrd_sdata, nrrd_sdata+numv, sdata);
+  }
+
+  template <> inline void nrrd2scalar<float>( Nrrd *nrrd, float * sdata )
   // convert nrrd to <float> data and store in sdata
   // nrrd = nrrd data structure
   // sdata = array of float
@@ -35,16 +72,16 @@ namespace {
     float (*lup) (const void *, size_t iv);
 
     void * nrrd_data = nrrd->data;
-    int numv = nrrdElementNumber(nrrd);
+    size_t numv = nrrdElementNumber(nrrd);
     lup = nrrdFLookup[nrrd->type];
 
     nrrd_check_null(numv, sdata);
 
-    for (int iv = 0; iv < numv; iv++)
+    for (size_t iv = 0; iv < numv; iv++)
       sdata[iv] = lup(nrrd_data, iv);
   }
 
-  template <> void nrrd2scalar<double>( Nrrd *nrrd, double * sdata )
+  template <> inline void nrrd2scalar<double>( Nrrd *nrrd, double * sdata )
   // convert nrrd to <double> data and store in sdata
   // nrrd = nrrd data structure
   // sdata = array of float
@@ -53,16 +90,16 @@ namespace {
     double (*lup) (const void *, size_t iv);
 
     void * nrrd_data = nrrd->data;
-    int numv = nrrdElementNumber(nrrd);
+    size_t numv = nrrdElementNumber(nrrd);
     lup = nrrdDLookup[nrrd->type];
 
     nrrd_check_null(numv, sdata);
 
-    for (int iv = 0; iv < numv; iv++)
+    for (size_t iv = 0; iv < numv; iv++)
       sdata[iv] = lup(nrrd_data, iv);
   }
 
-  template <> void nrrd2scalar<int>( Nrrd *nrrd, int * sdata )
+  template <> inline void nrrd2scalar<int>( Nrrd *nrrd, int * sdata )
   // convert nrrd to <int> data and store in sdata
   // nrrd = nrrd data structure
   // sdata = array of float
@@ -71,12 +108,12 @@ namespace {
     int (*lup) (const void *, size_t iv);
 
     void * nrrd_data = nrrd->data;
-    int numv = nrrdElementNumber(nrrd);
+    size_t numv = nrrdElementNumber(nrrd);
     lup = nrrdILookup[nrrd->type];
 
     nrrd_check_null(numv, sdata);
 
-    for (int iv = 0; iv < numv; iv++)
+    for (size_t iv = 0; iv < numv; iv++)
       sdata[iv] = lup(nrrd_data, iv);
   }
 
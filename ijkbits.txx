@@ -217,6 +217,25 @@ namespace IJK {
 
     return(contains_two_opposite_ones(ival_complement, num_bits));
   }
+
+  /// Compute Morton (Z-order) code of 3D coordinates.
+  /// - Bit b of coord[d] is bit (3*b+d) of morton_code.
+  /// - Uses first num_bits bits of each coordinate.
+  /// @pre 3*num_bits is at most the number of bits in MTYPE.
+  template <typename CTYPE, typename NTYPE, typename MTYPE>
+  void compute_morton_code_3D
+  (const CTYPE coord[3], const NTYPE num_bits, MTYPE & morton_code)
+  {
+    const int DIM3(3);
+
+    morton_code = 0;
+    for (NTYPE b = 0; b < num_bits; b++) {
+      for (int d = 0; d < DIM3; d++) {
+        const MTYPE bit = (MTYPE(coord[d]) >> b) & MTYPE(1);
+        morton_code = morton_code | (bit << (DIM3*b+d));
+      }
+    }
+  }
     
 }
 
@@ -738,7 +738,7 @@ namespace IJK {
     else if (mag02 > max_small_magnitude && mag12 > max_small_magnitude) {
       flag_zero = false;
       compute_inner_product
-        (dimension, u02.PtrConst(), u12.PtrConst(), cos_angleB);
+        (dimension, u02.PtrConst(), u12.PtrConst(), cos_angleC);
       cos_min_angle = (cos_angleC/mag02)/mag12;
     }
     else {
@@ -48,6 +48,8 @@ namespace IJKDUAL {
   /// Construct isosurface mesh using Dual Contouring algorithm.
   /// Allow multiple isosurface vertices per grid cube.
   /// Returns list of isosurface polytope vertices.
+  /// @param context Scratch buffers and facet intersection table.
+  ///        Buffer capacity is reused across calls.
   template <typename GRID_EDGE_TYPE, typename GRID_CUBE_DATA_TYPE,
             typename DUAL_ISOVERT_TYPE>
   void construct_multi_isov_mesh
@@ -60,8 +62,12 @@ namespace IJKDUAL {
    std::vector<GRID_CUBE_DATA_TYPE> & cube_isov_list,
    std::vector<DUAL_ISOVERT_TYPE> & iso_vlist,
    MERGE_DATA & merge_data, 
+   DUALISO_CONTEXT & context,
    DUALISO_INFO & dualiso_info)
   {
+    const int DIM3(3);
+    const int NUM_VERT_PER_QUAD(4);
+    const int NUM_VERT_PER_TRI_PAIR(6);
     const int dimension = scalar_grid.Dimension();
     const bool flag_split_non_manifold = param.SplitNonManifoldFlag();
     const bool flag_select_split = param.SelectSplitFlag();
@@ -69,23 +75,70 @@ namespace IJKDUAL {
     const bool flag_connect_ambiguous = param.ConnectAmbiguousFlag();
     const VERTEX_POSITION_METHOD vpos_method = param.VertexPositionMethod();
     IJK::PROCEDURE_ERROR error("dual_contouring");
-    clock_t t0, t1, t2;
-
-    t0 = clock();
 
     isopoly_vert.clear();
     dualiso_info.time.Clear();
 
-    std::vector<ISO_VERTEX_INDEX> isopoly;
-    std::vector<FACET_VERTEX_INDEX> facet_vertex;
-    extract_dual_isopoly
-      (scalar_grid, isovalue, isopoly, facet_vertex, dual_edge, dualiso_info);
-    t1 = clock();
+    std::vector<VERTEX_INDEX> & isopoly = context.isopoly;
+    std::vector<FACET_VERTEX_INDEX> & facet_vertex = context.facet_vertex;
+    if (context.multi_isovalue.Contains(isovalue, true)) {
+      // Polytopes extracted in a single sweep for multiple isovalues.
+      context.multi_isovalue.Take
+        (isovalue, isopoly, &facet_vertex, dual_edge, dualiso_info);
+    }
+    else if (param.ROIFlag()) {
+      extract_dual_isopoly_in_roi
+        (scalar_grid, isovalue, param.ROI(), isopoly, facet_vertex, 
+         dual_edge, dualiso_info);
+    }
+    else if (param.BrickFlag()) {
+      extract_dual_isopoly_in_brick
+        (scalar_grid, isovalue, param.BrickOwnedBox(), isopoly, 
+         facet_vertex, dual_edge, dualiso_info);
+    }
+    else if (param.ExtractActiveCubesFlag()) {
+      extract_dual_isopoly_in_cubes
+        (scalar_grid, isovalue, context.active_cube, isopoly, 
+         facet_vertex, dual_edge, dualiso_info);
+    }
+    else if (param.ExtractIncrementalFlag()) {
+      extract_dual_isopoly_incremental
+        (scalar_grid, isovalue, param.ExtractBlockLength(), 
+         isopoly, facet_vertex, dual_edge, context.incremental, 
+         dualiso_info);
+    }
+    else if (param.ExtractTwoPassFlag()) {
+      extract_dual_isopoly_two_pass
+        (scalar_grid, isovalue, isopoly, facet_vertex, dual_edge, 
+         dualiso_info);
+    }
+    else if (param.ExtractInBlocksFlag()) {
+      extract_dual_isopoly_in_blocks
+        (scalar_grid, isovalue, param.ExtractBlockLength(), 
+         isopoly, facet_vertex, dual_edge, dualiso_info);
+    }
+    else {
+      extract_dual_isopoly
+        (scalar_grid, isovalue, isopoly, facet_vertex, dual_edge, 
+         dualiso_info);
+    }
 
-    std::vector<ISO_VERTEX_INDEX> cube_list;
-    std::vector<ISO_VERTEX_INDEX> isopoly_cube;
+    // Quadrilaterals output as triangles are triangulated in place.
+    // Reserve room for two triangles per quadrilateral.
+    // (See convert_quad_to_tri_in_place.)
+    if (param.UseTriangleMesh() && !param.flag_tri4_quad && 
+        dimension == DIM3)
+      { isopoly_vert.reserve
+          ((isopoly.size()/NUM_VERT_PER_QUAD)*NUM_VERT_PER_TRI_PAIR); }
+
+    std::vector<VERTEX_INDEX> & cube_list = context.cube_list;
+    std::vector<ISO_VERTEX_INDEX> & isopoly_cube = context.isopoly_cube;
+    IJK::SCOPED_TIMER merge_timer(dualiso_info.time.merge);
     merge_identical(isopoly, cube_list, isopoly_cube, merge_data);
-    t2 = clock();
+    merge_timer.Stop();
+
+    // Each cube in cube_list contains some isosurface polytope vertex.
+    dualiso_info.scalar.num_non_empty_cubes = cube_list.size();
 
     set_grid_cube_indices(scalar_grid, cube_list, cube_isov_list);
 
@@ -99,14 +152,13 @@ namespace IJKDUAL {
       int num_ambig_ridge_cubes_changed = 0;
       int num_non_ambig_ridge_cubes_changed = 0;
 
+      IJK::SCOPED_TIMER classify_timer(dualiso_info.time.classify);
       IJK::compute_cube_isotable_info
         (scalar_grid, isodual_table, isovalue, cube_isov_list);
 
       if (flag_split_non_manifold) {
-        IJK::FACET_INTERSECTION_TABLE
-          <DIRECTION_TYPE,VERTEX_INDEX,BOUNDARY_BITS_TYPE>
-          facet_intersection_table(dimension);
-        facet_intersection_table.Create();
+        const DUALISO_FACET_INTERSECTION_TABLE & facet_intersection_table =
+          context.FacetIntersectionTable(dimension);
 
         // Recompute isotable indices for cubes on grid ridges
         //   to avoid non-manifold vertices.
@@ -115,10 +167,13 @@ namespace IJKDUAL {
            flag_separate_neg, cube_isov_list, num_ambig_ridge_cubes_changed,
            num_non_ambig_ridge_cubes_changed);
       }
+      classify_timer.Stop();
 
+      IJK::SCOPED_TIMER split_timer(dualiso_info.time.split);
       if (flag_split_non_manifold) {
         IJK::split_non_manifold_isov_pairs
-          (scalar_grid, isodual_table, cube_isov_list, num_non_manifold_split);
+          (scalar_grid, isodual_table, context.index_to_cube_list,
+           cube_isov_list, num_non_manifold_split);
       }
 
       if (flag_select_split) {
@@ -136,6 +191,7 @@ namespace IJKDUAL {
       IJK::split_dual_isovert
         (isodual_table, isopoly_cube, facet_vertex, cube_isov_list, 
          iso_vlist, isopoly_vert, num_split);
+      split_timer.Stop();
 
       dualiso_info.multi_isov.num_non_manifold_split = num_non_manifold_split;
       dualiso_info.multi_isov.num_1_2_changed = num_1_2_changed;
@@ -146,6 +202,8 @@ namespace IJKDUAL {
         num_non_ambig_ridge_cubes_changed;
     }
     else {
+      // Computes cube isosurface table indices and splits vertices.
+      IJK::SCOPED_TIMER split_timer(dualiso_info.time.split);
       IJK::split_dual_isovert
         (scalar_grid, isodual_table, isovalue, 
          isopoly_cube, facet_vertex, cube_isov_list,
@@ -155,10 +213,32 @@ namespace IJKDUAL {
     dualiso_info.multi_isov.num_cubes_multi_isov = num_split;
     dualiso_info.multi_isov.num_cubes_single_isov =
       cube_list.size() - num_split;
+  }
 
-    // store times
-    IJK::clock2seconds(t1-t0, dualiso_info.time.extract);
-    IJK::clock2seconds(t2-t1, dualiso_info.time.merge);
+  /// Construct isosurface mesh using Dual Contouring algorithm.
+  /// Allow multiple isosurface vertices per grid cube.
+  /// Returns list of isosurface polytope vertices.
+  /// Version which creates temporary scratch buffers.
+  template <typename GRID_EDGE_TYPE, typename GRID_CUBE_DATA_TYPE,
+            typename DUAL_ISOVERT_TYPE>
+  void construct_multi_isov_mesh
+  (const DUALISO_SCALAR_GRID_BASE & scalar_grid,
+   const SCALAR_TYPE isovalue, 
+   const IJKDUALTABLE::ISODUAL_CUBE_TABLE_AMBIG & isodual_table,
+   const DUALISO_DATA_FLAGS & param,
+   std::vector<ISO_VERTEX_INDEX> & isopoly_vert,
+   std::vector<GRID_EDGE_TYPE> & dual_edge,
+   std::vector<GRID_CUBE_DATA_TYPE> & cube_isov_list,
+   std::vector<DUAL_ISOVERT_TYPE> & iso_vlist,
+   MERGE_DATA & merge_data, 
+   DUALISO_INFO & dualiso_info)
+  {
+    DUALISO_CONTEXT context;
+
+    construct_multi_isov_mesh
+      (scalar_grid, isovalue, isodual_table, param, isopoly_vert,
+       dual_edge, cube_isov_list, iso_vlist, merge_data, context,
+       dualiso_info);
   }
 
 
@@ -171,7 +251,7 @@ namespace IJKDUAL {
   /// Returns list of isosurface polytope vertices
   ///   and list of isosurface vertex coordinates.
   template <typename GRID_EDGE_TYPE, typename GRID_CUBE_DATA_TYPE,
-            typename DUAL_ISOVERT_TYPE>
+            typename DUAL_ISOVERT_TYPE, typename COORD_ARRAY_TYPE>
   void dual_contouring_multi_isov
   (const DUALISO_SCALAR_GRID_BASE & scalar_grid,
    const SCALAR_TYPE isovalue, 
@@ -181,8 +261,9 @@ namespace IJKDUAL {
    std::vector<GRID_EDGE_TYPE> & dual_edge,
    std::vector<GRID_CUBE_DATA_TYPE> & cube_isov_list,
    std::vector<DUAL_ISOVERT_TYPE> & iso_vlist,
-   COORD_ARRAY & vertex_coord,
+   COORD_ARRAY_TYPE & vertex_coord,
    MERGE_DATA & merge_data, 
+   DUALISO_CONTEXT & context,
    DUALISO_INFO & dualiso_info)
   {
     const int dimension = scalar_grid.Dimension();
@@ -193,16 +274,15 @@ namespace IJKDUAL {
     const VERTEX_POSITION_METHOD vpos_method = param.VertexPositionMethod();
     const COORD_TYPE center_offset = 0.1;
     IJK::PROCEDURE_ERROR error("dual_contouring");
-    clock_t t0, t1, t2;
-
-    t0 = clock();
+    IJK::WALL_CPU_TIME total_time;
+    IJK::SCOPED_TIMER total_timer(total_time);
 
     construct_multi_isov_mesh
       (scalar_grid, isovalue, isodual_table, param, isopoly_vert,
-       dual_edge, cube_isov_list, iso_vlist, merge_data, dualiso_info);
-
-    t1 = clock();
+       dual_edge, cube_isov_list, iso_vlist, merge_data, context, 
+       dualiso_info);
 
+    IJK::SCOPED_TIMER position_timer(dualiso_info.time.position);
     if (vpos_method == CUBE_CENTER) {
       position_all_dual_isovertices_near_cube_center_multi
         (scalar_grid, isodual_table, isovalue, iso_vlist, center_offset, 
@@ -220,11 +300,39 @@ namespace IJKDUAL {
         (scalar_grid, isodual_table, isovalue, iso_vlist, vertex_coord);
     }
 
-    t2 = clock();
+    position_timer.Stop();
 
     // store times
-    IJK::clock2seconds(t2-t1, dualiso_info.time.position);
-    IJK::clock2seconds(t2-t0, dualiso_info.time.total);
+    total_timer.Stop();
+    dualiso_info.time.total = total_time;
+  }
+
+  /// Extract isosurface using Dual Contouring algorithm.
+  /// Allow multiple isosurface vertices per grid cube.
+  /// Returns list of isosurface polytope vertices
+  ///   and list of isosurface vertex coordinates.
+  /// Version which creates temporary scratch buffers.
+  template <typename GRID_EDGE_TYPE, typename GRID_CUBE_DATA_TYPE,
+            typename DUAL_ISOVERT_TYPE, typename COORD_ARRAY_TYPE>
+  void dual_contouring_multi_isov
+  (const DUALISO_SCALAR_GRID_BASE & scalar_grid,
+   const SCALAR_TYPE isovalue, 
+   const IJKDUALTABLE::ISODUAL_CUBE_TABLE_AMBIG & isodual_table,
+   const DUALISO_DATA_FLAGS & param,
+   std::vector<ISO_VERTEX_INDEX> & isopoly_vert,
+   std::vector<GRID_EDGE_TYPE> & dual_edge,
+   std::vector<GRID_CUBE_DATA_TYPE> & cube_isov_list,
+   std::vector<DUAL_ISOVERT_TYPE> & iso_vlist,
+   COORD_ARRAY_TYPE & vertex_coord,
+   MERGE_DATA & merge_data, 
+   DUALISO_INFO & dualiso_info)
+  {
+    DUALISO_CONTEXT context;
+
+    dual_contouring_multi_isov
+      (scalar_grid, isovalue, isodual_table, param, isopoly_vert,
+       dual_edge, cube_isov_list, iso_vlist, vertex_coord,
+       merge_data, context, dualiso_info);
   }
 
   /// Extract isosurface using Dual Contouring algorithm.
@@ -232,7 +340,8 @@ namespace IJKDUAL {
   /// Returns list of isosurface polytope vertices
   ///   and list of isosurface vertex coordinates
   /// Version without argument cube_isov_list.
-  template <typename GRID_EDGE_TYPE, typename DUAL_ISOVERT_TYPE>
+  template <typename GRID_EDGE_TYPE, typename DUAL_ISOVERT_TYPE,
+            typename COORD_ARRAY_TYPE>
   void dual_contouring_multi_isov
   (const DUALISO_SCALAR_GRID_BASE & scalar_grid,
    const SCALAR_TYPE isovalue, 
@@ -241,7 +350,7 @@ namespace IJKDUAL {
    std::vector<ISO_VERTEX_INDEX> & isopoly_vert,
    std::vector<GRID_EDGE_TYPE> & dual_edge,
    std::vector<DUAL_ISOVERT_TYPE> & iso_vlist,
-   COORD_ARRAY & vertex_coord,
+   COORD_ARRAY_TYPE & vertex_coord,
    MERGE_DATA & merge_data, 
    DUALISO_INFO & dualiso_info)
   {
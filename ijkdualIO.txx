@@ -49,7 +49,8 @@ namespace IJKDUAL {
         (output_info, dualiso_data, dual_isosurface.vertex_coord, 
          dual_isosurface.tri_vert, dualiso_info, io_time);
     }
-    else if (output_info.flag_dual_collapse) {
+    else if (output_info.flag_dual_collapse || 
+             output_info.flag_adaptive_octree) {
       output_dual_quad_tri_isosurface
         (output_info, dualiso_data, dual_isosurface.vertex_coord, 
          dual_isosurface.isopoly_vert, dual_isosurface.tri_vert, 
@@ -69,7 +70,7 @@ namespace IJKDUAL {
   (const OUTPUT_INFO_TYPE & output_info, 
    const DUALISO_DATA_TYPE & dualiso_data,
    const std::vector<COORD_TYPE> & vertex_coord, 
-   const std::vector<VERTEX_INDEX> & slist,
+   const std::vector<ISO_VERTEX_INDEX> & slist,
    const DUALISO_INFO_TYPE & dualiso_info, 
    IO_TIME_TYPE & io_time)
   {
@@ -90,7 +91,7 @@ namespace IJKDUAL {
   (const OUTPUT_INFO_TYPE & output_info, 
    const DUALISO_DATA_TYPE & dualiso_data,
    const std::vector<COORD_TYPE> & vertex_coord,
-   const std::vector<VERTEX_INDEX> & tri_vert,
+   const std::vector<ISO_VERTEX_INDEX> & tri_vert,
    const DUALISO_INFO_TYPE & dualiso_info, IO_TIME_TYPE & io_time)
   {
     if (!output_info.flag_use_stdout && !output_info.flag_silent) {
@@ -111,8 +112,8 @@ namespace IJKDUAL {
   (const OUTPUT_INFO_TYPE & output_info, 
    const DUALISO_DATA_TYPE & dualiso_data,
    const std::vector<COORD_TYPE> & vertex_coord,
-   const std::vector<VERTEX_INDEX> & quad_vert,
-   const std::vector<VERTEX_INDEX> & tri_vert,
+   const std::vector<ISO_VERTEX_INDEX> & quad_vert,
+   const std::vector<ISO_VERTEX_INDEX> & tri_vert,
    const DUALISO_INFO_TYPE & dualiso_info, IO_TIME_TYPE & io_time)
   {
     if (!output_info.flag_use_stdout && !output_info.flag_silent) {
@@ -136,7 +137,7 @@ namespace IJKDUAL {
   (const OUTPUT_INFO_TYPE & output_info, 
    const DUALISO_DATA_TYPE & dualiso_data,
    const std::vector<COORD_TYPE> & vertex_coord, 
-   const std::vector<VERTEX_INDEX> & slist,
+   const std::vector<ISO_VERTEX_INDEX> & slist,
    const COLOR_TYPE * front_color, 
    const COLOR_TYPE * back_color,
    const DUALISO_INFO_TYPE & dualiso_info, IO_TIME_TYPE & io_time)
@@ -255,7 +256,7 @@ namespace IJKDUAL {
   (const OUTPUT_INFO_TYPE & output_info, 
    const DUALISO_DATA_TYPE & dualiso_data,
    const std::vector<COORD_TYPE> & vertex_coord, 
-   const std::vector<VERTEX_INDEX> & plist, 
+   const std::vector<ISO_VERTEX_INDEX> & plist, 
    const DUALISO_INFO_TYPE & dualiso_info)
   {
     const int dimension = output_info.dimension;
@@ -284,8 +285,8 @@ namespace IJKDUAL {
   (const OUTPUT_INFO_TYPE & output_info, 
    const DUALISO_DATA_TYPE & dualiso_data,
    const std::vector<COORD_TYPE> & vertex_coord, 
-   const std::vector<VERTEX_INDEX> & quad_list, 
-   const std::vector<VERTEX_INDEX> & tri_list, 
+   const std::vector<ISO_VERTEX_INDEX> & quad_list, 
+   const std::vector<ISO_VERTEX_INDEX> & tri_list, 
    const DUALISO_INFO_TYPE & dualiso_info)
   {
     const int dimension = output_info.dimension;
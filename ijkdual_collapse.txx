@@ -0,0 +1,449 @@
+/// \file ijkdual_collapse.txx
+/// Collapse dual isosurface vertices.
+
+/*
+  IJK: Isosurface Jeneration Kode
+  Copyright (C) 2017 Rephael Wenger
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License
+  (LGPL) as published by the Free Software Foundation; either
+  version 2.1 of the License, or any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef _IJKDUAL_COLLAPSE_TXX_
+#define _IJKDUAL_COLLAPSE_TXX_
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "ijkbits.txx"
+#include "ijkcoord.txx"
+#include "ijkmesh.txx"
+
+#include "ijkdual_types.h"
+
+
+namespace IJKDUAL {
+
+  // **************************************************
+  // CUBE CONTAINING ISOSURFACE VERTEX
+  // **************************************************
+
+  /// Compute coordinates of cube containing point coord[].
+  /// - Points on a cube boundary may be assigned to either cube.
+  /// - Points outside the grid are assigned to the nearest cube.
+  template <typename GRID_TYPE, typename CTYPE, typename GTYPE>
+  void compute_cube_containing_coord_3D
+  (const GRID_TYPE & grid, const CTYPE coord[], GTYPE cube_coord[])
+  {
+    const int DIM3(3);
+
+    for (int d = 0; d < DIM3; d++) {
+      GTYPE c = GTYPE(std::floor(coord[d]));
+      if (c+2 > grid.AxisSize(d)) { c = grid.AxisSize(d)-2; }
+      if (c < 0) { c = 0; }
+      cube_coord[d] = c;
+    }
+  }
+
+
+  /// Compute unit vector in direction of scalar gradient in cube.
+  /// - Gradient is the average of the scalar differences along cube edges.
+  /// - Set normal[] to the zero vector if the gradient magnitude
+  ///   is at most max_small_magnitude.
+  template <typename SGRID_TYPE, typename GTYPE, typename CTYPE,
+            typename MTYPE>
+  void compute_cube_unit_gradient_3D
+  (const SGRID_TYPE & scalar_grid, const GTYPE cube_coord[],
+   const MTYPE max_small_magnitude, CTYPE normal[])
+  {
+    typedef typename SGRID_TYPE::VERTEX_INDEX_TYPE VTYPE;
+
+    const int DIM3(3);
+    const int NUM_CUBE_VERTICES_3D(8);
+    const VTYPE iv0 = scalar_grid.ComputeVertexIndex(cube_coord);
+    CTYPE magnitude;
+
+    IJK::set_coord_3D(0, normal);
+    for (int k = 0; k < NUM_CUBE_VERTICES_3D; k++) {
+      const CTYPE s = scalar_grid.Scalar(scalar_grid.CubeVertex(iv0, k));
+      for (int d = 0; d < DIM3; d++) {
+        if ((k >> d) & 1) { normal[d] += s; }
+        else { normal[d] -= s; }
+      }
+    }
+
+    IJK::normalize_vector
+      (DIM3, normal, max_small_magnitude, normal, magnitude);
+  }
+
+
+  // **************************************************
+  // COLLAPSE TESTS
+  // **************************************************
+
+  /// Test for collapsing isosurface vertices in a block of grid cubes.
+  /// - Block collapses if the block centroid is within max_distance
+  ///   of the plane through each vertex orthogonal to the vertex
+  ///   scalar gradient (max-norm quadratic error.)
+  /// - Block does not collapse if some vertex scalar gradient points
+  ///   to the opposite side of the average scalar gradient.
+  class COLLAPSE_QEF_TEST {
+
+  protected:
+    COORD_ARRAY normal;
+    COORD_TYPE max_distance;
+    COORD_TYPE max_small_magnitude;
+
+  public:
+    /// Constructor.  Compute vertex scalar gradients.
+    template <typename SGRID_TYPE>
+    COLLAPSE_QEF_TEST
+    (const SGRID_TYPE & scalar_grid, const COORD_ARRAY & vertex_coord,
+     const COORD_TYPE max_distance, const COORD_TYPE max_small_magnitude);
+
+    /// Return true if vertices vlist[] collapse to centroid[].
+    template <typename VTYPE, typename NTYPE>
+    bool IsCollapsible
+    (const COORD_ARRAY & vertex_coord,
+     const VTYPE vlist[], const NTYPE numv, 
+     const COORD_TYPE centroid[]) const;
+  };
+
+
+  template <typename SGRID_TYPE>
+  COLLAPSE_QEF_TEST::COLLAPSE_QEF_TEST
+  (const SGRID_TYPE & scalar_grid, const COORD_ARRAY & vertex_coord,
+   const COORD_TYPE max_distance, const COORD_TYPE max_small_magnitude)
+  {
+    const int DIM3(3);
+    const ISO_VERTEX_INDEX numv = vertex_coord.size()/DIM3;
+
+    this->max_distance = max_distance;
+    this->max_small_magnitude = max_small_magnitude;
+
+    normal.resize(vertex_coord.size());
+    for (ISO_VERTEX_INDEX iv = 0; iv < numv; iv++) {
+      VERTEX_INDEX cube_coord[DIM3];
+
+      compute_cube_containing_coord_3D
+        (scalar_grid, &(vertex_coord[iv*DIM3]), cube_coord);
+      compute_cube_unit_gradient_3D
+        (scalar_grid, cube_coord, max_small_magnitude, &(normal[iv*DIM3]));
+    }
+  }
+
+
+  template <typename VTYPE, typename NTYPE>
+  bool COLLAPSE_QEF_TEST::IsCollapsible
+  (const COORD_ARRAY & vertex_coord,
+   const VTYPE vlist[], const NTYPE numv, 
+   const COORD_TYPE centroid[]) const
+  {
+    const int DIM3(3);
+    COORD_TYPE block_normal[DIM3];
+    COORD_TYPE magnitude;
+
+    IJK::set_coord_3D(0, block_normal);
+    for (NTYPE i = 0; i < numv; i++) {
+      const VTYPE iv = vlist[i];
+      IJK::add_coord_3D(block_normal, &(normal[iv*DIM3]), block_normal);
+    }
+    IJK::normalize_vector
+      (DIM3, block_normal, max_small_magnitude, block_normal, magnitude);
+    if (magnitude <= max_small_magnitude) { return(false); }
+
+    for (NTYPE i = 0; i < numv; i++) {
+      const VTYPE iv = vlist[i];
+      COORD_TYPE diff[DIM3], distance, cos_angle;
+
+      IJK::subtract_coord_3D(&(vertex_coord[iv*DIM3]), centroid, diff);
+      IJK::compute_inner_product_3D(diff, &(normal[iv*DIM3]), distance);
+      IJK::compute_inner_product_3D
+        (&(normal[iv*DIM3]), block_normal, cos_angle);
+      if (std::abs(distance) > max_distance || cos_angle <= 0)
+        { return(false); }
+    }
+
+    return(true);
+  }
+
+
+  // **************************************************
+  // DELETE DUPLICATE POLYGONS
+  // **************************************************
+
+  /// Delete duplicate polygons and cancel pairs of identical polygons
+  ///   with opposite orientations.
+  /// - See IJK::flag_duplicate_polygons.
+  /// @param poly_info Array of polygon information matching poly_vert.
+  ///   Ignored if poly_info is NULL.
+  template <typename VTYPE, typename INFO_TYPE>
+  void delete_duplicate_polygons
+  (const int numv_per_poly, const int cyclic_order[],
+   std::vector<VTYPE> & poly_vert, std::vector<INFO_TYPE> * poly_info)
+  {
+    std::vector<bool> keep_poly;
+    std::size_t num_kept = 0;
+
+    IJK::flag_duplicate_polygons
+      (poly_vert, numv_per_poly, cyclic_order, keep_poly);
+
+    for (std::size_t ipoly = 0; ipoly < keep_poly.size(); ipoly++) {
+      if (!keep_poly[ipoly]) { continue; }
+
+      std::copy(poly_vert.begin()+ipoly*numv_per_poly,
+                poly_vert.begin()+(ipoly+1)*numv_per_poly,
+                poly_vert.begin()+num_kept*numv_per_poly);
+      if (poly_info != NULL)
+        { (*poly_info)[num_kept] = (*poly_info)[ipoly]; }
+      num_kept++;
+    }
+
+    poly_vert.resize(num_kept*numv_per_poly);
+    if (poly_info != NULL) { poly_info->resize(num_kept); }
+  }
+
+
+  // **************************************************
+  // COLLAPSE ISOSURFACE VERTICES IN BLOCKS
+  // **************************************************
+
+  /// Collapse isosurface vertices in hierarchical blocks of grid cubes.
+  /// - Level k blocks are 2^k x 2^k x 2^k cubes.
+  ///   Blocks at level k are unions of eight blocks at level (k-1).
+  /// - A block collapses to the centroid of its isosurface vertices if
+  ///   all its blocks at level (k-1) collapsed and 
+  ///   block_test.IsCollapsible() returns true.
+  /// - Quadrilaterals with one collapsed edge become triangles
+  ///   and are added to dual_isosurface.tri_vert.
+  ///   Triangles already in dual_isosurface.tri_vert with
+  ///   a collapsed edge are deleted.
+  ///   Quadrilaterals with more collapsed edges are deleted.
+  ///   isopoly_info[] is updated to match the remaining quadrilaterals.
+  /// - Collapsing may make two quadrilaterals or two triangles
+  ///   identical.  Duplicates are deleted and identical polygons
+  ///   with opposite orientations cancel, so collapse does not create
+  ///   back-to-back polygons.  (See delete_duplicate_polygons.)
+  ///   Distinct polygons may still share an edge of the collapsed mesh.
+  /// - Unreferenced vertices are deleted.
+  /// @pre Vertex coordinates are in grid units (before rescaling).
+  /// @pre Quadrilateral vertices are ordered bottom-left, bottom-right,
+  ///   top-left, top-right.
+  template <typename SGRID_TYPE, typename BLOCK_TEST_TYPE, 
+            typename ISOSURFACE_TYPE>
+  void collapse_isov_in_blocks_3D
+  (const SGRID_TYPE & scalar_grid, const int max_level,
+   const BLOCK_TEST_TYPE & block_test, ISOSURFACE_TYPE & dual_isosurface)
+  {
+    typedef typename ISOSURFACE_TYPE::ISOPOLY_INFO_ARRAY ISOPOLY_INFO_ARRAY;
+    typedef unsigned long long MORTON_CODE_TYPE;
+    typedef std::pair<MORTON_CODE_TYPE, ISO_VERTEX_INDEX> KEY_VERTEX_PAIR;
+
+    const int DIM3(3);
+    const int NUM_VERT_PER_QUAD(4);
+    const int MAX_NUM_BITS(21);
+    const int dimension = scalar_grid.Dimension();
+    const ISO_VERTEX_INDEX numv = dual_isosurface.NumIsoVert();
+    const std::size_t num_quad = dual_isosurface.NumIsoPoly();
+    const COORD_ARRAY & vertex_coord = dual_isosurface.vertex_coord;
+    IJK::PROCEDURE_ERROR error("collapse_isov_in_blocks_3D");
+
+    if (dimension != DIM3) {
+      error.AddMessage("Illegal dimension ", dimension, ".");
+      error.AddMessage("  Collapse is only implemented for dimension 3.");
+      throw error;
+    }
+
+    if (dual_isosurface.NumVerticesPerIsoPoly() != NUM_VERT_PER_QUAD) {
+      error.AddMessage
+        ("Programming error.  Isosurface polygons must be quadrilaterals.");
+      throw error;
+    }
+
+    for (int d = 0; d < DIM3; d++) {
+      if (scalar_grid.AxisSize(d) > (1 << MAX_NUM_BITS)) {
+        error.AddMessage("Axis size ", d, " is greater than ",
+                         (1 << MAX_NUM_BITS), ".");
+        error.AddMessage("  Collapse requires smaller axis sizes.");
+        throw error;
+      }
+    }
+
+    if (numv == 0 || max_level < 1) { return; }
+
+    // Sort vertices by Morton code of containing cube,
+    //   so that each block is a contiguous subsequence at every level.
+    std::vector<KEY_VERTEX_PAIR> key_vertex(numv);
+    std::vector<VERTEX_INDEX> cube_coord(DIM3*numv);
+    for (ISO_VERTEX_INDEX iv = 0; iv < numv; iv++) {
+      compute_cube_containing_coord_3D
+        (scalar_grid, &(vertex_coord[iv*DIM3]), &(cube_coord[iv*DIM3]));
+      key_vertex[iv].second = iv;
+      IJK::compute_morton_code_3D
+        (&(cube_coord[iv*DIM3]), MAX_NUM_BITS, key_vertex[iv].first);
+    }
+    std::sort(key_vertex.begin(), key_vertex.end());
+
+    std::vector<ISO_VERTEX_INDEX> sorted_vertex(numv);
+    for (ISO_VERTEX_INDEX i = 0; i < numv; i++) 
+      { sorted_vertex[i] = key_vertex[i].second; }
+
+    // new_vertex[iv] = vertex replacing iv.
+    std::vector<ISO_VERTEX_INDEX> new_vertex(numv);
+    for (ISO_VERTEX_INDEX iv = 0; iv < numv; iv++) { new_vertex[iv] = iv; }
+
+    // flag_collapsed[iv] = true if block containing iv collapsed.
+    std::vector<bool> flag_collapsed(numv, true);
+
+    COORD_ARRAY new_coord(vertex_coord);
+    for (int level = 1; level <= max_level && level <= MAX_NUM_BITS; 
+         level++) {
+
+      const int shift = DIM3*level;
+      ISO_VERTEX_INDEX i0 = 0;
+      while (i0 < numv) {
+
+        const MORTON_CODE_TYPE block_key = (key_vertex[i0].first >> shift);
+        ISO_VERTEX_INDEX i1 = i0+1;
+        while (i1 < numv && (key_vertex[i1].first >> shift) == block_key)
+          { i1++; }
+
+        const ISO_VERTEX_INDEX * vlist = &(sorted_vertex[i0]);
+        const ISO_VERTEX_INDEX numv_block = i1-i0;
+        COORD_TYPE centroid[DIM3];
+        ISO_VERTEX_INDEX first_vertex = vlist[0];
+        bool flag_collapse = true;
+
+        IJK::set_coord_3D(0, centroid);
+        for (ISO_VERTEX_INDEX i = 0; i < numv_block; i++) {
+          const ISO_VERTEX_INDEX iv = vlist[i];
+          if (!flag_collapsed[iv]) { flag_collapse = false; }
+          if (iv < first_vertex) { first_vertex = iv; }
+          IJK::add_coord_3D(centroid, &(vertex_coord[iv*DIM3]), centroid);
+        }
+        IJK::multiply_coord_3D(1.0/numv_block, centroid, centroid);
+
+        if (flag_collapse) {
+          flag_collapse = block_test.IsCollapsible
+            (vertex_coord, vlist, numv_block, centroid);
+        }
+
+        for (ISO_VERTEX_INDEX i = 0; i < numv_block; i++) {
+          const ISO_VERTEX_INDEX iv = vlist[i];
+          flag_collapsed[iv] = flag_collapse;
+          if (flag_collapse) { new_vertex[iv] = first_vertex; }
+        }
+
+        if (flag_collapse && numv_block > 1)
+          { IJK::copy_coord_3D(centroid, &(new_coord[first_vertex*DIM3])); }
+
+        i0 = i1;
+      }
+    }
+
+    // Replace vertices and remove degenerate triangles.
+    const int NUM_VERT_PER_TRI(3);
+    const std::size_t num_tri = 
+      dual_isosurface.tri_vert.size()/NUM_VERT_PER_TRI;
+    ISO_VERTEX_INDEX_ARRAY new_tri_vert;
+    new_tri_vert.reserve(dual_isosurface.tri_vert.size());
+    for (std::size_t itri = 0; itri < num_tri; itri++) {
+      ISO_VERTEX_INDEX tri_vert[NUM_VERT_PER_TRI];
+      for (int k = 0; k < NUM_VERT_PER_TRI; k++) {
+        const ISO_VERTEX_INDEX iv =
+          dual_isosurface.tri_vert[itri*NUM_VERT_PER_TRI+k];
+        tri_vert[k] = new_vertex[iv];
+      }
+
+      if (tri_vert[0] != tri_vert[1] && tri_vert[1] != tri_vert[2] &&
+          tri_vert[0] != tri_vert[2]) {
+        for (int k = 0; k < NUM_VERT_PER_TRI; k++)
+          { new_tri_vert.push_back(tri_vert[k]); }
+      }
+    }
+
+    // Replace vertices and remove degenerate quadrilaterals.
+    const bool flag_isopoly_info =
+      (dual_isosurface.isopoly_info.size() == num_quad);
+    ISO_VERTEX_INDEX_ARRAY new_quad_vert;
+    ISOPOLY_INFO_ARRAY new_isopoly_info;
+    new_quad_vert.reserve(dual_isosurface.isopoly_vert.size());
+    for (std::size_t iquad = 0; iquad < num_quad; iquad++) {
+      ISO_VERTEX_INDEX quad_vert[NUM_VERT_PER_QUAD];
+      for (int k = 0; k < NUM_VERT_PER_QUAD; k++) {
+        const ISO_VERTEX_INDEX iv =
+          dual_isosurface.isopoly_vert[iquad*NUM_VERT_PER_QUAD+k];
+        quad_vert[k] = new_vertex[iv];
+      }
+
+      const std::size_t num_quad_vert = new_quad_vert.size();
+      IJK::get_non_degenerate_quad_btlr
+        (quad_vert, new_tri_vert, new_quad_vert);
+      if (flag_isopoly_info && new_quad_vert.size() > num_quad_vert) {
+        new_isopoly_info.push_back(dual_isosurface.isopoly_info[iquad]);
+      }
+    }
+
+    // Delete duplicate polygons created by collapse.
+    const int QUAD_CYCLIC_ORDER[NUM_VERT_PER_QUAD] = { 0, 1, 3, 2 };
+    const int TRI_CYCLIC_ORDER[NUM_VERT_PER_TRI] = { 0, 1, 2 };
+    ISOPOLY_INFO_ARRAY * isopoly_info_ptr = 
+      (flag_isopoly_info ? &new_isopoly_info : NULL);
+    delete_duplicate_polygons
+      (NUM_VERT_PER_QUAD, QUAD_CYCLIC_ORDER, new_quad_vert, 
+       isopoly_info_ptr);
+    delete_duplicate_polygons
+      (NUM_VERT_PER_TRI, TRI_CYCLIC_ORDER, new_tri_vert, 
+       (ISOPOLY_INFO_ARRAY *) NULL);
+
+    dual_isosurface.isopoly_vert.swap(new_quad_vert);
+    dual_isosurface.tri_vert.swap(new_tri_vert);
+    dual_isosurface.isopoly_info.swap(new_isopoly_info);
+    dual_isosurface.vertex_coord.swap(new_coord);
+
+    IJK::delete_unreferenced_vertices_two_lists
+      (DIM3, dual_isosurface.vertex_coord,
+       dual_isosurface.isopoly_vert, dual_isosurface.tri_vert);
+  }
+
+
+  // **************************************************
+  // DUAL COLLAPSE
+  // **************************************************
+
+  /// Collapse isosurface vertices by clustering vertices
+  ///   in blocks of grid cubes.
+  /// - Block collapses if COLLAPSE_QEF_TEST::IsCollapsible is true
+  ///   for max_distance equal to dualiso_data.MaxCollapseDistance().
+  /// - Blocks have at most 2^L x 2^L x 2^L cubes where 
+  ///   L equals dualiso_data.MaxCollapseLevel().
+  /// - See collapse_isov_in_blocks_3D.
+  template <typename DATA_TYPE, typename ISOSURFACE_TYPE>
+  void dual_collapse
+  (const DATA_TYPE & dualiso_data, ISOSURFACE_TYPE & dual_isosurface)
+  {
+    const COLLAPSE_QEF_TEST qef_test
+      (dualiso_data.ScalarGrid(), dual_isosurface.vertex_coord,
+       dualiso_data.MaxCollapseDistance(), dualiso_data.MaxSmallMagnitude());
+
+    collapse_isov_in_blocks_3D
+      (dualiso_data.ScalarGrid(), dualiso_data.MaxCollapseLevel(),
+       qef_test, dual_isosurface);
+  }
+
+}
+
+#endif
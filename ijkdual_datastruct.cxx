@@ -21,6 +21,7 @@
   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 */
 
+#include <algorithm>
 #include <assert.h>
 #include <cmath>
 #include <cstddef>
@@ -33,6 +34,7 @@
 
 #include "ijkdual_types.h"
 #include "ijkdual_datastruct.h"
+#include "ijkdual_extract.txx"
 
 using namespace IJK;
 using namespace IJKDUAL;
@@ -95,6 +97,22 @@ void DUALISO_DATA_FLAGS::Init()
   flag_connect_ambiguous = false;
   flag_iso_quad_dual_to_grid_edges = true;
   flag_dual_collapse = false;
+  max_collapse_level = 3;
+  max_collapse_distance = 0.1;
+  flag_adaptive_octree = false;
+  max_octree_level = 4;
+  max_octree_linear_error = 0;
+  flag_extract_in_blocks = false;
+  extract_block_length = 16;
+  flag_extract_incremental = false;
+  flag_extract_two_pass = false;
+  flag_extract_multi_isovalue = false;
+  flag_roi = false;
+  flag_brick = false;
+  flag_extract_active_cubes = false;
+  flag_reorder_vertex_cache = false;
+  vertex_cache_size = 32;
+  flag_cube_relative_coord = false;
   max_small_magnitude = 0.0001;
   use_triangle_mesh = false;
   quad_tri_method = UNDEFINED_TRI;
@@ -114,6 +132,20 @@ void DUALISO_DATA_FLAGS::Set(const DUALISO_DATA_FLAGS & data_flags)
   *this = data_flags;
 }
 
+// Set region of interest.
+void DUALISO_DATA_FLAGS::SetROI(const GRID_BOX & roi)
+{
+  this->roi = roi;
+  flag_roi = true;
+}
+
+// Set box of grid vertices owned by brick.
+void DUALISO_DATA_FLAGS::SetBrickOwnedBox(const GRID_BOX & owned_box)
+{
+  brick_owned_box = owned_box;
+  flag_brick = true;
+}
+
 // Return false if flag_iso_quad_dual_to_grid_edges is false.
 bool DUALISO_DATA_FLAGS::CheckIsoQuadDualToGridEdges
 (const char * proc_name, IJK::ERROR & error) const
@@ -144,22 +176,49 @@ IJKDUAL::DUALISO_TIME::DUALISO_TIME()
 
 void IJKDUAL::DUALISO_TIME::Clear()
 {
-  preprocessing = 0.0;
-  extract = 0.0;
-  merge = 0.0;
-  position = 0.0;
-  collapse = 0.0;
-  total = 0.0;
+  preprocessing.Clear();
+  extract.Clear();
+  merge.Clear();
+  classify.Clear();
+  split.Clear();
+  position.Clear();
+  collapse.Clear();
+  triangulate.Clear();
+  rescale.Clear();
+  total.Clear();
 }
 
 void IJKDUAL::DUALISO_TIME::Add(const DUALISO_TIME & dualiso_time)
 {
-  preprocessing += dualiso_time.preprocessing;
-  extract += dualiso_time.extract;
-  merge += dualiso_time.merge;
-  position += dualiso_time.position;
-  collapse += dualiso_time.collapse;
-  total += dualiso_time.total;
+  preprocessing.Add(dualiso_time.preprocessing);
+  extract.Add(dualiso_time.extract);
+  merge.Add(dualiso_time.merge);
+  classify.Add(dualiso_time.classify);
+  split.Add(dualiso_time.split);
+  position.Add(dualiso_time.position);
+  collapse.Add(dualiso_time.collapse);
+  triangulate.Add(dualiso_time.triangulate);
+  rescale.Add(dualiso_time.rescale);
+  total.Add(dualiso_time.total);
+}
+
+void IJKDUAL::DUALISO_TIME::WriteJSON(std::ostream & out) const
+{
+  const int NUM_STAGES = 10;
+  const char * stage_name[NUM_STAGES] = 
+    { "preprocessing", "extract", "merge", "classify", "split",
+      "position", "collapse", "triangulate", "rescale", "total" };
+  const IJK::WALL_CPU_TIME * stage_time[NUM_STAGES] = 
+    { &preprocessing, &extract, &merge, &classify, &split,
+      &position, &collapse, &triangulate, &rescale, &total };
+
+  out << "{";
+  for (int i = 0; i < NUM_STAGES; i++) {
+    if (i > 0) { out << ", "; }
+    out << "\"" << stage_name[i] << "\": ";
+    stage_time[i]->WriteJSON(out);
+  }
+  out << "}";
 }
 
 // **************************************************
@@ -176,6 +235,16 @@ void IJKDUAL::GRID_INFO::Clear()
   num_cubes = 0;
 }
 
+void IJKDUAL::GRID_INFO::Add(const GRID_INFO & info)
+{
+  num_cubes += info.num_cubes;
+}
+
+void IJKDUAL::GRID_INFO::WriteJSON(std::ostream & out) const
+{
+  out << "{\"num_cubes\": " << num_cubes << "}";
+}
+
 void IJKDUAL::SCALAR_INFO::Init(const int dimension)
 {
   this->dimension = 0;
@@ -195,6 +264,18 @@ void IJKDUAL::SCALAR_INFO::Clear()
   num_bipolar_edges = 0;
 }
 
+void IJKDUAL::SCALAR_INFO::Add(const SCALAR_INFO & info)
+{
+  num_non_empty_cubes += info.num_non_empty_cubes;
+  num_bipolar_edges += info.num_bipolar_edges;
+}
+
+void IJKDUAL::SCALAR_INFO::WriteJSON(std::ostream & out) const
+{
+  out << "{\"num_non_empty_cubes\": " << num_non_empty_cubes
+      << ", \"num_bipolar_edges\": " << num_bipolar_edges << "}";
+}
+
 void IJKDUAL::SCALAR_INFO::SetDimension(const int dimension)
 {
   FreeAll();
@@ -245,6 +326,31 @@ void IJKDUAL::MULTI_ISOV_INFO::Clear()
   num_non_ambig_ridge_cubes_changed = 0;
 }
 
+void IJKDUAL::MULTI_ISOV_INFO::Add(const MULTI_ISOV_INFO & info)
+{
+  num_cubes_single_isov += info.num_cubes_single_isov;
+  num_cubes_multi_isov += info.num_cubes_multi_isov;
+  num_non_manifold_split += info.num_non_manifold_split;
+  num_1_2_changed += info.num_1_2_changed;
+  num_connect_changed += info.num_connect_changed;
+  num_ambig_ridge_cubes_changed += info.num_ambig_ridge_cubes_changed;
+  num_non_ambig_ridge_cubes_changed += 
+    info.num_non_ambig_ridge_cubes_changed;
+}
+
+void IJKDUAL::MULTI_ISOV_INFO::WriteJSON(std::ostream & out) const
+{
+  out << "{\"num_cubes_single_isov\": " << num_cubes_single_isov
+      << ", \"num_cubes_multi_isov\": " << num_cubes_multi_isov
+      << ", \"num_non_manifold_split\": " << num_non_manifold_split
+      << ", \"num_1_2_changed\": " << num_1_2_changed
+      << ", \"num_connect_changed\": " << num_connect_changed
+      << ", \"num_ambig_ridge_cubes_changed\": " 
+      << num_ambig_ridge_cubes_changed
+      << ", \"num_non_ambig_ridge_cubes_changed\": " 
+      << num_non_ambig_ridge_cubes_changed << "}";
+}
+
 IJKDUAL::DUALISO_INFO::DUALISO_INFO()
 {
   Clear();
@@ -263,6 +369,27 @@ void IJKDUAL::DUALISO_INFO::Clear()
   multi_isov.Clear();
 }
 
+void IJKDUAL::DUALISO_INFO::Add(const DUALISO_INFO & info)
+{
+  grid.Add(info.grid);
+  scalar.Add(info.scalar);
+  time.Add(info.time);
+  multi_isov.Add(info.multi_isov);
+}
+
+void IJKDUAL::DUALISO_INFO::WriteJSON(std::ostream & out) const
+{
+  out << "{\"grid\": ";
+  grid.WriteJSON(out);
+  out << ", \"scalar\": ";
+  scalar.WriteJSON(out);
+  out << ", \"multi_isov\": ";
+  multi_isov.WriteJSON(out);
+  out << ", \"time\": ";
+  time.WriteJSON(out);
+  out << "}";
+}
+
 
 // **************************************************
 // MERGE DATA
@@ -270,7 +397,7 @@ void IJKDUAL::DUALISO_INFO::Clear()
 
 void IJKDUAL::MERGE_DATA::Init
 (const int dimension, const AXIS_SIZE_TYPE * axis_size,
- const MERGE_INDEX num_obj_per_vertex, const MERGE_INDEX num_obj_per_edge)
+ const VERTEX_INDEX num_obj_per_vertex, const VERTEX_INDEX num_obj_per_edge)
 {
   this->num_obj_per_vertex = num_obj_per_vertex;
   this->num_obj_per_edge = num_obj_per_edge;
@@ -279,9 +406,9 @@ void IJKDUAL::MERGE_DATA::Init
   compute_num_grid_vertices(dimension, axis_size, num_vertices);
   num_edges = dimension*num_vertices;
   vertex_id0 = num_obj_per_edge*num_edges;
-  MERGE_INDEX num_obj = 
+  VERTEX_INDEX num_obj = 
     num_obj_per_vertex*num_vertices + num_obj_per_edge*num_edges;
-  INTEGER_LIST<MERGE_INDEX,MERGE_INDEX>::Init(num_obj);
+  INTEGER_LIST<VERTEX_INDEX,MERGE_INDEX>::Init(num_obj);
 }
 
 bool IJKDUAL::MERGE_DATA::Check(ERROR & error) const
@@ -295,3 +422,269 @@ bool IJKDUAL::MERGE_DATA::Check(ERROR & error) const
   return(true);
 }
 
+
+
+// **************************************************
+// INCREMENTAL EXTRACTION DATA
+// **************************************************
+
+void IJKDUAL::EXTRACT_BLOCK_DATA::Clear()
+{
+  is_set = false;
+  sign_bits.clear();
+  isopoly.clear();
+  facet_vertex.clear();
+  dual_edge.clear();
+}
+
+bool IJKDUAL::INCREMENTAL_EXTRACT_DATA::Matches
+(const DUALISO_SCALAR_GRID_BASE & scalar_grid, 
+ const SCALAR_TYPE isovalue, const int block_length,
+ const bool flag_facet_vertex) const
+{
+  const int dimension = scalar_grid.Dimension();
+
+  if (int(axis_size.size()) != dimension) { return(false); }
+  for (int d = 0; d < dimension; d++) {
+    if (axis_size[d] != scalar_grid.AxisSize(d)) { return(false); }
+  }
+
+  return(this->isovalue == isovalue && 
+         this->block_length == block_length &&
+         this->flag_facet_vertex == flag_facet_vertex);
+}
+
+void IJKDUAL::INCREMENTAL_EXTRACT_DATA::Reset
+(const DUALISO_SCALAR_GRID_BASE & scalar_grid, 
+ const SCALAR_TYPE isovalue, const int block_length,
+ const bool flag_facet_vertex)
+{
+  const int dimension = scalar_grid.Dimension();
+  std::vector<GRID_COORD_TYPE> coord(dimension);
+
+  Clear();
+
+  axis_size.assign
+    (scalar_grid.AxisSize(), scalar_grid.AxisSize()+dimension);
+  this->isovalue = isovalue;
+  this->block_length = block_length;
+  this->flag_facet_vertex = flag_facet_vertex;
+
+  get_grid_blocks_in_morton_order(scalar_grid, block_length, block_base);
+
+  // Regions of block_minmax are in lexicographic order.
+  std::vector<VERTEX_INDEX> num_regions(dimension);
+  for (int d = 0; d < dimension; d++) {
+    num_regions[d] = IJK::compute_num_regions_along_axis
+      (scalar_grid.AxisSize(d), AXIS_SIZE_TYPE(block_length));
+  }
+
+  block_region.resize(block_base.size());
+  for (std::size_t ib = 0; ib < block_base.size(); ib++) {
+    scalar_grid.ComputeCoord(block_base[ib], &(coord.front()));
+
+    VERTEX_INDEX iregion = 0;
+    for (int d = dimension-1; d >= 0; d--)
+      { iregion = iregion*num_regions[d] + coord[d]/block_length; }
+    block_region[ib] = iregion;
+  }
+
+  block.resize(block_base.size());
+}
+
+void IJKDUAL::INCREMENTAL_EXTRACT_DATA::Clear()
+{
+  axis_size.clear();
+  isovalue = 0;
+  block_length = 0;
+  flag_facet_vertex = false;
+  block_base.clear();
+  block_region.clear();
+  std::vector<EXTRACT_BLOCK_DATA>().swap(block);
+  num_inactive_blocks = 0;
+  num_reused_blocks = 0;
+  num_extracted_blocks = 0;
+}
+
+
+// **************************************************
+// MULTI_ISOVALUE_EXTRACT_DATA
+// **************************************************
+
+int IJKDUAL::MULTI_ISOVALUE_EXTRACT_DATA::Find
+(const SCALAR_TYPE isovalue) const
+{
+  const auto iter = 
+    std::lower_bound(this->isovalue.begin(), this->isovalue.end(), isovalue);
+
+  if (iter == this->isovalue.end() || *iter != isovalue) { return(-1); }
+  return(iter - this->isovalue.begin());
+}
+
+bool IJKDUAL::MULTI_ISOVALUE_EXTRACT_DATA::Contains
+(const SCALAR_TYPE isovalue, const bool flag_facet_vertex) const
+{
+  if (flag_facet_vertex && !this->flag_facet_vertex) { return(false); }
+
+  const int k = Find(isovalue);
+  return(k >= 0 && is_set[k]);
+}
+
+void IJKDUAL::MULTI_ISOVALUE_EXTRACT_DATA::Reset
+(const std::vector<SCALAR_TYPE> & isovalue_list,
+ const bool flag_facet_vertex)
+{
+  Clear();
+
+  isovalue = isovalue_list;
+  std::sort(isovalue.begin(), isovalue.end());
+  isovalue.erase
+    (std::unique(isovalue.begin(), isovalue.end()), isovalue.end());
+  this->flag_facet_vertex = flag_facet_vertex;
+
+  const int num_isovalues = isovalue.size();
+  isopoly.resize(num_isovalues);
+  if (flag_facet_vertex) { facet_vertex.resize(num_isovalues); }
+  dual_edge.resize(num_isovalues);
+  is_set.assign(num_isovalues, true);
+}
+
+void IJKDUAL::MULTI_ISOVALUE_EXTRACT_DATA::Take
+(const SCALAR_TYPE isovalue, std::vector<VERTEX_INDEX> & isopoly,
+ std::vector<FACET_VERTEX_INDEX> * facet_vertex,
+ std::vector<GRID_EDGE_TYPE> & dual_edge,
+ DUALISO_INFO & dualiso_info)
+{
+  const int k = Find(isovalue);
+  IJK::PROCEDURE_ERROR error("MULTI_ISOVALUE_EXTRACT_DATA::Take");
+
+  if (!Contains(isovalue, facet_vertex != NULL)) {
+    error.AddMessage
+      ("Programming error.  No polytopes for isovalue ", isovalue, ".");
+    throw error;
+  }
+
+  // Swap, then free the old output buffers.
+  isopoly.swap(this->isopoly[k]);
+  std::vector<VERTEX_INDEX>().swap(this->isopoly[k]);
+  if (facet_vertex != NULL) { facet_vertex->swap(this->facet_vertex[k]); }
+  if (flag_facet_vertex) 
+    { std::vector<FACET_VERTEX_INDEX>().swap(this->facet_vertex[k]); }
+  dual_edge.swap(this->dual_edge[k]);
+  std::vector<GRID_EDGE_TYPE>().swap(this->dual_edge[k]);
+  is_set[k] = false;
+
+  dualiso_info.time.extract.Clear();
+  dualiso_info.scalar.num_bipolar_edges = dual_edge.size();
+}
+
+void IJKDUAL::MULTI_ISOVALUE_EXTRACT_DATA::Clear()
+{
+  flag_facet_vertex = false;
+  isovalue.clear();
+  std::vector< std::vector<VERTEX_INDEX> >().swap(isopoly);
+  std::vector< std::vector<FACET_VERTEX_INDEX> >().swap(facet_vertex);
+  std::vector< std::vector<GRID_EDGE_TYPE> >().swap(dual_edge);
+  is_set.clear();
+}
+
+
+// **************************************************
+// DUALISO CONTEXT
+// **************************************************
+
+void IJKDUAL::DUALISO_CONTEXT::Init()
+{
+  merge_data = NULL;
+  isodual_table = NULL;
+  facet_intersection_table = NULL;
+}
+
+void IJKDUAL::DUALISO_CONTEXT::FreeTables()
+{
+  delete merge_data;
+  merge_data = NULL;
+  merge_axis_size.clear();
+  delete isodual_table;
+  isodual_table = NULL;
+  delete facet_intersection_table;
+  facet_intersection_table = NULL;
+}
+
+ISO_MERGE_DATA & IJKDUAL::DUALISO_CONTEXT::MergeData
+(const int dimension, const AXIS_SIZE_TYPE * axis_size)
+{
+  bool flag_match = (merge_data != NULL && 
+                     int(merge_axis_size.size()) == dimension);
+  for (int d = 0; flag_match && d < dimension; d++) {
+    if (merge_axis_size[d] != axis_size[d]) { flag_match = false; }
+  }
+
+  if (!flag_match) {
+    delete merge_data;
+    merge_data = NULL;
+    merge_axis_size.assign(axis_size, axis_size+dimension);
+    merge_data = new ISO_MERGE_DATA(dimension, axis_size);
+  }
+
+  return(*merge_data);
+}
+
+const IJKDUALTABLE::ISODUAL_CUBE_TABLE_AMBIG & 
+IJKDUAL::DUALISO_CONTEXT::IsodualTable
+(const int dimension, const bool flag_separate_neg)
+{
+  const bool flag_always_separate_opposite(true);
+
+  if (isodual_table == NULL || isodual_table->Dimension() != dimension ||
+      isodual_table->FlagSeparateNeg() != flag_separate_neg) {
+    delete isodual_table;
+    isodual_table = NULL;
+    isodual_table = new IJKDUALTABLE::ISODUAL_CUBE_TABLE_AMBIG
+      (dimension, flag_separate_neg, flag_always_separate_opposite);
+  }
+
+  return(*isodual_table);
+}
+
+const DUALISO_FACET_INTERSECTION_TABLE & 
+IJKDUAL::DUALISO_CONTEXT::FacetIntersectionTable(const int dimension)
+{
+  if (facet_intersection_table == NULL || 
+      facet_intersection_table->Dimension() != dimension) {
+    delete facet_intersection_table;
+    facet_intersection_table = NULL;
+    facet_intersection_table = 
+      new DUALISO_FACET_INTERSECTION_TABLE(dimension);
+    facet_intersection_table->Create();
+  }
+
+  return(*facet_intersection_table);
+}
+
+void IJKDUAL::DUALISO_CONTEXT::ClearBuffers()
+{
+  isopoly.clear();
+  facet_vertex.clear();
+  cube_list.clear();
+  isopoly_cube.clear();
+  cube_isov_list.clear();
+  iso_vlist.clear();
+}
+
+void IJKDUAL::DUALISO_CONTEXT::Clear()
+{
+  FreeTables();
+
+  // Swap with empty vectors to release capacity.
+  std::vector<VERTEX_INDEX>().swap(isopoly);
+  std::vector<FACET_VERTEX_INDEX>().swap(facet_vertex);
+  std::vector<VERTEX_INDEX>().swap(cube_list);
+  std::vector<ISO_VERTEX_INDEX>().swap(isopoly_cube);
+  std::vector<GRID_CUBE_DATA>().swap(cube_isov_list);
+  std::vector<DUAL_ISOVERT>().swap(iso_vlist);
+  std::vector<ISO_VERTEX_INDEX>().swap(index_to_cube_list);
+  incremental.Clear();
+  std::vector<VERTEX_INDEX>().swap(active_cube);
+  multi_isovalue.Clear();
+}
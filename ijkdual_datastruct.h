@@ -32,6 +32,8 @@
 #include "ijkisopoly.txx"
 #include "ijkscalar_grid.txx"
 #include "ijkmerge.txx"
+#include "ijkfacet_intersection_table.txx"
+#include "ijktime.txx"
 
 
 #include "ijkdual_types.h"
@@ -52,11 +54,11 @@ namespace IJKDUAL {
     GRID_PLUS;                     ///< Regular grid.
   typedef IJK::GRID_SPACING<COORD_TYPE, GRID_PLUS>
     DUALISO_GRID;                  ///< Grid and spacing information.
-  typedef IJK::SCALAR_GRID_BASE<DUALISO_GRID, SCALAR_TYPE> 
+  typedef IJK::SCALAR_GRID_BASE<DUALISO_GRID, GRID_SCALAR_TYPE> 
     DUALISO_SCALAR_GRID_BASE;      ///< Marching Cubes base scalar grid.
-  typedef IJK::SCALAR_GRID_WRAPPER<DUALISO_GRID, SCALAR_TYPE>
+  typedef IJK::SCALAR_GRID_WRAPPER<DUALISO_GRID, GRID_SCALAR_TYPE>
     DUALISO_SCALAR_GRID_WRAPPER;   ///< Marching Cubes scalar grid wrapper.
-  typedef IJK::SCALAR_GRID<DUALISO_GRID, SCALAR_TYPE> 
+  typedef IJK::SCALAR_GRID<DUALISO_GRID, GRID_SCALAR_TYPE> 
     DUALISO_SCALAR_GRID;           ///< Marching Cubes scalar grid.
 
 
@@ -73,12 +75,12 @@ namespace IJKDUAL {
   // **************************************************
 
   typedef IJK::DUAL_ISOVERT
-  <ISO_VERTEX_INDEX, FACET_VERTEX_INDEX, IJKDUALTABLE::TABLE_INDEX,
+  <VERTEX_INDEX, FACET_VERTEX_INDEX, IJKDUALTABLE::TABLE_INDEX,
    ISO_VERTEX_INDEX>
   DUAL_ISOVERT;
 
   typedef IJK::DUAL_ISOVERT_BFLAG
-  <ISO_VERTEX_INDEX, FACET_VERTEX_INDEX, IJKDUALTABLE::TABLE_INDEX,
+  <VERTEX_INDEX, FACET_VERTEX_INDEX, IJKDUALTABLE::TABLE_INDEX,
    ISO_VERTEX_INDEX>
   DUAL_ISOVERT_BFLAG;
 
@@ -88,7 +90,7 @@ namespace IJKDUAL {
   // **************************************************
 
   typedef IJK::GRID_CUBE_ISOVERT
-  <ISO_VERTEX_INDEX, IJKDUALTABLE::TABLE_INDEX, FACET_VERTEX_INDEX,
+  <VERTEX_INDEX, IJKDUALTABLE::TABLE_INDEX, FACET_VERTEX_INDEX,
    ISO_VERTEX_INDEX> GRID_CUBE_ISOVERT;
 
 
@@ -107,7 +109,7 @@ namespace IJKDUAL {
   // **************************************************
 
   class GRID_CUBE_DATA:
-    public IJK::GRID_CUBE_ISOVERT<ISO_VERTEX_INDEX, IJKDUALTABLE::TABLE_INDEX, 
+    public IJK::GRID_CUBE_ISOVERT<VERTEX_INDEX, IJKDUALTABLE::TABLE_INDEX, 
                                   FACET_VERTEX_INDEX, ISO_VERTEX_INDEX> {
 
   public:
@@ -157,6 +159,57 @@ namespace IJKDUAL {
   };
 
 
+  // **************************************************
+  // CUBE RELATIVE COORDINATES
+  // **************************************************
+
+  /// Isosurface vertex coordinates stored relative to the grid cube
+  ///   containing each vertex.
+  /// - Coordinate d of vertex i is
+  ///     (cube coordinate d) + offset[i*dimension+d]/MaxOffset().
+  /// - Coordinates are in grid units, i.e., before rescaling
+  ///   by grid spacing.
+  /// - Each 3D vertex takes sizeof(VERTEX_INDEX)+6 bytes,
+  ///   i.e., 10 bytes, or 14 bytes if ISODUAL_64BIT_INDEX is defined.
+  ///   Absolute float coordinates take 12 bytes.
+  class CUBE_RELATIVE_COORD_ARRAY {
+
+  public:
+    typedef unsigned short OFFSET_TYPE;
+    static const int NUM_OFFSET_BITS = 16;
+
+  protected:
+    int dimension;
+
+  public:
+    /// cube_index[i] = Index of cube containing i'th vertex.
+    VERTEX_INDEX_ARRAY cube_index;
+
+    /// Fixed point offsets of each vertex from its cube.
+    std::vector<OFFSET_TYPE> offset;
+
+  public:
+    CUBE_RELATIVE_COORD_ARRAY(const int dimension)
+    { this->dimension = dimension; }
+
+    int Dimension() const
+    { return(dimension); }
+
+    VERTEX_INDEX NumVertices() const
+    { return(cube_index.size()); }
+
+    /// Return offset representing the far side of the cube.
+    static OFFSET_TYPE MaxOffset()
+    { return(OFFSET_TYPE((1 << NUM_OFFSET_BITS) - 1)); }
+
+    void Clear()
+    {
+      cube_index.clear();
+      offset.clear();
+    }
+  };
+
+
   // **************************************************
   // DUAL CONTOURING ISOSURFACE CLASS
   // **************************************************
@@ -175,14 +228,21 @@ namespace IJKDUAL {
     void Init(const int dimension, const VERTEX_INDEX numv_per_isopoly);
 
   public:
+    typedef std::vector<ISOPOLY_INFO_TYPE> ISOPOLY_INFO_ARRAY;
+
     /// List of isosurface polytope vertices.
-    VERTEX_INDEX_ARRAY isopoly_vert;
+    ISO_VERTEX_INDEX_ARRAY isopoly_vert;
 
-    std::vector<ISOPOLY_INFO_TYPE> isopoly_info;
+    ISOPOLY_INFO_ARRAY isopoly_info;
 
     /// List of vertex coordinates.
     COORD_ARRAY vertex_coord;
 
+    /// Vertex coordinates relative to grid cubes.
+    /// Set instead of vertex_coord if DUALISO_DATA_FLAGS::CubeRelativeCoordFlag()
+    ///   is true.  Converted to vertex_coord before rescaling.
+    CUBE_RELATIVE_COORD_ARRAY cube_relative_coord;
+
     /// Index of first isosurface vertex on a grid edge.
     /// i'th isosurface vertex on grid edge is on the grid edge
     ///   dual to the i'th isosurface polytope.
@@ -191,7 +251,7 @@ namespace IJKDUAL {
     /// List of vertices of each triangle in triangle mesh.
     /// Only for 2D surface embedded in 3D.
     /// Not always set.
-    VERTEX_INDEX_ARRAY tri_vert;
+    ISO_VERTEX_INDEX_ARRAY tri_vert;
 
     /// cube_containing_isopoly[i] = cube containing i'th isopoly.
     /// Not always set.
@@ -199,7 +259,8 @@ namespace IJKDUAL {
 
   public:
     DUAL_ISOSURFACE_BASE
-      (const int dimension, const VERTEX_INDEX numv_per_isopoly)
+      (const int dimension, const VERTEX_INDEX numv_per_isopoly):
+      cube_relative_coord(dimension)
       { Init(dimension, numv_per_isopoly); }
 
     int Dimension() const
@@ -212,7 +273,15 @@ namespace IJKDUAL {
       { return(isopoly_vert.size()/NumVerticesPerIsoPoly()); };
 
     VERTEX_INDEX NumIsoVert() const
-    { return(vertex_coord.size()/dimension); }
+    {
+      if (IsCubeRelativeCoord())
+        { return(cube_relative_coord.NumVertices()); }
+      return(vertex_coord.size()/dimension);
+    }
+
+    /// Return true if vertex coordinates are stored in cube_relative_coord.
+    bool IsCubeRelativeCoord() const
+    { return(cube_relative_coord.NumVertices() > 0); }
 
     void Clear();
 
@@ -283,6 +352,92 @@ namespace IJKDUAL {
     /// If true, call dual_collapse to merge close isosurface vertices.
     bool flag_dual_collapse;
 
+    /// Maximum collapse level.
+    /// Level k merges isosurface vertices in blocks of 2^k x 2^k x 2^k cubes.
+    int max_collapse_level;
+
+    /// Maximum distance (in grid units) from an isosurface vertex
+    ///   to the plane approximating collapsed isosurface vertices.
+    COORD_TYPE max_collapse_distance;
+
+    /// If true, extract isosurface from the leaves of an
+    ///   adaptive octree, with a single vertex in each leaf.
+    bool flag_adaptive_octree;
+
+    /// Maximum octree level.
+    /// Octants at level k are blocks of 2^k x 2^k x 2^k cubes.
+    int max_octree_level;
+
+    /// Octant is a leaf if the scalar field on the octant grid vertices
+    ///   is within max_octree_linear_error of a linear function.
+    SCALAR_TYPE max_octree_linear_error;
+
+    /// If true, extract isosurface polytopes block by block,
+    ///   visiting grid blocks in Morton order.
+    bool flag_extract_in_blocks;
+
+    /// Extraction blocks have extract_block_length^dimension grid vertices.
+    int extract_block_length;
+
+    /// If true, extract isosurface polytopes incrementally,
+    ///   reusing the polytopes of grid blocks whose signs
+    ///   did not change since the previous call with the same context.
+    /// Uses extraction blocks of extract_block_length.
+    bool flag_extract_incremental;
+
+    /// If true, extract isosurface polytopes in two passes.
+    /// First pass counts bipolar edges in each grid slab.
+    /// Second pass writes polytopes into preallocated arrays.
+    /// Both passes process grid slabs in parallel.
+    /// Single pass and block extraction do not preallocate their output.
+    bool flag_extract_two_pass;
+
+    /// If true, extract isosurface polytopes for all isovalues
+    ///   in a single sweep of the grid before contouring
+    ///   each isovalue.  (See extract_dual_isopoly_multi_isovalue.)
+    bool flag_extract_multi_isovalue;
+
+    /// If true, construct isosurface only in region of interest roi.
+    /// - Extracts isosurface polytopes dual to grid edges
+    ///   whose incident grid cubes all lie in roi.
+    /// - The full grid is not copied.  Isosurface vertex coordinates
+    ///   are in the coordinate frame of the full grid.
+    /// - Cannot be combined with extraction in blocks,
+    ///   incremental extraction or two pass extraction.
+    ///   (See DUALISO_DATA::Check().)
+    bool flag_roi;
+
+    /// Region of interest.  Box of grid vertices.
+    GRID_BOX roi;
+
+    /// If true, grid is one brick of a decomposed grid.
+    /// - Extracts isosurface polytopes dual to interior grid edges
+    ///   whose lowest endpoint is in brick_owned_box.
+    /// - Brick includes a one vertex ghost layer around brick_owned_box,
+    ///   except on the boundary of the decomposed grid.
+    bool flag_brick;
+
+    /// Box of grid vertices owned by the brick.
+    GRID_BOX brick_owned_box;
+
+    /// If true, extract isosurface polytopes only from the cubes
+    ///   in DUALISO_CONTEXT::active_cube.
+    /// - Active cubes must include every cube with a bipolar edge.
+    /// - Used by progressive extraction, where active cubes are found
+    ///   from the scalar range of coarser levels.
+    bool flag_extract_active_cubes;
+
+    /// If true, reorder isosurface triangles and vertices
+    ///   for locality in a GPU vertex cache.
+    bool flag_reorder_vertex_cache;
+
+    /// Number of vertices in the vertex cache used for reordering.
+    int vertex_cache_size;
+
+    /// If true, store isosurface vertex coordinates as cube index
+    ///   plus fixed point offsets until rescaling.
+    bool flag_cube_relative_coord;
+
     /// Parameter for selecting triangulation based on distance to facets.
     /// If all vertices of quadrilateral q are distance at least
     ///   min_distance_use_tri4 to the facets incident on the grid edge
@@ -310,11 +465,53 @@ namespace IJKDUAL {
     /// Set
     void Set(const DUALISO_DATA_FLAGS & data_flags);
 
+    /// Set region of interest and set flag_roi to true.
+    void SetROI(const GRID_BOX & roi);
+
+    /// Set box of grid vertices owned by brick and set flag_brick to true.
+    void SetBrickOwnedBox(const GRID_BOX & owned_box);
+
     // Get functions
     bool AllowMultipleIsoVertices() const
       { return(allow_multiple_iso_vertices); }
     bool CollapseFlag() const
       { return(flag_dual_collapse); }
+    int MaxCollapseLevel() const
+      { return(max_collapse_level); }
+    COORD_TYPE MaxCollapseDistance() const
+      { return(max_collapse_distance); }
+    bool AdaptiveOctreeFlag() const
+      { return(flag_adaptive_octree); }
+    int MaxOctreeLevel() const
+      { return(max_octree_level); }
+    SCALAR_TYPE MaxOctreeLinearError() const
+      { return(max_octree_linear_error); }
+    bool ExtractInBlocksFlag() const
+      { return(flag_extract_in_blocks); }
+    int ExtractBlockLength() const
+      { return(extract_block_length); }
+    bool ExtractIncrementalFlag() const
+      { return(flag_extract_incremental); }
+    bool ExtractTwoPassFlag() const
+      { return(flag_extract_two_pass); }
+    bool ExtractMultiIsovalueFlag() const
+      { return(flag_extract_multi_isovalue); }
+    bool ROIFlag() const
+      { return(flag_roi); }
+    const GRID_BOX & ROI() const
+      { return(roi); }
+    bool BrickFlag() const
+      { return(flag_brick); }
+    const GRID_BOX & BrickOwnedBox() const
+      { return(brick_owned_box); }
+    bool ExtractActiveCubesFlag() const
+      { return(flag_extract_active_cubes); }
+    bool ReorderVertexCacheFlag() const
+      { return(flag_reorder_vertex_cache); }
+    int VertexCacheSize() const
+      { return(vertex_cache_size); }
+    bool CubeRelativeCoordFlag() const
+      { return(flag_cube_relative_coord); }
     bool SplitNonManifoldFlag() const
       { return(flag_split_non_manifold); }
     bool SelectSplitFlag() const
@@ -410,26 +607,36 @@ namespace IJKDUAL {
   // **************************************************
 
   /// dual contouring time.
-  /// Uses system clock() function to determine time.  
-  /// System clock() function should return cpu time, 
-  ///   but may return wall time.
+  /// Each stage records monotonic wall clock time and process CPU time.
   class DUALISO_TIME {
 
   public:
-    // all times are in seconds
+    // all times are in seconds, wall clock and CPU
+
+    typedef IJK::WALL_CPU_TIME TIME_TYPE;
 
     /// time to create data structure for faster isosurface extraction
-    float preprocessing;  
+    TIME_TYPE preprocessing;  
+
+    TIME_TYPE extract;      ///< time to extract isosurface mesh
+    TIME_TYPE merge;        ///< time to merge identical vertices
+    TIME_TYPE classify;     ///< time to compute cube isosurface table indices
+    TIME_TYPE split;        ///< time to split multiple isosurface vertices
+    TIME_TYPE position;     ///< time to position isosurface vertices
+    TIME_TYPE collapse;     ///< time to collapse isosurface vertices
+    TIME_TYPE triangulate;  ///< time to triangulate isosurface polygons
+    TIME_TYPE rescale;      ///< time to rescale vertex coordinates
 
-    float extract;    ///< time to extract isosurface mesh
-    float merge;      ///< time to merge identical vertices
-    float position;   ///< time to position isosurface vertices
-    float collapse;   ///< time to collapse isosurface vertices
-    float total;      /// extract_time+merge_time+position_time+collapse_time
+    /// Total time of all stages.
+    TIME_TYPE total;
 
     DUALISO_TIME();
     void Clear();
     void Add(const DUALISO_TIME & dualiso_time);
+
+    /// Write stage times as a JSON object.
+    /// - Each stage is written as {"wall": wall, "cpu": cpu}.
+    void WriteJSON(std::ostream & out) const;
   };
 
   // **************************************************
@@ -445,6 +652,10 @@ namespace IJKDUAL {
     VERTEX_INDEX num_cubes;         ///< Number of grid cubes.
 
     void Clear();                   ///< Clear all data.
+    void Add(const GRID_INFO & info); ///< Add counts in info.
+
+    /// Write as JSON object.
+    void WriteJSON(std::ostream & out) const;
   };
 
   // **************************************************
@@ -484,6 +695,10 @@ namespace IJKDUAL {
     int Dimension() const { return(dimension); };
 
     void Clear();     // clear all data
+    void Add(const SCALAR_INFO & info);   ///< Add counts in info.
+
+    /// Write as JSON object.
+    void WriteJSON(std::ostream & out) const;
   };
 
 
@@ -507,6 +722,10 @@ namespace IJKDUAL {
 
     
     void Clear();     // clear all data
+    void Add(const MULTI_ISOV_INFO & info);  ///< Add counts in info.
+
+    /// Write as JSON object.
+    void WriteJSON(std::ostream & out) const;
   };
 
 
@@ -528,6 +747,14 @@ namespace IJKDUAL {
     DUALISO_INFO(const int dimension);
 
     void Clear();     // clear all data
+
+    /// Add counts and times in info.
+    /// - Used to aggregate information over multiple isovalues.
+    void Add(const DUALISO_INFO & info);
+
+    /// Write as JSON object with members "grid", "scalar",
+    ///   "multi_isov" and "time".
+    void WriteJSON(std::ostream & out) const;
   };
 
   // **************************************************
@@ -535,55 +762,57 @@ namespace IJKDUAL {
   // **************************************************
 
   /// Internal data structure for merge_identical_vertices 
-  class MERGE_DATA: public IJK::INTEGER_LIST<MERGE_INDEX, MERGE_INDEX> {
+  /// - Identifiers are grid vertex or edge indices.
+  ///   Locations in the merged list have type MERGE_INDEX.
+  class MERGE_DATA: public IJK::INTEGER_LIST<VERTEX_INDEX, MERGE_INDEX> {
 
   protected:
-    MERGE_INDEX num_edges;             ///< Number of edges.
-    MERGE_INDEX num_vertices;          ///< Number of vertices.
-    MERGE_INDEX num_obj_per_vertex;    ///< Number of objects per vertex.
-    MERGE_INDEX num_obj_per_edge;      ///< Number of objects per edge.
-    MERGE_INDEX num_obj_per_grid_vertex; ///< Number of objects per grid vertex.
-    MERGE_INDEX vertex_id0;            ///< First vertex identifier.
+    VERTEX_INDEX num_edges;             ///< Number of edges.
+    VERTEX_INDEX num_vertices;          ///< Number of vertices.
+    VERTEX_INDEX num_obj_per_vertex;    ///< Number of objects per vertex.
+    VERTEX_INDEX num_obj_per_edge;      ///< Number of objects per edge.
+    VERTEX_INDEX num_obj_per_grid_vertex; ///< Number of objects per grid vertex.
+    VERTEX_INDEX vertex_id0;            ///< First vertex identifier.
 
     /// Initialize.
     void Init(const int dimension, const AXIS_SIZE_TYPE * axis_size,
-              const MERGE_INDEX num_obj_per_vertex,
-              const MERGE_INDEX num_obj_per_edge);
+              const VERTEX_INDEX num_obj_per_vertex,
+              const VERTEX_INDEX num_obj_per_edge);
 
   public:
     MERGE_DATA(const int dimension, const AXIS_SIZE_TYPE * axis_size)
       { Init(dimension, axis_size, 0, 1); };
     MERGE_DATA(const int dimension, const AXIS_SIZE_TYPE * axis_size,
-               const MERGE_INDEX num_obj_per_vertex, 
-               const MERGE_INDEX num_obj_per_edge)
+               const VERTEX_INDEX num_obj_per_vertex, 
+               const VERTEX_INDEX num_obj_per_edge)
       { Init(dimension, axis_size, num_obj_per_vertex, num_obj_per_edge); };
 
     // get functions
-    MERGE_INDEX NumEdges() const        /// Number of edges.
+    VERTEX_INDEX NumEdges() const        /// Number of edges.
       { return(num_edges); };
-    MERGE_INDEX NumVertices() const     /// Number of vertices.
+    VERTEX_INDEX NumVertices() const     /// Number of vertices.
       { return(num_vertices); };
-    MERGE_INDEX NumObjPerVertex() const { return(num_obj_per_vertex); };
-    MERGE_INDEX NumObjPerEdge() const { return(num_obj_per_edge); };
-    MERGE_INDEX NumObjPerGridVertex() const
+    VERTEX_INDEX NumObjPerVertex() const { return(num_obj_per_vertex); };
+    VERTEX_INDEX NumObjPerEdge() const { return(num_obj_per_edge); };
+    VERTEX_INDEX NumObjPerGridVertex() const
       { return(num_obj_per_grid_vertex); };
-    MERGE_INDEX VertexIdentifier       /// Vertex identifier.
-      (const MERGE_INDEX iv) const { return(vertex_id0 + iv); };
-    MERGE_INDEX VertexIdentifier       /// Vertex identifier.
-      (const MERGE_INDEX iv, const MERGE_INDEX j) const 
+    VERTEX_INDEX VertexIdentifier       /// Vertex identifier.
+      (const VERTEX_INDEX iv) const { return(vertex_id0 + iv); };
+    VERTEX_INDEX VertexIdentifier       /// Vertex identifier.
+      (const VERTEX_INDEX iv, const VERTEX_INDEX j) const 
       { return(vertex_id0 + iv + j * num_vertices); };
-    MERGE_INDEX EdgeIdentifier         /// Edge identifier.
-      (const MERGE_INDEX ie) const { return(ie); };
-    MERGE_INDEX EdgeIdentifier         /// edge identifier
-      (const MERGE_INDEX ie, const MERGE_INDEX j) const 
+    VERTEX_INDEX EdgeIdentifier         /// Edge identifier.
+      (const VERTEX_INDEX ie) const { return(ie); };
+    VERTEX_INDEX EdgeIdentifier         /// edge identifier
+      (const VERTEX_INDEX ie, const VERTEX_INDEX j) const 
       { return(ie + j * num_edges); };
 
     /// Get first endpoint of edge containing isosurface vertex isov.
-    inline VERTEX_INDEX GetFirstEndpoint(const MERGE_INDEX isov) const
+    inline VERTEX_INDEX GetFirstEndpoint(const VERTEX_INDEX isov) const
       { return(isov/NumObjPerGridVertex()); };
 
     /// Get direction of edge containing isosurface vertex isov.
-    inline MERGE_INDEX GetEdgeDir(const MERGE_INDEX isov) const
+    inline VERTEX_INDEX GetEdgeDir(const VERTEX_INDEX isov) const
       { return(isov%NumObjPerGridVertex()); };
 
     bool Check(IJK::ERROR & error) const;     ///< Check allocated memory.
@@ -597,6 +826,246 @@ namespace IJKDUAL {
       MERGE_DATA(dimension, axis_size, 1, 0) {};
   };
 
+
+  // **************************************************
+  // INCREMENTAL EXTRACTION DATA
+  // **************************************************
+
+  /// Min and max scalar values of grid regions.
+  typedef IJK::MINMAX_REGIONS<DUALISO_GRID, GRID_SCALAR_TYPE>
+  DUALISO_MINMAX_REGIONS;
+
+  /// Isosurface polytopes extracted from one grid block.
+  /// - Polytopes depend only on the signs of the block vertices,
+  ///   so they are reused while the signs do not change.
+  class EXTRACT_BLOCK_DATA {
+
+  public:
+    /// True if sign_bits and the polytopes are valid.
+    bool is_set;
+
+    /// Packed signs of the block vertices, including the vertices
+    ///   on the upper block boundary.  Bit is 1 if scalar < isovalue.
+    std::vector<unsigned long long> sign_bits;
+
+    std::vector<VERTEX_INDEX> isopoly;
+    std::vector<FACET_VERTEX_INDEX> facet_vertex;
+    std::vector<GRID_EDGE_TYPE> dual_edge;
+
+  public:
+    EXTRACT_BLOCK_DATA() { is_set = false; };
+
+    /// Clear polytopes and set is_set to false.  Capacity is kept.
+    void Clear();
+  };
+
+  /// Data kept between calls for incremental extraction.
+  /// - Blocks are the extraction blocks of extract_dual_isopoly_in_blocks,
+  ///   in Morton order.
+  /// - Block data is valid only for the grid axis sizes, isovalue,
+  ///   and block length in the last call.
+  class INCREMENTAL_EXTRACT_DATA {
+
+  protected:
+    std::vector<AXIS_SIZE_TYPE> axis_size;
+    SCALAR_TYPE isovalue;
+    int block_length;
+    bool flag_facet_vertex;
+
+  public:
+    /// Min and max scalar values of each block.
+    DUALISO_MINMAX_REGIONS block_minmax;
+
+    /// block_base[ib] = Lowest vertex of block ib.
+    std::vector<VERTEX_INDEX> block_base;
+
+    /// block_region[ib] = Index of block ib in block_minmax.
+    std::vector<VERTEX_INDEX> block_region;
+
+    /// Polytopes extracted from each block.
+    std::vector<EXTRACT_BLOCK_DATA> block;
+
+    // Number of blocks of each type in the last call.
+    VERTEX_INDEX num_inactive_blocks;   ///< Blocks with no bipolar edges.
+    VERTEX_INDEX num_reused_blocks;     ///< Blocks with unchanged signs.
+    VERTEX_INDEX num_extracted_blocks;  ///< Blocks extracted again.
+
+  public:
+    INCREMENTAL_EXTRACT_DATA() { Clear(); };
+
+    /// Return true if block data is valid for the given parameters.
+    bool Matches
+      (const DUALISO_SCALAR_GRID_BASE & scalar_grid, 
+       const SCALAR_TYPE isovalue, const int block_length,
+       const bool flag_facet_vertex) const;
+
+    /// Set parameters and compute blocks.  Invalidate all block data.
+    void Reset
+      (const DUALISO_SCALAR_GRID_BASE & scalar_grid, 
+       const SCALAR_TYPE isovalue, const int block_length,
+       const bool flag_facet_vertex);
+
+    /// Free all block data.
+    void Clear();
+  };
+
+
+  /// Isosurface polytopes extracted for several isovalues
+  ///   in a single sweep of the grid.
+  /// - Polytopes of an isovalue are taken by the next call
+  ///   to dual_contouring with that isovalue, in place of extraction.
+  /// - Data is valid only for the scalar grid of the sweep.
+  class MULTI_ISOVALUE_EXTRACT_DATA {
+
+  protected:
+    bool flag_facet_vertex;
+
+    /// Return location of isovalue in list isovalue[], or -1.
+    int Find(const SCALAR_TYPE isovalue) const;
+
+  public:
+    /// Isovalues in increasing order, without duplicates.
+    std::vector<SCALAR_TYPE> isovalue;
+
+    /// isopoly[k], facet_vertex[k] and dual_edge[k] are the polytopes 
+    ///   of isovalue[k].
+    std::vector< std::vector<VERTEX_INDEX> > isopoly;
+    std::vector< std::vector<FACET_VERTEX_INDEX> > facet_vertex;
+    std::vector< std::vector<GRID_EDGE_TYPE> > dual_edge;
+
+    /// is_set[k] is true until the polytopes of isovalue[k] are taken.
+    std::vector<bool> is_set;
+
+  public:
+    MULTI_ISOVALUE_EXTRACT_DATA() { Clear(); };
+
+    /// Return true if polytopes include facet vertices.
+    bool FacetVertexFlag() const
+      { return(flag_facet_vertex); }
+
+    /// Return true if polytopes of isovalue are set and not yet taken.
+    /// @param flag_facet_vertex If true, polytopes must include
+    ///   facet vertices.
+    bool Contains
+      (const SCALAR_TYPE isovalue, const bool flag_facet_vertex) const;
+
+    /// Set isovalues, sorted and without duplicates.  Clear polytopes.
+    void Reset
+      (const std::vector<SCALAR_TYPE> & isovalue_list,
+       const bool flag_facet_vertex);
+
+    /// Move polytopes of isovalue to isopoly, facet_vertex and dual_edge.
+    /// - Sets dualiso_info.scalar.num_bipolar_edges.
+    /// - Extraction time is reported by the sweep, not by Take().
+    /// @param facet_vertex If NULL, facet vertices are discarded.
+    /// @pre Contains(isovalue, facet_vertex != NULL).
+    void Take
+      (const SCALAR_TYPE isovalue, std::vector<VERTEX_INDEX> & isopoly,
+       std::vector<FACET_VERTEX_INDEX> * facet_vertex,
+       std::vector<GRID_EDGE_TYPE> & dual_edge,
+       DUALISO_INFO & dualiso_info);
+
+    /// Free all polytopes.
+    void Clear();
+  };
+
+
+  // **************************************************
+  // DUALISO CONTEXT
+  // **************************************************
+
+  /// Facet intersection table used to split non-manifold vertices.
+  typedef IJK::FACET_INTERSECTION_TABLE
+  <DIRECTION_TYPE,VERTEX_INDEX,BOUNDARY_BITS_TYPE>
+  DUALISO_FACET_INTERSECTION_TABLE;
+
+  /// Lookup tables and scratch buffers reused by repeated calls
+  ///   to dual_contouring.
+  /// - Tables are created on first use and recreated only when
+  ///   the grid dimensions or table flags change.
+  /// - Scratch vectors are cleared, not freed, between calls,
+  ///   so their capacity is kept.
+  /// - Amortized: no grid-sized allocations after the first call.
+  ///   Small temporaries, such as coordinate arrays and
+  ///   grid facet vertex lists, are still allocated on each call.
+  class DUALISO_CONTEXT {
+
+  protected:
+    ISO_MERGE_DATA * merge_data;
+    std::vector<AXIS_SIZE_TYPE> merge_axis_size; ///< Axis sizes of merge_data.
+    IJKDUALTABLE::ISODUAL_CUBE_TABLE_AMBIG * isodual_table;
+    DUALISO_FACET_INTERSECTION_TABLE * facet_intersection_table;
+
+    void Init();
+    void FreeTables();
+
+  private:
+    // Context owns its tables. Copying is not allowed.
+    DUALISO_CONTEXT(const DUALISO_CONTEXT &);
+    const DUALISO_CONTEXT & operator = (const DUALISO_CONTEXT &);
+
+  public:
+    /// Isosurface polytope vertices before merging.
+    std::vector<VERTEX_INDEX> isopoly;
+
+    /// Location of each isosurface polytope vertex on the cube facets.
+    std::vector<FACET_VERTEX_INDEX> facet_vertex;
+
+    /// List of cubes containing isosurface vertices.
+    std::vector<VERTEX_INDEX> cube_list;
+
+    /// isopoly_cube[i] = location in cube_list of cube containing isopoly[i].
+    std::vector<ISO_VERTEX_INDEX> isopoly_cube;
+
+    /// Cube isosurface table information.
+    std::vector<GRID_CUBE_DATA> cube_isov_list;
+
+    /// List of dual isosurface vertices.
+    std::vector<DUAL_ISOVERT> iso_vlist;
+
+    /// Map from grid cube index to location in cube_isov_list.
+    /// Entries are overwritten, never reset.  Not cleared by ClearBuffers().
+    std::vector<ISO_VERTEX_INDEX> index_to_cube_list;
+
+    /// Block polytopes kept for incremental extraction.
+    /// Not cleared by ClearBuffers().
+    INCREMENTAL_EXTRACT_DATA incremental;
+
+    /// Cubes processed if DUALISO_DATA_FLAGS::ExtractActiveCubesFlag().
+    /// Set by the caller.  Not cleared by ClearBuffers().
+    std::vector<VERTEX_INDEX> active_cube;
+
+    /// Polytopes extracted in a single sweep for multiple isovalues.
+    /// Not cleared by ClearBuffers().
+    MULTI_ISOVALUE_EXTRACT_DATA multi_isovalue;
+
+  public:
+    DUALISO_CONTEXT() { Init(); };
+    ~DUALISO_CONTEXT() { FreeTables(); };
+
+    /// Return merge data for grid with given dimension and axis sizes.
+    /// Create merge data if it does not exist or has different axis sizes.
+    ISO_MERGE_DATA & MergeData
+      (const int dimension, const AXIS_SIZE_TYPE * axis_size);
+
+    /// Return isodual lookup table with given dimension and flag_separate_neg.
+    /// Create table if it does not exist or has different parameters.
+    /// Table always separates diagonally opposite vertices.
+    const IJKDUALTABLE::ISODUAL_CUBE_TABLE_AMBIG & IsodualTable
+      (const int dimension, const bool flag_separate_neg);
+
+    /// Return facet intersection table with given dimension.
+    /// Create table if it does not exist or has different dimension.
+    const DUALISO_FACET_INTERSECTION_TABLE & FacetIntersectionTable
+      (const int dimension);
+
+    /// Clear scratch buffers.  Capacity is kept.
+    void ClearBuffers();
+
+    /// Free tables and scratch buffer memory.
+    void Clear();
+  };
+
   // **************************************************
   // MESH VERTEX LIST
   // **************************************************
@@ -686,7 +1155,9 @@ namespace IJKDUAL {
   void DUAL_ISOSURFACE_BASE<ISOPOLY_INFO_TYPE>::Clear()
   {
     isopoly_vert.clear();
+    isopoly_info.clear();
     vertex_coord.clear();
+    cube_relative_coord.Clear();
     first_isov_on_grid_edge = 0;
   }
 
@@ -864,6 +1335,17 @@ namespace IJKDUAL {
       return(false);
     }
 
+    if (this->ROIFlag()) {
+      if (this->ExtractInBlocksFlag() || this->ExtractIncrementalFlag() ||
+          this->ExtractTwoPassFlag()) {
+        error.AddMessage
+          ("Region of interest cannot be combined with extraction in blocks,");
+        error.AddMessage
+          ("  incremental extraction or two pass extraction.");
+        return(false);
+      }
+    }
+
     return(true);
   }
 
@@ -24,11 +24,15 @@
 #ifndef _IJKDUAL_EXTRACT_TXX_
 #define _IJKDUAL_EXTRACT_TXX_
 
+#include <algorithm>
+#include <vector>
+
 #include "ijkgrid_macros.h"
 #include "ijkdualtable.h"
 #include "ijkdual_types.h"
 #include "ijkdual_datastruct.h"
 
+#include "ijkbits.txx"
 #include "ijkisopoly.txx"
 #include "ijkmerge.txx"
 #include "ijktime.txx"
@@ -36,6 +40,132 @@
 
 namespace IJKDUAL {
 
+  // ***************************************************
+  // COUNT ROUTINES
+  // ***************************************************
+
+  /// Apply f(iv_start, iv_end, edge_dir) to rows of interior grid edges.
+  /// - A row is the set of grid vertices with the same coordinates 
+  ///   in directions 1 to dimension-1.  Row irow starts at 
+  ///   vertex irow*grid.AxisSize(0).
+  /// - Visits rows irow_start to irow_end-1 in order.
+  /// - For each row and each edge direction edge_dir, f processes 
+  ///   the interior grid edges (iv, iv+grid.AxisIncrement(edge_dir))
+  ///   for iv in [iv_start,iv_end).  
+  /// - Grid edge ranges are processed in order of edge direction.
+  template <typename GTYPE, typename FTYPE>
+  void for_each_interior_grid_edge_row
+  (const GTYPE & grid, const VERTEX_INDEX irow_start, 
+   const VERTEX_INDEX irow_end, FTYPE & f)
+  {
+    typedef typename GTYPE::DIMENSION_TYPE DTYPE;
+    const DTYPE dimension = grid.Dimension();
+
+    if (dimension < 1 || irow_start >= irow_end) { return; }
+
+    const VERTEX_INDEX axis_size0 = grid.AxisSize(0);
+
+    // Coordinates of first vertex in row.  coord[0] is not used.
+    std::vector<long> coord(dimension, 0);
+    grid.ComputeCoord(irow_start*axis_size0, &(coord.front()));
+
+    for (VERTEX_INDEX irow = irow_start; irow < irow_end; irow++) {
+
+      const VERTEX_INDEX row_start = irow*axis_size0;
+
+      // An edge in direction edge_dir is interior if all its coordinates,
+      //   except the edge_dir coordinate, are not on the grid boundary.
+      DTYPE num_boundary = 0;
+      DTYPE boundary_dir = 0;
+      for (DTYPE d = 1; d < dimension; d++) {
+        if (coord[d] == 0 || coord[d]+1 == long(grid.AxisSize(d))) {
+          num_boundary++;
+          boundary_dir = d;
+        }
+      }
+
+      if (num_boundary == 0) {
+        f(row_start, row_start+axis_size0-1, 0);
+        for (DTYPE d = 1; d < dimension; d++) 
+          { f(row_start+1, row_start+axis_size0-1, d); }
+      }
+      else if (num_boundary == 1 && coord[boundary_dir] == 0 &&
+               grid.AxisSize(boundary_dir) > 1) {
+        // Only edges in direction boundary_dir are interior.
+        f(row_start+1, row_start+axis_size0-1, boundary_dir);
+      }
+
+      // Next row, lexicographic order.
+      for (DTYPE d = 1; d < dimension; d++) {
+        coord[d]++;
+        if (coord[d] < long(grid.AxisSize(d))) { break; }
+        coord[d] = 0;
+      }
+    }
+  }
+
+
+  /// Count bipolar edges (iv, iv+increment) for iv in [iv_start,iv_end).
+  template <typename STYPE, typename ISOTYPE>
+  inline VERTEX_INDEX count_bipolar_edges_in_row
+  (const STYPE * scalar, const ISOTYPE isovalue,
+   const VERTEX_INDEX iv_start, const VERTEX_INDEX iv_end,
+   const VERTEX_INDEX increment)
+  {
+    VERTEX_INDEX num_bipolar = 0;
+    for (VERTEX_INDEX iv = iv_start; iv < iv_end; iv++) {
+      const bool is_negative0 = (scalar[iv] < isovalue);
+      const bool is_negative1 = (scalar[iv+increment] < isovalue);
+      num_bipolar += VERTEX_INDEX(is_negative0 != is_negative1);
+    }
+    return(num_bipolar);
+  }
+
+
+  /// Count interior bipolar grid edges in rows irow_start to irow_end-1.
+  /// - See for_each_interior_grid_edge_row for the definition of rows.
+  template <typename GTYPE, typename STYPE>
+  VERTEX_INDEX count_interior_bipolar_edges_in_rows
+  (const GTYPE & scalar_grid, const STYPE isovalue,
+   const VERTEX_INDEX irow_start, const VERTEX_INDEX irow_end)
+  {
+    const auto * scalar = scalar_grid.ScalarPtrConst();
+    VERTEX_INDEX num_bipolar = 0;
+
+    auto count_in_row = 
+      [&](const VERTEX_INDEX iv_start, const VERTEX_INDEX iv_end,
+          const int edge_dir)
+      {
+        num_bipolar += count_bipolar_edges_in_row
+          (scalar, isovalue, iv_start, iv_end, 
+           scalar_grid.AxisIncrement(edge_dir));
+      };
+
+    for_each_interior_grid_edge_row
+      (scalar_grid, irow_start, irow_end, count_in_row);
+
+    return(num_bipolar);
+  }
+
+
+  /// Store number of interior bipolar edges in dualiso_info.
+  /// - Each interior bipolar grid edge is dual to one isosurface polytope,
+  ///   so the count is read off the polytopes extracted by the loop.
+  /// - The count is known only after extraction, so the single pass
+  ///   and block extraction routines do not reserve their output.
+  ///   Output vectors grow geometrically and keep their capacity
+  ///   when reused.  extract_dual_isopoly_two_pass counts bipolar
+  ///   edges per grid slab and preallocates its output exactly.
+  template <typename GTYPE>
+  void set_num_bipolar_edges
+  (const GTYPE & scalar_grid, const std::vector<VERTEX_INDEX> & iso_poly,
+   DUALISO_INFO & dualiso_info)
+  {
+    dualiso_info.scalar.num_bipolar_edges = 
+      iso_poly.size()/scalar_grid.NumFacetVertices();
+  }
+
+
   // ***************************************************
   // EXTRACT ROUTINES
   // ***************************************************
@@ -50,12 +180,12 @@ namespace IJKDUAL {
   template <typename GTYPE, typename STYPE>
   void extract_dual_isopoly
   (const GTYPE & scalar_grid, const STYPE isovalue, 
-   std::vector<ISO_VERTEX_INDEX> & iso_poly,
+   std::vector<VERTEX_INDEX> & iso_poly,
    DUALISO_INFO & dualiso_info)
   {
-    dualiso_info.time.extract = 0;
+    dualiso_info.time.extract.Clear();
 
-    clock_t t0 = clock();
+    IJK::SCOPED_TIMER timer(dualiso_info.time.extract);
 
     // initialize output
     iso_poly.clear();
@@ -68,8 +198,7 @@ namespace IJKDUAL {
         (scalar_grid, isovalue, iend0, edge_dir, iso_poly);
     }
 
-    clock_t t1 = clock();
-    IJK::clock2seconds(t1-t0, dualiso_info.time.extract);
+    set_num_bipolar_edges(scalar_grid, iso_poly, dualiso_info);
   }
 
   /// Extract isosurface polytopes
@@ -87,13 +216,13 @@ namespace IJKDUAL {
   template <typename GTYPE, typename STYPE, typename ETYPE>
   void extract_dual_isopoly
   (const GTYPE & scalar_grid, const STYPE isovalue, 
-   std::vector<ISO_VERTEX_INDEX> & iso_poly,
+   std::vector<VERTEX_INDEX> & iso_poly,
    std::vector<ETYPE> & dual_edge,
    DUALISO_INFO & dualiso_info)
   {
-    dualiso_info.time.extract = 0;
+    dualiso_info.time.extract.Clear();
 
-    clock_t t0 = clock();
+    IJK::SCOPED_TIMER timer(dualiso_info.time.extract);
 
     // initialize output
     iso_poly.clear();
@@ -105,8 +234,7 @@ namespace IJKDUAL {
         (scalar_grid, isovalue, iend0, edge_dir, iso_poly, dual_edge);
     }
 
-    clock_t t1 = clock();
-    IJK::clock2seconds(t1-t0, dualiso_info.time.extract);
+    set_num_bipolar_edges(scalar_grid, iso_poly, dualiso_info);
   }
 
   /// Extract isosurface polytopes
@@ -120,13 +248,13 @@ namespace IJKDUAL {
   template <typename GTYPE, typename STYPE>
   void extract_dual_isopoly
   (const GTYPE & scalar_grid, const STYPE isovalue, 
-   std::vector<ISO_VERTEX_INDEX> & iso_poly,
+   std::vector<VERTEX_INDEX> & iso_poly,
    std::vector<FACET_VERTEX_INDEX> & facet_vertex,
    DUALISO_INFO & dualiso_info)
   {
-    dualiso_info.time.extract = 0;
+    dualiso_info.time.extract.Clear();
 
-    clock_t t0 = clock();
+    IJK::SCOPED_TIMER timer(dualiso_info.time.extract);
 
     // initialize output
     iso_poly.clear();
@@ -140,8 +268,7 @@ namespace IJKDUAL {
         (scalar_grid, isovalue, iend0, edge_dir, iso_poly, facet_vertex);
     }
 
-    clock_t t1 = clock();
-    IJK::clock2seconds(t1-t0, dualiso_info.time.extract);
+    set_num_bipolar_edges(scalar_grid, iso_poly, dualiso_info);
   }
 
 
@@ -161,14 +288,14 @@ namespace IJKDUAL {
   template <typename GTYPE, typename STYPE, typename ETYPE>
   void extract_dual_isopoly
   (const GTYPE & scalar_grid,
-   const STYPE isovalue, std::vector<ISO_VERTEX_INDEX> & iso_poly,
+   const STYPE isovalue, std::vector<VERTEX_INDEX> & iso_poly,
    std::vector<FACET_VERTEX_INDEX> & facet_vertex,
    std::vector<ETYPE> & dual_edge,
    DUALISO_INFO & dualiso_info)
   {
-    dualiso_info.time.extract = 0;
+    dualiso_info.time.extract.Clear();
 
-    clock_t t0 = clock();
+    IJK::SCOPED_TIMER timer(dualiso_info.time.extract);
 
     // initialize output
     iso_poly.clear();
@@ -182,11 +309,1386 @@ namespace IJKDUAL {
          dual_edge);
     }
 
-    clock_t t1 = clock();
-    IJK::clock2seconds(t1-t0, dualiso_info.time.extract);
+    set_num_bipolar_edges(scalar_grid, iso_poly, dualiso_info);
+  }
+
+
+  // ***************************************************
+  // EXTRACT IN GRID BLOCKS
+  // ***************************************************
+
+  /// Compute coordinates of block ib in a grid of num_blocks[] blocks.
+  template <typename ITYPE, typename DTYPE>
+  void compute_block_coord
+  (const ITYPE ib, const DTYPE dimension, 
+   const std::vector<long> & num_blocks, std::vector<long> & bcoord)
+  {
+    ITYPE k = ib;
+    for (DTYPE d = 0; d < dimension; d++) {
+      bcoord[d] = k%num_blocks[d];
+      k = k/num_blocks[d];
+    }
+  }
+
+
+  /// Get lowest vertices of grid blocks, in Morton order.
+  /// - Blocks have block_length x ... x block_length vertices
+  ///   and cover all vertices with coordinates less than axis_size-1.
+  ///   Those are the lowest endpoints of all interior grid edges.
+  /// - Blocks are in Morton (Z-order) of block coordinates 
+  ///   if grid dimension is 3, and in lexicographic order otherwise.
+  template <typename GTYPE, typename LTYPE, typename VTYPE>
+  void get_grid_blocks_in_morton_order
+  (const GTYPE & grid, const LTYPE block_length, 
+   std::vector<VTYPE> & block_base)
+  {
+    typedef typename GTYPE::DIMENSION_TYPE DTYPE;
+    const DTYPE dimension = grid.Dimension();
+    const int DIM3(3);
+    IJK::PROCEDURE_ERROR error("get_grid_blocks_in_morton_order");
+
+    block_base.clear();
+
+    if (block_length < 1) {
+      error.AddMessage("Illegal block length ", block_length, ".");
+      error.AddMessage("  Block length must be positive.");
+      throw error;
+    }
+
+    std::vector<long> num_blocks(dimension);
+    long total_num_blocks = 1;
+    for (DTYPE d = 0; d < dimension; d++) {
+      if (grid.AxisSize(d) < 2) { return; }
+      num_blocks[d] = (grid.AxisSize(d)-2)/block_length + 1;
+      total_num_blocks *= num_blocks[d];
+    }
+
+    std::vector<long> block_order(total_num_blocks);
+    for (long i = 0; i < total_num_blocks; i++) 
+      { block_order[i] = i; }
+
+    std::vector<long> bcoord(dimension);
+
+    if (dimension == DIM3) {
+      long max_num_blocks = 
+        *std::max_element(num_blocks.begin(), num_blocks.end());
+      int num_bits = 0;
+      while ((long(1) << num_bits) < max_num_blocks) { num_bits++; }
+
+      std::vector<unsigned long long> morton_code(total_num_blocks);
+      for (long i = 0; i < total_num_blocks; i++) {
+        compute_block_coord(i, dimension, num_blocks, bcoord);
+        IJK::compute_morton_code_3D
+          (&(bcoord.front()), num_bits, morton_code[i]);
+      }
+
+      IJK::ARRAY_LESS_THAN<unsigned long long> 
+        morton_less_than(&(morton_code.front()));
+      std::sort(block_order.begin(), block_order.end(), morton_less_than);
+    }
+
+    block_base.resize(total_num_blocks);
+    for (long i = 0; i < total_num_blocks; i++) {
+      compute_block_coord(block_order[i], dimension, num_blocks, bcoord);
+      VTYPE iv = 0;
+      for (DTYPE d = 0; d < dimension; d++)
+        { iv += bcoord[d]*block_length*grid.AxisIncrement(d); }
+      block_base[i] = iv;
+    }
+  }
+
+
+  /// Apply f(iend0, edge_dir) to every interior grid edge
+  ///   whose lowest endpoint iend0 has coordinates coord
+  ///   with coord_min[d] <= coord[d] < coord_end[d].
+  /// - Requires coord_end[d] <= grid.AxisSize(d)-1.
+  /// - Edges are processed one row (parallel to axis 0) at a time.
+  template <typename GTYPE, typename FTYPE>
+  void for_each_interior_grid_edge_in_range
+  (const GTYPE & grid, const std::vector<long> & coord_min, 
+   const std::vector<long> & coord_end, FTYPE & f)
+  {
+    typedef typename GTYPE::DIMENSION_TYPE DTYPE;
+    typedef typename GTYPE::VERTEX_INDEX_TYPE VTYPE;
+    const DTYPE dimension = grid.Dimension();
+
+    if (dimension < 1) { return; }
+
+    std::vector<long> coord(dimension);
+    std::vector<bool> is_row_interior(dimension);
+
+    VTYPE row_start = 0;
+    for (DTYPE d = 0; d < dimension; d++) {
+      if (coord_min[d] >= coord_end[d]) { return; }
+      coord[d] = coord_min[d];
+      row_start += coord[d]*grid.AxisIncrement(d);
+    }
+
+    while (true) {
+
+      // Edge in direction edge_dir is interior if all endpoint
+      //   coordinates, except the edge_dir coordinate, are positive.
+      for (DTYPE edge_dir = 0; edge_dir < dimension; edge_dir++) {
+        is_row_interior[edge_dir] = true;
+        for (DTYPE d = 1; d < dimension; d++) {
+          if (d != edge_dir && coord[d] == 0) 
+            { is_row_interior[edge_dir] = false; }
+        }
+      }
+
+      VTYPE iend0 = row_start;
+      for (long x = coord_min[0]; x < coord_end[0]; x++) {
+        if (is_row_interior[0]) { f(iend0, 0); }
+        if (x > 0) {
+          for (DTYPE edge_dir = 1; edge_dir < dimension; edge_dir++) {
+            if (is_row_interior[edge_dir]) { f(iend0, edge_dir); }
+          }
+        }
+        iend0++;
+      }
+
+      // Next row in range, lexicographic order.
+      DTYPE d = 1;
+      while (d < dimension) {
+        coord[d]++;
+        row_start += grid.AxisIncrement(d);
+        if (coord[d] < coord_end[d]) { break; }
+        row_start -= (coord[d]-coord_min[d])*grid.AxisIncrement(d);
+        coord[d] = coord_min[d];
+        d++;
+      }
+      if (d >= dimension) { break; }
+    }
+  }
+
+
+  /// Apply f(iend0, edge_dir) to every interior grid edge
+  ///   whose lowest endpoint iend0 is in the block with lowest vertex iv0.
+  /// - Block contains block_length^dimension vertices,
+  ///   truncated at the upper grid boundary.
+  /// - Edges are processed one row (parallel to axis 0) at a time.
+  template <typename GTYPE, typename VTYPE, typename LTYPE, typename FTYPE>
+  void for_each_interior_grid_edge_in_block
+  (const GTYPE & grid, const VTYPE iv0, const LTYPE block_length, FTYPE & f)
+  {
+    typedef typename GTYPE::DIMENSION_TYPE DTYPE;
+    const DTYPE dimension = grid.Dimension();
+
+    if (dimension < 1) { return; }
+
+    std::vector<long> base_coord(dimension);
+    std::vector<long> coord_end(dimension);
+
+    grid.ComputeCoord(iv0, &(base_coord.front()));
+    for (DTYPE d = 0; d < dimension; d++) {
+      coord_end[d] = std::min(base_coord[d]+long(block_length), 
+                              long(grid.AxisSize(d))-1);
+    }
+
+    for_each_interior_grid_edge_in_range(grid, base_coord, coord_end, f);
+  }
+
+
+  /// Apply f(iend0, edge_dir) to every interior grid edge
+  ///   whose lowest endpoint iend0 is in box.
+  /// - Box is a box of grid vertices, truncated at the upper grid boundary.
+  /// - Edges are processed one row (parallel to axis 0) at a time.
+  template <typename GTYPE, typename BOX_TYPE, typename FTYPE>
+  void for_each_interior_grid_edge_in_box
+  (const GTYPE & grid, const BOX_TYPE & box, FTYPE & f)
+  {
+    typedef typename GTYPE::DIMENSION_TYPE DTYPE;
+    const DTYPE dimension = grid.Dimension();
+
+    if (dimension < 1) { return; }
+
+    std::vector<long> coord_min(dimension);
+    std::vector<long> coord_end(dimension);
+
+    for (DTYPE d = 0; d < dimension; d++) {
+      coord_min[d] = std::max(long(box.MinCoord(d)), 0L);
+      coord_end[d] = std::min(long(box.MaxCoord(d))+1, 
+                              long(grid.AxisSize(d))-1);
+    }
+
+    for_each_interior_grid_edge_in_range(grid, coord_min, coord_end, f);
+  }
+
+
+  /// Apply f(iend0, edge_dir) to every interior grid edge.
+  /// - Grid edges are processed block by block, with blocks in Morton order.
+  /// - Each block processes the edges in all directions whose
+  ///   lowest endpoint iend0 is in the block.
+  /// - Interior grid edges are grid edges not contained in the
+  ///   grid boundary.
+  template <typename GTYPE, typename LTYPE, typename FTYPE>
+  void for_each_interior_grid_edge_in_blocks
+  (const GTYPE & grid, const LTYPE block_length, FTYPE & f)
+  {
+    typedef typename GTYPE::VERTEX_INDEX_TYPE VTYPE;
+
+    if (grid.Dimension() < 1) { return; }
+
+    std::vector<VTYPE> block_base;
+    get_grid_blocks_in_morton_order(grid, block_length, block_base);
+
+    for (std::size_t ib = 0; ib < block_base.size(); ib++) {
+      for_each_interior_grid_edge_in_block
+        (grid, block_base[ib], block_length, f);
+    }
+  }
+
+
+  /// Extract isosurface polytopes, processing the grid in blocks.
+  /// - Same isosurface polytopes as extract_dual_isopoly,
+  ///   but polytopes are ordered by grid blocks in Morton order.
+  /// - Polytopes from a block are consecutive, so isosurface vertices
+  ///   shared by those polytopes are spatially coherent.
+  /// @param block_length Grid blocks have block_length^dimension vertices.
+  /// @param[out] dual_edge[] = Array of dual edges.
+  ///   - dual_edge[i] is the grid edge dual to polytope i.
+  template <typename GTYPE, typename STYPE, typename LTYPE, typename ETYPE>
+  void extract_dual_isopoly_in_blocks
+  (const GTYPE & scalar_grid, const STYPE isovalue, 
+   const LTYPE block_length,
+   std::vector<VERTEX_INDEX> & iso_poly,
+   std::vector<ETYPE> & dual_edge,
+   DUALISO_INFO & dualiso_info)
+  {
+    dualiso_info.time.extract.Clear();
+
+    IJK::SCOPED_TIMER timer(dualiso_info.time.extract);
+
+    // initialize output
+    iso_poly.clear();
+
+    if (scalar_grid.NumCubeVertices() < 1) { return; }
+
+    auto extract_around_edge = 
+      [&](const VERTEX_INDEX iend0, const int edge_dir)
+      {
+        extract_dual_isopoly_around_bipolar_edge_E
+          (scalar_grid, isovalue, iend0, edge_dir, iso_poly, dual_edge);
+      };
+
+    for_each_interior_grid_edge_in_blocks
+      (scalar_grid, block_length, extract_around_edge);
+
+    set_num_bipolar_edges(scalar_grid, iso_poly, dualiso_info);
+  }
+
+
+  /// Extract isosurface polytopes, processing the grid in blocks.
+  /// - Version returning facet_vertex[].
+  /// @param facet_vertex[i] = Edge of cube containing iso_poly[i].
+  template <typename GTYPE, typename STYPE, typename LTYPE, typename ETYPE>
+  void extract_dual_isopoly_in_blocks
+  (const GTYPE & scalar_grid, const STYPE isovalue, 
+   const LTYPE block_length,
+   std::vector<VERTEX_INDEX> & iso_poly,
+   std::vector<FACET_VERTEX_INDEX> & facet_vertex,
+   std::vector<ETYPE> & dual_edge,
+   DUALISO_INFO & dualiso_info)
+  {
+    dualiso_info.time.extract.Clear();
+
+    IJK::SCOPED_TIMER timer(dualiso_info.time.extract);
+
+    // initialize output
+    iso_poly.clear();
+    facet_vertex.clear();
+
+    if (scalar_grid.NumCubeVertices() < 1) { return; }
+
+    auto extract_around_edge = 
+      [&](const VERTEX_INDEX iend0, const int edge_dir)
+      {
+        extract_dual_isopoly_around_bipolar_edge_E
+          (scalar_grid, isovalue, iend0, edge_dir, iso_poly, facet_vertex,
+           dual_edge);
+      };
+
+    for_each_interior_grid_edge_in_blocks
+      (scalar_grid, block_length, extract_around_edge);
+
+    set_num_bipolar_edges(scalar_grid, iso_poly, dualiso_info);
+  }
+
+
+
+  // ***************************************************
+  // EXTRACT IN TWO PASSES
+  // ***************************************************
+
+  /// Get number of grid slabs and number of rows per slab.
+  /// - A grid slab is the set of grid rows with the same 
+  ///   coordinate in direction dimension-1.
+  /// - See for_each_interior_grid_edge_row for the definition of rows.
+  template <typename GTYPE>
+  void get_grid_slabs
+  (const GTYPE & grid, VERTEX_INDEX & num_slabs, 
+   VERTEX_INDEX & num_rows_per_slab)
+  {
+    const int dimension = grid.Dimension();
+
+    num_slabs = 0;
+    num_rows_per_slab = 0;
+    if (dimension < 1 || grid.NumVertices() < 1) { return; }
+
+    const VERTEX_INDEX num_rows = grid.NumVertices()/grid.AxisSize(0);
+    if (dimension == 1) { num_slabs = 1; }
+    else { num_slabs = grid.AxisSize(dimension-1); }
+    num_rows_per_slab = num_rows/num_slabs;
+  }
+
+
+  /// Extract isosurface polytopes in two passes.
+  /// - First pass counts the bipolar edges in each grid slab.
+  ///   Second pass writes the isosurface polytopes of each slab
+  ///   at offsets given by prefix sums of the counts.
+  /// - Output arrays are allocated once, with their exact size.
+  /// - Both passes process slabs in parallel, if OpenMP is enabled.
+  ///   Output is identical for any number of threads.
+  /// - Polytopes are ordered by grid row and, within each row, 
+  ///   by edge direction.
+  /// @param[out] facet_vertex If not NULL, set (*facet_vertex)[i] 
+  ///   to the edge of the cube containing iso_poly[i].
+  /// @param[out] dual_edge[] Array of dual edges.
+  ///   - dual_edge[i] is the grid edge dual to polytope i.
+  template <typename GTYPE, typename STYPE, typename ETYPE>
+  void extract_dual_isopoly_two_pass_F
+  (const GTYPE & scalar_grid, const STYPE isovalue, 
+   std::vector<VERTEX_INDEX> & iso_poly,
+   std::vector<FACET_VERTEX_INDEX> * facet_vertex,
+   std::vector<ETYPE> & dual_edge,
+   DUALISO_INFO & dualiso_info)
+  {
+    const VERTEX_INDEX num_facet_vertices = scalar_grid.NumFacetVertices();
+    const auto * scalar = scalar_grid.ScalarPtrConst();
+    VERTEX_INDEX num_slabs, num_rows_per_slab;
+
+    dualiso_info.time.extract.Clear();
+
+    IJK::SCOPED_TIMER timer(dualiso_info.time.extract);
+
+    // initialize output
+    iso_poly.clear();
+    if (facet_vertex != NULL) { facet_vertex->clear(); }
+    dual_edge.clear();
+
+    if (scalar_grid.NumCubeVertices() < 1) { return; }
+
+    get_grid_slabs(scalar_grid, num_slabs, num_rows_per_slab);
+
+    // First pass.  Count bipolar edges in each slab.
+    std::vector<VERTEX_INDEX> slab_offset(num_slabs+1, 0);
+
+#pragma omp parallel
+    {
+      IJK::SCOPED_THREAD_TIMER thread_timer(&dualiso_info.time.extract);
+
+#pragma omp for schedule(dynamic)
+      for (long islab = 0; islab < long(num_slabs); islab++) {
+        const VERTEX_INDEX irow_start = islab*num_rows_per_slab;
+        slab_offset[islab+1] = count_interior_bipolar_edges_in_rows
+          (scalar_grid, isovalue, irow_start, irow_start+num_rows_per_slab);
+      }
+    }
+
+    for (VERTEX_INDEX islab = 0; islab < num_slabs; islab++)
+      { slab_offset[islab+1] += slab_offset[islab]; }
+
+    const VERTEX_INDEX num_bipolar_edges = slab_offset[num_slabs];
+    dualiso_info.scalar.num_bipolar_edges = num_bipolar_edges;
+
+    iso_poly.resize(num_bipolar_edges*num_facet_vertices);
+    if (facet_vertex != NULL) 
+      { facet_vertex->resize(num_bipolar_edges*num_facet_vertices); }
+    dual_edge.resize(num_bipolar_edges);
+
+    // Second pass.  Write isosurface polytopes of each slab.
+#pragma omp parallel
+    {
+      IJK::SCOPED_THREAD_TIMER thread_timer(&dualiso_info.time.extract);
+
+#pragma omp for schedule(dynamic)
+      for (long islab = 0; islab < long(num_slabs); islab++) {
+
+        const VERTEX_INDEX irow_start = islab*num_rows_per_slab;
+        VERTEX_INDEX ipoly = slab_offset[islab];
+
+        auto extract_in_row = 
+          [&](const VERTEX_INDEX iv_start, const VERTEX_INDEX iv_end,
+              const int edge_dir)
+          {
+            const VERTEX_INDEX increment = scalar_grid.AxisIncrement(edge_dir);
+            for (VERTEX_INDEX iend0 = iv_start; iend0 < iv_end; iend0++) {
+              const VERTEX_INDEX iend1 = iend0 + increment;
+              const bool is_end0_negative = (scalar[iend0] < isovalue);
+              const bool is_end1_negative = (scalar[iend1] < isovalue);
+
+              if (is_end0_negative == is_end1_negative) { continue; }
+
+              FACET_VERTEX_INDEX * facet_vertex_ptr = NULL;
+              if (facet_vertex != NULL) 
+                { facet_vertex_ptr = 
+                    &((*facet_vertex)[ipoly*num_facet_vertices]); }
+
+              // Reverse orientation if iend0 is positive.
+              IJK::set_dual_isopoly_around_edge
+                (scalar_grid, iend0, edge_dir, !is_end0_negative,
+                 &(iso_poly[ipoly*num_facet_vertices]), facet_vertex_ptr);
+              dual_edge[ipoly].Set(iend0, iend1, edge_dir);
+              ipoly++;
+            }
+          };
+
+        for_each_interior_grid_edge_row
+          (scalar_grid, irow_start, irow_start+num_rows_per_slab, 
+           extract_in_row);
+      }
+    }
+  }
+
+
+  /// Extract isosurface polytopes in two passes.
+  /// - See extract_dual_isopoly_two_pass_F.
+  template <typename GTYPE, typename STYPE, typename ETYPE>
+  void extract_dual_isopoly_two_pass
+  (const GTYPE & scalar_grid, const STYPE isovalue, 
+   std::vector<VERTEX_INDEX> & iso_poly,
+   std::vector<ETYPE> & dual_edge,
+   DUALISO_INFO & dualiso_info)
+  {
+    extract_dual_isopoly_two_pass_F
+      (scalar_grid, isovalue, iso_poly, 
+       (std::vector<FACET_VERTEX_INDEX> *) NULL, dual_edge, dualiso_info);
+  }
+
+
+  /// Extract isosurface polytopes in two passes.
+  /// - Version returning facet_vertex[].
+  /// - See extract_dual_isopoly_two_pass_F.
+  /// @param facet_vertex[i] = Edge of cube containing iso_poly[i].
+  template <typename GTYPE, typename STYPE, typename ETYPE>
+  void extract_dual_isopoly_two_pass
+  (const GTYPE & scalar_grid, const STYPE isovalue, 
+   std::vector<VERTEX_INDEX> & iso_poly,
+   std::vector<FACET_VERTEX_INDEX> & facet_vertex,
+   std::vector<ETYPE> & dual_edge,
+   DUALISO_INFO & dualiso_info)
+  {
+    extract_dual_isopoly_two_pass_F
+      (scalar_grid, isovalue, iso_poly, &facet_vertex, dual_edge, 
+       dualiso_info);
+  }
+
+
+  // ***************************************************
+  // EXTRACT INCREMENTALLY
+  // ***************************************************
+
+  /// Compute packed signs of the vertices of the block with lowest vertex iv0.
+  /// - Includes vertices on the upper block boundary, so the signs
+  ///   determine the polytopes dual to the edges processed by
+  ///   for_each_interior_grid_edge_in_block.
+  /// - Bit k is 1 if the k'th block vertex, in lexicographic order,
+  ///   has scalar value less than isovalue.
+  template <typename GTYPE, typename STYPE, typename VTYPE, typename LTYPE>
+  void compute_block_sign_bits
+  (const GTYPE & scalar_grid, const STYPE isovalue, const VTYPE iv0,
+   const LTYPE block_length, std::vector<unsigned long long> & sign_bits)
+  {
+    typedef typename GTYPE::DIMENSION_TYPE DTYPE;
+    const DTYPE dimension = scalar_grid.Dimension();
+    const auto * scalar = scalar_grid.ScalarPtrConst();
+    const int NUM_BITS = 64;
+
+    sign_bits.clear();
+    if (dimension < 1) { return; }
+
+    std::vector<long> base_coord(dimension);
+    std::vector<long> coord(dimension);
+    std::vector<long> coord_end(dimension);
+
+    scalar_grid.ComputeCoord(iv0, &(base_coord.front()));
+    for (DTYPE d = 0; d < dimension; d++) {
+      coord[d] = base_coord[d];
+      coord_end[d] = std::min(base_coord[d]+long(block_length)+1, 
+                              long(scalar_grid.AxisSize(d)));
+    }
+
+    unsigned long long bits = 0;
+    int num_bits = 0;
+    VTYPE row_start = iv0;
+    while (true) {
+
+      const VTYPE row_end = row_start + (coord_end[0]-base_coord[0]);
+      for (VTYPE iv = row_start; iv < row_end; iv++) {
+        if (scalar[iv] < isovalue) 
+          { bits |= ((unsigned long long)(1) << num_bits); }
+        num_bits++;
+        if (num_bits == NUM_BITS) {
+          sign_bits.push_back(bits);
+          bits = 0;
+          num_bits = 0;
+        }
+      }
+
+      // Next row in block, lexicographic order.
+      DTYPE d = 1;
+      while (d < dimension) {
+        coord[d]++;
+        row_start += scalar_grid.AxisIncrement(d);
+        if (coord[d] < coord_end[d]) { break; }
+        row_start -= (coord[d]-base_coord[d])*scalar_grid.AxisIncrement(d);
+        coord[d] = base_coord[d];
+        d++;
+      }
+      if (d >= dimension) { break; }
+    }
+
+    if (num_bits > 0) { sign_bits.push_back(bits); }
   }
 
 
+  /// Extract isosurface polytopes incrementally, processing the grid 
+  ///   in blocks.
+  /// - Same isosurface polytopes, in the same order,
+  ///   as extract_dual_isopoly_in_blocks.
+  /// - Blocks with scalar values all below isovalue or all at or above
+  ///   isovalue have no bipolar edges.  They are found from the block
+  ///   min and max and are not visited.
+  /// - Other blocks reuse the polytopes stored in incremental_data
+  ///   if the signs of the block vertices are unchanged since
+  ///   the previous call.  Otherwise, the block is extracted
+  ///   and its polytopes are stored.
+  /// - Stored polytopes are discarded if the grid axis sizes, isovalue
+  ///   or block_length change.
+  /// - Blocks are processed in parallel, if OpenMP is enabled.
+  /// @param[out] facet_vertex If not NULL, set (*facet_vertex)[i] 
+  ///   to the edge of the cube containing iso_poly[i].
+  /// @param[out] dual_edge[] Array of dual edges.
+  ///   - dual_edge[i] is the grid edge dual to polytope i.
+  template <typename GTYPE, typename STYPE, typename LTYPE>
+  void extract_dual_isopoly_incremental_F
+  (const GTYPE & scalar_grid, const STYPE isovalue, 
+   const LTYPE block_length,
+   std::vector<VERTEX_INDEX> & iso_poly,
+   std::vector<FACET_VERTEX_INDEX> * facet_vertex,
+   std::vector<GRID_EDGE_TYPE> & dual_edge,
+   INCREMENTAL_EXTRACT_DATA & incremental_data,
+   DUALISO_INFO & dualiso_info)
+  {
+    const VERTEX_INDEX num_facet_vertices = scalar_grid.NumFacetVertices();
+    const bool flag_facet_vertex = (facet_vertex != NULL);
+
+    dualiso_info.time.extract.Clear();
+
+    IJK::SCOPED_TIMER timer(dualiso_info.time.extract);
+
+    // initialize output
+    iso_poly.clear();
+    if (facet_vertex != NULL) { facet_vertex->clear(); }
+    dual_edge.clear();
+
+    if (scalar_grid.NumCubeVertices() < 1) { return; }
+
+    if (!incremental_data.Matches
+        (scalar_grid, isovalue, block_length, flag_facet_vertex)) {
+      incremental_data.Reset
+        (scalar_grid, isovalue, block_length, flag_facet_vertex);
+    }
+
+    DUALISO_MINMAX_REGIONS & block_minmax = incremental_data.block_minmax;
+    block_minmax.ComputeMinMax(scalar_grid, block_length);
+
+    long num_inactive = 0;
+    long num_reused = 0;
+    long num_extracted = 0;
+
+#pragma omp parallel reduction(+:num_inactive,num_reused,num_extracted)
+    {
+      IJK::SCOPED_THREAD_TIMER thread_timer(&dualiso_info.time.extract);
+
+#pragma omp for schedule(dynamic)
+      for (long ib = 0; ib < long(incremental_data.block.size()); ib++) {
+
+        EXTRACT_BLOCK_DATA & block = incremental_data.block[ib];
+        const VERTEX_INDEX iregion = incremental_data.block_region[ib];
+
+        if (block_minmax.Max(iregion) < isovalue ||
+            block_minmax.Min(iregion) >= isovalue) {
+          // No bipolar edges.
+          block.Clear();
+          num_inactive++;
+          continue;
+        }
+
+        std::vector<unsigned long long> sign_bits;
+        compute_block_sign_bits
+          (scalar_grid, isovalue, incremental_data.block_base[ib],
+           block_length, sign_bits);
+
+        if (block.is_set && sign_bits == block.sign_bits) {
+          num_reused++;
+          continue;
+        }
+
+        block.Clear();
+        block.sign_bits.swap(sign_bits);
+
+        auto extract_around_edge = 
+          [&](const VERTEX_INDEX iend0, const int edge_dir)
+          {
+            if (flag_facet_vertex) {
+              extract_dual_isopoly_around_bipolar_edge_E
+                (scalar_grid, isovalue, iend0, edge_dir, block.isopoly, 
+                 block.facet_vertex, block.dual_edge);
+            }
+            else {
+              extract_dual_isopoly_around_bipolar_edge_E
+                (scalar_grid, isovalue, iend0, edge_dir, block.isopoly, 
+                 block.dual_edge);
+            }
+          };
+
+        for_each_interior_grid_edge_in_block
+          (scalar_grid, incremental_data.block_base[ib], block_length,
+           extract_around_edge);
+
+        block.is_set = true;
+        num_extracted++;
+      }
+    }
+
+    incremental_data.num_inactive_blocks = num_inactive;
+    incremental_data.num_reused_blocks = num_reused;
+    incremental_data.num_extracted_blocks = num_extracted;
+
+    // Concatenate block polytopes in Morton order.
+    VERTEX_INDEX num_bipolar_edges = 0;
+    for (std::size_t ib = 0; ib < incremental_data.block.size(); ib++) 
+      { num_bipolar_edges += incremental_data.block[ib].dual_edge.size(); }
+    dualiso_info.scalar.num_bipolar_edges = num_bipolar_edges;
+
+    iso_poly.reserve(num_bipolar_edges*num_facet_vertices);
+    if (facet_vertex != NULL) 
+      { facet_vertex->reserve(num_bipolar_edges*num_facet_vertices); }
+    dual_edge.reserve(num_bipolar_edges);
+
+    for (std::size_t ib = 0; ib < incremental_data.block.size(); ib++) {
+      const EXTRACT_BLOCK_DATA & block = incremental_data.block[ib];
+      iso_poly.insert
+        (iso_poly.end(), block.isopoly.begin(), block.isopoly.end());
+      if (facet_vertex != NULL) {
+        facet_vertex->insert
+          (facet_vertex->end(), block.facet_vertex.begin(), 
+           block.facet_vertex.end());
+      }
+      dual_edge.insert
+        (dual_edge.end(), block.dual_edge.begin(), block.dual_edge.end());
+    }
+  }
+
+
+  /// Extract isosurface polytopes incrementally.
+  /// - See extract_dual_isopoly_incremental_F.
+  template <typename GTYPE, typename STYPE, typename LTYPE>
+  void extract_dual_isopoly_incremental
+  (const GTYPE & scalar_grid, const STYPE isovalue, 
+   const LTYPE block_length,
+   std::vector<VERTEX_INDEX> & iso_poly,
+   std::vector<GRID_EDGE_TYPE> & dual_edge,
+   INCREMENTAL_EXTRACT_DATA & incremental_data,
+   DUALISO_INFO & dualiso_info)
+  {
+    extract_dual_isopoly_incremental_F
+      (scalar_grid, isovalue, block_length, iso_poly, 
+       (std::vector<FACET_VERTEX_INDEX> *) NULL, dual_edge, 
+       incremental_data, dualiso_info);
+  }
+
+
+  /// Extract isosurface polytopes incrementally.
+  /// - Version returning facet_vertex[].
+  /// - See extract_dual_isopoly_incremental_F.
+  /// @param facet_vertex[i] = Edge of cube containing iso_poly[i].
+  template <typename GTYPE, typename STYPE, typename LTYPE>
+  void extract_dual_isopoly_incremental
+  (const GTYPE & scalar_grid, const STYPE isovalue, 
+   const LTYPE block_length,
+   std::vector<VERTEX_INDEX> & iso_poly,
+   std::vector<FACET_VERTEX_INDEX> & facet_vertex,
+   std::vector<GRID_EDGE_TYPE> & dual_edge,
+   INCREMENTAL_EXTRACT_DATA & incremental_data,
+   DUALISO_INFO & dualiso_info)
+  {
+    extract_dual_isopoly_incremental_F
+      (scalar_grid, isovalue, block_length, iso_poly, &facet_vertex, 
+       dual_edge, incremental_data, dualiso_info);
+  }
+
+
+  // ***************************************************
+  // EXTRACT IN REGION OF INTEREST
+  // ***************************************************
+
+  /// Return true if roi is a box of grid vertices contained in grid
+  ///   and roi contains at least one grid cube.
+  template <typename GTYPE, typename BOX_TYPE>
+  bool check_roi
+  (const GTYPE & grid, const BOX_TYPE & roi, IJK::ERROR & error)
+  {
+    typedef typename GTYPE::DIMENSION_TYPE DTYPE;
+
+    if (roi.Dimension() != grid.Dimension()) {
+      error.AddMessage
+        ("Region of interest dimension ", roi.Dimension(),
+         " does not match grid dimension ", grid.Dimension(), ".");
+      return(false);
+    }
+
+    for (DTYPE d = 0; d < grid.Dimension(); d++) {
+      if (long(roi.MinCoord(d)) < 0 || 
+          long(roi.MaxCoord(d)) >= long(grid.AxisSize(d))) {
+        error.AddMessage
+          ("Region of interest coordinate ", d, " range [", 
+           roi.MinCoord(d), ",", roi.MaxCoord(d), 
+           "] is not contained in grid range [0,", 
+           grid.AxisSize(d)-1, "].");
+        return(false);
+      }
+
+      if (roi.MinCoord(d) >= roi.MaxCoord(d)) {
+        error.AddMessage
+          ("Region of interest minimum coordinate ", d, 
+           " must be less than maximum coordinate ", d, ".");
+        return(false);
+      }
+    }
+
+    return(true);
+  }
+
+
+  /// Apply f(iend0, edge_dir) to every grid edge whose incident
+  ///   grid cubes all lie in region of interest roi.
+  /// - Region roi is a box of grid vertices.
+  /// - Edge in direction edge_dir has lowest endpoint coordinate edge_dir
+  ///   in [MinCoord(edge_dir), MaxCoord(edge_dir)-1] and all other
+  ///   lowest endpoint coordinates d in [MinCoord(d)+1, MaxCoord(d)-1].
+  /// - Edges are processed one row (parallel to axis 0) at a time.
+  ///   Grid vertices outside roi are not visited.
+  /// - Requires roi to be contained in grid.  (See check_roi.)
+  template <typename GTYPE, typename BOX_TYPE, typename FTYPE>
+  void for_each_grid_edge_in_roi
+  (const GTYPE & grid, const BOX_TYPE & roi, FTYPE & f)
+  {
+    typedef typename GTYPE::DIMENSION_TYPE DTYPE;
+    typedef typename GTYPE::VERTEX_INDEX_TYPE VTYPE;
+    const DTYPE dimension = grid.Dimension();
+
+    if (dimension < 1) { return; }
+
+    std::vector<long> coord(dimension);
+    std::vector<bool> is_row_in_roi(dimension);
+
+    VTYPE row_start = 0;
+    for (DTYPE d = 0; d < dimension; d++) {
+      if (roi.MinCoord(d) >= roi.MaxCoord(d)) { return; }
+      coord[d] = roi.MinCoord(d);
+      row_start += coord[d]*grid.AxisIncrement(d);
+    }
+
+    const long x0 = roi.MinCoord(0);
+    const long x1 = roi.MaxCoord(0);
+
+    while (true) {
+
+      for (DTYPE edge_dir = 0; edge_dir < dimension; edge_dir++) {
+        is_row_in_roi[edge_dir] = true;
+        for (DTYPE d = 1; d < dimension; d++) {
+          if (d == edge_dir) {
+            if (coord[d] >= long(roi.MaxCoord(d)))
+              { is_row_in_roi[edge_dir] = false; }
+          }
+          else if (coord[d] <= long(roi.MinCoord(d)) ||
+                   coord[d] >= long(roi.MaxCoord(d))) {
+            is_row_in_roi[edge_dir] = false;
+          }
+        }
+      }
+
+      VTYPE iend0 = row_start;
+      for (long x = x0; x < x1; x++) {
+        if (is_row_in_roi[0]) { f(iend0, 0); }
+        if (x > x0) {
+          for (DTYPE edge_dir = 1; edge_dir < dimension; edge_dir++) {
+            if (is_row_in_roi[edge_dir]) { f(iend0, edge_dir); }
+          }
+        }
+        iend0++;
+      }
+
+      // Next row in roi, lexicographic order.
+      DTYPE d = 1;
+      while (d < dimension) {
+        coord[d]++;
+        row_start += grid.AxisIncrement(d);
+        if (coord[d] <= long(roi.MaxCoord(d))) { break; }
+        row_start -= (coord[d]-roi.MinCoord(d))*grid.AxisIncrement(d);
+        coord[d] = roi.MinCoord(d);
+        d++;
+      }
+      if (d >= dimension) { break; }
+    }
+  }
+
+
+  /// Extract isosurface polytopes in region of interest roi.
+  /// - Extracts the polytopes of extract_dual_isopoly which are dual
+  ///   to grid edges whose incident grid cubes all lie in roi.
+  /// - Isosurface vertices are identified by cube indices
+  ///   of the full grid, so the grid is not copied.
+  /// - Sets dualiso_info.scalar.num_bipolar_edges to the number
+  ///   of bipolar edges processed, i.e., the number of polytopes.
+  /// @param facet_vertex If NULL, facet vertices are not returned.
+  ///   Otherwise, (*facet_vertex)[i] = Edge of cube containing iso_poly[i].
+  /// @param[out] dual_edge[] = Array of dual edges.
+  ///   - dual_edge[i] is the grid edge dual to polytope i.
+  template <typename GTYPE, typename STYPE, typename BOX_TYPE, typename ETYPE>
+  void extract_dual_isopoly_in_roi_F
+  (const GTYPE & scalar_grid, const STYPE isovalue, const BOX_TYPE & roi,
+   std::vector<VERTEX_INDEX> & iso_poly,
+   std::vector<FACET_VERTEX_INDEX> * facet_vertex,
+   std::vector<ETYPE> & dual_edge,
+   DUALISO_INFO & dualiso_info)
+  {
+    IJK::PROCEDURE_ERROR error("extract_dual_isopoly_in_roi");
+
+    dualiso_info.time.extract.Clear();
+
+    IJK::SCOPED_TIMER timer(dualiso_info.time.extract);
+
+    // initialize output
+    iso_poly.clear();
+    if (facet_vertex != NULL) { facet_vertex->clear(); }
+    dual_edge.clear();
+    dualiso_info.scalar.num_bipolar_edges = 0;
+
+    if (scalar_grid.NumCubeVertices() < 1) { return; }
+
+    if (!check_roi(scalar_grid, roi, error)) { throw error; }
+
+    if (facet_vertex == NULL) {
+      auto extract_around_edge = 
+        [&](const VERTEX_INDEX iend0, const int edge_dir)
+        {
+          extract_dual_isopoly_around_bipolar_edge_E
+            (scalar_grid, isovalue, iend0, edge_dir, iso_poly, dual_edge);
+        };
+
+      for_each_grid_edge_in_roi(scalar_grid, roi, extract_around_edge);
+    }
+    else {
+      auto extract_around_edge = 
+        [&](const VERTEX_INDEX iend0, const int edge_dir)
+        {
+          extract_dual_isopoly_around_bipolar_edge_E
+            (scalar_grid, isovalue, iend0, edge_dir, iso_poly, 
+             *facet_vertex, dual_edge);
+        };
+
+      for_each_grid_edge_in_roi(scalar_grid, roi, extract_around_edge);
+    }
+
+    dualiso_info.scalar.num_bipolar_edges = dual_edge.size();
+  }
+
+
+  /// Extract isosurface polytopes in region of interest roi.
+  /// - See extract_dual_isopoly_in_roi_F.
+  template <typename GTYPE, typename STYPE, typename BOX_TYPE, typename ETYPE>
+  void extract_dual_isopoly_in_roi
+  (const GTYPE & scalar_grid, const STYPE isovalue, const BOX_TYPE & roi,
+   std::vector<VERTEX_INDEX> & iso_poly,
+   std::vector<ETYPE> & dual_edge,
+   DUALISO_INFO & dualiso_info)
+  {
+    extract_dual_isopoly_in_roi_F
+      (scalar_grid, isovalue, roi, iso_poly, 
+       (std::vector<FACET_VERTEX_INDEX> *) NULL, dual_edge, dualiso_info);
+  }
+
+
+  /// Extract isosurface polytopes in region of interest roi.
+  /// - Version returning facet_vertex[].
+  /// - See extract_dual_isopoly_in_roi_F.
+  /// @param facet_vertex[i] = Edge of cube containing iso_poly[i].
+  template <typename GTYPE, typename STYPE, typename BOX_TYPE, typename ETYPE>
+  void extract_dual_isopoly_in_roi
+  (const GTYPE & scalar_grid, const STYPE isovalue, const BOX_TYPE & roi,
+   std::vector<VERTEX_INDEX> & iso_poly,
+   std::vector<FACET_VERTEX_INDEX> & facet_vertex,
+   std::vector<ETYPE> & dual_edge,
+   DUALISO_INFO & dualiso_info)
+  {
+    extract_dual_isopoly_in_roi_F
+      (scalar_grid, isovalue, roi, iso_poly, &facet_vertex, dual_edge, 
+       dualiso_info);
+  }
+
+
+  // ***************************************************
+  // EXTRACT IN BRICK
+  // ***************************************************
+
+  /// Extract isosurface polytopes dual to interior grid edges 
+  ///   whose lowest endpoint is in owned_box.
+  /// - Grid is one brick of a decomposed grid.  Bricks own disjoint
+  ///   boxes of grid vertices and include a one vertex ghost layer
+  ///   around the owned box.  Each grid edge of the full grid 
+  ///   is processed by exactly one brick.
+  /// - Sets dualiso_info.scalar.num_bipolar_edges to the number
+  ///   of bipolar edges processed, i.e., the number of polytopes.
+  /// @param facet_vertex If NULL, facet vertices are not returned.
+  ///   Otherwise, (*facet_vertex)[i] = Edge of cube containing iso_poly[i].
+  /// @param[out] dual_edge[] = Array of dual edges.
+  ///   - dual_edge[i] is the grid edge dual to polytope i.
+  template <typename GTYPE, typename STYPE, typename BOX_TYPE, typename ETYPE>
+  void extract_dual_isopoly_in_brick_F
+  (const GTYPE & scalar_grid, const STYPE isovalue, 
+   const BOX_TYPE & owned_box,
+   std::vector<VERTEX_INDEX> & iso_poly,
+   std::vector<FACET_VERTEX_INDEX> * facet_vertex,
+   std::vector<ETYPE> & dual_edge,
+   DUALISO_INFO & dualiso_info)
+  {
+    IJK::PROCEDURE_ERROR error("extract_dual_isopoly_in_brick");
+
+    dualiso_info.time.extract.Clear();
+
+    IJK::SCOPED_TIMER timer(dualiso_info.time.extract);
+
+    // initialize output
+    iso_poly.clear();
+    if (facet_vertex != NULL) { facet_vertex->clear(); }
+    dual_edge.clear();
+    dualiso_info.scalar.num_bipolar_edges = 0;
+
+    if (scalar_grid.NumCubeVertices() < 1) { return; }
+
+    if (owned_box.Dimension() != scalar_grid.Dimension()) {
+      error.AddMessage
+        ("Owned box dimension ", owned_box.Dimension(),
+         " does not match grid dimension ", scalar_grid.Dimension(), ".");
+      throw error;
+    }
+
+    if (facet_vertex == NULL) {
+      auto extract_around_edge = 
+        [&](const VERTEX_INDEX iend0, const int edge_dir)
+        {
+          extract_dual_isopoly_around_bipolar_edge_E
+            (scalar_grid, isovalue, iend0, edge_dir, iso_poly, dual_edge);
+        };
+
+      for_each_interior_grid_edge_in_box
+        (scalar_grid, owned_box, extract_around_edge);
+    }
+    else {
+      auto extract_around_edge = 
+        [&](const VERTEX_INDEX iend0, const int edge_dir)
+        {
+          extract_dual_isopoly_around_bipolar_edge_E
+            (scalar_grid, isovalue, iend0, edge_dir, iso_poly, 
+             *facet_vertex, dual_edge);
+        };
+
+      for_each_interior_grid_edge_in_box
+        (scalar_grid, owned_box, extract_around_edge);
+    }
+
+    dualiso_info.scalar.num_bipolar_edges = dual_edge.size();
+  }
+
+
+  /// Extract isosurface polytopes in brick.
+  /// - See extract_dual_isopoly_in_brick_F.
+  template <typename GTYPE, typename STYPE, typename BOX_TYPE, typename ETYPE>
+  void extract_dual_isopoly_in_brick
+  (const GTYPE & scalar_grid, const STYPE isovalue, 
+   const BOX_TYPE & owned_box,
+   std::vector<VERTEX_INDEX> & iso_poly,
+   std::vector<ETYPE> & dual_edge,
+   DUALISO_INFO & dualiso_info)
+  {
+    extract_dual_isopoly_in_brick_F
+      (scalar_grid, isovalue, owned_box, iso_poly, 
+       (std::vector<FACET_VERTEX_INDEX> *) NULL, dual_edge, dualiso_info);
+  }
+
+
+  /// Extract isosurface polytopes in brick.
+  /// - Version returning facet_vertex[].
+  /// - See extract_dual_isopoly_in_brick_F.
+  /// @param facet_vertex[i] = Edge of cube containing iso_poly[i].
+  template <typename GTYPE, typename STYPE, typename BOX_TYPE, typename ETYPE>
+  void extract_dual_isopoly_in_brick
+  (const GTYPE & scalar_grid, const STYPE isovalue, 
+   const BOX_TYPE & owned_box,
+   std::vector<VERTEX_INDEX> & iso_poly,
+   std::vector<FACET_VERTEX_INDEX> & facet_vertex,
+   std::vector<ETYPE> & dual_edge,
+   DUALISO_INFO & dualiso_info)
+  {
+    extract_dual_isopoly_in_brick_F
+      (scalar_grid, isovalue, owned_box, iso_poly, &facet_vertex, 
+       dual_edge, dualiso_info);
+  }
+
+  // ***************************************************
+  // EXTRACT IN ACTIVE CUBES
+  // ***************************************************
+
+  /// Apply f(iend0, edge_dir) to every interior grid edge
+  ///   whose lowest endpoint iend0 is the lowest vertex of a cube
+  ///   in cube_list.
+  /// - Every edge of a cube is an edge of the cube with lowest
+  ///   vertex iend0, so every bipolar interior grid edge is processed
+  ///   if cube_list contains all cubes with bipolar edges.
+  template <typename GTYPE, typename CTYPE, typename FTYPE>
+  void for_each_interior_grid_edge_in_cubes
+  (const GTYPE & grid, const std::vector<CTYPE> & cube_list, FTYPE & f)
+  {
+    typedef typename GTYPE::DIMENSION_TYPE DTYPE;
+    const DTYPE dimension = grid.Dimension();
+
+    if (dimension < 1) { return; }
+
+    std::vector<long> coord(dimension);
+
+    for (std::size_t i = 0; i < cube_list.size(); i++) {
+      const CTYPE iend0 = cube_list[i];
+      grid.ComputeCoord(iend0, &(coord.front()));
+
+      // Edge in direction edge_dir is interior if all endpoint
+      //   coordinates, except the edge_dir coordinate, are positive.
+      int num_zero = 0;
+      DTYPE zero_dir = 0;
+      for (DTYPE d = 0; d < dimension; d++) {
+        if (coord[d] == 0) { num_zero++; zero_dir = d; }
+      }
+
+      if (num_zero == 0) {
+        for (DTYPE edge_dir = 0; edge_dir < dimension; edge_dir++)
+          { f(iend0, edge_dir); }
+      }
+      else if (num_zero == 1)
+        { f(iend0, zero_dir); }
+    }
+  }
+
+
+  /// Extract isosurface polytopes dual to interior grid edges
+  ///   whose lowest endpoint is the lowest vertex of a cube 
+  ///   in active_cube.
+  /// - Same isosurface polytopes as extract_dual_isopoly if active_cube
+  ///   contains every cube with a bipolar edge.
+  /// - Cubes in active_cube must be distinct.
+  /// - Sets dualiso_info.scalar.num_bipolar_edges to the number
+  ///   of bipolar edges processed, i.e., the number of polytopes.
+  /// @param facet_vertex If NULL, facet vertices are not returned.
+  ///   Otherwise, (*facet_vertex)[i] = Edge of cube containing iso_poly[i].
+  /// @param[out] dual_edge[] = Array of dual edges.
+  ///   - dual_edge[i] is the grid edge dual to polytope i.
+  template <typename GTYPE, typename STYPE, typename CTYPE, typename ETYPE>
+  void extract_dual_isopoly_in_cubes_F
+  (const GTYPE & scalar_grid, const STYPE isovalue, 
+   const std::vector<CTYPE> & active_cube,
+   std::vector<VERTEX_INDEX> & iso_poly,
+   std::vector<FACET_VERTEX_INDEX> * facet_vertex,
+   std::vector<ETYPE> & dual_edge,
+   DUALISO_INFO & dualiso_info)
+  {
+    dualiso_info.time.extract.Clear();
+
+    IJK::SCOPED_TIMER timer(dualiso_info.time.extract);
+
+    // initialize output
+    iso_poly.clear();
+    if (facet_vertex != NULL) { facet_vertex->clear(); }
+    dual_edge.clear();
+    dualiso_info.scalar.num_bipolar_edges = 0;
+
+    if (scalar_grid.NumCubeVertices() < 1) { return; }
+
+    if (facet_vertex == NULL) {
+      auto extract_around_edge = 
+        [&](const VERTEX_INDEX iend0, const int edge_dir)
+        {
+          extract_dual_isopoly_around_bipolar_edge_E
+            (scalar_grid, isovalue, iend0, edge_dir, iso_poly, dual_edge);
+        };
+
+      for_each_interior_grid_edge_in_cubes
+        (scalar_grid, active_cube, extract_around_edge);
+    }
+    else {
+      auto extract_around_edge = 
+        [&](const VERTEX_INDEX iend0, const int edge_dir)
+        {
+          extract_dual_isopoly_around_bipolar_edge_E
+            (scalar_grid, isovalue, iend0, edge_dir, iso_poly, 
+             *facet_vertex, dual_edge);
+        };
+
+      for_each_interior_grid_edge_in_cubes
+        (scalar_grid, active_cube, extract_around_edge);
+    }
+
+    dualiso_info.scalar.num_bipolar_edges = dual_edge.size();
+  }
+
+
+  /// Extract isosurface polytopes in active cubes.
+  /// - See extract_dual_isopoly_in_cubes_F.
+  template <typename GTYPE, typename STYPE, typename CTYPE, typename ETYPE>
+  void extract_dual_isopoly_in_cubes
+  (const GTYPE & scalar_grid, const STYPE isovalue, 
+   const std::vector<CTYPE> & active_cube,
+   std::vector<VERTEX_INDEX> & iso_poly,
+   std::vector<ETYPE> & dual_edge,
+   DUALISO_INFO & dualiso_info)
+  {
+    extract_dual_isopoly_in_cubes_F
+      (scalar_grid, isovalue, active_cube, iso_poly, 
+       (std::vector<FACET_VERTEX_INDEX> *) NULL, dual_edge, dualiso_info);
+  }
+
+
+  /// Extract isosurface polytopes in active cubes.
+  /// - Version returning facet_vertex[].
+  /// - See extract_dual_isopoly_in_cubes_F.
+  /// @param facet_vertex[i] = Edge of cube containing iso_poly[i].
+  template <typename GTYPE, typename STYPE, typename CTYPE, typename ETYPE>
+  void extract_dual_isopoly_in_cubes
+  (const GTYPE & scalar_grid, const STYPE isovalue, 
+   const std::vector<CTYPE> & active_cube,
+   std::vector<VERTEX_INDEX> & iso_poly,
+   std::vector<FACET_VERTEX_INDEX> & facet_vertex,
+   std::vector<ETYPE> & dual_edge,
+   DUALISO_INFO & dualiso_info)
+  {
+    extract_dual_isopoly_in_cubes_F
+      (scalar_grid, isovalue, active_cube, iso_poly, &facet_vertex, 
+       dual_edge, dualiso_info);
+  }
+
+
+  // ***************************************************
+  // EXTRACT FOR MULTIPLE ISOVALUES
+  // ***************************************************
+
+  /// Extract isosurface polytopes for several isovalues
+  ///   in a single sweep of the grid.
+  /// - Reads the endpoints of each interior grid edge once.
+  ///   The edge is bipolar for the isovalues in its scalar interval
+  ///   (min,max].  Binary search on the sorted isovalues finds them.
+  ///   The dual polytope is extracted once and copied to each of them.
+  /// - Polytopes of multi_data.isovalue[k] are the same as the
+  ///   polytopes of extract_dual_isopoly, up to polytope order.
+  /// - Visits grid rows in memory order.
+  ///   (See for_each_interior_grid_edge_row.)
+  /// - Sets dualiso_info.scalar.num_bipolar_edges to the total number
+  ///   of polytopes over all isovalues.
+  /// @param isovalue Isovalues.  May be unsorted and contain duplicates.
+  /// @param flag_facet_vertex If true, extract facet vertices.
+  template <typename GTYPE>
+  void extract_dual_isopoly_multi_isovalue
+  (const GTYPE & scalar_grid, const std::vector<SCALAR_TYPE> & isovalue,
+   const bool flag_facet_vertex, MULTI_ISOVALUE_EXTRACT_DATA & multi_data,
+   DUALISO_INFO & dualiso_info)
+  {
+    const VERTEX_INDEX num_facet_vertices = scalar_grid.NumFacetVertices();
+    const auto * scalar = scalar_grid.ScalarPtrConst();
+
+    dualiso_info.time.extract.Clear();
+
+    IJK::SCOPED_TIMER timer(dualiso_info.time.extract);
+
+    // initialize output
+    multi_data.Reset(isovalue, flag_facet_vertex);
+    dualiso_info.scalar.num_bipolar_edges = 0;
+
+    const int num_isovalues = multi_data.isovalue.size();
+    if (scalar_grid.NumCubeVertices() < 1 || num_isovalues == 0) { return; }
+
+    const SCALAR_TYPE * iso_begin = &(multi_data.isovalue.front());
+    const SCALAR_TYPE * iso_end = iso_begin + num_isovalues;
+
+    auto extract_in_row = 
+      [&](const VERTEX_INDEX iv_start, const VERTEX_INDEX iv_end,
+          const int edge_dir)
+      {
+        const VERTEX_INDEX increment = scalar_grid.AxisIncrement(edge_dir);
+
+        for (VERTEX_INDEX iend0 = iv_start; iend0 < iv_end; iend0++) {
+          const VERTEX_INDEX iend1 = iend0 + increment;
+          const SCALAR_TYPE s0 = scalar[iend0];
+          const SCALAR_TYPE s1 = scalar[iend1];
+
+          if (s0 == s1) { continue; }
+
+          // Edge is bipolar for isovalue[k], k0 <= k < k1.
+          const SCALAR_TYPE smin = std::min(s0, s1);
+          const SCALAR_TYPE smax = std::max(s0, s1);
+          const int k0 = 
+            std::upper_bound(iso_begin, iso_end, smin) - iso_begin;
+          const int k1 = 
+            std::upper_bound(iso_begin+k0, iso_end, smax) - iso_begin;
+
+          if (k0 == k1) { continue; }
+
+          std::vector<VERTEX_INDEX> & iso_poly0 = multi_data.isopoly[k0];
+          if (s0 < s1) {
+            if (flag_facet_vertex) {
+              extract_dual_isopoly_around_edge
+                (scalar_grid, iend0, iend1, edge_dir, iso_poly0,
+                 multi_data.facet_vertex[k0]);
+            }
+            else {
+              extract_dual_isopoly_around_edge
+                (scalar_grid, iend0, iend1, edge_dir, iso_poly0);
+            }
+          }
+          else {
+            if (flag_facet_vertex) {
+              extract_dual_isopoly_around_edge_reverse_orient
+                (scalar_grid, iend0, iend1, edge_dir, iso_poly0,
+                 multi_data.facet_vertex[k0]);
+            }
+            else {
+              extract_dual_isopoly_around_edge_reverse_orient
+                (scalar_grid, iend0, iend1, edge_dir, iso_poly0);
+            }
+          }
+
+          GRID_EDGE_TYPE grid_edge;
+          grid_edge.Set(iend0, iend1, edge_dir);
+          multi_data.dual_edge[k0].push_back(grid_edge);
+
+          // Copy polytope to the other isovalues.
+          for (int k = k0+1; k < k1; k++) {
+            multi_data.isopoly[k].insert
+              (multi_data.isopoly[k].end(), 
+               iso_poly0.end()-num_facet_vertices, iso_poly0.end());
+            if (flag_facet_vertex) {
+              const std::vector<FACET_VERTEX_INDEX> & facet_vertex0 =
+                multi_data.facet_vertex[k0];
+              multi_data.facet_vertex[k].insert
+                (multi_data.facet_vertex[k].end(), 
+                 facet_vertex0.end()-num_facet_vertices, facet_vertex0.end());
+            }
+            multi_data.dual_edge[k].push_back(grid_edge);
+          }
+        }
+      };
+
+    const VERTEX_INDEX num_rows = 
+      scalar_grid.NumVertices()/scalar_grid.AxisSize(0);
+    for_each_interior_grid_edge_row
+      (scalar_grid, 0, num_rows, extract_in_row);
+
+    VERTEX_INDEX num_bipolar_edges = 0;
+    for (int k = 0; k < num_isovalues; k++) 
+      { num_bipolar_edges += multi_data.dual_edge[k].size(); }
+    dualiso_info.scalar.num_bipolar_edges = num_bipolar_edges;
+  }
+
+
+  // ***************************************************
+  // EXTRACT INTERVAL VOLUME
+  // ***************************************************
+
+  /// Extract interval volume polytopes dual to grid vertices.
+  /// - Each interior grid vertex iv with
+  ///   isovalue0 <= scalar(iv) < isovalue1 is dual to one polytope,
+  ///   a hexahedron in 3D.  Polytope vertices are the grid cubes
+  ///   containing iv, in the order of the cube vertices:
+  ///   polytope vertex k is the cube containing iv as
+  ///   cube vertex (NumCubeVertices()-1-k).
+  /// - Boundary facets of the polytopes are dual to interior grid edges
+  ///   which are bipolar for isovalue0 or isovalue1.  They have
+  ///   the same vertex cubes as the dual isosurface polytopes 
+  ///   of isovalue0 and isovalue1.
+  /// - Visits grid vertices in memory order, one row at a time.
+  /// @param[out] ivolpoly[] Cubes containing polytope vertices.
+  /// @param[out] dual_vertex[ip] Grid vertex dual to polytope ip.
+  ///   Increasing in ip.
+  template <typename GTYPE, typename STYPE, typename VTYPE>
+  void extract_dual_ivolpoly
+  (const GTYPE & scalar_grid, const STYPE isovalue0, const STYPE isovalue1,
+   std::vector<VERTEX_INDEX> & ivolpoly, std::vector<VTYPE> & dual_vertex,
+   DUALISO_INFO & dualiso_info)
+  {
+    typedef typename GTYPE::DIMENSION_TYPE DTYPE;
+
+    const DTYPE dimension = scalar_grid.Dimension();
+    const VERTEX_INDEX num_cube_vertices = scalar_grid.NumCubeVertices();
+    const auto * scalar = scalar_grid.ScalarPtrConst();
+
+    dualiso_info.time.extract.Clear();
+
+    IJK::SCOPED_TIMER timer(dualiso_info.time.extract);
+
+    // initialize output
+    ivolpoly.clear();
+    dual_vertex.clear();
+
+    if (dimension < 1) { return; }
+    for (DTYPE d = 0; d < dimension; d++)
+      { if (scalar_grid.AxisSize(d) < 3) { return; } }
+
+    const VERTEX_INDEX axis_size0 = scalar_grid.AxisSize(0);
+    const VERTEX_INDEX num_rows = scalar_grid.NumVertices()/axis_size0;
+
+    // Coordinates of first vertex in row.  coord[0] is not used.
+    std::vector<long> coord(dimension, 0);
+
+    for (VERTEX_INDEX irow = 0; irow < num_rows; irow++) {
+
+      bool is_interior = true;
+      for (DTYPE d = 1; d < dimension; d++) {
+        if (coord[d] == 0 || coord[d]+1 == long(scalar_grid.AxisSize(d)))
+          { is_interior = false; }
+      }
+
+      if (is_interior) {
+        const VERTEX_INDEX row_start = irow*axis_size0;
+        const VERTEX_INDEX iv_end = row_start+axis_size0-1;
+        for (VERTEX_INDEX iv = row_start+1; iv < iv_end; iv++) {
+          const STYPE s = scalar[iv];
+          if (s < isovalue0 || !(s < isovalue1)) { continue; }
+
+          for (VERTEX_INDEX k = 0; k < num_cube_vertices; k++) {
+            ivolpoly.push_back
+              (iv - scalar_grid.CubeVertexIncrement(num_cube_vertices-1-k));
+          }
+          dual_vertex.push_back(iv);
+        }
+      }
+
+      // Next row, lexicographic order.
+      for (DTYPE d = 1; d < dimension; d++) {
+        coord[d]++;
+        if (coord[d] < long(scalar_grid.AxisSize(d))) { break; }
+        coord[d] = 0;
+      }
+    }
+  }
+
 };
 
 #endif
@@ -0,0 +1,606 @@
+/// \file ijkdual_octree.txx
+/// Dual contouring on an adaptive octree.
+
+/*
+  IJK: Isosurface Jeneration Kode
+  Copyright (C) 2017 Rephael Wenger
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License
+  (LGPL) as published by the Free Software Foundation; either
+  version 2.1 of the License, or any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef _IJKDUAL_OCTREE_TXX_
+#define _IJKDUAL_OCTREE_TXX_
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "ijkcoord.txx"
+#include "ijkisopoly.txx"
+#include "ijkmesh.txx"
+#include "ijktime.txx"
+
+#include "ijkdual_types.h"
+#include "ijkdual_datastruct.h"
+
+
+namespace IJKDUAL {
+
+  // **************************************************
+  // LINEAR FIT ERROR
+  // **************************************************
+
+  /// Compute maximum difference between the scalar values of
+  ///   grid vertices in region [vmin,vmax] and their least squares
+  ///   linear approximation.
+  /// - Region vertices form a product set, so the least squares
+  ///   slope in each direction is computed independently.
+  template <typename SGRID_TYPE, typename GTYPE, typename ETYPE>
+  void compute_linear_fit_error_3D
+  (const SGRID_TYPE & scalar_grid, const GTYPE vmin[], const GTYPE vmax[],
+   ETYPE & error)
+  {
+    typedef typename SGRID_TYPE::VERTEX_INDEX_TYPE VTYPE;
+
+    const int DIM3(3);
+    double mean_coord[DIM3], sum_sq[DIM3], slope[DIM3];
+    double mean_scalar(0);
+    GTYPE coord[DIM3];
+    long num_vert = 1;
+
+    for (int d = 0; d < DIM3; d++) {
+      num_vert *= long(vmax[d]-vmin[d])+1;
+      mean_coord[d] = 0.5*(vmin[d]+vmax[d]);
+      slope[d] = 0;
+    }
+
+    // sum_sq[d] = Sum over region vertices of (coord[d]-mean_coord[d])^2.
+    for (int d = 0; d < DIM3; d++) {
+      const double n = double(vmax[d]-vmin[d])+1;
+      sum_sq[d] = (num_vert/n)*n*(n*n-1)/12.0;
+    }
+
+    for (coord[2] = vmin[2]; coord[2] <= vmax[2]; coord[2]++) {
+      for (coord[1] = vmin[1]; coord[1] <= vmax[1]; coord[1]++) {
+        coord[0] = vmin[0];
+        VTYPE iv = scalar_grid.ComputeVertexIndex(coord);
+        for (; coord[0] <= vmax[0]; coord[0]++) {
+          const double s = scalar_grid.Scalar(iv);
+          mean_scalar += s;
+          for (int d = 0; d < DIM3; d++)
+            { slope[d] += (coord[d]-mean_coord[d])*s; }
+          iv++;
+        }
+      }
+    }
+
+    mean_scalar = mean_scalar/num_vert;
+    for (int d = 0; d < DIM3; d++) {
+      if (sum_sq[d] > 0) { slope[d] = slope[d]/sum_sq[d]; }
+      else { slope[d] = 0; }
+    }
+
+    error = 0;
+    for (coord[2] = vmin[2]; coord[2] <= vmax[2]; coord[2]++) {
+      for (coord[1] = vmin[1]; coord[1] <= vmax[1]; coord[1]++) {
+        coord[0] = vmin[0];
+        VTYPE iv = scalar_grid.ComputeVertexIndex(coord);
+        for (; coord[0] <= vmax[0]; coord[0]++) {
+          double s = mean_scalar;
+          for (int d = 0; d < DIM3; d++)
+            { s += slope[d]*(coord[d]-mean_coord[d]); }
+          const ETYPE diff = std::abs(scalar_grid.Scalar(iv)-s);
+          if (diff > error) { error = diff; }
+          iv++;
+        }
+      }
+    }
+  }
+
+
+  /// Return true if some grid vertex in region [vmin,vmax]
+  ///   has scalar value below isovalue and some has scalar value
+  ///   at or above isovalue.
+  template <typename SGRID_TYPE, typename STYPE, typename GTYPE>
+  bool is_region_bipolar_3D
+  (const SGRID_TYPE & scalar_grid, const STYPE isovalue,
+   const GTYPE vmin[], const GTYPE vmax[])
+  {
+    typedef typename SGRID_TYPE::VERTEX_INDEX_TYPE VTYPE;
+
+    const int DIM3(3);
+    GTYPE coord[DIM3];
+    bool flag_negative = false;
+    bool flag_positive = false;
+
+    for (coord[2] = vmin[2]; coord[2] <= vmax[2]; coord[2]++) {
+      for (coord[1] = vmin[1]; coord[1] <= vmax[1]; coord[1]++) {
+        coord[0] = vmin[0];
+        VTYPE iv = scalar_grid.ComputeVertexIndex(coord);
+        for (; coord[0] <= vmax[0]; coord[0]++) {
+          if (scalar_grid.Scalar(iv) < isovalue) { flag_negative = true; }
+          else { flag_positive = true; }
+          if (flag_negative && flag_positive) { return(true); }
+          iv++;
+        }
+      }
+    }
+
+    return(false);
+  }
+
+
+  // **************************************************
+  // ADAPTIVE OCTREE
+  // **************************************************
+
+  /// Adaptive octree over the grid cubes.
+  /// - Octants at level k are blocks of 2^k x 2^k x 2^k grid cubes
+  ///   whose lowest cube has coordinates divisible by 2^k.
+  ///   Octants are clipped to the grid.
+  /// - Only active leaves, leaves whose grid vertices have scalar
+  ///   values on both sides of the isovalue, are recorded.
+  /// - Each active leaf is identified by the index of its lowest cube.
+  class DUAL_OCTREE_3D {
+
+  public:
+
+    /// leaf_cube[icube] = Lowest cube of the active leaf containing icube.
+    /// - Undefined if icube is not in an active leaf.
+    VERTEX_INDEX_ARRAY leaf_cube;
+
+    /// leaf_level[ileaf] = Level of the active leaf with lowest cube ileaf.
+    /// - Undefined if ileaf is not the lowest cube of an active leaf.
+    std::vector<unsigned char> leaf_level;
+
+    /// Lowest cubes of the active leaves.
+    VERTEX_INDEX_ARRAY active_leaf;
+
+    /// Compute region of grid vertices [vmin,vmax] of active leaf ileaf.
+    template <typename SGRID_TYPE, typename GTYPE>
+    void ComputeLeafRegion
+    (const SGRID_TYPE & grid, const VERTEX_INDEX ileaf,
+     GTYPE vmin[], GTYPE vmax[]) const
+    {
+      const int DIM3(3);
+      const GTYPE leaf_size = (GTYPE(1) << leaf_level[ileaf]);
+
+      grid.ComputeCoord(ileaf, vmin);
+      for (int d = 0; d < DIM3; d++) {
+        vmax[d] = vmin[d] + leaf_size;
+        if (vmax[d] >= grid.AxisSize(d)) { vmax[d] = grid.AxisSize(d)-1; }
+      }
+    }
+  };
+
+
+  /// Subdivide octant with lowest cube cmin[] at the given level.
+  /// - Octant is a leaf if it is at level 0, if its grid vertices
+  ///   are not bipolar or if its scalar field is within max_linear_error
+  ///   of a linear function.
+  template <typename SGRID_TYPE, typename STYPE, typename ETYPE>
+  void build_dual_octree_3D_octant
+  (const SGRID_TYPE & scalar_grid, const STYPE isovalue,
+   const ETYPE max_linear_error, const VERTEX_INDEX cmin[], const int level,
+   DUAL_OCTREE_3D & octree)
+  {
+    const int DIM3(3);
+    const int NUM_CHILDREN(8);
+    const VERTEX_INDEX octant_size = (VERTEX_INDEX(1) << level);
+    VERTEX_INDEX vmax[DIM3];
+
+    for (int d = 0; d < DIM3; d++) {
+      vmax[d] = cmin[d] + octant_size;
+      if (vmax[d] >= scalar_grid.AxisSize(d))
+        { vmax[d] = scalar_grid.AxisSize(d)-1; }
+    }
+
+    if (!is_region_bipolar_3D(scalar_grid, isovalue, cmin, vmax))
+      { return; }
+
+    if (level > 0) {
+      double error;
+      compute_linear_fit_error_3D(scalar_grid, cmin, vmax, error);
+
+      if (error > max_linear_error) {
+        const VERTEX_INDEX child_size = octant_size/2;
+        for (int k = 0; k < NUM_CHILDREN; k++) {
+          VERTEX_INDEX child_cmin[DIM3];
+          bool flag_in_grid = true;
+          for (int d = 0; d < DIM3; d++) {
+            child_cmin[d] = cmin[d] + ((k >> d) & 1)*child_size;
+            if (child_cmin[d]+1 >= scalar_grid.AxisSize(d))
+              { flag_in_grid = false; }
+          }
+
+          if (flag_in_grid) {
+            build_dual_octree_3D_octant
+              (scalar_grid, isovalue, max_linear_error, child_cmin,
+               level-1, octree);
+          }
+        }
+        return;
+      }
+    }
+
+    // Active leaf.
+    const VERTEX_INDEX ileaf = scalar_grid.ComputeVertexIndex(cmin);
+    VERTEX_INDEX coord[DIM3];
+    octree.active_leaf.push_back(ileaf);
+    octree.leaf_level[ileaf] = level;
+    for (coord[2] = cmin[2]; coord[2] < vmax[2]; coord[2]++) {
+      for (coord[1] = cmin[1]; coord[1] < vmax[1]; coord[1]++) {
+        coord[0] = cmin[0];
+        VERTEX_INDEX icube = scalar_grid.ComputeVertexIndex(coord);
+        for (; coord[0] < vmax[0]; coord[0]++) {
+          octree.leaf_cube[icube] = ileaf;
+          icube++;
+        }
+      }
+    }
+  }
+
+
+  /// Build adaptive octree.
+  /// - Octree leaves have at most 2^L x 2^L x 2^L cubes
+  ///   where L equals max_level.
+  /// - See build_dual_octree_3D_octant.
+  template <typename SGRID_TYPE, typename STYPE, typename ETYPE>
+  void build_dual_octree_3D
+  (const SGRID_TYPE & scalar_grid, const STYPE isovalue,
+   const int max_level, const ETYPE max_linear_error,
+   DUAL_OCTREE_3D & octree)
+  {
+    const int DIM3(3);
+    VERTEX_INDEX cmin[DIM3];
+
+    octree.active_leaf.clear();
+    octree.leaf_cube.resize(scalar_grid.NumVertices());
+    octree.leaf_level.resize(scalar_grid.NumVertices());
+
+    if (scalar_grid.NumCubeVertices() < 1) { return; }
+
+    // Octants larger than the grid are not needed.
+    int root_level = 0;
+    for (int d = 0; d < DIM3; d++) {
+      while (root_level < max_level &&
+             (VERTEX_INDEX(1) << root_level)+1 < scalar_grid.AxisSize(d))
+        { root_level++; }
+    }
+    const VERTEX_INDEX root_size = (VERTEX_INDEX(1) << root_level);
+
+    for (cmin[2] = 0; cmin[2]+1 < scalar_grid.AxisSize(2);
+         cmin[2] += root_size) {
+      for (cmin[1] = 0; cmin[1]+1 < scalar_grid.AxisSize(1);
+           cmin[1] += root_size) {
+        for (cmin[0] = 0; cmin[0]+1 < scalar_grid.AxisSize(0);
+             cmin[0] += root_size) {
+          build_dual_octree_3D_octant
+            (scalar_grid, isovalue, max_linear_error, cmin, root_level,
+             octree);
+        }
+      }
+    }
+  }
+
+
+  // **************************************************
+  // EXTRACT ISOSURFACE POLYTOPES FROM OCTREE LEAVES
+  // **************************************************
+
+  /// Extract dual quadrilaterals around minimal edges of active octree leaves.
+  /// - A minimal leaf edge is a maximal run of collinear grid edges
+  ///   on leaf edges whose four surrounding cubes lie in the same
+  ///   four octree leaves.
+  /// - Each minimal leaf edge gives at most one quadrilateral,
+  ///   whose vertices are the four octree leaves.  The quadrilateral
+  ///   is extracted if the endpoints of the minimal leaf edge
+  ///   have different signs.  A sign change followed by a sign change
+  ///   back along the minimal leaf edge gives no quadrilateral.
+  /// - Minimal leaf edges whose four cubes lie in one or two leaves
+  ///   give quadrilaterals which collapse to edges and are skipped.
+  ///   Every other minimal leaf edge lies on an edge of some leaf
+  ///   containing exactly one of its four cubes.  The minimal leaf edge
+  ///   is extracted once, from the first such leaf.
+  /// @param[out] iso_poly[] Quadrilateral vertices,
+  ///   identified by lowest cube of octree leaf.
+  ///   Quadrilaterals with one collapsed edge are not removed.
+  /// @param[out] dual_edge[i] = First bipolar grid edge in the
+  ///   minimal leaf edge dual to quadrilateral i.
+  template <typename SGRID_TYPE, typename STYPE, typename ETYPE>
+  void extract_dual_isopoly_from_octree_3D
+  (const SGRID_TYPE & scalar_grid, const STYPE isovalue,
+   const DUAL_OCTREE_3D & octree, VERTEX_INDEX_ARRAY & iso_poly,
+   std::vector<ETYPE> & dual_edge)
+  {
+    const int DIM3(3);
+    const int NUM_VERT_PER_QUAD(4);
+    const int NUM_LEAF_EDGES_PER_DIR(4);
+
+    iso_poly.clear();
+    dual_edge.clear();
+
+    for (std::size_t i = 0; i < octree.active_leaf.size(); i++) {
+      const VERTEX_INDEX ileaf = octree.active_leaf[i];
+      VERTEX_INDEX vmin[DIM3], vmax[DIM3];
+
+      octree.ComputeLeafRegion(scalar_grid, ileaf, vmin, vmax);
+
+      for (int edge_dir = 0; edge_dir < DIM3; edge_dir++) {
+        const int d1 = (edge_dir+1)%DIM3;
+        const int d2 = (edge_dir+2)%DIM3;
+        const VERTEX_INDEX increment = scalar_grid.AxisIncrement(edge_dir);
+
+        // Add quadrilateral dual to the minimal leaf edge
+        //   from grid vertex run_start to grid vertex run_end.
+        // - run_leaf[] = Leaves around the minimal leaf edge.
+        // - run_bipolar = Lower endpoint of first bipolar grid edge
+        //   in the minimal leaf edge, or -1 if there is none.
+        auto add_quad =
+          [&](const VERTEX_INDEX run_start, const VERTEX_INDEX run_end,
+              const VERTEX_INDEX run_bipolar, 
+              const VERTEX_INDEX run_leaf[])
+          {
+            if (run_bipolar < 0) { return; }
+
+            const bool is_start_negative =
+              (scalar_grid.Scalar(run_start) < isovalue);
+            const bool is_end_negative =
+              (scalar_grid.Scalar(run_end) < isovalue);
+            if (is_start_negative == is_end_negative) { return; }
+
+            // Find first leaf containing exactly one of the four cubes.
+            int kowner = NUM_VERT_PER_QUAD;
+            for (int k = 0; k < NUM_VERT_PER_QUAD &&
+                   kowner == NUM_VERT_PER_QUAD; k++) {
+              int num_equal = 0;
+              for (int m = 0; m < NUM_VERT_PER_QUAD; m++) {
+                if (run_leaf[m] == run_leaf[k]) { num_equal++; }
+              }
+              if (num_equal == 1) { kowner = k; }
+            }
+
+            if (kowner == NUM_VERT_PER_QUAD ||
+                run_leaf[kowner] != ileaf) { return; }
+
+            // Grid edges before run_bipolar are not bipolar,
+            //   so run_bipolar has the sign of run_start.
+            // Reverse orientation if run_start is positive.
+            VERTEX_INDEX quad_cube[NUM_VERT_PER_QUAD];
+            IJK::set_dual_isopoly_around_edge
+              (scalar_grid, run_bipolar, edge_dir, !is_start_negative,
+               quad_cube, (FACET_VERTEX_INDEX *) NULL);
+
+            for (int k = 0; k < NUM_VERT_PER_QUAD; k++)
+              { iso_poly.push_back(octree.leaf_cube[quad_cube[k]]); }
+            dual_edge.push_back(ETYPE());
+            dual_edge.back().Set
+              (run_bipolar, run_bipolar+increment, edge_dir);
+          };
+
+        for (int j = 0; j < NUM_LEAF_EDGES_PER_DIR; j++) {
+          VERTEX_INDEX coord[DIM3];
+          coord[edge_dir] = vmin[edge_dir];
+          coord[d1] = ((j & 1) ? vmax[d1] : vmin[d1]);
+          coord[d2] = ((j & 2) ? vmax[d2] : vmin[d2]);
+
+          // Skip grid edges on the grid boundary.
+          if (coord[d1] < 1 || coord[d1]+2 > scalar_grid.AxisSize(d1) ||
+              coord[d2] < 1 || coord[d2]+2 > scalar_grid.AxisSize(d2))
+            { continue; }
+
+          VERTEX_INDEX run_leaf[NUM_VERT_PER_QUAD];
+          VERTEX_INDEX run_start = 0;
+          VERTEX_INDEX run_bipolar = -1;
+
+          VERTEX_INDEX iend0 = scalar_grid.ComputeVertexIndex(coord);
+          for (VERTEX_INDEX c = vmin[edge_dir]; c < vmax[edge_dir];
+               c++, iend0 += increment) {
+            const VERTEX_INDEX iend1 = iend0 + increment;
+            VERTEX_INDEX quad_cube[NUM_VERT_PER_QUAD];
+            VERTEX_INDEX quad_leaf[NUM_VERT_PER_QUAD];
+
+            IJK::set_dual_isopoly_around_edge
+              (scalar_grid, iend0, edge_dir, false, quad_cube,
+               (FACET_VERTEX_INDEX *) NULL);
+            for (int k = 0; k < NUM_VERT_PER_QUAD; k++)
+              { quad_leaf[k] = octree.leaf_cube[quad_cube[k]]; }
+
+            if (c == vmin[edge_dir] ||
+                !std::equal(quad_leaf, quad_leaf+NUM_VERT_PER_QUAD, 
+                            run_leaf)) {
+              if (c != vmin[edge_dir])
+                { add_quad(run_start, iend0, run_bipolar, run_leaf); }
+
+              // Start new minimal leaf edge.
+              std::copy(quad_leaf, quad_leaf+NUM_VERT_PER_QUAD, run_leaf);
+              run_start = iend0;
+              run_bipolar = -1;
+            }
+
+            if (run_bipolar < 0 &&
+                (scalar_grid.Scalar(iend0) < isovalue) !=
+                (scalar_grid.Scalar(iend1) < isovalue))
+              { run_bipolar = iend0; }
+          }
+
+          if (vmin[edge_dir] < vmax[edge_dir])
+            { add_quad(run_start, iend0, run_bipolar, run_leaf); }
+        }
+      }
+    }
+  }
+
+
+  // **************************************************
+  // POSITION OCTREE ISOSURFACE VERTICES
+  // **************************************************
+
+  /// Position isosurface vertex of each octree leaf in leaf_list[]
+  ///   at the centroid of the intersections of the isosurface
+  ///   and the bipolar grid edges in the leaf.
+  /// - Vertex is positioned at the leaf center if no grid edge
+  ///   in the leaf is bipolar.
+  /// - Resizes vertex_coord.
+  template <typename SGRID_TYPE, typename STYPE, typename CTYPE>
+  void position_octree_isovertices_centroid_3D
+  (const SGRID_TYPE & scalar_grid, const STYPE isovalue,
+   const DUAL_OCTREE_3D & octree, const VERTEX_INDEX_ARRAY & leaf_list,
+   std::vector<CTYPE> & vertex_coord)
+  {
+    const int DIM3(3);
+
+    vertex_coord.resize(DIM3*leaf_list.size());
+
+    for (std::size_t i = 0; i < leaf_list.size(); i++) {
+      const VERTEX_INDEX ileaf = leaf_list[i];
+      CTYPE * vcoord = &(vertex_coord[i*DIM3]);
+      VERTEX_INDEX vmin[DIM3], vmax[DIM3], coord[DIM3];
+      long num_intersected_edges = 0;
+
+      octree.ComputeLeafRegion(scalar_grid, ileaf, vmin, vmax);
+      IJK::set_coord_3D(0, vcoord);
+
+      for (coord[2] = vmin[2]; coord[2] <= vmax[2]; coord[2]++) {
+        for (coord[1] = vmin[1]; coord[1] <= vmax[1]; coord[1]++) {
+          coord[0] = vmin[0];
+          VERTEX_INDEX iend0 = scalar_grid.ComputeVertexIndex(coord);
+          for (; coord[0] <= vmax[0]; coord[0]++, iend0++) {
+            const double s0 = scalar_grid.Scalar(iend0);
+            const bool is_end0_negative = (s0 < isovalue);
+
+            for (int edge_dir = 0; edge_dir < DIM3; edge_dir++) {
+              if (coord[edge_dir] >= vmax[edge_dir]) { continue; }
+
+              const VERTEX_INDEX iend1 =
+                iend0 + scalar_grid.AxisIncrement(edge_dir);
+              const double s1 = scalar_grid.Scalar(iend1);
+              if (is_end0_negative == (s1 < isovalue)) { continue; }
+
+              for (int d = 0; d < DIM3; d++) { vcoord[d] += coord[d]; }
+              vcoord[edge_dir] += (isovalue-s0)/(s1-s0);
+              num_intersected_edges++;
+            }
+          }
+        }
+      }
+
+      if (num_intersected_edges > 0) {
+        IJK::multiply_coord_3D
+          (1.0/num_intersected_edges, vcoord, vcoord);
+      }
+      else {
+        for (int d = 0; d < DIM3; d++)
+          { vcoord[d] = 0.5*(vmin[d]+vmax[d]); }
+      }
+    }
+  }
+
+
+  // **************************************************
+  // DUAL CONTOURING ON ADAPTIVE OCTREE
+  // **************************************************
+
+  /// Extract isosurface from the leaves of an adaptive octree.
+  /// - Each active octree leaf contains a single isosurface vertex.
+  /// - Octree leaves have at most 2^L x 2^L x 2^L cubes where
+  ///   L equals dualiso_data.MaxOctreeLevel().
+  /// - Octant is a leaf if its scalar field is within
+  ///   dualiso_data.MaxOctreeLinearError() of a linear function.
+  /// - Dual quadrilaterals with one collapsed edge are added
+  ///   to dual_isosurface.tri_vert.
+  ///   isopoly_info[] matches the remaining quadrilaterals.
+  /// - Vertex coordinates are in grid units.
+  template <typename DATA_TYPE, typename STYPE, typename ISOSURFACE_TYPE,
+            typename MERGE_DATA_TYPE>
+  void dual_contouring_octree
+  (const DATA_TYPE & dualiso_data, const STYPE isovalue,
+   ISOSURFACE_TYPE & dual_isosurface, MERGE_DATA_TYPE & merge_data,
+   DUALISO_INFO & dualiso_info)
+  {
+    typedef typename ISOSURFACE_TYPE::ISOPOLY_INFO_ARRAY ISOPOLY_INFO_ARRAY;
+
+    const int DIM3(3);
+    const int NUM_VERT_PER_QUAD(4);
+    const int MAX_LEVEL(30);
+    const int dimension = dualiso_data.ScalarGrid().Dimension();
+    const int max_level = dualiso_data.MaxOctreeLevel();
+    DUAL_OCTREE_3D octree;
+    VERTEX_INDEX_ARRAY isopoly;
+    VERTEX_INDEX_ARRAY leaf_list;
+    std::vector<ISO_VERTEX_INDEX> quad_vert;
+    ISOPOLY_INFO_ARRAY dual_edge;
+    IJK::PROCEDURE_ERROR error("dual_contouring_octree");
+
+    if (dimension != DIM3) {
+      error.AddMessage("Illegal dimension ", dimension, ".");
+      error.AddMessage
+        ("  Adaptive octree is only implemented for dimension 3.");
+      throw error;
+    }
+
+    if (max_level < 0 || max_level > MAX_LEVEL) {
+      error.AddMessage("Illegal octree level ", max_level, ".");
+      error.AddMessage
+        ("  Octree level must be in range [0,", MAX_LEVEL, "].");
+      throw error;
+    }
+
+    if (dualiso_data.ROIFlag() || dualiso_data.BrickFlag() ||
+        dualiso_data.ExtractActiveCubesFlag()) {
+      error.AddMessage("Adaptive octree requires the full grid.");
+      error.AddMessage
+        ("  Region of interest, brick and active cube extraction"
+         " are not supported.");
+      throw error;
+    }
+
+    IJK::SCOPED_TIMER extract_timer(dualiso_info.time.extract);
+    build_dual_octree_3D
+      (dualiso_data.ScalarGrid(), isovalue, max_level,
+       dualiso_data.MaxOctreeLinearError(), octree);
+    extract_dual_isopoly_from_octree_3D
+      (dualiso_data.ScalarGrid(), isovalue, octree, isopoly, dual_edge);
+    extract_timer.Stop();
+
+    IJK::SCOPED_TIMER merge_timer(dualiso_info.time.merge);
+    merge_identical(isopoly, leaf_list, quad_vert, merge_data);
+
+    // Replace quadrilaterals with one collapsed edge by triangles.
+    const std::size_t num_quad = dual_edge.size();
+    dual_isosurface.isopoly_vert.clear();
+    dual_isosurface.isopoly_info.clear();
+    dual_isosurface.tri_vert.clear();
+    for (std::size_t iquad = 0; iquad < num_quad; iquad++) {
+      const std::size_t num_quad_vert = dual_isosurface.isopoly_vert.size();
+      IJK::get_non_degenerate_quad_btlr
+        (&(quad_vert[iquad*NUM_VERT_PER_QUAD]), dual_isosurface.tri_vert,
+         dual_isosurface.isopoly_vert);
+      if (dual_isosurface.isopoly_vert.size() > num_quad_vert)
+        { dual_isosurface.isopoly_info.push_back(dual_edge[iquad]); }
+    }
+    merge_timer.Stop();
+
+    dualiso_info.scalar.num_non_empty_cubes = leaf_list.size();
+
+    IJK::SCOPED_TIMER position_timer(dualiso_info.time.position);
+    position_octree_isovertices_centroid_3D
+      (dualiso_data.ScalarGrid(), isovalue, octree, leaf_list,
+       dual_isosurface.vertex_coord);
+  }
+
+}
+
+#endif
@@ -23,9 +23,12 @@
 #ifndef IJKDUAL_POSITION_TXX_
 #define IJKDUAL_POSITION_TXX_
 
+#include <cmath>
+#include <utility>
 #include <vector>
 
 #include "ijkdualtable.h"
+#include "ijkdual_datastruct.h"
 
 #include "ijkcoord.txx"
 #include "ijkinterpolate.txx"
@@ -35,6 +38,262 @@
 
 namespace IJKDUAL {
 
+  // **************************************************
+  // FIXED DIMENSION CUBE
+  // **************************************************
+
+  /// Grid cube vertex increments and edge endpoints in fixed dimension DIM.
+  /// - Numbers of cube vertices and edges are compile time constants,
+  ///   so loops over cube vertices, edges and coordinates can be unrolled.
+  /// - Cube vertex coordinates are computed from the coordinates
+  ///   of the primary cube vertex and the bits of the cube vertex index.
+  /// - Used only for vertex positioning.  Extraction of the isosurface
+  ///   polytopes uses the generic grid edge loops in every dimension.
+  template <int DIM, typename VTYPE>
+  class FIXED_DIM_CUBE {
+
+  public:
+    static const int DIMENSION = DIM;
+    static const int NUM_VERTICES = (1 << DIM);
+    static const int NUM_FACET_VERTICES = NUM_VERTICES/2;
+    static const int NUM_EDGES = DIM*NUM_FACET_VERTICES;
+
+    /// vertex_increment[k] = Index increment of k'th cube vertex.
+    VTYPE vertex_increment[NUM_VERTICES];
+
+    /// (edge_endpoint[2*ie], edge_endpoint[2*ie+1]) =
+    ///   Endpoints of edge ie in the order of IJK::CUBE_FACE_INFO.
+    int edge_endpoint[2*NUM_EDGES];
+
+    /// (dir_edge_endpoint[2*j], dir_edge_endpoint[2*j+1]) =
+    ///   Endpoints of edge j where edges are listed by direction
+    ///   and then by lower endpoint in the order of grid facet vertices.
+    /// - Edge j has direction j/NUM_FACET_VERTICES.
+    int dir_edge_endpoint[2*NUM_EDGES];
+
+  public:
+    template <typename GRID_TYPE>
+    FIXED_DIM_CUBE(const GRID_TYPE & grid);
+
+    /// Compute coordinates of k'th cube vertex.
+    /// @param base_coord[] Coordinates of primary cube vertex.
+    template <typename CTYPE>
+    void ComputeVertexCoord
+    (const CTYPE base_coord[], const int k, CTYPE coord[]) const
+    {
+      for (int d = 0; d < DIM; d++)
+        { coord[d] = base_coord[d] + ((k >> d) & 1); }
+    }
+  };
+
+
+  template <int DIM, typename VTYPE>
+  template <typename GRID_TYPE>
+  FIXED_DIM_CUBE<DIM,VTYPE>::FIXED_DIM_CUBE(const GRID_TYPE & grid)
+  {
+    IJK::PROCEDURE_ERROR error("FIXED_DIM_CUBE");
+
+    if (grid.Dimension() != DIM) {
+      error.AddMessage("Programming error.  Grid dimension ",
+                       grid.Dimension(), " does not equal ", DIM, ".");
+      throw error;
+    }
+
+    for (int k = 0; k < NUM_VERTICES; k++)
+      { vertex_increment[k] = grid.CubeVertexIncrement(k); }
+
+    IJK::CUBE_FACE_INFO<int,int,int> cube(DIM);
+    for (int ie = 0; ie < NUM_EDGES; ie++) {
+      edge_endpoint[2*ie] = cube.EdgeEndpoint(ie, 0);
+      edge_endpoint[2*ie+1] = cube.EdgeEndpoint(ie, 1);
+    }
+
+    for (int d = 0; d < DIM; d++) {
+      for (int k = 0; k < NUM_FACET_VERTICES; k++) {
+        const int j = d*NUM_FACET_VERTICES+k;
+        const VTYPE inc = grid.FacetVertexIncrement(d, k);
+
+        int k0 = 0;
+        while (k0 < NUM_VERTICES && vertex_increment[k0] != inc)
+          { k0++; }
+
+        if (k0 == NUM_VERTICES) {
+          error.AddMessage
+            ("Programming error.  Unable to find facet vertex ", k,
+             " of facet ", d, " in cube.");
+          throw error;
+        }
+
+        dir_edge_endpoint[2*j] = k0;
+        dir_edge_endpoint[2*j+1] = (k0 | (1 << d));
+      }
+    }
+  }
+
+
+  /// Position dual isosurface vertex in centroid
+  ///   of isosurface-edge intersections in fixed dimension.
+  /// - Computes the same coordinates as position_dual_isov_centroid().
+  /// @param iv Index of grid cube containing isosurface vertex.
+  /// @param[out] vcoord[] Vertex coordinates.
+  template <typename GRID_TYPE, typename FIXED_CUBE_TYPE,
+            typename STYPE, typename VTYPE, typename CTYPE>
+  void position_dual_isov_centroid_fixed_dim
+  (const GRID_TYPE & scalar_grid, const FIXED_CUBE_TYPE & cube,
+   const STYPE isovalue, const VTYPE iv, CTYPE * vcoord)
+  {
+    typedef typename GRID_TYPE::NUMBER_TYPE NTYPE;
+
+    const int DIM = FIXED_CUBE_TYPE::DIMENSION;
+    const auto * scalar = scalar_grid.ScalarPtrConst();
+    CTYPE base_coord[DIM];
+    CTYPE coord0[DIM], coord1[DIM], coord2[DIM];
+
+    NTYPE num_intersected_edges = 0;
+    IJK::set_coord(DIM, 0.0, vcoord);
+    scalar_grid.ComputeCoord(iv, base_coord);
+
+    for (int j = 0; j < FIXED_CUBE_TYPE::NUM_EDGES; j++) {
+      const int k0 = cube.dir_edge_endpoint[2*j];
+      const int k1 = cube.dir_edge_endpoint[2*j+1];
+      const STYPE s0 = scalar[iv+cube.vertex_increment[k0]];
+      const STYPE s1 = scalar[iv+cube.vertex_increment[k1]];
+
+      if ((s0 < isovalue) != (s1 < isovalue)) {
+        cube.ComputeVertexCoord(base_coord, k0, coord0);
+        cube.ComputeVertexCoord(base_coord, k1, coord1);
+
+        IJK::linear_interpolate_coord
+          (DIM, s0, coord0, s1, coord1, isovalue, coord2);
+
+        IJK::add_coord(DIM, vcoord, coord2, vcoord);
+
+        num_intersected_edges++;
+      }
+    }
+
+    if (num_intersected_edges > 0) {
+      IJK::multiply_coord
+        (DIM, 1.0/num_intersected_edges, vcoord, vcoord);
+    }
+    else {
+      scalar_grid.ComputeCubeCenterCoord(iv, vcoord);
+    }
+  }
+
+
+  /// Position dual isosurface vertices in centroid
+  ///   of isosurface-edge intersections in fixed dimension DIM.
+  /// @pre scalar_grid.Dimension() == DIM.
+  template <int DIM, typename GRID_TYPE, typename STYPE,
+            typename ISOV_INDEX_TYPE, typename CTYPE>
+  void position_all_dual_isovertices_centroid_fixed_dim
+  (const GRID_TYPE & scalar_grid,
+   const STYPE isovalue,
+   const std::vector<ISOV_INDEX_TYPE> & vlist, CTYPE * coord)
+  {
+    typedef typename GRID_TYPE::VERTEX_INDEX_TYPE VTYPE;
+    typedef typename std::vector<ISOV_INDEX_TYPE>::size_type SIZE_TYPE;
+
+    const FIXED_DIM_CUBE<DIM,VTYPE> cube(scalar_grid);
+
+    for (SIZE_TYPE i = 0; i < vlist.size(); i++) {
+      position_dual_isov_centroid_fixed_dim
+        (scalar_grid, cube, isovalue, VTYPE(vlist[i]), coord+i*DIM);
+    }
+  }
+
+
+  /// Position dual isosurface vertex at centroid in fixed dimension.
+  /// - Computes the same coordinates as position_dual_isov_centroid_multi().
+  /// @param[out] vcoord[] Vertex coordinates.
+  template <typename GRID_TYPE, typename FIXED_CUBE_TYPE, typename STYPE,
+            typename DUAL_ISOV_TYPE, typename CTYPE>
+  void position_dual_isov_centroid_multi_fixed_dim
+  (const GRID_TYPE & scalar_grid,
+   const IJKDUALTABLE::ISODUAL_CUBE_TABLE & isodual_table,
+   const FIXED_CUBE_TYPE & cube,
+   const STYPE isovalue,
+   const DUAL_ISOV_TYPE & isov_info,
+   CTYPE * vcoord)
+  {
+    typedef typename GRID_TYPE::VERTEX_INDEX_TYPE VTYPE;
+    typedef typename GRID_TYPE::NUMBER_TYPE NTYPE;
+
+    const int DIM = FIXED_CUBE_TYPE::DIMENSION;
+    const VTYPE icube = isov_info.cube_index;
+    const NTYPE ipatch = isov_info.patch_index;
+    const IJKDUALTABLE::TABLE_INDEX it = isov_info.table_index;
+    const auto * scalar = scalar_grid.ScalarPtrConst();
+    CTYPE base_coord[DIM];
+    CTYPE coord0[DIM], coord1[DIM], coord2[DIM];
+
+    NTYPE num_intersected_edges = 0;
+    IJK::set_coord(DIM, 0.0, vcoord);
+    scalar_grid.ComputeCoord(icube, base_coord);
+
+    for (int ie = 0; ie < FIXED_CUBE_TYPE::NUM_EDGES; ie++) {
+      if (isodual_table.IsBipolar(it, ie) &&
+          isodual_table.IncidentIsoVertex(it, ie) == ipatch) {
+        const int k0 = cube.edge_endpoint[2*ie];
+        const int k1 = cube.edge_endpoint[2*ie+1];
+        const STYPE s0 = scalar[icube+cube.vertex_increment[k0]];
+        const STYPE s1 = scalar[icube+cube.vertex_increment[k1]];
+
+        cube.ComputeVertexCoord(base_coord, k0, coord0);
+        cube.ComputeVertexCoord(base_coord, k1, coord1);
+
+        if ((s0 < isovalue && s1 < isovalue) ||
+            (s0 > isovalue && s1 > isovalue)) {
+          // Use edge midpoint.
+          IJK::linear_interpolate_coord(DIM, 0.5, coord0, coord1, coord2);
+        }
+        else {
+          IJK::linear_interpolate_coord
+            (DIM, s0, coord0, s1, coord1, isovalue, coord2);
+        }
+
+        IJK::add_coord(DIM, vcoord, coord2, vcoord);
+
+        num_intersected_edges++;
+      }
+    }
+
+    if (num_intersected_edges > 0) {
+      IJK::multiply_coord
+        (DIM, 1.0/num_intersected_edges, vcoord, vcoord);
+    }
+    else {
+      scalar_grid.ComputeCubeCenterCoord(icube, vcoord);
+    }
+  }
+
+
+  /// Position dual isosurface vertices using centroids
+  ///   in fixed dimension DIM.
+  /// @pre scalar_grid.Dimension() == DIM.
+  template <int DIM, typename GRID_TYPE, typename STYPE,
+            typename DUAL_ISOV_TYPE, typename CTYPE>
+  void position_all_dual_isovertices_centroid_multi_fixed_dim
+  (const GRID_TYPE & scalar_grid,
+   const IJKDUALTABLE::ISODUAL_CUBE_TABLE & isodual_table,
+   const STYPE isovalue,
+   const std::vector<DUAL_ISOV_TYPE> & iso_vlist,
+   CTYPE * coord)
+  {
+    typedef typename GRID_TYPE::VERTEX_INDEX_TYPE VTYPE;
+    typedef typename std::vector<DUAL_ISOV_TYPE>::size_type SIZE_TYPE;
+
+    const FIXED_DIM_CUBE<DIM,VTYPE> cube(scalar_grid);
+
+    for (SIZE_TYPE i = 0; i < iso_vlist.size(); i++) {
+      position_dual_isov_centroid_multi_fixed_dim
+        (scalar_grid, isodual_table, cube, isovalue, iso_vlist[i],
+         coord+i*DIM);
+    }
+  }
+
+
   // **************************************************
   // SINGLE ISOSURFACE VERTEX IN A GRID CUBE
   // **************************************************
@@ -76,6 +335,69 @@ namespace IJKDUAL {
   }
 
 
+  /// Position dual isosurface vertex in centroid 
+  ///   of isosurface-edge intersections.
+  /// @param iv Index of grid cube containing isosurface vertex.
+  /// @param[out] vcoord[] Vertex coordinates.
+  /// @param temp_coord0[] Temporary coordinate array.
+  /// @param temp_coord1[] Temporary coordinate array.
+  /// @param temp_coord2[] Temporary coordinate array.
+  template <typename GRID_TYPE, typename STYPE, typename VTYPE,
+            typename CTYPE, typename CTYPE2>
+  void position_dual_isov_centroid
+  (const GRID_TYPE & scalar_grid, const STYPE isovalue, const VTYPE iv,
+   CTYPE * vcoord,
+   CTYPE2 * temp_coord0, CTYPE2 * temp_coord1, CTYPE2 * temp_coord2)
+  {
+    typedef typename GRID_TYPE::DIMENSION_TYPE DTYPE;
+    typedef typename GRID_TYPE::NUMBER_TYPE NTYPE;
+
+    const DTYPE dimension = scalar_grid.Dimension();
+
+    NTYPE num_intersected_edges = 0;
+    IJK::set_coord(dimension, 0.0, vcoord);
+
+    for (DTYPE edge_dir = 0; edge_dir < dimension; edge_dir++)
+      for (NTYPE k = 0; k < scalar_grid.NumFacetVertices(); k++) {
+        VTYPE iend0 = scalar_grid.FacetVertex(iv, edge_dir, k);
+        VTYPE iend1 = scalar_grid.NextVertex(iend0, edge_dir);
+
+        STYPE s0 = scalar_grid.Scalar(iend0);
+        bool is_end0_positive = true;
+        if (s0 < isovalue)
+          { is_end0_positive = false; };
+
+        STYPE s1 = scalar_grid.Scalar(iend1);
+        bool is_end1_positive = true;
+        if (s1 < isovalue)
+          { is_end1_positive = false; };
+
+        if (is_end0_positive != is_end1_positive) {
+
+          scalar_grid.ComputeCoord(iend0, temp_coord0);
+          scalar_grid.ComputeCoord(iend1, temp_coord1);
+
+          IJK::linear_interpolate_coord
+            (dimension, s0, temp_coord0, s1, temp_coord1, 
+             isovalue, temp_coord2);
+
+          IJK::add_coord(dimension, vcoord, temp_coord2, vcoord);
+
+          num_intersected_edges++;
+        }
+
+      }
+
+    if (num_intersected_edges > 0) {
+      IJK::multiply_coord
+        (dimension, 1.0/num_intersected_edges, vcoord, vcoord);
+    }
+    else {
+      scalar_grid.ComputeCubeCenterCoord(iv, vcoord);
+    }
+  }
+
+
   /// Position dual isosurface vertices in centroid 
   ///   of isosurface-edge intersections
   template <typename GRID_TYPE, typename STYPE, typename ISOV_INDEX_TYPE,
@@ -87,10 +409,21 @@ namespace IJKDUAL {
   {
     typedef typename GRID_TYPE::DIMENSION_TYPE DTYPE;
     typedef typename GRID_TYPE::VERTEX_INDEX_TYPE VTYPE;
-    typedef typename GRID_TYPE::NUMBER_TYPE NTYPE;
 
     const DTYPE dimension = scalar_grid.Dimension();
-    IJK::ARRAY<CTYPE> vcoord(dimension);
+
+    // Unrolled versions for 3D and 4D grids.
+    if (dimension == 3) {
+      position_all_dual_isovertices_centroid_fixed_dim<3>
+        (scalar_grid, isovalue, vlist, coord);
+      return;
+    }
+    else if (dimension == 4) {
+      position_all_dual_isovertices_centroid_fixed_dim<4>
+        (scalar_grid, isovalue, vlist, coord);
+      return;
+    }
+
     IJK::ARRAY<CTYPE> coord0(dimension);
     IJK::ARRAY<CTYPE> coord1(dimension);
     IJK::ARRAY<CTYPE> coord2(dimension);
@@ -98,49 +431,9 @@ namespace IJKDUAL {
     for (VTYPE i = 0; i < vlist.size(); i++) {
       VTYPE iv = vlist[i];
 
-      NTYPE num_intersected_edges = 0;
-      IJK::set_coord(dimension, 0.0, vcoord.Ptr());
-
-      for (DTYPE edge_dir = 0; edge_dir < dimension; edge_dir++)
-        for (NTYPE k = 0; k < scalar_grid.NumFacetVertices(); k++) {
-          VTYPE iend0 = scalar_grid.FacetVertex(iv, edge_dir, k);
-          VTYPE iend1 = scalar_grid.NextVertex(iend0, edge_dir);
-
-          STYPE s0 = scalar_grid.Scalar(iend0);
-          bool is_end0_positive = true;
-          if (s0 < isovalue)
-            { is_end0_positive = false; };
-
-          STYPE s1 = scalar_grid.Scalar(iend1);
-          bool is_end1_positive = true;
-          if (s1 < isovalue)
-            { is_end1_positive = false; };
-
-          if (is_end0_positive != is_end1_positive) {
-
-            scalar_grid.ComputeCoord(iend0, coord0.Ptr());
-            scalar_grid.ComputeCoord(iend1, coord1.Ptr());
-
-            IJK::linear_interpolate_coord
-              (dimension, s0, coord0.Ptr(), s1, coord1.Ptr(), 
-               isovalue, coord2.Ptr());
-
-            IJK::add_coord(dimension, vcoord.Ptr(), coord2.Ptr(), vcoord.Ptr());
-
-            num_intersected_edges++;
-          }
-
-        }
-
-      if (num_intersected_edges > 0) {
-        IJK::multiply_coord
-          (dimension, 1.0/num_intersected_edges, vcoord.Ptr(), 
-           coord+i*dimension);
-      }
-      else {
-        scalar_grid.ComputeCubeCenterCoord(iv, coord+i*dimension);
-      }
-
+      position_dual_isov_centroid
+        (scalar_grid, isovalue, iv, coord+i*dimension,
+         coord0.Ptr(), coord1.Ptr(), coord2.Ptr());
     }
   }
 
@@ -258,6 +551,19 @@ namespace IJKDUAL {
     typedef typename GRID_TYPE::NUMBER_TYPE NTYPE;
 
     const DTYPE dimension = scalar_grid.Dimension();
+
+    // Unrolled versions for 3D and 4D grids.
+    if (dimension == 3) {
+      position_all_dual_isovertices_centroid_multi_fixed_dim<3>
+        (scalar_grid, isodual_table, isovalue, iso_vlist, coord);
+      return;
+    }
+    else if (dimension == 4) {
+      position_all_dual_isovertices_centroid_multi_fixed_dim<4>
+        (scalar_grid, isodual_table, isovalue, iso_vlist, coord);
+      return;
+    }
+
     IJK::ARRAY<CTYPE> vcoord(dimension);
     IJK::ARRAY<CTYPE> coord0(dimension);
     IJK::ARRAY<CTYPE> coord1(dimension);
@@ -292,81 +598,102 @@ namespace IJKDUAL {
        &(coord.front()));
   }
 
-  /// Position dual isosurface vertices near cube centers.
-  /// More than one vertex can be in a cube.
-  /// If cube contains multiple isosurface then vertices are positioned
-  ///   near but not on cube center.
-  template <typename GRID_TYPE, typename STYPE,
-            typename DUAL_ISOV_TYPE, typename CTYPE0, typename CTYPE1>
-  void position_all_dual_isovertices_near_cube_center_multi
+  /// Position dual isosurface vertex near cube center.
+  /// If cube contains multiple isosurface vertices, then the vertex
+  ///   is positioned near but not on cube center.
+  /// @param[out] vcoord[] Vertex coordinates.
+  template <typename GRID_TYPE, typename DUAL_ISOV_TYPE, 
+            typename ISOV_INDEX_TYPE, typename CUBE_TYPE, 
+            typename UNIT_CUBE_TYPE, typename CTYPE0, typename CTYPE1>
+  void position_dual_isov_near_cube_center_multi
   (const GRID_TYPE & scalar_grid,
    const IJKDUALTABLE::ISODUAL_CUBE_TABLE & isodual_table,
-   const STYPE isovalue,
    const std::vector<DUAL_ISOV_TYPE> & iso_vlist,
+   const CUBE_TYPE & cube,
+   const UNIT_CUBE_TYPE & unit_cube,
+   const ISOV_INDEX_TYPE isov,
    const CTYPE0 offset,
-   CTYPE1 * coord)
+   CTYPE1 * vcoord)
   {
     typedef typename GRID_TYPE::DIMENSION_TYPE DTYPE;
     typedef typename GRID_TYPE::VERTEX_INDEX_TYPE VTYPE;
     typedef typename GRID_TYPE::NUMBER_TYPE NTYPE;
 
     const DTYPE dimension = scalar_grid.Dimension();
-    CTYPE1 vcoord[dimension];
-    IJK::CUBE_FACE_INFO<int,int,int> cube(dimension);
-    IJK::UNIT_CUBE<int,int,int> unit_cube(dimension);
+    const VTYPE icube = iso_vlist[isov].cube_index;
+    const NTYPE ipatch = iso_vlist[isov].patch_index;
+    const IJKDUALTABLE::TABLE_INDEX it = iso_vlist[isov].table_index;
     bool intersects_facet[2*dimension];
 
-    for (VTYPE i = 0; i < iso_vlist.size(); i++) {
-      VTYPE icube = iso_vlist[i].cube_index;
-      NTYPE ipatch = iso_vlist[i].patch_index;
-      IJKDUALTABLE::TABLE_INDEX it = iso_vlist[i].table_index;
+    scalar_grid.ComputeCubeCenterCoord(icube, vcoord);
 
-      if (isodual_table.NumIsoVertices(it) == 1) {
-        scalar_grid.ComputeCubeCenterCoord(icube, coord+i*dimension);
-      }
-      else {
+    if (isodual_table.NumIsoVertices(it) == 1) { return; }
 
-        scalar_grid.ComputeCubeCenterCoord(icube, vcoord);
+    // Set intersects facet to false.
+    for (DTYPE d = 0; d < dimension; d++) {
+      intersects_facet[2*d] = false;
+      intersects_facet[2*d+1] = false;
+    }
 
-        // Set intersects facet to false.
-        for (DTYPE d = 0; d < dimension; d++) {
-          intersects_facet[2*d] = false;
-          intersects_facet[2*d+1] = false;
-        }
+    for (NTYPE ie = 0; ie < cube.NumEdges(); ie++) {
+      if (isodual_table.IsBipolar(it, ie)) {
+        if (isodual_table.IncidentIsoVertex(it, ie) == ipatch) {
+          NTYPE k0 = cube.EdgeEndpoint(ie, 0);
+          NTYPE k1 = cube.EdgeEndpoint(ie, 1);
 
-        for (NTYPE ie = 0; ie < cube.NumEdges(); ie++) {
-          if (isodual_table.IsBipolar(it, ie)) {
-            if (isodual_table.IncidentIsoVertex(it, ie) == ipatch) {
-              NTYPE k0 = cube.EdgeEndpoint(ie, 0);
-              NTYPE k1 = cube.EdgeEndpoint(ie, 1);
-
-              for (DTYPE d = 0; d < dimension; d++) {
-                NTYPE c = unit_cube.VertexCoord(k0, d);
-                if (c == unit_cube.VertexCoord(k1, d)) {
-                  if (c > 0) 
-                    { intersects_facet[2*d+1] = true; }
-                  else
-                    { intersects_facet[2*d] = true; }
-                }
-              }
+          for (DTYPE d = 0; d < dimension; d++) {
+            NTYPE c = unit_cube.VertexCoord(k0, d);
+            if (c == unit_cube.VertexCoord(k1, d)) {
+              if (c > 0) 
+                { intersects_facet[2*d+1] = true; }
+              else
+                { intersects_facet[2*d] = true; }
             }
           }
         }
+      }
+    }
 
-        for (DTYPE d = 0; d < dimension; d++) {
+    for (DTYPE d = 0; d < dimension; d++) {
 
-          if (intersects_facet[2*d] != intersects_facet[2*d+1]) {
-            if (intersects_facet[2*d]) 
-              { vcoord[d] -= offset; }
-            else
-              { vcoord[d] += offset; }
-          }
-        }
-        IJK::copy_coord(dimension, vcoord, coord+i*dimension);
+      if (intersects_facet[2*d] != intersects_facet[2*d+1]) {
+        if (intersects_facet[2*d]) 
+          { vcoord[d] -= offset; }
+        else
+          { vcoord[d] += offset; }
       }
     }
   }
 
+  /// Position dual isosurface vertices near cube centers.
+  /// More than one vertex can be in a cube.
+  /// If cube contains multiple isosurface then vertices are positioned
+  ///   near but not on cube center.
+  template <typename GRID_TYPE, typename STYPE,
+            typename DUAL_ISOV_TYPE, typename CTYPE0, typename CTYPE1>
+  void position_all_dual_isovertices_near_cube_center_multi
+  (const GRID_TYPE & scalar_grid,
+   const IJKDUALTABLE::ISODUAL_CUBE_TABLE & isodual_table,
+   const STYPE isovalue,
+   const std::vector<DUAL_ISOV_TYPE> & iso_vlist,
+   const CTYPE0 offset,
+   CTYPE1 * coord)
+  {
+    typedef typename GRID_TYPE::DIMENSION_TYPE DTYPE;
+    typedef typename GRID_TYPE::VERTEX_INDEX_TYPE VTYPE;
+
+    const DTYPE dimension = scalar_grid.Dimension();
+    IJK::CUBE_FACE_INFO<int,int,int> cube(dimension);
+    IJK::UNIT_CUBE<int,int,int> unit_cube(dimension);
+    const VTYPE numv = iso_vlist.size();
+
+    for (VTYPE i = 0; i < numv; i++) {
+      position_dual_isov_near_cube_center_multi
+        (scalar_grid, isodual_table, iso_vlist, cube, unit_cube, i, offset,
+         coord+i*dimension);
+    }
+  }
+
   /// Position dual isosurface vertices near cube centers.
   /// - More than one vertex can be in a cube.
   /// - C++ STL vector format for array coord[].
@@ -470,6 +797,345 @@ namespace IJKDUAL {
        &(coord.front()));
   }
 
+
+  // **************************************************
+  // POSITION INTERVAL VOLUME VERTICES
+  // **************************************************
+
+  /// Position dual interval volume vertex in centroid of the
+  ///   intersections of cube edges with isovalue0 and isovalue1.
+  /// - Positions vertex at the cube center if no cube edge
+  ///   is bipolar for either isovalue.
+  /// @param iv Index of grid cube containing interval volume vertex.
+  /// @param[out] vcoord[] Vertex coordinates.
+  /// @param temp_coord0[] Temporary coordinate array.
+  /// @param temp_coord1[] Temporary coordinate array.
+  /// @param temp_coord2[] Temporary coordinate array.
+  template <typename GRID_TYPE, typename STYPE, typename VTYPE,
+            typename CTYPE, typename CTYPE2>
+  void position_dual_ivolv_centroid
+  (const GRID_TYPE & scalar_grid,
+   const STYPE isovalue0, const STYPE isovalue1, const VTYPE iv,
+   CTYPE * vcoord,
+   CTYPE2 * temp_coord0, CTYPE2 * temp_coord1, CTYPE2 * temp_coord2)
+  {
+    typedef typename GRID_TYPE::DIMENSION_TYPE DTYPE;
+    typedef typename GRID_TYPE::NUMBER_TYPE NTYPE;
+
+    const DTYPE dimension = scalar_grid.Dimension();
+    const STYPE isovalue[2] = { isovalue0, isovalue1 };
+
+    NTYPE num_intersections = 0;
+    IJK::set_coord(dimension, 0.0, vcoord);
+
+    for (DTYPE edge_dir = 0; edge_dir < dimension; edge_dir++)
+      for (NTYPE k = 0; k < scalar_grid.NumFacetVertices(); k++) {
+        VTYPE iend0 = scalar_grid.FacetVertex(iv, edge_dir, k);
+        VTYPE iend1 = scalar_grid.NextVertex(iend0, edge_dir);
+
+        STYPE s0 = scalar_grid.Scalar(iend0);
+        STYPE s1 = scalar_grid.Scalar(iend1);
+
+        for (int j = 0; j < 2; j++) {
+          if ((s0 < isovalue[j]) != (s1 < isovalue[j])) {
+            scalar_grid.ComputeCoord(iend0, temp_coord0);
+            scalar_grid.ComputeCoord(iend1, temp_coord1);
+
+            IJK::linear_interpolate_coord
+              (dimension, s0, temp_coord0, s1, temp_coord1,
+               isovalue[j], temp_coord2);
+
+            IJK::add_coord(dimension, vcoord, temp_coord2, vcoord);
+
+            num_intersections++;
+          }
+        }
+      }
+
+    if (num_intersections > 0) {
+      IJK::multiply_coord
+        (dimension, 1.0/num_intersections, vcoord, vcoord);
+    }
+    else {
+      scalar_grid.ComputeCubeCenterCoord(iv, vcoord);
+    }
+  }
+
+
+  /// Position dual interval volume vertices in centroid of the
+  ///   intersections of cube edges with isovalue0 and isovalue1.
+  /// C++ STL vector format for array coord[].
+  /// @param cube_list[] Grid cubes containing interval volume vertices.
+  template <typename GRID_TYPE, typename STYPE, typename ISOV_INDEX_TYPE,
+            typename CTYPE>
+  void position_all_dual_ivol_vertices_centroid
+  (const GRID_TYPE & scalar_grid,
+   const STYPE isovalue0, const STYPE isovalue1,
+   const std::vector<ISOV_INDEX_TYPE> & cube_list,
+   std::vector<CTYPE> & coord)
+  {
+    typedef typename GRID_TYPE::DIMENSION_TYPE DTYPE;
+    typedef typename GRID_TYPE::VERTEX_INDEX_TYPE VTYPE;
+
+    const DTYPE dimension = scalar_grid.Dimension();
+    IJK::ARRAY<CTYPE> coord0(dimension);
+    IJK::ARRAY<CTYPE> coord1(dimension);
+    IJK::ARRAY<CTYPE> coord2(dimension);
+
+    coord.resize(cube_list.size()*dimension);
+    for (VTYPE i = 0; i < cube_list.size(); i++) {
+      position_dual_ivolv_centroid
+        (scalar_grid, isovalue0, isovalue1, VTYPE(cube_list[i]),
+         &(coord[i*dimension]), coord0.Ptr(), coord1.Ptr(), coord2.Ptr());
+    }
+  }
+
+
+  // **************************************************
+  // CUBE RELATIVE COORDINATES
+  // **************************************************
+
+  /// Position dual isosurface vertices and store their coordinates
+  ///   relative to the grid cubes containing them.
+  /// - Vertices are positioned in double precision and then
+  ///   quantized to offsets within their cubes.
+  /// @param position_isov Function position_isov(i, vcoord) which
+  ///   sets vcoord[] to the coordinates of the i'th isosurface vertex.
+  /// @pre cube_relative_coord.cube_index[i] is the index of 
+  ///   the grid cube containing the i'th isosurface vertex.
+  template <typename GRID_TYPE, typename FTYPE>
+  void position_all_dual_isovertices_cube_relative
+  (const GRID_TYPE & scalar_grid, FTYPE position_isov,
+   CUBE_RELATIVE_COORD_ARRAY & cube_relative_coord)
+  {
+    typedef typename GRID_TYPE::DIMENSION_TYPE DTYPE;
+    typedef typename GRID_TYPE::VERTEX_INDEX_TYPE VTYPE;
+    typedef CUBE_RELATIVE_COORD_ARRAY::OFFSET_TYPE OFFSET_TYPE;
+
+    const DTYPE dimension = scalar_grid.Dimension();
+    const VTYPE numv = cube_relative_coord.NumVertices();
+    const double max_offset = cube_relative_coord.MaxOffset();
+    IJK::ARRAY<double> vcoord(dimension);
+    IJK::ARRAY<double> cube_coord(dimension);
+
+    cube_relative_coord.offset.resize(numv*dimension);
+    for (VTYPE i = 0; i < numv; i++) {
+      const VTYPE icube = cube_relative_coord.cube_index[i];
+      OFFSET_TYPE * offset = &(cube_relative_coord.offset[i*dimension]);
+
+      position_isov(i, vcoord.Ptr());
+      scalar_grid.ComputeCoord(icube, cube_coord.Ptr());
+
+      for (DTYPE d = 0; d < dimension; d++) {
+        double f = vcoord[d] - cube_coord[d];
+        if (f < 0) { f = 0; }
+        if (f > 1) { f = 1; }
+        offset[d] = OFFSET_TYPE(std::floor(f*max_offset + 0.5));
+      }
+    }
+  }
+
+  /// Position dual isosurface vertices in cube centers.
+  /// Version storing cube relative coordinates.
+  template <typename GRID_TYPE, typename ISOV_INDEX_TYPE>
+  void position_all_dual_isovertices_cube_center
+  (const GRID_TYPE & grid,
+   const std::vector<ISOV_INDEX_TYPE> & vlist, 
+   CUBE_RELATIVE_COORD_ARRAY & cube_relative_coord)
+  {
+    typedef typename GRID_TYPE::VERTEX_INDEX_TYPE VTYPE;
+
+    cube_relative_coord.cube_index.assign(vlist.begin(), vlist.end());
+    position_all_dual_isovertices_cube_relative
+      (grid, [&](const VTYPE i, double * vcoord) 
+       { grid.ComputeCubeCenterCoord(vlist[i], vcoord); },
+       cube_relative_coord);
+  }
+
+  /// Position dual isosurface vertices in centroid 
+  ///   of isosurface-edge intersections.
+  /// Version storing cube relative coordinates.
+  template <typename GRID_TYPE, typename STYPE, typename ISOV_INDEX_TYPE>
+  void position_all_dual_isovertices_centroid
+  (const GRID_TYPE & scalar_grid,
+   const STYPE isovalue,
+   const std::vector<ISOV_INDEX_TYPE> & vlist, 
+   CUBE_RELATIVE_COORD_ARRAY & cube_relative_coord)
+  {
+    typedef typename GRID_TYPE::DIMENSION_TYPE DTYPE;
+    typedef typename GRID_TYPE::VERTEX_INDEX_TYPE VTYPE;
+
+    const DTYPE dimension = scalar_grid.Dimension();
+    IJK::ARRAY<double> coord0(dimension);
+    IJK::ARRAY<double> coord1(dimension);
+    IJK::ARRAY<double> coord2(dimension);
+
+    cube_relative_coord.cube_index.assign(vlist.begin(), vlist.end());
+    position_all_dual_isovertices_cube_relative
+      (scalar_grid, [&](const VTYPE i, double * vcoord) 
+       { position_dual_isov_centroid
+           (scalar_grid, isovalue, VTYPE(vlist[i]), vcoord,
+            coord0.Ptr(), coord1.Ptr(), coord2.Ptr()); },
+       cube_relative_coord);
+  }
+
+  /// Set cube_relative_coord.cube_index[i] to iso_vlist[i].cube_index.
+  template <typename DUAL_ISOV_TYPE>
+  void set_cube_relative_coord_cube_index
+  (const std::vector<DUAL_ISOV_TYPE> & iso_vlist,
+   CUBE_RELATIVE_COORD_ARRAY & cube_relative_coord)
+  {
+    const VERTEX_INDEX numv = iso_vlist.size();
+
+    cube_relative_coord.cube_index.resize(numv);
+    for (VERTEX_INDEX i = 0; i < numv; i++)
+      { cube_relative_coord.cube_index[i] = iso_vlist[i].cube_index; }
+  }
+
+  /// Position dual isosurface vertices using centroids.
+  /// Version storing cube relative coordinates.
+  template <typename GRID_TYPE, typename STYPE, typename DUAL_ISOV_TYPE>
+  void position_all_dual_isovertices_centroid_multi
+  (const GRID_TYPE & scalar_grid,
+   const IJKDUALTABLE::ISODUAL_CUBE_TABLE & isodual_table,
+   const STYPE isovalue,
+   const std::vector<DUAL_ISOV_TYPE> & iso_vlist, 
+   CUBE_RELATIVE_COORD_ARRAY & cube_relative_coord)
+  {
+    typedef typename GRID_TYPE::DIMENSION_TYPE DTYPE;
+    typedef typename GRID_TYPE::VERTEX_INDEX_TYPE VTYPE;
+
+    const DTYPE dimension = scalar_grid.Dimension();
+    IJK::ARRAY<double> coord0(dimension);
+    IJK::ARRAY<double> coord1(dimension);
+    IJK::ARRAY<double> coord2(dimension);
+    IJK::CUBE_FACE_INFO<int,int,int> cube(dimension);
+
+    set_cube_relative_coord_cube_index(iso_vlist, cube_relative_coord);
+    position_all_dual_isovertices_cube_relative
+      (scalar_grid, [&](const VTYPE i, double * vcoord) 
+       { position_dual_isov_centroid_multi
+           (scalar_grid, isodual_table, isovalue, iso_vlist, cube, i, 
+            vcoord, coord0.Ptr(), coord1.Ptr(), coord2.Ptr()); },
+       cube_relative_coord);
+  }
+
+  /// Position dual isosurface vertices near cube centers.
+  /// Version storing cube relative coordinates.
+  template <typename GRID_TYPE, typename STYPE,
+            typename DUAL_ISOV_TYPE, typename CTYPE0>
+  void position_all_dual_isovertices_near_cube_center_multi
+  (const GRID_TYPE & scalar_grid,
+   const IJKDUALTABLE::ISODUAL_CUBE_TABLE & isodual_table,
+   const STYPE isovalue,
+   const std::vector<DUAL_ISOV_TYPE> & iso_vlist,
+   const CTYPE0 offset,
+   CUBE_RELATIVE_COORD_ARRAY & cube_relative_coord)
+  {
+    typedef typename GRID_TYPE::DIMENSION_TYPE DTYPE;
+    typedef typename GRID_TYPE::VERTEX_INDEX_TYPE VTYPE;
+
+    const DTYPE dimension = scalar_grid.Dimension();
+    IJK::CUBE_FACE_INFO<int,int,int> cube(dimension);
+    IJK::UNIT_CUBE<int,int,int> unit_cube(dimension);
+
+    set_cube_relative_coord_cube_index(iso_vlist, cube_relative_coord);
+    position_all_dual_isovertices_cube_relative
+      (scalar_grid, [&](const VTYPE i, double * vcoord) 
+       { position_dual_isov_near_cube_center_multi
+           (scalar_grid, isodual_table, iso_vlist, cube, unit_cube, i,
+            offset, vcoord); },
+       cube_relative_coord);
+  }
+
+  /// Position interval volume vertices which have been lifted
+  ///   to one higher dimension.
+  /// Version storing cube relative coordinates.
+  template <typename GRID_TYPE, typename STYPE, typename DUAL_ISOV_TYPE>
+  void position_all_dual_isovertices_ivol_lifted
+  (const GRID_TYPE & scalar_grid,
+   const IJKDUALTABLE::ISODUAL_CUBE_TABLE & isodual_table,
+   const STYPE isovalue0,
+   const STYPE isovalue1,
+   const std::vector<DUAL_ISOV_TYPE> & iso_vlist,
+   CUBE_RELATIVE_COORD_ARRAY & cube_relative_coord)
+  {
+    typedef typename GRID_TYPE::DIMENSION_TYPE DTYPE;
+    typedef typename GRID_TYPE::VERTEX_INDEX_TYPE VTYPE;
+
+    const DTYPE dimension = scalar_grid.Dimension();
+
+    if (dimension < 1) { return; }
+
+    const VTYPE numv_in_grid_facet_maxd = 
+      scalar_grid.AxisIncrement(dimension-1);
+    IJK::ARRAY<double> coord0(dimension);
+    IJK::ARRAY<double> coord1(dimension);
+    IJK::ARRAY<double> coord2(dimension);
+    IJK::CUBE_FACE_INFO<int,int,int> cube(dimension);
+
+    set_cube_relative_coord_cube_index(iso_vlist, cube_relative_coord);
+    position_all_dual_isovertices_cube_relative
+      (scalar_grid, [&](const VTYPE i, double * vcoord) 
+       { 
+         // Apply isovalue1 to (*,*,*,0) and isovalue0 to (*,*,*,1) cubes.
+         const STYPE isovalue = 
+           (iso_vlist[i].cube_index < numv_in_grid_facet_maxd) ?
+           isovalue1 : isovalue0;
+         position_dual_isov_centroid_multi
+           (scalar_grid, isodual_table, isovalue, iso_vlist, cube, i, 
+            vcoord, coord0.Ptr(), coord1.Ptr(), coord2.Ptr()); },
+       cube_relative_coord);
+  }
+
+  /// Convert cube relative coordinates to vertex coordinates.
+  /// - Vertex coordinates are in grid units.
+  template <typename GRID_TYPE, typename CTYPE>
+  void convert_cube_relative_coord
+  (const GRID_TYPE & grid,
+   const CUBE_RELATIVE_COORD_ARRAY & cube_relative_coord,
+   std::vector<CTYPE> & vertex_coord)
+  {
+    typedef typename GRID_TYPE::DIMENSION_TYPE DTYPE;
+    typedef typename GRID_TYPE::VERTEX_INDEX_TYPE VTYPE;
+
+    const DTYPE dimension = grid.Dimension();
+    const VTYPE numv = cube_relative_coord.NumVertices();
+    const double max_offset = cube_relative_coord.MaxOffset();
+    IJK::ARRAY<VTYPE> cube_coord(dimension);
+
+    vertex_coord.resize(numv*dimension);
+    for (VTYPE i = 0; i < numv; i++) {
+      const VTYPE icube = cube_relative_coord.cube_index[i];
+      grid.ComputeCoord(icube, cube_coord.Ptr());
+      for (DTYPE d = 0; d < dimension; d++) {
+        const VTYPE k = i*dimension+d;
+        vertex_coord[k] = CTYPE
+          (cube_coord[d] + cube_relative_coord.offset[k]/max_offset);
+      }
+    }
+  }
+
+  /// Convert cube relative coordinates of dual_isosurface
+  ///   to dual_isosurface.vertex_coord.
+  /// - Clears dual_isosurface.cube_relative_coord.
+  /// - Does nothing if dual_isosurface does not store
+  ///   cube relative coordinates.
+  template <typename GRID_TYPE, typename DUAL_ISOSURFACE_TYPE>
+  void convert_cube_relative_coord
+  (const GRID_TYPE & grid, DUAL_ISOSURFACE_TYPE & dual_isosurface)
+  {
+    if (!dual_isosurface.IsCubeRelativeCoord()) { return; }
+
+    convert_cube_relative_coord
+      (grid, dual_isosurface.cube_relative_coord, 
+       dual_isosurface.vertex_coord);
+
+    // Free memory.
+    CUBE_RELATIVE_COORD_ARRAY empty(grid.Dimension());
+    std::swap(dual_isosurface.cube_relative_coord, empty);
+  }
+
 }
 
 #endif
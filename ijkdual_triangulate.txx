@@ -28,6 +28,8 @@
 #include "ijkcoord.txx"
 #include "ijkinterpolate.txx"
 #include "ijkisocoord.txx"
+#include "ijkmesh.txx"
+#include "ijktime.txx"
 #include "ijktriangulate_geom.txx"
 
 #include "ijkdual_types.h"
@@ -164,20 +166,23 @@ namespace IJKDUAL {
   // **************************************************
 
   /// Add isosurface vertices on grid edges.
+  /// @param thread_time If not NULL, add wall clock time of each thread
+  ///   in parallel regions.
   template <typename DATA_TYPE, typename STYPE, typename ISOSURFACE_TYPE>
   void add_isov_on_grid_edges
   (const DATA_TYPE & dualiso_data, const STYPE isovalue,
-   ISOSURFACE_TYPE & dual_isosurface)
+   ISOSURFACE_TYPE & dual_isosurface, IJK::WALL_CPU_TIME * thread_time)
   {
     const QUAD_EDGE_INTERSECTION_METHOD qei_method =
       dualiso_data.quad_edge_intersection_method;
 
     if (qei_method == QEI_INTERPOLATE_COORD) {
-      add_isov_on_grid_edges_interpolate_coord(dualiso_data, dual_isosurface);
+      add_isov_on_grid_edges_interpolate_coord
+        (dualiso_data, dual_isosurface, thread_time);
     }
     else {
       add_isov_on_grid_edges_interpolate_scalar
-        (dualiso_data, isovalue, dual_isosurface);
+        (dualiso_data, isovalue, dual_isosurface, thread_time);
     }
 
   }
@@ -188,7 +193,7 @@ namespace IJKDUAL {
   template <typename DATA_TYPE, typename STYPE, typename ISOSURFACE_TYPE>
   void add_isov_on_grid_edges_interpolate_scalar
   (const DATA_TYPE & dualiso_data, const STYPE isovalue,
-   ISOSURFACE_TYPE & dual_isosurface)
+   ISOSURFACE_TYPE & dual_isosurface, IJK::WALL_CPU_TIME * thread_time)
   {
     typedef std::vector<VERTEX_INDEX>::size_type SIZE_TYPE;
 
@@ -218,7 +223,8 @@ namespace IJKDUAL {
 
       IJK::compute_isov_coord_on_grid_edge_linear
         (dualiso_data.ScalarGrid(), isovalue,
-         dual_isosurface.isopoly_info, first_isov_on_edge_coord);
+         dual_isosurface.isopoly_info, first_isov_on_edge_coord, 
+         thread_time);
     }
 
   }
@@ -228,7 +234,8 @@ namespace IJKDUAL {
   ///   of quadrilateral vertex coordinates.
   template <typename DATA_TYPE, typename ISOSURFACE_TYPE>
   void add_isov_on_grid_edges_interpolate_coord
-  (const DATA_TYPE & dualiso_data, ISOSURFACE_TYPE & dual_isosurface)
+  (const DATA_TYPE & dualiso_data, ISOSURFACE_TYPE & dual_isosurface,
+   IJK::WALL_CPU_TIME * thread_time)
   {
     typedef std::vector<VERTEX_INDEX>::size_type SIZE_TYPE;
 
@@ -255,16 +262,24 @@ namespace IJKDUAL {
         IJK::vector2pointerNC(dual_isosurface.vertex_coord)
         + dimension*first_isov_on_edge;
 
-      for (int ipoly = 0; ipoly < num_poly; ipoly++) {
+      // New vertices are not quadrilateral vertices, so new vertex 
+      //   coordinates can be computed in parallel.
+#pragma omp parallel
+      {
+        IJK::SCOPED_THREAD_TIMER thread_timer(thread_time);
+
+#pragma omp for schedule(static)
+        for (int ipoly = 0; ipoly < num_poly; ipoly++) {
 
-        const ISO_VERTEX_INDEX isov = first_isov_on_edge + ipoly;
-        COORD_TYPE * isov_coord =
-          &(dual_isosurface.vertex_coord[isov*dimension]);
+          const ISO_VERTEX_INDEX isov = first_isov_on_edge + ipoly;
+          COORD_TYPE * isov_coord =
+            &(dual_isosurface.vertex_coord[isov*dimension]);
 
-        compute_intersection_of_quad_and_grid_edge
-          (dualiso_data.ScalarGrid(), dual_isosurface.isopoly_vert,
-           dual_isosurface.isopoly_info[ipoly], dual_isosurface.vertex_coord, 
-           ipoly, isov_coord);
+          compute_intersection_of_quad_and_grid_edge
+            (dualiso_data.ScalarGrid(), dual_isosurface.isopoly_vert,
+             dual_isosurface.isopoly_info[ipoly], 
+             dual_isosurface.vertex_coord, ipoly, isov_coord);
+        }
       }
     }
   }
@@ -276,9 +291,12 @@ namespace IJKDUAL {
 
 
   /// Add new isosurface vertices at centroid of isosurface poly vertices.
+  /// @param thread_time If not NULL, add wall clock time of each thread
+  ///   in parallel regions.
   template <typename DATA_TYPE, typename ISOSURFACE_TYPE>
   void add_isov_at_poly_centroids
-  (const DATA_TYPE & dualiso_data, ISOSURFACE_TYPE & dual_isosurface)
+  (const DATA_TYPE & dualiso_data, ISOSURFACE_TYPE & dual_isosurface,
+   IJK::WALL_CPU_TIME * thread_time)
   {
     typedef std::vector<VERTEX_INDEX>::size_type SIZE_TYPE;
 
@@ -297,17 +315,25 @@ namespace IJKDUAL {
 
     if (dual_isosurface.vertex_coord.size() > 0) {
 
-      for (int ipoly = 0; ipoly < num_poly; ipoly++) {
+      // New vertices are not polygon vertices, so new vertex 
+      //   coordinates can be computed in parallel.
+#pragma omp parallel
+      {
+        IJK::SCOPED_THREAD_TIMER thread_timer(thread_time);
 
-        const ISO_VERTEX_INDEX isov = first_new_isov + ipoly;
-        COORD_TYPE * isov_coord =
-          &(dual_isosurface.vertex_coord[isov*dimension]);
+#pragma omp for schedule(static)
+        for (int ipoly = 0; ipoly < num_poly; ipoly++) {
 
-        const ISO_VERTEX_INDEX * first_isopoly_vert = 
-          &(dual_isosurface.isopoly_vert[ipoly*numv_per_iso_poly]);
+          const ISO_VERTEX_INDEX isov = first_new_isov + ipoly;
+          COORD_TYPE * isov_coord =
+            &(dual_isosurface.vertex_coord[isov*dimension]);
+
+          const ISO_VERTEX_INDEX * first_isopoly_vert = 
+            &(dual_isosurface.isopoly_vert[ipoly*numv_per_iso_poly]);
         
-        compute_quad_centroid
-          (first_isopoly_vert, dual_isosurface.vertex_coord, isov_coord);
+          compute_quad_centroid
+            (first_isopoly_vert, dual_isosurface.vertex_coord, isov_coord);
+        }
       }
     }
 
@@ -364,19 +390,23 @@ namespace IJKDUAL {
 
   /// Convert quadrilaterals (embedded in 3D) to triangles.
   /// Assumes input isosurface is quadrilaterals embedded in 3D.
+  /// @param thread_time If not NULL, add wall clock time of each thread
+  ///   in parallel regions.
   template <typename DATA_TYPE, typename ISOSURFACE_TYPE>
   void convert_quad_to_tri
-  (const DATA_TYPE & dualiso_data, ISOSURFACE_TYPE & dual_isosurface)
+  (const DATA_TYPE & dualiso_data, ISOSURFACE_TYPE & dual_isosurface,
+   IJK::WALL_CPU_TIME * thread_time)
   {
     typedef std::vector<VERTEX_INDEX>::size_type SIZE_TYPE;
 
+    const int DIM3(3);
     const int NUM_VERT_PER_QUAD = 4;
     const int dimension = dualiso_data.ScalarGrid().Dimension();
     const int numv_per_iso_poly = dual_isosurface.NumVerticesPerIsoPoly();
     const COORD_TYPE max_small_magnitude = dualiso_data.MaxSmallMagnitude();
     const QUAD_TRI_METHOD quad_tri_method = 
       dualiso_data.QuadTriangulationMethod();
-    VERTEX_INDEX_ARRAY quad_vert(dual_isosurface.isopoly_vert);
+    ISO_VERTEX_INDEX_ARRAY & quad_vert = dual_isosurface.isopoly_vert;
     IJK::PROCEDURE_ERROR error("convert_quad_to_tri");
 
     if (numv_per_iso_poly != NUM_VERT_PER_QUAD) {
@@ -387,9 +417,22 @@ namespace IJKDUAL {
       throw error;
     }
 
-    IJK::reorder_quad_vertices(quad_vert);
+    // Reorder isopoly_vert in place, instead of copying it.
+    // Original order is restored when reorder_quad goes out of scope.
+    IJK::SCOPED_REORDER_QUAD_VERTICES<ISO_VERTEX_INDEX> reorder_quad(quad_vert);
 
-    if (quad_tri_method == MAX_MIN_ANGLE) {
+    if (dimension == DIM3 && !dualiso_data.flag_tri4_quad) {
+      IJK::QUAD_TRI_METHOD_3D method_3D = IJK::QUAD_TRI_UNIFORM_3D;
+      if (quad_tri_method == MAX_MIN_ANGLE)
+        { method_3D = IJK::QUAD_TRI_MAX_MIN_ANGLE_3D; }
+      else if (quad_tri_method == SPLIT_MAX_ANGLE)
+        { method_3D = IJK::QUAD_TRI_SPLIT_MAX_ANGLE_3D; }
+
+      IJK::triangulate_quad_batch_3D
+        (dual_isosurface.vertex_coord, quad_vert, method_3D,
+         max_small_magnitude, dual_isosurface.tri_vert, thread_time);
+    }
+    else if (quad_tri_method == MAX_MIN_ANGLE) {
 
       IJK::triangulate_quad_max_min_angle
         (dimension, dual_isosurface.vertex_coord, quad_vert, 
@@ -430,7 +473,7 @@ namespace IJKDUAL {
             (dualiso_data.ScalarGrid(), dual_isosurface.vertex_coord, 
              quad_vert, dual_isosurface.isopoly_info,
              first_isov_on_grid_edge, min_distance_use_tri4, 
-             max_small_magnitude, dual_isosurface.tri_vert);
+             max_small_magnitude, dual_isosurface.tri_vert, thread_time);
         }
         else {
 
@@ -439,7 +482,7 @@ namespace IJKDUAL {
             triangulate_quad_tri4_max_min_angle
               (dualiso_data.ScalarGrid(), dual_isosurface.vertex_coord, 
                quad_vert, first_isov_on_grid_edge, max_small_magnitude, 
-               dual_isosurface.tri_vert);
+               dual_isosurface.tri_vert, thread_time);
           }
           else {
             triangulate_dual_quad_tri4_max_min_angle
@@ -447,7 +490,7 @@ namespace IJKDUAL {
                quad_vert, dual_isosurface.isopoly_info,
                first_isov_on_grid_edge,
                min_distance_allow_tri4, max_small_magnitude, 
-               dual_isosurface.tri_vert);
+               dual_isosurface.tri_vert, thread_time);
           }
         }
       }
@@ -457,6 +500,118 @@ namespace IJKDUAL {
     }
   }
 
+
+  /// Convert quadrilaterals (embedded in 3D) to triangles in place.
+  /// - Triangles are stored in dual_isosurface.tri_vert.
+  /// - Clears dual_isosurface.isopoly_vert and dual_isosurface.isopoly_info.
+  /// - Quadrilateral storage is reused for the triangles.
+  ///   Frees isopoly_info, but reallocating the quadrilateral list
+  ///   to hold the triangles may still briefly store both lists.
+  ///   See IJK::triangulate_quad_batch_3D_in_place.
+  /// - dual_contouring reserves room for the triangles when
+  ///   dualiso_data.UseTriangleMesh() is true, so the list
+  ///   is not reallocated.
+  /// - Triangles are identical to the ones returned by convert_quad_to_tri.
+  /// @param thread_time If not NULL, add wall clock time of each thread
+  ///   in parallel regions.
+  /// @pre dualiso_data.flag_tri4_quad is false.
+  template <typename DATA_TYPE, typename ISOSURFACE_TYPE>
+  void convert_quad_to_tri_in_place
+  (const DATA_TYPE & dualiso_data, ISOSURFACE_TYPE & dual_isosurface,
+   IJK::WALL_CPU_TIME * thread_time)
+  {
+    const int DIM3(3);
+    const int NUM_VERT_PER_QUAD = 4;
+    const int dimension = dualiso_data.ScalarGrid().Dimension();
+    const int numv_per_iso_poly = dual_isosurface.NumVerticesPerIsoPoly();
+    const COORD_TYPE max_small_magnitude = dualiso_data.MaxSmallMagnitude();
+    const QUAD_TRI_METHOD quad_tri_method = 
+      dualiso_data.QuadTriangulationMethod();
+    IJK::PROCEDURE_ERROR error("convert_quad_to_tri_in_place");
+
+    if (numv_per_iso_poly != NUM_VERT_PER_QUAD) {
+      error.AddMessage("Number of vertices per isosurface polygon is ",
+                       numv_per_iso_poly, ".");
+      error.AddMessage("Number of vertices per isosurface polygon must be ",
+                       NUM_VERT_PER_QUAD, ".");
+      throw error;
+    }
+
+    if (dimension != DIM3) {
+      error.AddMessage("Illegal dimension ", dimension, ".");
+      error.AddMessage("  Triangulation in place requires dimension 3.");
+      throw error;
+    }
+
+    if (dualiso_data.flag_tri4_quad) {
+      error.AddMessage
+        ("Programming error.  Triangulation in place does not add vertices.");
+      error.AddMessage("  Call convert_quad_to_tri when flag_tri4_quad is true.");
+      throw error;
+    }
+
+    // Dual edges are not needed for the triangulation.  Free them first.
+    typename ISOSURFACE_TYPE::ISOPOLY_INFO_ARRAY().swap
+      (dual_isosurface.isopoly_info);
+
+    IJK::QUAD_TRI_METHOD_3D method_3D = IJK::QUAD_TRI_UNIFORM_3D;
+    if (quad_tri_method == MAX_MIN_ANGLE)
+      { method_3D = IJK::QUAD_TRI_MAX_MIN_ANGLE_3D; }
+    else if (quad_tri_method == SPLIT_MAX_ANGLE)
+      { method_3D = IJK::QUAD_TRI_SPLIT_MAX_ANGLE_3D; }
+
+    ISO_VERTEX_INDEX_ARRAY & quad_tri_vert = dual_isosurface.isopoly_vert;
+    IJK::reorder_quad_vertices(quad_tri_vert);
+    IJK::triangulate_quad_batch_3D_in_place
+      (dual_isosurface.vertex_coord, method_3D, max_small_magnitude, 
+       quad_tri_vert, thread_time);
+
+    if (dual_isosurface.tri_vert.size() == 0) 
+      { dual_isosurface.tri_vert.swap(quad_tri_vert); }
+    else {
+      dual_isosurface.tri_vert.insert
+        (dual_isosurface.tri_vert.end(), 
+         quad_tri_vert.begin(), quad_tri_vert.end());
+    }
+
+    ISO_VERTEX_INDEX_ARRAY().swap(quad_tri_vert);
+  }
+
+
+  // **************************************************
+  // REORDER FOR VERTEX CACHE
+  // **************************************************
+
+  /// Reorder isosurface triangles and vertices for vertex cache locality.
+  /// - Reorder triangles using IJK::reorder_triangles_vertex_cache.
+  /// - Renumber vertices in order of first reference by the triangles.
+  /// - Vertices of any remaining isosurface polygons are renumbered to match.
+  template <typename DATA_TYPE, typename ISOSURFACE_TYPE>
+  void reorder_isosurface_for_vertex_cache
+  (const DATA_TYPE & dualiso_data, ISOSURFACE_TYPE & dual_isosurface)
+  {
+    const int dimension = dualiso_data.ScalarGrid().Dimension();
+    const int cache_size = dualiso_data.VertexCacheSize();
+    const VERTEX_INDEX numv = dual_isosurface.NumIsoVert();
+    ISO_VERTEX_INDEX_ARRAY & tri_vert = dual_isosurface.tri_vert;
+    ISO_VERTEX_INDEX_ARRAY & isopoly_vert = dual_isosurface.isopoly_vert;
+    std::vector<ISO_VERTEX_INDEX> new_index;
+    IJK::PROCEDURE_ERROR error("reorder_isosurface_for_vertex_cache");
+
+    if (cache_size < 1) {
+      error.AddMessage("Illegal vertex cache size ", cache_size, ".");
+      error.AddMessage("  Vertex cache size must be positive.");
+      throw error;
+    }
+
+    IJK::reorder_triangles_vertex_cache(numv, cache_size, tri_vert);
+    IJK::reorder_vertices_by_first_reference
+      (dimension, dual_isosurface.vertex_coord, tri_vert, new_index);
+
+    for (ISO_VERTEX_INDEX_ARRAY::size_type j = 0; j < isopoly_vert.size(); j++)
+      { isopoly_vert[j] = new_index[isopoly_vert[j]]; }
+  }
+
 }
 
 #endif
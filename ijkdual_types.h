@@ -37,13 +37,45 @@ namespace IJKDUAL {
 // **************************************************
 
   typedef float SCALAR_TYPE;     ///< Scalar value type.
+
+  // Scalar grid storage type.
+  // Isovalues, interpolation and vertex positions use SCALAR_TYPE.
+#if defined(IJKDUAL_GRID_SCALAR_UINT8)
+  typedef unsigned char GRID_SCALAR_TYPE;   ///< Grid scalar type.
+#elif defined(IJKDUAL_GRID_SCALAR_INT16)
+  typedef short GRID_SCALAR_TYPE;           ///< Grid scalar type.
+#elif defined(IJKDUAL_GRID_SCALAR_UINT16)
+  typedef unsigned short GRID_SCALAR_TYPE;  ///< Grid scalar type.
+#else
+  typedef float GRID_SCALAR_TYPE;           ///< Grid scalar type.
+#endif
+
   typedef float COORD_TYPE;      ///< Isosurface vertex coordinate type.
-  typedef int VERTEX_INDEX;      ///< Grid vertex index type.
   typedef float GRADIENT_TYPE;   ///< Gradient coordinate type.
   typedef int GRID_COORD_TYPE;   ///< Grid vertex coordinate type.
   typedef int AXIS_SIZE_TYPE;    ///< Axis size type.
-  typedef int ISO_VERTEX_INDEX;  ///< Isosurface vertex index type.
-  typedef int MERGE_INDEX;       ///< Merge index type.
+
+#ifdef IJKDUAL_64BIT_INDEX
+
+  // Grids with 2^31 or more vertices.
+  typedef long long VERTEX_INDEX;      ///< Grid vertex index type.
+
+#else
+
+  typedef int VERTEX_INDEX;      ///< Grid vertex index type.
+
+#endif
+
+  /// Isosurface vertex index type.
+  /// - Stays 32 bits with IJKDUAL_64BIT_INDEX.  Isosurfaces have far
+  ///   fewer vertices than the grid.
+  /// - Lists of grid cubes, including isosurface polytope lists
+  ///   before merging, use VERTEX_INDEX.
+  typedef int ISO_VERTEX_INDEX;
+
+  /// Merge index type.  Location in a list of merged objects.
+  /// - Merge identifiers are grid cube or edge indices of type VERTEX_INDEX.
+  typedef int MERGE_INDEX;
 
   // *** SHOULD CHANGE TO unsigned char ***
   typedef int DIRECTION_TYPE;    ///< Direction type.
@@ -73,6 +105,8 @@ namespace IJKDUAL {
   typedef std::vector<COORD_TYPE> COORD_ARRAY;   ///< Grid coordinate array.
   typedef std::vector<VERTEX_INDEX>              /// Vertex index array.
     VERTEX_INDEX_ARRAY; 
+  typedef std::vector<ISO_VERTEX_INDEX>          /// Isosurface vertex array.
+    ISO_VERTEX_INDEX_ARRAY;
   typedef std::vector<SCALAR_TYPE> SCALAR_ARRAY; ///< Scalar array.
 
   /// Array of facet vertex indices.
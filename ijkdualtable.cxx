@@ -61,29 +61,6 @@ ISODUAL_TABLE::ISODUAL_TABLE_ENTRY::ISODUAL_TABLE_ENTRY()
   is_bipolar = NULL;
 }
 
-ISODUAL_TABLE::ISODUAL_TABLE_ENTRY::~ISODUAL_TABLE_ENTRY()
-  // destructor
-{
-  FreeAll();
-}
-
-void ISODUAL_TABLE::ISODUAL_TABLE_ENTRY::Allocate
-(const int num_poly_edges)
-{
-  if (incident_isovertex != NULL) {
-    delete [] incident_isovertex; 
-    incident_isovertex = NULL;
-  }
-
-  if (is_bipolar != NULL) {
-    delete [] is_bipolar;
-    is_bipolar = NULL;
-  }
-
-  incident_isovertex = new ISODUAL_VERTEX_INDEX[num_poly_edges];
-  is_bipolar = new bool[num_poly_edges];
-}
-
 bool ISODUAL_TABLE::ISODUAL_TABLE_ENTRY::Check
 (ERROR & error_msg) const
 {
@@ -106,16 +83,6 @@ bool ISODUAL_TABLE::ISODUAL_TABLE_ENTRY::Check
   return(true);
 }
 
-// Free all memory.
-void ISODUAL_TABLE::ISODUAL_TABLE_ENTRY::FreeAll()
-{
-  delete [] incident_isovertex;
-  incident_isovertex = NULL;
-  delete [] is_bipolar;
-  is_bipolar = NULL;
-  num_vertices = 0;
-}
-
 // default constructor. dimension = 3
 ISODUAL_TABLE::ISODUAL_TABLE()
 {
@@ -140,6 +107,8 @@ void ISODUAL_TABLE::Init(const int dimension)
 
   num_table_entries = 0;
   entry = NULL;
+  incident_isovertex_array = NULL;
+  is_bipolar_array = NULL;
   is_table_allocated = false;
 
   SetDimension(dimension);
@@ -198,18 +167,21 @@ void ISODUAL_TABLE::SetNumTableEntries(const int num_table_entries)
 {
   const char * procname = "ISODUAL_TABLE::SetNumTableEntries";
 
-  if (entry != NULL) delete [] entry;
-  entry = NULL;
-  this->num_table_entries = 0;
-  is_table_allocated = false;
+  FreeAll();
 
   entry = new ISODUAL_TABLE_ENTRY[num_table_entries];
   if (entry == NULL && num_table_entries > 0)
     throw PROCEDURE_ERROR
       (procname, "Unable to allocate memory for dual isosurface table.");
 
+  const long array_length = long(num_table_entries)*NumPolyEdges();
+  incident_isovertex_array = new ISODUAL_VERTEX_INDEX[array_length];
+  is_bipolar_array = new bool[array_length];
+
   for (int i = 0; i < num_table_entries; i++) {
-    entry[i].Allocate(NumPolyEdges());
+    entry[i].incident_isovertex = 
+      incident_isovertex_array + long(i)*NumPolyEdges();
+    entry[i].is_bipolar = is_bipolar_array + long(i)*NumPolyEdges();
   }
 
   this->num_table_entries = num_table_entries;
@@ -278,12 +250,12 @@ bool ISODUAL_TABLE::Check(ERROR & error_msg) const
 void ISODUAL_TABLE::FreeAll()
   // free all memory
 {
-  if (entry != NULL) {
-    for (int i = 0; i < num_table_entries; i++)
-      { entry[i].FreeAll(); }
-    delete [] entry;
-    entry = NULL;
-  };
+  delete [] entry;
+  entry = NULL;
+  delete [] incident_isovertex_array;
+  incident_isovertex_array = NULL;
+  delete [] is_bipolar_array;
+  is_bipolar_array = NULL;
   num_table_entries = 0;
   is_table_allocated = false;
 }
@@ -357,39 +329,51 @@ void ISODUAL_CUBE_TABLE::Create(const int dimension)
 void ISODUAL_CUBE_TABLE::CreateTableEntries
 (const bool flag_separate_neg, const bool flag_separate_opposite)
 {
+  typedef CUBE_VERTEX_COMPONENTS::CUBE_VERTEX_SET CUBE_VERTEX_SET;
 
   this->flag_separate_neg = flag_separate_neg;
   this->flag_always_separate_opposite = flag_separate_opposite;
 
-  FIND_COMPONENT find_component(Dimension());
+  CUBE_VERTEX_COMPONENTS cube_components(Dimension());
   IJK::CUBE_FACE_INFO<int, int, int> cube(Dimension());
+  std::vector<CUBE_VERTEX_SET> component_list;
+  std::vector<int> component(NumPolyVertices(), 0);
+  std::vector<int> edge_endpoint(2*cube.NumEdges());
+
+  for (int ie = 0; ie < cube.NumEdges(); ie++) {
+    edge_endpoint[2*ie] = cube.EdgeEndpoint(ie, 0);
+    edge_endpoint[2*ie+1] = cube.EdgeEndpoint(ie, 1);
+  }
 
   bool flag_separate_pos = (!flag_separate_neg);
   for (TABLE_INDEX ientry = 0; ientry < NumTableEntries(); ientry++) {
 
-    find_component.ClearAll();
-    find_component.SetVertexFlags(ientry);
+    // Bit i of vertex_flag is the flag of vertex i.
+    CUBE_VERTEX_SET vertex_flag = cube_components.VertexSet(ientry, true);
 
     if (flag_separate_opposite) {
       if (flag_separate_neg) {
         if (is_two_opposite_ones(ientry, NumPolyVertices()))
-          { find_component.NegateVertexFlags(); };
+          { vertex_flag = cube_components.AllVertices() & ~vertex_flag; };
       }
       else {
         if (is_two_opposite_zeros(ientry, NumPolyVertices()))
-          { find_component.NegateVertexFlags(); };
+          { vertex_flag = cube_components.AllVertices() & ~vertex_flag; };
       }
     }
 
+    // Components of vertices whose flag equals flag_separate_pos,
+    //   numbered in order of their lowest vertex.
+    CUBE_VERTEX_SET vset = vertex_flag;
+    if (!flag_separate_pos) 
+      { vset = cube_components.AllVertices() & ~vertex_flag; }
+    cube_components.GetComponents(vset, component_list);
 
-    int num_components(0);
+    const int num_components = component_list.size();
     for (int i = 0; i < NumPolyVertices(); i++) {
-      if (find_component.Component(i) == 0) {
-
-        if (find_component.VertexFlag(i) == flag_separate_pos) {
-          num_components++;
-          find_component.Search(i, num_components);
-        }
+      for (int icomp = 0; icomp < num_components; icomp++) {
+        if ((component_list[icomp] >> i) & 1UL) 
+          { component[i] = icomp; }
       }
     }
 
@@ -397,21 +381,23 @@ void ISODUAL_CUBE_TABLE::CreateTableEntries
     entry[ientry].num_vertices = num_components;
 
     for (int ie = 0; ie < cube.NumEdges(); ie++) {
-      int iv0 = cube.EdgeEndpoint(ie, 0);
-      int iv1 = cube.EdgeEndpoint(ie, 1);
+      int iv0 = edge_endpoint[2*ie];
+      int iv1 = edge_endpoint[2*ie+1];
+      const bool flag0 = ((vertex_flag >> iv0) & 1UL);
+      const bool flag1 = ((vertex_flag >> iv1) & 1UL);
 
-      if (find_component.VertexFlag(iv0) == find_component.VertexFlag(iv1)) {
+      if (flag0 == flag1) {
         entry[ientry].is_bipolar[ie] = false;
         entry[ientry].incident_isovertex[ie] = 0;
       }
       else {
         entry[ientry].is_bipolar[ie] = true;
-        int icomp = find_component.Component(iv0);
-        if (find_component.VertexFlag(iv1) == flag_separate_pos) {
+        int icomp = component[iv0];
+        if (flag1 == flag_separate_pos) {
           // Vertex iv1 is negative.
-          icomp = find_component.Component(iv1);
+          icomp = component[iv1];
         }
-        entry[ientry].incident_isovertex[ie] = icomp-1;
+        entry[ientry].incident_isovertex[ie] = icomp;
       }
     }
 
@@ -488,28 +474,60 @@ void ISODUAL_CUBE_TABLE_AMBIG::Alloc()
 
 
 /// Compute ambiguity information.
+/// - Same as is_cube_ambiguous() and compute_ambiguous_cube_facets(),
+///   but computes the positive and negative components
+///   of each entry once using bit operations.
 void ISODUAL_CUBE_TABLE_AMBIG::ComputeAmbiguityInformation()
 {
+  typedef CUBE_VERTEX_COMPONENTS::CUBE_VERTEX_SET CUBE_VERTEX_SET;
+
   const int num_cube_facets = IJK::compute_num_cube_facets(dimension);
-  FIND_COMPONENT find_component(dimension);
+  CUBE_VERTEX_COMPONENTS cube_components(dimension);
+  std::vector<CUBE_VERTEX_SET> pos_component;
+  std::vector<CUBE_VERTEX_SET> neg_component;
 
   for (TABLE_INDEX ientry = 0; ientry < num_table_entries; ientry++) {
-    is_ambiguous[ientry] = is_cube_ambiguous(ientry, find_component);
-
-    compute_ambiguous_cube_facets
-      (ientry, num_cube_facets, ambiguous_facet[ientry], 
-       num_ambiguous_facets[ientry], find_component);
+    cube_components.GetComponents
+      (cube_components.VertexSet(ientry, true), pos_component);
+    cube_components.GetComponents
+      (cube_components.VertexSet(ientry, false), neg_component);
+
+    is_ambiguous[ientry] = 
+      (pos_component.size() > 1 || neg_component.size() > 1);
+
+    ambiguous_facet[ientry] = 0;
+    num_ambiguous_facets[ientry] = 0;
+    for (int kf = 0; kf < num_cube_facets; kf++) {
+      const int num_pos_components =
+        cube_components.CountComponentsMeetingFacet(pos_component, kf);
+      const int num_neg_components =
+        cube_components.CountComponentsMeetingFacet(neg_component, kf);
+      if (num_pos_components > 1 || num_neg_components > 1) {
+        ambiguous_facet[ientry] |= (FACET_SET(1) << kf);
+        num_ambiguous_facets[ientry]++;
+      }
+    }
   }
 }
 
 /// Compute number of active facets.
 void ISODUAL_CUBE_TABLE_AMBIG::ComputeNumActiveFacets()
 {
-  ISODUAL_CUBE_FACE_INFO<int,int,int> cube_face_info(dimension);
+  typedef CUBE_VERTEX_COMPONENTS::CUBE_VERTEX_SET CUBE_VERTEX_SET;
+
+  const int num_cube_facets = IJK::compute_num_cube_facets(dimension);
+  CUBE_VERTEX_COMPONENTS cube_components(dimension);
 
   for (TABLE_INDEX ientry = 0; ientry < num_table_entries; ientry++) {
-    num_active_facets[ientry] = 
-      cube_face_info.ComputeNumActiveCubeFacets(ientry);
+    const CUBE_VERTEX_SET pos = cube_components.VertexSet(ientry, true);
+    const CUBE_VERTEX_SET neg = cube_components.VertexSet(ientry, false);
+
+    num_active_facets[ientry] = 0;
+    for (int kf = 0; kf < num_cube_facets; kf++) {
+      const CUBE_VERTEX_SET facet = cube_components.FacetVertices(kf);
+      if ((pos & facet) != 0 && (neg & facet) != 0)
+        { num_active_facets[ientry]++; }
+    }
   }
 }
 
@@ -714,6 +732,72 @@ int FIND_COMPONENT::ComputeNumComponentsInFacet
 }
 
 
+// **************************************************
+// CLASS CUBE_VERTEX_COMPONENTS
+// **************************************************
+
+CUBE_VERTEX_COMPONENTS::CUBE_VERTEX_COMPONENTS(const int dimension)
+{
+  const int num_facets = IJK::compute_num_cube_facets(dimension);
+
+  this->dimension = dimension;
+  num_cube_vertices = 1L << dimension;
+
+  if (num_cube_vertices > int(8*sizeof(CUBE_VERTEX_SET))) {
+    IJK::PROCEDURE_ERROR error("CUBE_VERTEX_COMPONENTS");
+    error.AddMessage("Illegal dimension ", dimension, ".");
+    error.AddMessage("  Cube has too many vertices for bit operations.");
+    throw error;
+  }
+
+  vertices_with_bit.assign(dimension, 0);
+  facet_vertices.assign(num_facets, 0);
+  for (int i = 0; i < num_cube_vertices; i++) {
+    const CUBE_VERTEX_SET mask = (CUBE_VERTEX_SET(1) << i);
+
+    for (int d = 0; d < dimension; d++) {
+      if ((i >> d) & 1) { vertices_with_bit[d] |= mask; }
+    }
+
+    for (int kf = 0; kf < num_facets; kf++) {
+      if (IJK::cube_facet_contains(dimension, kf, i))
+        { facet_vertices[kf] |= mask; }
+    }
+  }
+}
+
+// Get components of vset in order of their lowest vertex.
+void CUBE_VERTEX_COMPONENTS::GetComponents
+(const CUBE_VERTEX_SET vset, 
+ std::vector<CUBE_VERTEX_SET> & component_list) const
+{
+  CUBE_VERTEX_SET rest = vset;
+
+  component_list.clear();
+  while (rest != 0) {
+    const CUBE_VERTEX_SET seed = (rest & (~rest+1));
+    const CUBE_VERTEX_SET vcomp = Component(rest, seed);
+    component_list.push_back(vcomp);
+    rest = (rest & ~vcomp);
+  }
+}
+
+// Return number of sets in component_list which intersect facet kf.
+int CUBE_VERTEX_COMPONENTS::CountComponentsMeetingFacet
+(const std::vector<CUBE_VERTEX_SET> & component_list, const int kf) const
+{
+  const CUBE_VERTEX_SET facet = facet_vertices[kf];
+  int num_components(0);
+
+  for (int j = 0; j < int(component_list.size()); j++) {
+    if ((component_list[j] & facet) != 0)
+      { num_components++; }
+  }
+
+  return(num_components);
+}
+
+
 //**************************************************
 // AMBIGUITY ROUTINES
 //**************************************************
@@ -24,6 +24,8 @@
 #ifndef _IJKDUALTABLE_
 #define _IJKDUALTABLE_
 
+#include <vector>
+
 #include "ijk.txx"
 #include "ijkcube.txx"
 
@@ -40,6 +42,7 @@ namespace IJKDUALTABLE {
 
   // Forward definition.
   class FIND_COMPONENT;
+  class CUBE_VERTEX_COMPONENTS;
   
   // **************************************************
   // COMPUTE FUNCTIONS
@@ -63,12 +66,14 @@ namespace IJKDUALTABLE {
   protected:
 
     /// Entry in the dual isosurface lookup table.
+    /// - Arrays incident_isovertex[] and is_bipolar[] point into
+    ///   arrays owned by the table, so that all entries are stored
+    ///   in two contiguous blocks of memory.
     class ISODUAL_TABLE_ENTRY {
 
     public:
       int num_vertices;           ///< Number of dualiso vertices in cube.
       ISODUAL_TABLE_ENTRY();      ///< constructor
-      ~ISODUAL_TABLE_ENTRY();     ///< destructor
 
       /// incident_isovertex[kf] = Isosurface vertex incident on face kf.
       ///       Face kf is dual to polytope edge kf.
@@ -78,11 +83,7 @@ namespace IJKDUALTABLE {
       ///       Cube edge ke is dual to isosurface face kf.
       bool * is_bipolar;
 
-      /// Allocate incident_isovert[] and is_bipolar[].
-      void Allocate(const int num_poly_edges);
-
       bool Check(IJK::ERROR & error_msg) const;
-      void FreeAll();                            // free all memory
     };
 
 
@@ -101,6 +102,14 @@ namespace IJKDUALTABLE {
     ISODUAL_TABLE_ENTRY * entry;    ///< Array of dual isosurface table entries.
     long num_table_entries;         ///< Number of entries in table.
 
+    /// Incident isosurface vertices of all table entries.
+    /// Entry it uses incident_isovertex_array[it*num_poly_edges+ke].
+    ISODUAL_VERTEX_INDEX * incident_isovertex_array;
+
+    /// Bipolar edge flags of all table entries.
+    /// Entry it uses is_bipolar_array[it*num_poly_edges+ke].
+    bool * is_bipolar_array;
+
     /// Maximum number of vertices allowed for cube.
     int max_num_vertices; 
 
@@ -114,7 +123,7 @@ namespace IJKDUALTABLE {
   public:
     ISODUAL_TABLE();
     ISODUAL_TABLE(const int d);
-    ~ISODUAL_TABLE();                ///< Destructor
+    virtual ~ISODUAL_TABLE();        ///< Destructor
 
     // Get functions.
     int Dimension() const            ///< Return dimension.
@@ -347,6 +356,91 @@ namespace IJKDUALTABLE {
   };
 
 
+  // **************************************************
+  // CLASS CUBE_VERTEX_COMPONENTS
+  // **************************************************
+
+  /// Find connected components of sets of cube vertices
+  ///   using bit operations.
+  /// - Bit i of a CUBE_VERTEX_SET represents cube vertex i.
+  /// - Each step adds the neighbors of all vertices in a component
+  ///   in one direction, instead of searching one vertex at a time
+  ///   as in FIND_COMPONENT.
+  class CUBE_VERTEX_COMPONENTS {
+
+  public:
+    typedef unsigned long CUBE_VERTEX_SET;  ///< Bits representing vertices.
+
+  protected:
+    int dimension;
+    int num_cube_vertices;
+
+    /// vertices_with_bit[d] = Cube vertices with d'th coordinate 1.
+    std::vector<CUBE_VERTEX_SET> vertices_with_bit;
+
+    /// facet_vertices[kf] = Vertices of cube facet kf.
+    std::vector<CUBE_VERTEX_SET> facet_vertices;
+
+  public:
+    /// @pre 2^dimension is at most the number of bits
+    ///   in CUBE_VERTEX_SET.
+    CUBE_VERTEX_COMPONENTS(const int dimension);
+
+    // get functions
+    int Dimension() const
+    { return(dimension); }
+    int NumCubeVertices() const
+    { return(num_cube_vertices); }
+    CUBE_VERTEX_SET AllVertices() const
+    { return(CUBE_VERTEX_SET(~0UL) >> 
+             (8*sizeof(CUBE_VERTEX_SET)-num_cube_vertices)); }
+    CUBE_VERTEX_SET FacetVertices(const int kf) const
+    { return(facet_vertices[kf]); }
+
+    /// Return vertex set of table entry ientry, complemented
+    ///   if flag_positive is false.
+    CUBE_VERTEX_SET VertexSet
+    (const TABLE_INDEX ientry, const bool flag_positive) const
+    {
+      const CUBE_VERTEX_SET vset = CUBE_VERTEX_SET(ientry);
+      if (flag_positive) { return(vset); }
+      else { return(AllVertices() & ~vset); }
+    }
+
+    /// Return component of vset containing seed.
+    /// @pre seed is a subset of vset.
+    CUBE_VERTEX_SET Component
+    (const CUBE_VERTEX_SET vset, const CUBE_VERTEX_SET seed) const
+    {
+      CUBE_VERTEX_SET component = seed;
+      CUBE_VERTEX_SET prev;
+      do {
+        prev = component;
+        for (int d = 0; d < dimension; d++) {
+          const CUBE_VERTEX_SET upper = vertices_with_bit[d];
+          const int shift = (1 << d);
+          component |= vset & 
+            (((component & ~upper) << shift) | ((component & upper) >> shift));
+        }
+      } while (component != prev);
+
+      return(component);
+    }
+
+    /// Get components of vset in order of their lowest vertex.
+    void GetComponents
+    (const CUBE_VERTEX_SET vset, 
+     std::vector<CUBE_VERTEX_SET> & component_list) const;
+
+    /// Return number of sets in component_list which intersect facet kf.
+    /// - Components of vset which intersect facet kf are counted,
+    ///   not components of vset restricted to facet kf,
+    ///   as in FIND_COMPONENT::ComputeNumComponentsInFacet.
+    int CountComponentsMeetingFacet
+    (const std::vector<CUBE_VERTEX_SET> & component_list, const int kf) const;
+  };
+
+
   // **************************************************
   // CLASS ISODUAL_CUBE_FACE_INFO
   // *************************************************
@@ -5415,7 +5415,7 @@ namespace IJK {
     }
 
     if (grid.Dimension() == 1 && flag_dim1_facet_vertex)
-      { numv = std::max(numv, 1); };
+      { numv = std::max(numv, VTYPE(1)); };
 
     this->AllocateList(numv);
     GetVertices(grid, orth_dir, flag_dim1_facet_vertex);
@@ -5437,7 +5437,7 @@ namespace IJK {
        numv);
 
     if (grid.Dimension() == 1 && flag_dim1_facet_vertex)
-      { numv = std::max(numv, 1); };
+      { numv = std::max(numv, VTYPE(1)); };
 
     if (numv > this->ListLength()) 
       { this->AllocateList(numv); }
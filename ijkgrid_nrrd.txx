@@ -24,6 +24,7 @@
 #ifndef _IJKGRID_NRRD_
 #define _IJKGRID_NRRD_
 
+#include <limits>
 #include <string>
 
 #include "ijk.txx"
@@ -911,6 +912,40 @@ namespace IJK {
 
     size_t size[NRRD_DIM_MAX];
     nrrdAxisInfoGet_nva(this->data, nrrdAxisInfoSize, size);
+
+    // Check that grid vertex indices fit in the grid vertex index type.
+    typedef typename SCALAR_GRID::VERTEX_INDEX_TYPE VTYPE;
+    double num_vertices = 1;
+    for (DTYPE d = 0; d < dimension; d++) 
+      { num_vertices *= double(size[d]); }
+    if (num_vertices > double(std::numeric_limits<VTYPE>::max())) {
+      read_failed = true;
+      read_error.AddMessage("Error reading: ", input_filename);
+      read_error.AddMessage
+        ("  Number of grid vertices ", num_vertices, 
+         " exceeds maximum vertex index ", 
+         std::numeric_limits<VTYPE>::max(), ".");
+      read_error.AddMessage
+        ("  Recompile with a 64-bit vertex index type.");
+      return;
+    }
+
+    // Integer grids store nrrd data without rounding or clamping.
+    typedef typename SCALAR_GRID::SCALAR_TYPE STYPE;
+    const int grid_nrrd_type = NRRD_SCALAR_TYPE<STYPE>::value;
+    if (grid_nrrd_type != nrrdTypeUnknown && 
+        this->data->type != grid_nrrd_type) {
+      read_failed = true;
+      read_error.AddMessage("Error reading: ", input_filename);
+      read_error.AddMessage
+        ("  Nrrd type ", airEnumStr(nrrdType, this->data->type),
+         " does not match grid scalar type ", 
+         airEnumStr(nrrdType, grid_nrrd_type), ".");
+      read_error.AddMessage
+        ("  Recompile with a matching scalar grid type.");
+      return;
+    }
+
     grid.SetSize(dimension, size);
     nrrd2scalar(this->data, grid.ScalarPtr());
   }
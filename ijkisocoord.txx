@@ -29,6 +29,7 @@
 #include "ijk.txx"
 #include "ijkcoord.txx"
 #include "ijkinterpolate.txx"
+#include "ijktime.txx"
 
 namespace IJK {
 
@@ -129,13 +130,15 @@ namespace IJK {
   ///    and direction grid_edge[i].Direction().
   /// @param[out] coord[] Array of isosurface vertex coordinates.
   ///  coord[i*dimension+j] = j'th coordinate of vertex i'th vertex
+  /// @param thread_time If not NULL, add wall clock time of each thread.
   /// @pre Array coord[] is preallocated to length at least
   ///    dimension*(grid_edge.size()/2).
   template <typename SGRID_TYPE, typename ISOVALUE_TYPE,
             typename GRID_EDGE_TYPE, typename CTYPE>
   void compute_isov_coord_on_grid_edge_linear
   (const SGRID_TYPE & scalar_grid, const ISOVALUE_TYPE isovalue,
-   const std::vector<GRID_EDGE_TYPE> & grid_edge, CTYPE * coord)
+   const std::vector<GRID_EDGE_TYPE> & grid_edge, CTYPE * coord,
+   WALL_CPU_TIME * thread_time)
   {
     typedef typename SGRID_TYPE::DIMENSION_TYPE DTYPE;
     typedef typename SGRID_TYPE::NUMBER_TYPE NTYPE;
@@ -143,9 +146,15 @@ namespace IJK {
     const DTYPE dimension = scalar_grid.Dimension();
     const NTYPE nume = grid_edge.size();
 
-    for (NTYPE i = 0; i < nume; i++) {
-      compute_isov_coord_on_grid_edge_linear
-        (scalar_grid, isovalue, grid_edge[i], coord+dimension*i);
+#pragma omp parallel
+    {
+      IJK::SCOPED_THREAD_TIMER thread_timer(thread_time);
+
+#pragma omp for schedule(static)
+      for (NTYPE i = 0; i < nume; i++) {
+        compute_isov_coord_on_grid_edge_linear
+          (scalar_grid, isovalue, grid_edge[i], coord+dimension*i);
+      }
     }
   }
 
@@ -103,6 +103,23 @@ namespace IJK {
     };
   }
 
+  /// Compute isosurface table index of polyhedron with primary vertex iv0.
+  /// Number of polyhedron vertices NUMV is a compile time constant,
+  ///   so the loop is unrolled and branch free.
+  template <int NUMV, typename STYPE, typename STYPE2, typename VTYPE,
+            typename INC_TYPE, typename ITYPE>
+  inline void compute_isotable_index_fixed
+  (const STYPE * scalar, const STYPE2 isovalue,
+   const VTYPE iv0, const INC_TYPE * increment, ITYPE & it)
+  {
+    ITYPE it2 = 0;
+    for (int j = 0; j < NUMV; j++) {
+      const ITYPE bit = (scalar[iv0+increment[j]] >= isovalue);
+      it2 = (it2 | (bit << j));
+    }
+    it = it2;
+  }
+
   /// Compute isosurface table index of polyhedron
   template <typename STYPE, typename STYPE2, typename NTYPE, typename ITYPE>
   void compute_isotable_index
@@ -118,6 +135,28 @@ namespace IJK {
   }
 
 
+  /// For each cube, compute isosurface table index and the number 
+  ///   of isosurface vertices in the cube.
+  /// Version for cubes with a fixed number, NUMV, of vertices.
+  /// @pre scalar_grid.NumCubeVertices() == NUMV.
+  template <int NUMV, typename GRID_TYPE, typename ISODUAL_TABLE,
+            typename SCALAR_TYPE, typename GRID_CUBE_TYPE>
+  void compute_cube_isotable_info_fixed
+  (const GRID_TYPE & scalar_grid, const ISODUAL_TABLE & isodual_table,
+   const SCALAR_TYPE isovalue, 
+   std::vector<GRID_CUBE_TYPE> & cube_list)
+  {
+    typedef typename std::vector<GRID_CUBE_TYPE>::size_type SIZE_TYPE;
+
+    for (SIZE_TYPE i = 0; i < cube_list.size(); i++) {
+      compute_isotable_index_fixed<NUMV>
+        (scalar_grid.ScalarPtrConst(), isovalue, cube_list[i].cube_index,
+         scalar_grid.CubeVertexIncrement(), cube_list[i].table_index);
+      cube_list[i].num_isov = 
+        isodual_table.NumIsoVertices(cube_list[i].table_index);
+    }
+  }
+
   /// For each cube, compute isosurface table index and the number 
   ///   of isosurface vertices in the cube.
   template <typename GRID_TYPE, typename ISODUAL_TABLE,
@@ -131,6 +170,18 @@ namespace IJK {
  
     const NUMBER_TYPE num_cube_vertices = scalar_grid.NumCubeVertices();
 
+    // Unrolled versions for 3D and 4D cubes.
+    if (num_cube_vertices == 8) {
+      compute_cube_isotable_info_fixed<8>
+        (scalar_grid, isodual_table, isovalue, cube_list);
+      return;
+    }
+    else if (num_cube_vertices == 16) {
+      compute_cube_isotable_info_fixed<16>
+        (scalar_grid, isodual_table, isovalue, cube_list);
+      return;
+    }
+
     for (NUMBER_TYPE i = 0; i < cube_list.size(); i++) {
       compute_isotable_index
         (scalar_grid.ScalarPtrConst(), isovalue, cube_list[i].cube_index,
@@ -665,6 +716,43 @@ namespace IJK {
     }
   }
 
+  /// Set dual isosurface polytope around an edge.
+  /// - Writes grid.NumFacetVertices() isosurface polytope vertices
+  ///   to iso_poly[].  Does not allocate memory.
+  /// - If facet_vertex is not NULL, writes location of each
+  ///   isosurface vertex on facet to facet_vertex[].
+  /// @param flag_reverse_orient If true, reverse polytope orientation.
+  /// @pre Edge (iend0, iend1) is an interior edge with direction \a edge_dir.
+  /// @pre iso_poly[] (and facet_vertex[], if not NULL) have
+  ///   room for grid.NumFacetVertices() entries.
+  template <typename GRID_TYPE, typename VTYPE,
+            typename DTYPE, typename ISOV_TYPE, typename FACETV_TYPE>
+  inline void set_dual_isopoly_around_edge
+  (const GRID_TYPE & grid, const VTYPE iend0, const DTYPE edge_dir, 
+   const bool flag_reverse_orient,
+   ISOV_TYPE * iso_poly, FACETV_TYPE * facet_vertex)
+  {
+    typedef typename GRID_TYPE::NUMBER_TYPE NUM_TYPE;
+
+    const NUM_TYPE num_facet_vertices = grid.NumFacetVertices();
+
+    if (num_facet_vertices == 0) { return; };
+
+    // Reverse orientation starts with the last half of the vertices.
+    NUM_TYPE kstart = 0;
+    if (flag_reverse_orient) { kstart = num_facet_vertices/2; }
+
+    VTYPE iv0 = 
+      iend0 - grid.FacetVertexIncrement(edge_dir,num_facet_vertices-1);
+
+    for (NUM_TYPE j = 0; j < num_facet_vertices; j++) {
+      const NUM_TYPE k = (j + kstart)%num_facet_vertices;
+      iso_poly[j] = grid.FacetVertex(iv0, edge_dir, k);
+      if (facet_vertex != NULL) 
+        { facet_vertex[j] = edge_dir*num_facet_vertices+k; }
+    }
+  }
+
   /// Extract dual isosurface polytope around bipolar edge.
   /// Checks that edge is bipolar.
   /// Returns list of isosurface polytope vertices.
@@ -1037,6 +1125,22 @@ namespace IJK {
     }
   }
 
+  /// Return true if cube_index is in cube_list and set i to its location.
+  /// - Entries of index_to_cube_list for cubes not in cube_list
+  ///   are arbitrary.  Cubes adjacent to the region of interest
+  ///   are not in cube_list.
+  template <typename CTYPE, typename ILIST_TYPE, typename GRID_CUBE_TYPE,
+            typename ITYPE>
+  bool find_cube_list_index
+  (const CTYPE cube_index, const ILIST_TYPE & index_to_cube_list,
+   const std::vector<GRID_CUBE_TYPE> & cube_list, ITYPE & i)
+  {
+    i = index_to_cube_list[cube_index];
+    if (i < cube_list.size() && cube_list[i].cube_index == cube_index)
+      { return(true); }
+    return(false);
+  }
+
 
   /// Split isosurface vertex pairs which create non-manifold edges.
   ///   - Cubes containing vertices have only one ambiguous facet.
@@ -1081,7 +1185,10 @@ namespace IJK {
 
             VTYPE cube_index1 =
               grid.AdjacentVertex(cube_index0, orth_dir, side);
-            SIZE_TYPE i1 = index_to_cube_list[cube_index1];
+            SIZE_TYPE i1;
+            if (!find_cube_list_index
+                (cube_index1, index_to_cube_list, cube_list, i1))
+              { continue; }
             TABLE_INDEX it1 = cube_list[i1].table_index;
             NUM_TYPE num_isov1 = cube_list[i1].num_isov;
             if (num_isov1 == 1) {
@@ -1190,7 +1297,10 @@ namespace IJK {
             NUM_TYPE side = IJK::cube_facet_side(dimension, jfacet);
             VTYPE cube_index1 =
               grid.AdjacentVertex(cube_index0, orth_dir, side);
-            SIZE_TYPE i1 = index_to_cube_list[cube_index1];
+            SIZE_TYPE i1;
+            if (!find_cube_list_index
+                (cube_index1, index_to_cube_list, cube_list, i1))
+              { continue; }
             TABLE_INDEX it1 = cube_list[i1].table_index;
             NUM_TYPE num_isov1 = cube_list[i1].num_isov;
             if (num_isov1 == 1) {
@@ -1252,6 +1362,54 @@ namespace IJK {
   }
 
 
+  /// Split isosurface vertex pairs which create non-manifold edges.
+  /// Version with caller supplied index_to_cube_list buffer.
+  /// @param index_to_cube_list Buffer mapping cube index to location
+  ///        in cube_list.  Grown to grid.NumVertices() on first use.
+  ///   - Only entries for cubes in cube_list are written.  Stale entries
+  ///     are rejected by find_cube_list_index, so the buffer is never
+  ///     reset and reusing it across calls costs O(cube_list.size()).
+  template <typename GRID_TYPE, typename ISODUAL_TABLE,
+            typename GRID_CUBE_TYPE, typename INDEX_TYPE, typename NTYPE>
+  void split_non_manifold_isov_pairs
+  (const GRID_TYPE & grid,
+   const ISODUAL_TABLE & isodual_table,
+   std::vector<INDEX_TYPE> & index_to_cube_list,
+   std::vector<GRID_CUBE_TYPE> & cube_list, 
+   NTYPE & num_split)
+  {
+    typedef typename GRID_TYPE::DIMENSION_TYPE DTYPE;
+    typedef typename GRID_TYPE::NUMBER_TYPE NUM_TYPE;
+
+    const DTYPE dimension = grid.Dimension();
+    NUM_TYPE num_split1, num_split2;
+
+    const typename std::vector<INDEX_TYPE>::size_type num_vertices =
+      grid.NumVertices();
+    if (index_to_cube_list.size() < num_vertices)
+      { index_to_cube_list.resize(num_vertices); }
+    set_index_to_cube_list(cube_list, index_to_cube_list);
+
+    // Initialize
+    num_split1 = 0;
+    num_split2 = 0;
+
+    if (index_to_cube_list.size() > 0) {
+      split_non_manifold_isov_pairs_ambig1
+        (grid, isodual_table, &(index_to_cube_list.front()),
+         cube_list, num_split1);
+
+      if (dimension > 3) {
+        split_non_manifold_isov_pairs_ambig2
+          (grid, isodual_table, &(index_to_cube_list.front()),
+           cube_list, num_split2);
+      }
+    }
+
+    num_split = num_split1+num_split2;
+  }
+
+
   /// Select which cube has configuration of split isosurface vertices
   /// where adjacent cubes share an ambiguous facet and one will have
   /// one isosurface vertex while the other has two isosurface vertices.
@@ -1304,7 +1462,10 @@ namespace IJK {
           if (side) {
             VTYPE cube_index1 =
               grid.AdjacentVertex(cube_index0, orth_dir, side);
-            SIZE_TYPE i1 = index_to_cube_list[cube_index1];
+            SIZE_TYPE i1;
+            if (!find_cube_list_index
+                (cube_index1, index_to_cube_list, cube_list, i1))
+              { continue; }
             TABLE_INDEX it1 = cube_list[i1].table_index;
             NUM_TYPE num_isov1 = isodual_table.NumIsoVertices(it1);
 
@@ -1429,7 +1590,12 @@ namespace IJK {
 
               VTYPE cube_index1 = 
                 grid.AdjacentVertex(cube_index0, orth_dir, side);
-              SIZE_TYPE i1 = index_to_cube_list[cube_index1];
+              SIZE_TYPE i1;
+              if (!find_cube_list_index
+                  (cube_index1, index_to_cube_list, cube_list, i1)) {
+                flag_complement = false;
+                break;
+              }
               TABLE_INDEX it1 = cube_list[i1].table_index;
               NUM_TYPE num_isov1 = isodual_table.NumIsoVertices(it1);
 
@@ -1464,7 +1630,10 @@ namespace IJK {
 
                 VTYPE cube_index1 = 
                   grid.AdjacentVertex(cube_index0, orth_dir, side);
-                SIZE_TYPE i1 = index_to_cube_list[cube_index1];
+                SIZE_TYPE i1;
+                if (!find_cube_list_index
+                    (cube_index1, index_to_cube_list, cube_list, i1))
+                  { continue; }
                 TABLE_INDEX it1 = cube_list[i1].table_index;
                 NUM_TYPE num_isov1 = isodual_table.NumIsoVertices(it1);
 
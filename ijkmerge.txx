@@ -279,7 +279,7 @@ namespace IJK {
   ///      for all elements list0[i] of list0.
   template <typename ITYPE, typename MTYPE, typename INTEGER_LIST_TYPE>
   void merge_identical
-  (const std::vector<ITYPE> list0, std::vector<ITYPE> & list1_nodup,
+  (const std::vector<ITYPE> & list0, std::vector<ITYPE> & list1_nodup,
    std::vector<MTYPE> & list0_map, INTEGER_LIST_TYPE & int_list)
   {
     list0_map.resize(list0.size());
@@ -27,6 +27,7 @@
 #include "ijk.txx"
 
 #include <algorithm>
+#include <limits>
 #include <numeric>
 #include <tuple>
 #include <vector>
@@ -962,6 +963,25 @@ namespace IJK {
 
     reorder_quad_vertices(&(quad_vert.front()), num_quad);
   }
+
+  /// Reorder quad vertices until the end of the current scope.
+  /// - Constructor reorders quad vertices.
+  /// - Destructor restores the original order,
+  ///   even if an exception is thrown.
+  template <typename VTYPE>
+  class SCOPED_REORDER_QUAD_VERTICES {
+
+  protected:
+    std::vector<VTYPE> & quad_vert;
+
+  public:
+    SCOPED_REORDER_QUAD_VERTICES(std::vector<VTYPE> & quad_vert):
+      quad_vert(quad_vert)
+    { reorder_quad_vertices(quad_vert); }
+
+    ~SCOPED_REORDER_QUAD_VERTICES()
+    { reorder_quad_vertices(quad_vert); }
+  };
   
   ///@}
 
@@ -1170,6 +1190,122 @@ namespace IJK {
   ///@}
 
 
+  // **************************************************
+  /// @name DELETE DUPLICATE POLYGONS
+  // **************************************************
+
+  ///@{
+
+  /// Compute canonical cyclic order of polygon vertices.
+  /// - Rotate and possibly reverse the cyclic order so that the smallest 
+  ///   vertex is first and the second vertex is smaller than the last.
+  /// - Return true if the cyclic order was reversed.
+  /// @param cyclic_vert[] Polygon vertices in cyclic order.
+  /// @pre Polygon vertices are distinct.
+  template <typename VTYPE, typename NTYPE>
+  bool compute_canonical_cyclic_order
+  (const VTYPE cyclic_vert[], const NTYPE numv, VTYPE canonical_vert[])
+  {
+    NTYPE kmin = 0;
+    for (NTYPE k = 1; k < numv; k++) {
+      if (cyclic_vert[k] < cyclic_vert[kmin]) { kmin = k; }
+    }
+
+    const bool flag_reverse =
+      (cyclic_vert[(kmin+numv-1)%numv] < cyclic_vert[(kmin+1)%numv]);
+    for (NTYPE k = 0; k < numv; k++) {
+      if (flag_reverse) 
+        { canonical_vert[k] = cyclic_vert[(kmin+numv-k)%numv]; }
+      else
+        { canonical_vert[k] = cyclic_vert[(kmin+k)%numv]; }
+    }
+
+    return(flag_reverse);
+  }
+
+  /// Flag duplicate polygons and pairs of polygons 
+  ///   with opposite orientations.
+  /// - Polygons are identical if they have the same vertices
+  ///   in the same cyclic order, up to orientation.
+  /// - A set of identical polygons with p polygons of one orientation
+  ///   and q polygons of the opposite orientation is replaced by 
+  ///   a single polygon with the majority orientation if p != q 
+  ///   and by nothing if p == q.
+  /// @param poly_vert[] Polygon vertices.
+  ///   poly_vert[numv_per_poly*i+j] = j'th vertex of polygon i.
+  /// @param cyclic_order[] Cyclic order of polygon vertices.
+  ///   Vertex poly_vert[numv_per_poly*i+cyclic_order[k]] is the
+  ///   k'th vertex of polygon i in cyclic order.
+  /// @param[out] keep_poly[i] True if polygon i is kept.
+  /// @pre Vertices of each polygon are distinct.
+  template <typename VTYPE, typename NTYPE>
+  void flag_duplicate_polygons
+  (const std::vector<VTYPE> & poly_vert, const NTYPE numv_per_poly,
+   const int cyclic_order[], std::vector<bool> & keep_poly)
+  {
+    typedef typename std::vector<VTYPE>::size_type SIZE_TYPE;
+
+    const SIZE_TYPE num_poly = poly_vert.size()/numv_per_poly;
+    std::vector<VTYPE> canonical_vert(poly_vert.size());
+    std::vector<bool> is_reversed(num_poly);
+    std::vector<SIZE_TYPE> poly_index(num_poly);
+    std::vector<VTYPE> cyclic_vert(numv_per_poly);
+
+    keep_poly.assign(num_poly, false);
+
+    for (SIZE_TYPE i = 0; i < num_poly; i++) {
+      for (NTYPE k = 0; k < numv_per_poly; k++) {
+        cyclic_vert[k] = poly_vert[i*numv_per_poly+cyclic_order[k]];
+      }
+      is_reversed[i] = compute_canonical_cyclic_order
+        (IJK::vector2pointer(cyclic_vert), numv_per_poly, 
+         &(canonical_vert[i*numv_per_poly]));
+      poly_index[i] = i;
+    }
+
+    auto poly_less =
+      [&](const SIZE_TYPE i0, const SIZE_TYPE i1)
+      {
+        return(std::lexicographical_compare
+               (canonical_vert.begin()+i0*numv_per_poly,
+                canonical_vert.begin()+(i0+1)*numv_per_poly,
+                canonical_vert.begin()+i1*numv_per_poly,
+                canonical_vert.begin()+(i1+1)*numv_per_poly));
+      };
+    std::sort(poly_index.begin(), poly_index.end(), poly_less);
+
+    SIZE_TYPE j0 = 0;
+    while (j0 < num_poly) {
+      SIZE_TYPE j1 = j0+1;
+      while (j1 < num_poly && !poly_less(poly_index[j0], poly_index[j1]))
+        { j1++; }
+
+      // Keep first polygon of the majority orientation.
+      SIZE_TYPE num_reversed = 0;
+      SIZE_TYPE first_reversed = num_poly, first_not_reversed = num_poly;
+      for (SIZE_TYPE j = j0; j < j1; j++) {
+        const SIZE_TYPE i = poly_index[j];
+        if (is_reversed[i]) { 
+          num_reversed++; 
+          first_reversed = std::min(first_reversed, i); 
+        }
+        else 
+          { first_not_reversed = std::min(first_not_reversed, i); }
+      }
+
+      const SIZE_TYPE num_not_reversed = (j1-j0) - num_reversed;
+      if (num_reversed > num_not_reversed) 
+        { keep_poly[first_reversed] = true; }
+      else if (num_not_reversed > num_reversed)
+        { keep_poly[first_not_reversed] = true; }
+
+      j0 = j1;
+    }
+  }
+
+  ///@}
+
+
   // **************************************************
   /// @name SORT SIMPLEX VERTICES AND SIMPLICES
   // **************************************************
@@ -1271,6 +1407,318 @@ namespace IJK {
   }
 
 
+  // **************************************************
+  /// @name REORDER TRIANGLES FOR VERTEX CACHE
+  // **************************************************
+
+  ///@{
+
+  /// Reorder triangles for locality in a FIFO vertex cache.
+  /// - Tipsify algorithm (Sander, Nehab and Barczak, 2007).
+  /// - Triangles are emitted as fans around a current vertex.
+  ///   The next fanning vertex is a recently used vertex which is
+  ///   likely to still be in the cache.
+  /// - Triangle orientations are preserved.
+  /// @param numv Number of vertices.
+  ///   - All vertices in tri_vert[] are less than numv.
+  /// @param cache_size Number of vertices in the simulated vertex cache.
+  /// @param[out] tri_vert[] Array of triangle vertices.
+  ///   - tri_vert[3*i+k] is the k'th vertex of triangle i.
+  template <typename NTYPE, typename CSIZE_TYPE, typename VTYPE>
+  void reorder_triangles_vertex_cache
+  (const NTYPE numv, const CSIZE_TYPE cache_size, std::vector<VTYPE> & tri_vert)
+  {
+    typedef typename std::vector<VTYPE>::size_type SIZE_TYPE;
+    const int NUM_VERT_PER_TRI = 3;
+    const SIZE_TYPE num_tri = tri_vert.size()/NUM_VERT_PER_TRI;
+    const long k = cache_size;
+
+    if (num_tri == 0 || numv <= 0) { return; }
+
+    // Triangles incident on vertex iv are 
+    //   adjacent_tri[first_adjacent[iv]..first_adjacent[iv+1]-1].
+    std::vector<SIZE_TYPE> first_adjacent(numv+1, 0);
+    std::vector<SIZE_TYPE> adjacent_tri(tri_vert.size());
+    for (SIZE_TYPE j = 0; j < tri_vert.size(); j++)
+      { first_adjacent[tri_vert[j]+1]++; }
+    for (NTYPE iv = 0; iv < numv; iv++)
+      { first_adjacent[iv+1] += first_adjacent[iv]; }
+
+    // num_live[iv] = Number of triangles incident on iv not yet emitted.
+    std::vector<long> num_live(numv);
+    for (NTYPE iv = 0; iv < numv; iv++)
+      { num_live[iv] = first_adjacent[iv+1]-first_adjacent[iv]; }
+
+    std::vector<SIZE_TYPE> next_adjacent(first_adjacent.begin(), 
+                                         first_adjacent.end()-1);
+    for (SIZE_TYPE j = 0; j < tri_vert.size(); j++) {
+      const VTYPE iv = tri_vert[j];
+      adjacent_tri[next_adjacent[iv]] = j/NUM_VERT_PER_TRI;
+      next_adjacent[iv]++;
+    }
+
+    // cache_time[iv] = Time when iv last entered the cache.
+    std::vector<long> cache_time(numv, 0);
+    std::vector<bool> is_emitted(num_tri, false);
+    std::vector<VTYPE> dead_end_stack;
+    std::vector<VTYPE> candidate;
+    std::vector<VTYPE> new_tri_vert;
+    new_tri_vert.reserve(tri_vert.size());
+
+    long time_stamp = k+1;
+    NTYPE cursor = 0;
+    long fan_vertex = 0;
+
+    while (fan_vertex >= 0) {
+
+      candidate.clear();
+      for (SIZE_TYPE j = first_adjacent[fan_vertex]; 
+           j < first_adjacent[fan_vertex+1]; j++) {
+        const SIZE_TYPE jt = adjacent_tri[j];
+        if (is_emitted[jt]) { continue; }
+
+        for (int m = 0; m < NUM_VERT_PER_TRI; m++) {
+          const VTYPE iv = tri_vert[jt*NUM_VERT_PER_TRI+m];
+          new_tri_vert.push_back(iv);
+          dead_end_stack.push_back(iv);
+          candidate.push_back(iv);
+          num_live[iv]--;
+          if (time_stamp-cache_time[iv] > k) 
+            { cache_time[iv] = time_stamp; time_stamp++; }
+        }
+        is_emitted[jt] = true;
+      }
+
+      // Select next fanning vertex from candidates still in the cache.
+      fan_vertex = -1;
+      long max_priority = -1;
+      for (SIZE_TYPE j = 0; j < candidate.size(); j++) {
+        const VTYPE iv = candidate[j];
+        if (num_live[iv] > 0) {
+          long priority = 0;
+          if (time_stamp-cache_time[iv]+2*num_live[iv] <= k)
+            { priority = time_stamp-cache_time[iv]; }
+          if (priority > max_priority) {
+            max_priority = priority;
+            fan_vertex = iv;
+          }
+        }
+      }
+
+      if (fan_vertex < 0) {
+        // Dead end.  Use most recently referenced vertex with live triangles.
+        while (dead_end_stack.size() > 0) {
+          const VTYPE iv = dead_end_stack.back();
+          dead_end_stack.pop_back();
+          if (num_live[iv] > 0) { fan_vertex = iv; break; }
+        }
+      }
+
+      if (fan_vertex < 0) {
+        // Use next vertex in input order with live triangles.
+        while (cursor < numv) {
+          if (num_live[cursor] > 0) { fan_vertex = cursor; break; }
+          cursor++;
+        }
+      }
+    }
+
+    tri_vert.swap(new_tri_vert);
+  }
+
+
+  /// Renumber vertices in order of first reference in vlist[].
+  /// - Permute vertex coordinates to match.
+  /// - Unreferenced vertices follow all referenced vertices,
+  ///   in their original order.
+  /// @param[out] new_index[] new_index[iv] = New index of vertex iv.
+  template <typename DTYPE, typename CTYPE, typename VTYPE, typename ITYPE>
+  void reorder_vertices_by_first_reference
+  (const DTYPE dimension, std::vector<CTYPE> & coord,
+   std::vector<VTYPE> & vlist, std::vector<ITYPE> & new_index)
+  {
+    typedef typename std::vector<CTYPE>::size_type SIZE_TYPE;
+
+    if (coord.size() == 0) { return; }
+
+    const SIZE_TYPE numv = coord.size()/dimension;
+    new_index.assign(numv, numv);
+
+    SIZE_TYPE k = 0;
+    for (SIZE_TYPE j = 0; j < vlist.size(); j++) {
+      const VTYPE iv = vlist[j];
+      if (new_index[iv] == ITYPE(numv)) 
+        { new_index[iv] = k; k++; }
+    }
+
+    for (SIZE_TYPE iv = 0; iv < numv; iv++) {
+      if (new_index[iv] == ITYPE(numv)) 
+        { new_index[iv] = k; k++; }
+    }
+
+    std::vector<CTYPE> new_coord(coord.size());
+    for (SIZE_TYPE iv = 0; iv < numv; iv++) {
+      std::copy(coord.begin()+iv*dimension, coord.begin()+(iv+1)*dimension,
+                new_coord.begin()+new_index[iv]*dimension);
+    }
+    coord.swap(new_coord);
+
+    for (SIZE_TYPE j = 0; j < vlist.size(); j++)
+      { vlist[j] = new_index[vlist[j]]; }
+  }
+
+
+  /// Return average cache miss ratio (cache misses per triangle)
+  ///   of triangles in a FIFO vertex cache.
+  template <typename NTYPE, typename CSIZE_TYPE, typename VTYPE>
+  float compute_vertex_cache_miss_ratio
+  (const NTYPE numv, const CSIZE_TYPE cache_size, 
+   const std::vector<VTYPE> & tri_vert)
+  {
+    typedef typename std::vector<VTYPE>::size_type SIZE_TYPE;
+    const int NUM_VERT_PER_TRI = 3;
+    const SIZE_TYPE num_tri = tri_vert.size()/NUM_VERT_PER_TRI;
+
+    if (num_tri == 0) { return(0); }
+
+    // Vertex iv is in the cache if num_misses-cache_entry[iv] <= cache_size.
+    // Each cache miss pushes a vertex into the cache.
+    std::vector<long> cache_entry(numv, -long(cache_size)-1);
+    long num_misses = 0;
+    for (SIZE_TYPE j = 0; j < tri_vert.size(); j++) {
+      const VTYPE iv = tri_vert[j];
+      if (num_misses-cache_entry[iv] > long(cache_size)) {
+        num_misses++;
+        cache_entry[iv] = num_misses-1;
+      }
+    }
+
+    return(float(num_misses)/num_tri);
+  }
+
+  ///@}
+
+
+  // **************************************************
+  /// @name SPLIT TRIANGLES INTO MESHLETS
+  // **************************************************
+
+  ///@{
+
+  /// Meshlet.  Block of consecutive triangles with a local vertex list.
+  template <typename ITYPE>
+  class MESHLET {
+
+  public:
+    ITYPE first_vert;   ///< Index of first meshlet vertex in vertex list.
+    ITYPE num_vert;     ///< Number of meshlet vertices.
+    ITYPE first_tri;    ///< Index of first meshlet triangle.
+    ITYPE num_tri;      ///< Number of meshlet triangles.
+
+    MESHLET() 
+    { first_vert = 0; num_vert = 0; first_tri = 0; num_tri = 0; }
+  };
+
+
+  /// Split triangles into meshlets.
+  /// - Triangles are assigned greedily, in order, to meshlets with
+  ///   at most max_vert vertices and at most max_tri triangles.
+  /// - Reorder triangles with reorder_triangles_vertex_cache first
+  ///   to reduce the number of vertices shared by different meshlets.
+  /// @param[out] meshlet_vert[] List of global vertex indices.
+  ///   - Vertex k of meshlet i is 
+  ///     meshlet_vert[meshlet[i].first_vert+k].
+  /// @param[out] meshlet_tri_vert[] Triangle vertices as local indices.
+  ///   - Vertex m of triangle j of meshlet i is
+  ///     meshlet_vert[meshlet[i].first_vert+
+  ///                  meshlet_tri_vert[3*(meshlet[i].first_tri+j)+m]].
+  /// @pre max_vert is at least 3 and max_tri is at least 1.
+  /// @pre max_vert-1 is representable by LTYPE.
+  template <typename VTYPE, typename NTYPE, typename ITYPE, 
+            typename VTYPE2, typename LTYPE>
+  void split_triangles_into_meshlets
+  (const std::vector<VTYPE> & tri_vert, 
+   const NTYPE max_vert, const NTYPE max_tri,
+   std::vector< MESHLET<ITYPE> > & meshlet,
+   std::vector<VTYPE2> & meshlet_vert,
+   std::vector<LTYPE> & meshlet_tri_vert)
+  {
+    typedef typename std::vector<VTYPE>::size_type SIZE_TYPE;
+    const int NUM_VERT_PER_TRI = 3;
+    const SIZE_TYPE num_tri = tri_vert.size()/NUM_VERT_PER_TRI;
+    IJK::PROCEDURE_ERROR error("split_triangles_into_meshlets");
+
+    if (max_vert < NUM_VERT_PER_TRI || max_tri < 1) {
+      error.AddMessage("Illegal meshlet size ", max_vert, " vertices and ",
+                       max_tri, " triangles.");
+      error.AddMessage
+        ("  Meshlets must have at least 3 vertices and 1 triangle.");
+      throw error;
+    }
+
+    if (long(max_vert-1) > long(std::numeric_limits<LTYPE>::max())) {
+      error.AddMessage("Illegal meshlet size ", max_vert, " vertices.");
+      error.AddMessage("  Local vertex indices are at most ",
+                       long(std::numeric_limits<LTYPE>::max()), ".");
+      throw error;
+    }
+
+    meshlet.clear();
+    meshlet_vert.clear();
+    meshlet_tri_vert.clear();
+
+    if (num_tri == 0) { return; }
+
+    const VTYPE numv = 1 + *std::max_element(tri_vert.begin(), tri_vert.end());
+
+    // local_index[iv] = Index of iv in current meshlet or max_vert.
+    std::vector<NTYPE> local_index(numv, max_vert);
+
+    MESHLET<ITYPE> current;
+    for (SIZE_TYPE jt = 0; jt < num_tri; jt++) {
+      const VTYPE * tri = &(tri_vert[jt*NUM_VERT_PER_TRI]);
+
+      NTYPE num_new_vert = 0;
+      for (int m = 0; m < NUM_VERT_PER_TRI; m++) {
+        if (local_index[tri[m]] == max_vert) { 
+          bool is_repeated = false;
+          for (int m2 = 0; m2 < m; m2++) 
+            { if (tri[m2] == tri[m]) { is_repeated = true; } }
+          if (!is_repeated) { num_new_vert++; }
+        }
+      }
+
+      if (current.num_vert+num_new_vert > ITYPE(max_vert) || 
+          current.num_tri == ITYPE(max_tri)) {
+        // Start new meshlet.
+        for (ITYPE j = 0; j < current.num_vert; j++)
+          { local_index[meshlet_vert[current.first_vert+j]] = max_vert; }
+        meshlet.push_back(current);
+        current.first_vert = meshlet_vert.size();
+        current.first_tri = meshlet_tri_vert.size()/NUM_VERT_PER_TRI;
+        current.num_vert = 0;
+        current.num_tri = 0;
+      }
+
+      for (int m = 0; m < NUM_VERT_PER_TRI; m++) {
+        const VTYPE iv = tri[m];
+        if (local_index[iv] == max_vert) {
+          local_index[iv] = current.num_vert;
+          meshlet_vert.push_back(iv);
+          current.num_vert++;
+        }
+        meshlet_tri_vert.push_back(LTYPE(local_index[iv]));
+      }
+      current.num_tri++;
+    }
+
+    meshlet.push_back(current);
+  }
+
+  ///@}
+
+
+
 }
 
 #endif
@@ -0,0 +1,686 @@
+/// \file ijkqmesh.txx
+/// ijk templates for reading/writing quantized binary mesh files.
+/// - Vertex coordinates are quantized relative to the grid cube
+///   containing the vertex.
+/// - Cube indices and polygon vertex indices are delta encoded
+///   as zigzag varints.
+/// - Version 0.1.0
+
+/*
+  IJK: Isosurface Jeneration Kode
+  Copyright (C) 2017 Rephael Wenger
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License
+  (LGPL) as published by the Free Software Foundation; either
+  version 2.1 of the License, or any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef _IJKQMESH_
+#define _IJKQMESH_
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "ijk.txx"
+
+
+namespace IJK {
+
+  // **************************************************
+  /// @name VARINT ENCODING
+  // **************************************************
+
+  ///@{
+
+  /// Map signed integer to unsigned integer.
+  /// - 0, -1, 1, -2, 2, ... map to 0, 1, 2, 3, 4, ...
+  inline std::uint64_t zigzag_encode(const std::int64_t x)
+  { return((std::uint64_t(x) << 1) ^ std::uint64_t(x >> 63)); }
+
+  /// Inverse of zigzag_encode.
+  inline std::int64_t zigzag_decode(const std::uint64_t u)
+  { return(std::int64_t(u >> 1) ^ -std::int64_t(u & 1)); }
+
+  /// Write unsigned integer as varint.
+  /// - Seven bits per byte, least significant first.
+  /// - High bit of each byte is set if more bytes follow.
+  inline void write_varint(std::ostream & out, std::uint64_t u)
+  {
+    while (u >= 0x80) {
+      out.put(char((u & 0x7f) | 0x80));
+      u = (u >> 7);
+    }
+    out.put(char(u));
+  }
+
+  /// Write signed integer as zigzag varint.
+  inline void write_zigzag_varint(std::ostream & out, const std::int64_t x)
+  { write_varint(out, zigzag_encode(x)); }
+
+  /// Read varint.
+  /// @param[out] u Unsigned integer.
+  /// @return False if stream ends or varint has more than 64 bits.
+  inline bool read_varint(std::istream & in, std::uint64_t & u)
+  {
+    u = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      const int c = in.get();
+      if (c == EOF) { return(false); }
+      u = u | (std::uint64_t(c & 0x7f) << shift);
+      if ((c & 0x80) == 0) { return(true); }
+    }
+    return(false);
+  }
+
+  /// Read zigzag varint.
+  inline bool read_zigzag_varint(std::istream & in, std::int64_t & x)
+  {
+    std::uint64_t u;
+    if (!read_varint(in, u)) { return(false); }
+    x = zigzag_decode(u);
+    return(true);
+  }
+
+  /// Write unsigned integer in num_bytes bytes, little endian.
+  inline void write_uint_le
+  (std::ostream & out, const std::uint32_t u, const int num_bytes)
+  {
+    for (int i = 0; i < num_bytes; i++)
+      { out.put(char((u >> (8*i)) & 0xff)); }
+  }
+
+  /// Read unsigned integer in num_bytes bytes, little endian.
+  inline bool read_uint_le
+  (std::istream & in, std::uint32_t & u, const int num_bytes)
+  {
+    u = 0;
+    for (int i = 0; i < num_bytes; i++) {
+      const int c = in.get();
+      if (c == EOF) { return(false); }
+      u = u | (std::uint32_t(c) << (8*i));
+    }
+    return(true);
+  }
+
+  ///@}
+
+
+  // **************************************************
+  /// @name CUBE RELATIVE QUANTIZATION
+  // **************************************************
+
+  ///@{
+
+  /// Return maximum quantized coordinate for num_bits bits.
+  template <typename NTYPE>
+  inline std::uint32_t max_quantized_coord(const NTYPE num_bits)
+  { return((std::uint32_t(1) << num_bits) - 1); }
+
+  /// Quantize point coordinates relative to the grid cube containing it.
+  /// - Cube with lowest vertex (c[0],...,c[dimension-1]) contains points
+  ///   with c[d] <= coord[d]/spacing[d] <= c[d]+1.
+  /// - Points outside the grid are clamped to the grid boundary.
+  /// @param axis_size[] Number of grid vertices along each axis.
+  /// @param spacing[] Grid spacing along each axis.
+  /// @param num_bits Number of bits per quantized coordinate.
+  /// @param[out] cube_index Index of lowest vertex of cube containing point.
+  /// @param[out] qcoord[] Quantized coordinates of point relative
+  ///   to cube. qcoord[d] is in range [0,2^num_bits-1].
+  template <typename DTYPE, typename CTYPE, typename ATYPE, typename STYPE,
+            typename NTYPE, typename ITYPE, typename QTYPE>
+  void quantize_cube_relative_coord
+  (const DTYPE dimension, const CTYPE * coord,
+   const ATYPE * axis_size, const STYPE * spacing, const NTYPE num_bits,
+   ITYPE & cube_index, QTYPE * qcoord)
+  {
+    const double qmax = max_quantized_coord(num_bits);
+
+    cube_index = 0;
+    ITYPE axis_increment = 1;
+    for (DTYPE d = 0; d < dimension; d++) {
+      const double x = double(coord[d])/spacing[d];
+      double c = std::floor(x);
+      if (c > double(axis_size[d])-2) { c = double(axis_size[d])-2; }
+      if (c < 0) { c = 0; }
+
+      double f = x - c;
+      if (f < 0) { f = 0; }
+      if (f > 1) { f = 1; }
+
+      cube_index += ITYPE(c)*axis_increment;
+      axis_increment *= ITYPE(axis_size[d]);
+      qcoord[d] = QTYPE(std::floor(f*qmax + 0.5));
+    }
+  }
+
+  /// Compute point coordinates from cube index and quantized coordinates.
+  /// - Inverse of quantize_cube_relative_coord, up to quantization error.
+  template <typename DTYPE, typename ITYPE, typename QTYPE,
+            typename ATYPE, typename STYPE, typename NTYPE, typename CTYPE>
+  void dequantize_cube_relative_coord
+  (const DTYPE dimension, const ITYPE cube_index, const QTYPE * qcoord,
+   const ATYPE * axis_size, const STYPE * spacing, const NTYPE num_bits,
+   CTYPE * coord)
+  {
+    const double qmax = max_quantized_coord(num_bits);
+
+    ITYPE k = cube_index;
+    for (DTYPE d = 0; d < dimension; d++) {
+      const ITYPE c = k % ITYPE(axis_size[d]);
+      k = k / ITYPE(axis_size[d]);
+      coord[d] = CTYPE((double(c) + double(qcoord[d])/qmax)*spacing[d]);
+    }
+  }
+
+  ///@}
+
+
+  // **************************************************
+  /// @name QUANTIZED MESH HEADER
+  // **************************************************
+
+  ///@{
+
+  /// Header of quantized binary mesh file.
+  /// - File format:
+  ///   - char[8]: "IJKQMSH1".
+  ///   - varint: dimension, numv_per_poly, num_bits.
+  ///     numv_per_poly is 0 if polygons have varying numbers of vertices.
+  ///   - varint[dimension]: Grid axis sizes.
+  ///   - float32[dimension] (little endian): Grid spacing.
+  ///   - varint: num_vert, num_poly.
+  ///   - Vertices: Zigzag varint difference between the cube index
+  ///     of the vertex and the cube index of the previous vertex,
+  ///     followed by dimension quantized coordinates, each stored
+  ///     in 1 byte (num_bits <= 8) or 2 bytes (num_bits <= 16).
+  ///   - Polygons: If numv_per_poly is 0, varint number of polygon
+  ///     vertices.  Each polygon vertex is a zigzag varint difference
+  ///     from the previous polygon vertex in the file.
+  class QMESH_HEADER {
+
+  public:
+    int dimension;
+    int numv_per_poly;        ///< Zero if polygon sizes vary.
+    int num_bits;             ///< Bits per quantized coordinate.
+    std::vector<long> axis_size;
+    std::vector<float> spacing;
+    long num_vert;
+    long num_poly;
+
+  public:
+    QMESH_HEADER()
+    { dimension = 0; numv_per_poly = 0; num_bits = 16;
+      num_vert = 0; num_poly = 0; }
+
+    /// Set grid dimension, axis sizes and spacing.
+    template <typename DTYPE, typename ATYPE, typename STYPE>
+    void SetGrid
+    (const DTYPE dimension, const ATYPE * axis_size, const STYPE * spacing)
+    {
+      this->dimension = dimension;
+      this->axis_size.assign(axis_size, axis_size+dimension);
+      this->spacing.assign(spacing, spacing+dimension);
+    }
+
+    /// Number of bytes per quantized coordinate.
+    int NumBytesPerCoord() const
+    { return((num_bits <= 8) ? 1 : 2); }
+
+    /// Return true if all polygons have numv_per_poly vertices.
+    bool IsFixedPolySize() const
+    { return(numv_per_poly > 0); }
+
+    /// Return false and set error if header is invalid.
+    bool Check(IJK::ERROR & error) const;
+  };
+
+  inline bool QMESH_HEADER::Check(IJK::ERROR & error) const
+  {
+    if (dimension < 1) {
+      error.AddMessage("Illegal dimension ", dimension, ".");
+      return(false);
+    }
+
+    if (num_bits < 1 || num_bits > 16) {
+      error.AddMessage("Illegal number of bits ", num_bits,
+                       " per quantized coordinate.");
+      error.AddMessage("  Number of bits must be in range [1,16].");
+      return(false);
+    }
+
+    if (int(axis_size.size()) != dimension ||
+        int(spacing.size()) != dimension) {
+      error.AddMessage("Number of grid axis sizes or spacings does not");
+      error.AddMessage("  match dimension ", dimension, ".");
+      return(false);
+    }
+
+    for (int d = 0; d < dimension; d++) {
+      if (axis_size[d] < 1) {
+        error.AddMessage("Illegal axis size ", axis_size[d], ".");
+        return(false);
+      }
+
+      if (spacing[d] <= 0) {
+        error.AddMessage("Illegal grid spacing ", spacing[d], ".");
+        error.AddMessage("  Grid spacing must be positive.");
+        return(false);
+      }
+    }
+
+    return(true);
+  }
+
+  ///@}
+
+
+  // **************************************************
+  /// @name QUANTIZED MESH WRITER
+  // **************************************************
+
+  ///@{
+
+  /// Streaming writer for quantized binary mesh files.
+  /// - Call WriteHeader, then WriteVertex num_vert times,
+  ///   then WritePoly num_poly times.
+  class QMESH_WRITER {
+
+  protected:
+    std::ostream & out;
+    QMESH_HEADER header;
+    std::int64_t last_cube_index;
+    std::int64_t last_vertex;
+    long num_vert_written;
+    long num_poly_written;
+    std::vector<std::uint32_t> qcoord;
+
+  public:
+    QMESH_WRITER(std::ostream & _out, const QMESH_HEADER & _header):
+      out(_out), header(_header)
+    { last_cube_index = 0; last_vertex = 0;
+      num_vert_written = 0; num_poly_written = 0;
+      qcoord.resize(_header.dimension); }
+
+    const QMESH_HEADER & Header() const
+    { return(header); }
+
+    /// Write file header.
+    void WriteHeader();
+
+    /// Write next vertex.
+    template <typename CTYPE>
+    void WriteVertex(const CTYPE * coord);
+
+    /// Write next polygon.
+    template <typename VTYPE, typename NTYPE>
+    void WritePoly(const VTYPE * poly_vert, const NTYPE numv);
+  };
+
+
+  inline void QMESH_WRITER::WriteHeader()
+  {
+    const char magic[8] = { 'I', 'J', 'K', 'Q', 'M', 'S', 'H', '1' };
+    IJK::PROCEDURE_ERROR error("QMESH_WRITER::WriteHeader");
+
+    if (!header.Check(error)) { throw error; }
+
+    out.write(magic, sizeof(magic));
+    write_varint(out, header.dimension);
+    write_varint(out, header.numv_per_poly);
+    write_varint(out, header.num_bits);
+
+    for (int d = 0; d < header.dimension; d++)
+      { write_varint(out, header.axis_size[d]); }
+
+    for (int d = 0; d < header.dimension; d++) {
+      std::uint32_t u;
+      std::memcpy(&u, &(header.spacing[d]), sizeof(u));
+      write_uint_le(out, u, sizeof(u));
+    }
+
+    write_varint(out, header.num_vert);
+    write_varint(out, header.num_poly);
+  }
+
+
+  template <typename CTYPE>
+  void QMESH_WRITER::WriteVertex(const CTYPE * coord)
+  {
+    const int num_bytes = header.NumBytesPerCoord();
+    std::int64_t cube_index;
+    IJK::PROCEDURE_ERROR error("QMESH_WRITER::WriteVertex");
+
+    if (num_vert_written >= header.num_vert) {
+      error.AddMessage
+        ("Programming error.  Writing more than ", header.num_vert,
+         " vertices.");
+      throw error;
+    }
+
+    quantize_cube_relative_coord
+      (header.dimension, coord, &(header.axis_size.front()),
+       &(header.spacing.front()), header.num_bits,
+       cube_index, &(qcoord.front()));
+
+    write_zigzag_varint(out, cube_index-last_cube_index);
+    for (int d = 0; d < header.dimension; d++)
+      { write_uint_le(out, qcoord[d], num_bytes); }
+
+    last_cube_index = cube_index;
+    num_vert_written++;
+  }
+
+
+  template <typename VTYPE, typename NTYPE>
+  void QMESH_WRITER::WritePoly(const VTYPE * poly_vert, const NTYPE numv)
+  {
+    IJK::PROCEDURE_ERROR error("QMESH_WRITER::WritePoly");
+
+    if (num_poly_written >= header.num_poly) {
+      error.AddMessage
+        ("Programming error.  Writing more than ", header.num_poly,
+         " polygons.");
+      throw error;
+    }
+
+    if (header.IsFixedPolySize()) {
+      if (numv != header.numv_per_poly) {
+        error.AddMessage
+          ("Programming error.  Polygon has ", numv, " vertices.");
+        error.AddMessage
+          ("  All polygons must have ", header.numv_per_poly, " vertices.");
+        throw error;
+      }
+    }
+    else
+      { write_varint(out, numv); }
+
+    for (NTYPE k = 0; k < numv; k++) {
+      write_zigzag_varint(out, std::int64_t(poly_vert[k])-last_vertex);
+      last_vertex = poly_vert[k];
+    }
+
+    num_poly_written++;
+  }
+
+  ///@}
+
+
+  // **************************************************
+  /// @name QUANTIZED MESH READER
+  // **************************************************
+
+  ///@{
+
+  /// Streaming reader for quantized binary mesh files.
+  /// - Call ReadHeader, then ReadVertex Header().num_vert times,
+  ///   then ReadPoly Header().num_poly times.
+  class QMESH_READER {
+
+  protected:
+    std::istream & in;
+    QMESH_HEADER header;
+    std::int64_t last_cube_index;
+    std::int64_t last_vertex;
+    std::vector<std::uint32_t> qcoord;
+
+    void ThrowReadError(const char * proc_name) const
+    {
+      IJK::PROCEDURE_ERROR error(proc_name);
+      error.AddMessage("Error reading quantized mesh file.");
+      error.AddMessage("  Unexpected end of file or corrupted data.");
+      throw error;
+    }
+
+  public:
+    QMESH_READER(std::istream & _in):in(_in)
+    { last_cube_index = 0; last_vertex = 0; }
+
+    const QMESH_HEADER & Header() const
+    { return(header); }
+
+    /// Read file header.
+    void ReadHeader();
+
+    /// Read next vertex.
+    /// @pre coord[] is preallocated to length at least Header().dimension.
+    template <typename CTYPE>
+    void ReadVertex(CTYPE * coord);
+
+    /// Read next polygon and append its vertices to poly_vert[].
+    /// @return Number of polygon vertices.
+    template <typename VTYPE>
+    int ReadPoly(std::vector<VTYPE> & poly_vert);
+  };
+
+
+  inline void QMESH_READER::ReadHeader()
+  {
+    const char magic[8] = { 'I', 'J', 'K', 'Q', 'M', 'S', 'H', '1' };
+    char buffer[8];
+    std::uint64_t u;
+    IJK::PROCEDURE_ERROR error("QMESH_READER::ReadHeader");
+
+    in.read(buffer, sizeof(buffer));
+    if (!in || std::memcmp(buffer, magic, sizeof(magic)) != 0) {
+      error.AddMessage("Input is not a quantized mesh (IJKQMSH1) file.");
+      throw error;
+    }
+
+    if (!read_varint(in, u)) { ThrowReadError("QMESH_READER::ReadHeader"); }
+    header.dimension = int(u);
+    if (!read_varint(in, u)) { ThrowReadError("QMESH_READER::ReadHeader"); }
+    header.numv_per_poly = int(u);
+    if (!read_varint(in, u)) { ThrowReadError("QMESH_READER::ReadHeader"); }
+    header.num_bits = int(u);
+
+    header.axis_size.resize(header.dimension);
+    header.spacing.resize(header.dimension);
+    for (int d = 0; d < header.dimension; d++) {
+      if (!read_varint(in, u))
+        { ThrowReadError("QMESH_READER::ReadHeader"); }
+      header.axis_size[d] = long(u);
+    }
+
+    for (int d = 0; d < header.dimension; d++) {
+      std::uint32_t u32;
+      if (!read_uint_le(in, u32, sizeof(u32)))
+        { ThrowReadError("QMESH_READER::ReadHeader"); }
+      std::memcpy(&(header.spacing[d]), &u32, sizeof(u32));
+    }
+
+    if (!read_varint(in, u)) { ThrowReadError("QMESH_READER::ReadHeader"); }
+    header.num_vert = long(u);
+    if (!read_varint(in, u)) { ThrowReadError("QMESH_READER::ReadHeader"); }
+    header.num_poly = long(u);
+
+    if (!header.Check(error)) { throw error; }
+
+    qcoord.resize(header.dimension);
+  }
+
+
+  template <typename CTYPE>
+  void QMESH_READER::ReadVertex(CTYPE * coord)
+  {
+    const int num_bytes = header.NumBytesPerCoord();
+    std::int64_t delta;
+
+    if (!read_zigzag_varint(in, delta))
+      { ThrowReadError("QMESH_READER::ReadVertex"); }
+    last_cube_index += delta;
+
+    for (int d = 0; d < header.dimension; d++) {
+      if (!read_uint_le(in, qcoord[d], num_bytes))
+        { ThrowReadError("QMESH_READER::ReadVertex"); }
+    }
+
+    dequantize_cube_relative_coord
+      (header.dimension, last_cube_index, &(qcoord.front()),
+       &(header.axis_size.front()), &(header.spacing.front()),
+       header.num_bits, coord);
+  }
+
+
+  template <typename VTYPE>
+  int QMESH_READER::ReadPoly(std::vector<VTYPE> & poly_vert)
+  {
+    std::uint64_t numv = header.numv_per_poly;
+    std::int64_t delta;
+
+    if (!header.IsFixedPolySize()) {
+      if (!read_varint(in, numv))
+        { ThrowReadError("QMESH_READER::ReadPoly"); }
+    }
+
+    for (std::uint64_t k = 0; k < numv; k++) {
+      if (!read_zigzag_varint(in, delta))
+        { ThrowReadError("QMESH_READER::ReadPoly"); }
+      last_vertex += delta;
+      poly_vert.push_back(VTYPE(last_vertex));
+    }
+
+    return(int(numv));
+  }
+
+  ///@}
+
+
+  // **************************************************
+  /// @name WRITE/READ QUANTIZED MESH FILES
+  // **************************************************
+
+  ///@{
+
+  /// Write quantized mesh file.
+  /// - All polygons have numv_per_poly vertices.
+  /// @param coord[] Vertex coordinates.
+  /// @param poly_vert[] Polygon vertices.
+  ///   poly_vert[numv_per_poly*j+k] is the k'th vertex of polygon j.
+  template <typename DTYPE, typename ATYPE, typename STYPE,
+            typename CTYPE, typename VTYPE>
+  void ijkoutQMESH
+  (std::ostream & out, const DTYPE dimension,
+   const ATYPE * axis_size, const STYPE * spacing, const int num_bits,
+   const int numv_per_poly,
+   const std::vector<CTYPE> & coord, const std::vector<VTYPE> & poly_vert)
+  {
+    QMESH_HEADER header;
+    header.SetGrid(dimension, axis_size, spacing);
+    header.numv_per_poly = numv_per_poly;
+    header.num_bits = num_bits;
+    header.num_vert = coord.size()/dimension;
+    header.num_poly = poly_vert.size()/numv_per_poly;
+
+    QMESH_WRITER writer(out, header);
+    writer.WriteHeader();
+
+    for (long iv = 0; iv < header.num_vert; iv++)
+      { writer.WriteVertex(&(coord[iv*dimension])); }
+
+    for (long j = 0; j < header.num_poly; j++)
+      { writer.WritePoly(&(poly_vert[j*numv_per_poly]), numv_per_poly); }
+  }
+
+
+  /// Write quantized mesh file of quadrilaterals and triangles.
+  /// - Quadrilaterals are written before triangles.
+  /// - If there are only quadrilaterals or only triangles,
+  ///   the file has fixed polygon size.
+  /// @param quad_vert[] Quadrilateral vertices.
+  ///   quad_vert[4*j+k] is the k'th vertex of quadrilateral j.
+  /// @param tri_vert[] Triangle vertices.
+  ///   tri_vert[3*j+k] is the k'th vertex of triangle j.
+  /// @param flag_reorder_quad_vertices If true, swap the last two
+  ///   vertices of each quadrilateral.  Changes lower-left, lower-right,
+  ///   upper-left, upper-right order to counter-clockwise order.
+  template <typename DTYPE, typename ATYPE, typename STYPE,
+            typename CTYPE, typename VTYPE>
+  void ijkoutQuadTriQMESH
+  (std::ostream & out, const DTYPE dimension,
+   const ATYPE * axis_size, const STYPE * spacing, const int num_bits,
+   const std::vector<CTYPE> & coord,
+   const std::vector<VTYPE> & quad_vert, const std::vector<VTYPE> & tri_vert,
+   const bool flag_reorder_quad_vertices)
+  {
+    const int NUM_VERT_PER_QUAD = 4;
+    const int NUM_VERT_PER_TRI = 3;
+    const long num_quad = quad_vert.size()/NUM_VERT_PER_QUAD;
+    const long num_tri = tri_vert.size()/NUM_VERT_PER_TRI;
+
+    QMESH_HEADER header;
+    header.SetGrid(dimension, axis_size, spacing);
+    header.numv_per_poly = 0;
+    if (num_tri == 0) { header.numv_per_poly = NUM_VERT_PER_QUAD; }
+    else if (num_quad == 0) { header.numv_per_poly = NUM_VERT_PER_TRI; }
+    header.num_bits = num_bits;
+    header.num_vert = coord.size()/dimension;
+    header.num_poly = num_quad + num_tri;
+
+    QMESH_WRITER writer(out, header);
+    writer.WriteHeader();
+
+    for (long iv = 0; iv < header.num_vert; iv++)
+      { writer.WriteVertex(&(coord[iv*dimension])); }
+
+    for (long j = 0; j < num_quad; j++) {
+      const VTYPE * q = &(quad_vert[j*NUM_VERT_PER_QUAD]);
+      if (flag_reorder_quad_vertices) {
+        const VTYPE q2[NUM_VERT_PER_QUAD] = { q[0], q[1], q[3], q[2] };
+        writer.WritePoly(q2, NUM_VERT_PER_QUAD);
+      }
+      else 
+        { writer.WritePoly(q, NUM_VERT_PER_QUAD); }
+    }
+
+    for (long j = 0; j < num_tri; j++)
+      { writer.WritePoly(&(tri_vert[j*NUM_VERT_PER_TRI]), NUM_VERT_PER_TRI); }
+  }
+
+
+  /// Read quantized mesh file.
+  /// @param[out] header File header.
+  /// @param[out] coord[] Vertex coordinates.
+  /// @param[out] num_poly_vert[] num_poly_vert[j] is the number
+  ///   of vertices of polygon j.
+  /// @param[out] poly_vert[] Polygon vertices, listed polygon by polygon.
+  template <typename CTYPE, typename NTYPE, typename VTYPE>
+  void ijkinQMESH
+  (std::istream & in, QMESH_HEADER & header,
+   std::vector<CTYPE> & coord, std::vector<NTYPE> & num_poly_vert,
+   std::vector<VTYPE> & poly_vert)
+  {
+    QMESH_READER reader(in);
+
+    reader.ReadHeader();
+    header = reader.Header();
+
+    const int dimension = header.dimension;
+    coord.resize(header.num_vert*dimension);
+    for (long iv = 0; iv < header.num_vert; iv++)
+      { reader.ReadVertex(&(coord[iv*dimension])); }
+
+    num_poly_vert.resize(header.num_poly);
+    poly_vert.clear();
+    for (long j = 0; j < header.num_poly; j++)
+      { num_poly_vert[j] = reader.ReadPoly(poly_vert); }
+  }
+
+  ///@}
+
+}
+
+#endif
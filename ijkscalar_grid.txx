@@ -1434,7 +1434,7 @@ namespace IJK {
     subgrid_axis_size[0] = 1;
 
     subsample_subgrid_vertices
-      (*this, 0, subgrid_axis_size.PtrConst(), period, vlist1.Ptr());
+      (*this, VTYPE(0), subgrid_axis_size.PtrConst(), period, vlist1.Ptr());
 
     for (VTYPE x0 = 0; x0 < scalar_grid2.AxisSize(0); x0++) {
       VTYPE x1 = x0*supersample_period;
@@ -1511,7 +1511,7 @@ namespace IJK {
 
       IJK::ARRAY<VTYPE> vlist(numv);
       subsample_subgrid_vertices
-        (*this, 0, subgrid_axis_size.PtrConst(),
+        (*this, VTYPE(0), subgrid_axis_size.PtrConst(),
          subsample_period.PtrConst(), vlist.Ptr());
 
       for (VTYPE x = 0; x+1 < this->AxisSize(d); x += supersample_period) {
@@ -1562,7 +1562,7 @@ namespace IJK {
 
       IJK::ARRAY<VTYPE> vlist(numv);
       subsample_subgrid_vertices
-        (*this, 0, subgrid_axis_size.PtrConst(),
+        (*this, VTYPE(0), subgrid_axis_size.PtrConst(),
          subsample_period.PtrConst(), vlist.Ptr());
 
       for (VTYPE x = 0; x+1 < this->AxisSize(d); x += supersample_period[d]) {
@@ -25,7 +25,14 @@
 #ifndef _IJKTIME_
 #define _IJKTIME_
 
+#include <chrono>
 #include <ctime>
+#include <iostream>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace IJK {
 
@@ -39,6 +46,156 @@ namespace IJK {
     seconds = S_TYPE(t)/CLOCKS_PER_SEC;
   }
 
+
+  // **************************************************
+  // WALL CLOCK AND CPU TIME
+  // **************************************************
+
+  /// Wall clock time and process CPU time, in seconds.
+  /// - Wall clock time is measured with a monotonic clock.
+  /// - CPU time is summed over all threads, so cpu/wall
+  ///   approximates the number of busy threads.
+  /// - thread_wall[i] is the wall clock time thread i spent
+  ///   in timed parallel regions.  Empty if there are none.
+  class WALL_CPU_TIME {
+
+  public:
+    double wall;     ///< Wall clock time.
+    double cpu;      ///< Process CPU time.
+    std::vector<double> thread_wall;  ///< Wall clock time of each thread.
+
+  public:
+    WALL_CPU_TIME() { Clear(); };
+
+    void Clear()
+    { wall = 0; cpu = 0; thread_wall.clear(); }
+
+    void Add(const WALL_CPU_TIME & t)
+    {
+      wall += t.wall; 
+      cpu += t.cpu;
+      if (thread_wall.size() < t.thread_wall.size())
+        { thread_wall.resize(t.thread_wall.size(), 0); }
+      for (std::size_t i = 0; i < t.thread_wall.size(); i++)
+        { thread_wall[i] += t.thread_wall[i]; }
+    }
+
+    /// Return maximum wall clock time of any thread.
+    double MaxThreadWall() const
+    {
+      double max_wall = 0;
+      for (std::size_t i = 0; i < thread_wall.size(); i++) {
+        if (thread_wall[i] > max_wall) { max_wall = thread_wall[i]; }
+      }
+      return(max_wall);
+    }
+
+    /// Write as JSON object {"wall": wall, "cpu": cpu}.
+    /// - Add member "thread_wall": [...] if thread_wall is not empty.
+    void WriteJSON(std::ostream & out) const
+    {
+      out << "{\"wall\": " << wall << ", \"cpu\": " << cpu;
+      if (thread_wall.size() > 0) {
+        out << ", \"thread_wall\": [";
+        for (std::size_t i = 0; i < thread_wall.size(); i++) {
+          if (i > 0) { out << ", "; }
+          out << thread_wall[i];
+        }
+        out << "]";
+      }
+      out << "}";
+    }
+  };
+
+
+  /// Timer which adds elapsed wall clock and CPU time to a WALL_CPU_TIME.
+  /// - Time is added when Stop() is called or when the timer
+  ///   goes out of scope, whichever comes first.
+  /// - Timers may be nested.
+  class SCOPED_TIMER {
+
+  protected:
+    typedef std::chrono::steady_clock CLOCK_TYPE;
+
+    WALL_CPU_TIME * total;
+    CLOCK_TYPE::time_point wall_start;
+    std::clock_t cpu_start;
+    bool is_running;
+
+  public:
+    SCOPED_TIMER(WALL_CPU_TIME & total)
+    {
+      this->total = &total;
+      wall_start = CLOCK_TYPE::now();
+      cpu_start = std::clock();
+      is_running = true;
+    }
+
+    ~SCOPED_TIMER() { Stop(); }
+
+    /// Add elapsed time to total and stop timer.
+    void Stop()
+    {
+      if (!is_running) { return; }
+
+      const std::chrono::duration<double> wall_elapsed = 
+        CLOCK_TYPE::now() - wall_start;
+      total->wall += wall_elapsed.count();
+      total->cpu += double(std::clock() - cpu_start)/CLOCKS_PER_SEC;
+      is_running = false;
+    }
+  };
+
+
+  /// Timer for the calling thread in an OpenMP parallel region.
+  /// - Adds elapsed wall clock time to total->thread_wall[i]
+  ///   where i is the OpenMP thread number.
+  /// - Construct inside the parallel region, outside the work sharing loop,
+  ///   so each thread times all its loop iterations.
+  /// - Does nothing if total is NULL.
+  class SCOPED_THREAD_TIMER {
+
+  protected:
+    typedef std::chrono::steady_clock CLOCK_TYPE;
+
+    WALL_CPU_TIME * total;
+    CLOCK_TYPE::time_point wall_start;
+    bool is_running;
+
+  public:
+    SCOPED_THREAD_TIMER(WALL_CPU_TIME * total)
+    {
+      this->total = total;
+      wall_start = CLOCK_TYPE::now();
+      is_running = (total != NULL);
+    }
+
+    ~SCOPED_THREAD_TIMER() { Stop(); }
+
+    /// Add elapsed time to total->thread_wall and stop timer.
+    void Stop()
+    {
+      if (!is_running) { return; }
+
+      const std::chrono::duration<double> wall_elapsed = 
+        CLOCK_TYPE::now() - wall_start;
+
+#ifdef _OPENMP
+      const std::size_t ithread = omp_get_thread_num();
+#else
+      const std::size_t ithread = 0;
+#endif
+
+#pragma omp critical (IJK_SCOPED_THREAD_TIMER)
+      {
+        if (total->thread_wall.size() <= ithread)
+          { total->thread_wall.resize(ithread+1, 0); }
+        total->thread_wall[ithread] += wall_elapsed.count();
+      }
+      is_running = false;
+    }
+  };
+
 }
 
 #endif
@@ -25,10 +25,12 @@
 #ifndef _IJKTRIANGULATE_GEOM_
 #define _IJKTRIANGULATE_GEOM_
 
+#include <cmath>
 #include <vector>
 
 #include "ijk.txx"
 #include "ijkcoord.txx"
+#include "ijktime.txx"
 #include "ijktriangulate.txx"
 
 
@@ -701,6 +703,52 @@ namespace IJK {
   ///@}
 
 
+  // **************************************************
+  /// @name TRIANGULATE QUADRILATERALS IN BLOCKS
+  // **************************************************
+
+  ///@{
+
+  /// Number of quadrilaterals in each block of quadrilaterals
+  ///   triangulated by a single thread.
+  /// - Block boundaries do not depend on the number of threads,
+  ///   so the output does not depend on the number of threads.
+  /// - Routines which triangulate blocks or batches in parallel
+  ///   add the wall clock time of each thread to thread_time,
+  ///   if thread_time is not NULL.
+  const int QUAD_BLOCK_SIZE = 4096;
+
+  /// Return number of blocks of QUAD_BLOCK_SIZE quadrilaterals.
+  template <typename NTYPE>
+  long compute_num_quad_blocks(const NTYPE num_quad)
+  {
+    return((long(num_quad)+QUAD_BLOCK_SIZE-1)/QUAD_BLOCK_SIZE);
+  }
+
+  /// Append triangles of each block to tri_vert, in block order.
+  /// - Clears block_tri_vert[].
+  template <typename VTYPE>
+  void append_block_triangles
+  (std::vector< std::vector<VTYPE> > & block_tri_vert,
+   std::vector<VTYPE> & tri_vert)
+  {
+    typedef typename std::vector<VTYPE>::size_type SIZE_TYPE;
+
+    SIZE_TYPE num_tri_vert = tri_vert.size();
+    for (SIZE_TYPE i = 0; i < block_tri_vert.size(); i++)
+      { num_tri_vert += block_tri_vert[i].size(); }
+    tri_vert.reserve(num_tri_vert);
+
+    for (SIZE_TYPE i = 0; i < block_tri_vert.size(); i++) {
+      tri_vert.insert(tri_vert.end(), block_tri_vert[i].begin(),
+                      block_tri_vert[i].end());
+      std::vector<VTYPE>().swap(block_tri_vert[i]);
+    }
+  }
+
+  ///@}
+
+
   // **************************************************
   /// @name TRIANGULATE QUADRILATERAL
   // **************************************************
@@ -991,13 +1039,40 @@ namespace IJK {
    const VTYPE0 quad_vert[], const NTYPE num_quad,
    const GRID_EDGE_TYPE dual_edge[], const VTYPE1 first_vertex, 
    const DIST_TYPE min_distance,  const MTYPE max_small_magnitude,
-   std::vector<VTYPE2> & tri_vert)
+   std::vector<VTYPE2> & tri_vert, WALL_CPU_TIME * thread_time)
   {
     typedef typename GRID_TYPE::DIMENSION_TYPE DTYPE;
 
     const DTYPE dimension = grid.Dimension();
     const NTYPE NUM_VERT_PER_QUAD = 4;
 
+    if (num_quad > QUAD_BLOCK_SIZE) {
+      // Triangulate blocks of quadrilaterals in parallel.
+      const long num_block = compute_num_quad_blocks(num_quad);
+      std::vector< std::vector<VTYPE2> > block_tri_vert(num_block);
+
+#pragma omp parallel
+      {
+        IJK::SCOPED_THREAD_TIMER thread_timer(thread_time);
+
+#pragma omp for schedule(dynamic)
+        for (long ib = 0; ib < num_block; ib++) {
+          const NTYPE iquad0 = ib*QUAD_BLOCK_SIZE;
+          NTYPE numq = num_quad - iquad0;
+          if (numq > QUAD_BLOCK_SIZE) { numq = QUAD_BLOCK_SIZE; }
+
+          triangulate_quad_tri4_by_distance
+            (grid, vertex_coord, quad_vert+iquad0*NUM_VERT_PER_QUAD, numq,
+             dual_edge+iquad0, first_vertex+iquad0, min_distance, 
+             max_small_magnitude, block_tri_vert[ib], 
+             (WALL_CPU_TIME *) NULL);
+        }
+      }
+
+      append_block_triangles(block_tri_vert, tri_vert);
+      return;
+    }
+
     for (NTYPE iquad = 0; iquad < num_quad; iquad++) {
 
       const NTYPE k = iquad*NUM_VERT_PER_QUAD;
@@ -1041,7 +1116,7 @@ namespace IJK {
    const std::vector<GRID_EDGE_TYPE> & dual_edge, 
    const VTYPE1 first_vertex, 
    const DIST_TYPE min_distance,  const MTYPE max_small_magnitude,
-   std::vector<VTYPE2> & tri_vert)
+   std::vector<VTYPE2> & tri_vert, WALL_CPU_TIME * thread_time)
   {
     typedef typename std::vector<VTYPE0>::size_type SIZE_TYPE;
 
@@ -1052,7 +1127,7 @@ namespace IJK {
       (grid, IJK::vector2pointer(vertex_coord),
        IJK::vector2pointer(quad_vert), num_quad,
        IJK::vector2pointer(dual_edge), first_vertex,
-       min_distance, max_small_magnitude, tri_vert);
+       min_distance, max_small_magnitude, tri_vert, thread_time);
   }
 
 
@@ -1171,7 +1246,7 @@ namespace IJK {
    const VTYPE1 first_vertex_on_dual_edge, 
    const DIST_TYPE min_distance_allow_tri4,
    const MTYPE max_small_magnitude,
-   std::vector<VTYPE2> & tri_vert)
+   std::vector<VTYPE2> & tri_vert, WALL_CPU_TIME * thread_time)
   {
     typedef typename GRID_TYPE::DIMENSION_TYPE DTYPE;
 
@@ -1187,6 +1262,33 @@ namespace IJK {
       throw error;
     }
 
+    if (num_quad > QUAD_BLOCK_SIZE) {
+      // Triangulate blocks of quadrilaterals in parallel.
+      const long num_block = compute_num_quad_blocks(num_quad);
+      std::vector< std::vector<VTYPE2> > block_tri_vert(num_block);
+
+#pragma omp parallel
+      {
+        IJK::SCOPED_THREAD_TIMER thread_timer(thread_time);
+
+#pragma omp for schedule(dynamic)
+        for (long ib = 0; ib < num_block; ib++) {
+          const NTYPE iquad0 = ib*QUAD_BLOCK_SIZE;
+          NTYPE numq = num_quad - iquad0;
+          if (numq > QUAD_BLOCK_SIZE) { numq = QUAD_BLOCK_SIZE; }
+
+          triangulate_dual_quad_tri4_max_min_angle
+            (grid, vertex_coord, quad_vert+iquad0*NUM_VERT_PER_QUAD, numq,
+             dual_edge+iquad0, first_vertex_on_dual_edge+iquad0,
+             min_distance_allow_tri4, max_small_magnitude, 
+             block_tri_vert[ib], (WALL_CPU_TIME *) NULL);
+        }
+      }
+
+      append_block_triangles(block_tri_vert, tri_vert);
+      return;
+    }
+
     for (NTYPE iquad = 0; iquad < num_quad; iquad++) {
       const VTYPE2 iw = first_vertex_on_dual_edge+iquad;
       const NTYPE k = iquad*NUM_VERT_PER_QUAD;
@@ -1239,7 +1341,7 @@ namespace IJK {
    const VTYPE1 first_vertex_on_dual_edge, 
    const DIST_TYPE min_distance_allow_tri4,
    const MTYPE max_small_magnitude,
-   std::vector<VTYPE2> & tri_vert)
+   std::vector<VTYPE2> & tri_vert, WALL_CPU_TIME * thread_time)
   {
     typedef typename std::vector<VTYPE0>::size_type SIZE_TYPE;
 
@@ -1262,7 +1364,7 @@ namespace IJK {
        IJK::vector2pointer(dual_edge),
        first_vertex_on_dual_edge,
        min_distance_allow_tri4, max_small_magnitude,
-       tri_vert);
+       tri_vert, thread_time);
   }
 
 
@@ -1277,7 +1379,7 @@ namespace IJK {
    const NTYPE num_quad,
    const VTYPE1 first_vertex_on_dual_edge, 
    const MTYPE max_small_magnitude,
-   std::vector<VTYPE2> & tri_vert)
+   std::vector<VTYPE2> & tri_vert, WALL_CPU_TIME * thread_time)
   {
     typedef typename GRID_TYPE::DIMENSION_TYPE DTYPE;
 
@@ -1293,6 +1395,32 @@ namespace IJK {
       throw error;
     }
 
+    if (num_quad > QUAD_BLOCK_SIZE) {
+      // Triangulate blocks of quadrilaterals in parallel.
+      const long num_block = compute_num_quad_blocks(num_quad);
+      std::vector< std::vector<VTYPE2> > block_tri_vert(num_block);
+
+#pragma omp parallel
+      {
+        IJK::SCOPED_THREAD_TIMER thread_timer(thread_time);
+
+#pragma omp for schedule(dynamic)
+        for (long ib = 0; ib < num_block; ib++) {
+          const NTYPE iquad0 = ib*QUAD_BLOCK_SIZE;
+          NTYPE numq = num_quad - iquad0;
+          if (numq > QUAD_BLOCK_SIZE) { numq = QUAD_BLOCK_SIZE; }
+
+          triangulate_quad_tri4_max_min_angle
+            (grid, vertex_coord, quad_vert+iquad0*NUM_VERT_PER_QUAD, numq,
+             first_vertex_on_dual_edge+iquad0, max_small_magnitude, 
+             block_tri_vert[ib], (WALL_CPU_TIME *) NULL);
+        }
+      }
+
+      append_block_triangles(block_tri_vert, tri_vert);
+      return;
+    }
+
     for (NTYPE iquad = 0; iquad < num_quad; iquad++) {
       const VTYPE2 iw = first_vertex_on_dual_edge+iquad;
       const NTYPE k = iquad*NUM_VERT_PER_QUAD;
@@ -1315,7 +1443,7 @@ namespace IJK {
    const std::vector<VTYPE0> & quad_vert,
    const VTYPE1 first_additional_vertex,
    const MTYPE max_small_magnitude,
-   std::vector<VTYPE2> & tri_vert)
+   std::vector<VTYPE2> & tri_vert, WALL_CPU_TIME * thread_time)
   {
     typedef typename std::vector<VTYPE0>::size_type SIZE_TYPE;
 
@@ -1327,7 +1455,7 @@ namespace IJK {
        IJK::vector2pointer(quad_vert), num_quad, 
        first_additional_vertex,
        max_small_magnitude,
-       tri_vert);
+       tri_vert, thread_time);
   }
 
   /// Triangulate a single quad into four triangles or two triangles
@@ -1495,6 +1623,449 @@ namespace IJK {
   ///@}
 
 
+  // **************************************************
+  /// @name TRIANGULATE 3D QUADRILATERALS IN BATCHES
+  // **************************************************
+
+  ///@{
+
+  /// Number of quadrilaterals processed together by the batched 
+  ///   3D triangulation routines.
+  /// - Coordinates of a batch are stored lane by lane so that loops
+  ///   over the batch compile to SIMD instructions.
+  const int QUAD_BATCH_SIZE_3D = 8;
+
+  /*!
+   *  Compute the cosine of the smallest angle of a batch of triangles.
+   *  - Branch free version of compute_cos_min_triangle_angle
+   *    for dimension 3.
+   *  - coordA[d][k] is the d'th coordinate of vertex A of triangle k.
+   *  @param max_small_magnitude Vectors with magnitude less than or
+   *           equal to max_small_magnitude are set to 0.
+   *  @param[out] cos_min_angle[k] Cosine of min angle of triangle k.
+   *  @param[out] flag_zero[k] Non-zero, if two or three edges of 
+   *    triangle k have length less than or equal to max_small_magnitude.
+   */
+  template <typename CTYPE, typename MTYPE>
+  void compute_cos_min_triangle_angle_batch_3D
+  (const CTYPE coordA[3][QUAD_BATCH_SIZE_3D],
+   const CTYPE coordB[3][QUAD_BATCH_SIZE_3D],
+   const CTYPE coordC[3][QUAD_BATCH_SIZE_3D],
+   const MTYPE max_small_magnitude,
+   CTYPE cos_min_angle[QUAD_BATCH_SIZE_3D], 
+   unsigned char flag_zero[QUAD_BATCH_SIZE_3D])
+  {
+    const CTYPE msm = max_small_magnitude;
+
+    for (int k = 0; k < QUAD_BATCH_SIZE_3D; k++) {
+      const CTYPE u01x = coordB[0][k] - coordA[0][k];
+      const CTYPE u01y = coordB[1][k] - coordA[1][k];
+      const CTYPE u01z = coordB[2][k] - coordA[2][k];
+      const CTYPE u02x = coordC[0][k] - coordA[0][k];
+      const CTYPE u02y = coordC[1][k] - coordA[1][k];
+      const CTYPE u02z = coordC[2][k] - coordA[2][k];
+      const CTYPE u12x = coordC[0][k] - coordB[0][k];
+      const CTYPE u12y = coordC[1][k] - coordB[1][k];
+      const CTYPE u12z = coordC[2][k] - coordB[2][k];
+
+      const CTYPE mag01 = std::sqrt(u01x*u01x + u01y*u01y + u01z*u01z);
+      const CTYPE mag02 = std::sqrt(u02x*u02x + u02y*u02y + u02z*u02z);
+      const CTYPE mag12 = std::sqrt(u12x*u12x + u12y*u12y + u12z*u12z);
+
+      const bool is_ok01 = (mag01 > msm);
+      const bool is_ok02 = (mag02 > msm);
+      const bool is_ok12 = (mag12 > msm);
+
+      // Replace small magnitudes by 1 to avoid division by zero.
+      // Results computed with those magnitudes are discarded below.
+      const CTYPE div01 = is_ok01 ? mag01 : CTYPE(1);
+      const CTYPE div02 = is_ok02 ? mag02 : CTYPE(1);
+      const CTYPE div12 = is_ok12 ? mag12 : CTYPE(1);
+
+      const CTYPE cosA = ((u01x*u02x + u01y*u02y + u01z*u02z)/div01)/div02;
+      // Note: Angle b is formed by vectors -u01 and u12.
+      const CTYPE cosB = -((u01x*u12x + u01y*u12y + u01z*u12z)/div01)/div12;
+      const CTYPE cosC = ((u02x*u12x + u02y*u12y + u02z*u12z)/div02)/div12;
+
+      CTYPE cos_max = (cosA > cosB) ? cosA : cosB;
+      cos_max = (cos_max < cosC) ? cosC : cos_max;
+      cos_max = (cos_max < -1) ? CTYPE(-1) : cos_max;
+      cos_max = (cos_max > 1) ? CTYPE(1) : cos_max;
+
+      CTYPE cosX = (is_ok01 && is_ok12) ? cosB : cosC;
+      cosX = (is_ok01 && is_ok02) ? cosA : cosX;
+      cos_min_angle[k] = (is_ok01 && is_ok02 && is_ok12) ? cos_max : cosX;
+
+      flag_zero[k] = 
+        ((int(is_ok01) + int(is_ok02) + int(is_ok12)) < 2);
+    }
+  }
+
+
+  /*!
+   *  Compute the cosine of the angle at each vertex of a batch 
+   *    of quadrilaterals.
+   *  - Branch free version of compute_cos_angle for dimension 3.
+   *  - Computes cosine of angle between (coord1-coord0) and (coord2-coord0).
+   *  - Cosine is 0 if either vector has magnitude at most
+   *    max_small_magnitude.
+   */
+  template <typename CTYPE, typename MTYPE>
+  void compute_cos_angle_batch_3D
+  (const CTYPE coord0[3][QUAD_BATCH_SIZE_3D],
+   const CTYPE coord1[3][QUAD_BATCH_SIZE_3D],
+   const CTYPE coord2[3][QUAD_BATCH_SIZE_3D],
+   const MTYPE max_small_magnitude,
+   CTYPE cos_angle[QUAD_BATCH_SIZE_3D])
+  {
+    const CTYPE msm = max_small_magnitude;
+
+    for (int k = 0; k < QUAD_BATCH_SIZE_3D; k++) {
+      const CTYPE u1x = coord1[0][k] - coord0[0][k];
+      const CTYPE u1y = coord1[1][k] - coord0[1][k];
+      const CTYPE u1z = coord1[2][k] - coord0[2][k];
+      const CTYPE u2x = coord2[0][k] - coord0[0][k];
+      const CTYPE u2y = coord2[1][k] - coord0[1][k];
+      const CTYPE u2z = coord2[2][k] - coord0[2][k];
+
+      const CTYPE mag1 = std::sqrt(u1x*u1x + u1y*u1y + u1z*u1z);
+      const CTYPE mag2 = std::sqrt(u2x*u2x + u2y*u2y + u2z*u2z);
+      const bool is_ok = (mag1 > msm && mag2 > msm);
+      const CTYPE div1 = is_ok ? mag1 : CTYPE(1);
+      const CTYPE div2 = is_ok ? mag2 : CTYPE(1);
+
+      CTYPE cosA = ((u1x*u2x + u1y*u2y + u1z*u2z)/div1)/div2;
+      cosA = (cosA < -1) ? CTYPE(-1) : cosA;
+      cosA = (cosA > 1) ? CTYPE(1) : cosA;
+      cos_angle[k] = is_ok ? cosA : CTYPE(0);
+    }
+  }
+
+
+  /// Copy coordinates of a batch of quadrilaterals into lane order.
+  /// - quad_coord[j][d][k] = d'th coordinate of vertex j of quad k.
+  /// - Lanes k >= num_quad are set to zero.
+  /// @pre num_quad <= QUAD_BATCH_SIZE_3D.
+  template <typename CTYPE0, typename CTYPE1, typename VTYPE, 
+            typename NTYPE>
+  void gather_quad_coord_batch_3D
+  (const CTYPE0 * vert_coord, const VTYPE * quad_vert, const NTYPE num_quad,
+   CTYPE1 quad_coord[4][3][QUAD_BATCH_SIZE_3D])
+  {
+    const int DIM3(3);
+    const int NUM_VERT_PER_QUAD(4);
+
+    for (int j = 0; j < NUM_VERT_PER_QUAD; j++) {
+      for (int k = 0; k < QUAD_BATCH_SIZE_3D; k++) {
+        if (k < num_quad) {
+          const CTYPE0 * vcoord = 
+            vert_coord + DIM3*quad_vert[k*NUM_VERT_PER_QUAD+j];
+          quad_coord[j][0][k] = vcoord[0];
+          quad_coord[j][1][k] = vcoord[1];
+          quad_coord[j][2][k] = vcoord[2];
+        }
+        else {
+          quad_coord[j][0][k] = 0;
+          quad_coord[j][1][k] = 0;
+          quad_coord[j][2][k] = 0;
+        }
+      }
+    }
+  }
+
+
+  /// Compute triangulation vertex which maximizes the minimum triangle
+  ///   angle for a batch of quadrilaterals.
+  /// - Same selection as triangulate_quad_max_min_angle.
+  /// - Quad vertices are listed in clockwise or counter-clockwise order
+  ///   around the quadrilateral.
+  /// @param[out] index_tri_vert[k] Triangulation vertex (0 or 1) of quad k.
+  ///   Quad k is split by diagonal from quad vertex index_tri_vert[k].
+  /// @pre num_quad <= QUAD_BATCH_SIZE_3D.
+  template <typename CTYPE, typename VTYPE, typename NTYPE, typename MTYPE>
+  void compute_quad_tri_vert_max_min_angle_batch_3D
+  (const CTYPE * vert_coord, const VTYPE * quad_vert, const NTYPE num_quad,
+   const MTYPE max_small_magnitude,
+   unsigned char index_tri_vert[QUAD_BATCH_SIZE_3D])
+  {
+    CTYPE qcoord[4][3][QUAD_BATCH_SIZE_3D];
+    CTYPE cos_tri012[QUAD_BATCH_SIZE_3D], cos_tri032[QUAD_BATCH_SIZE_3D];
+    CTYPE cos_tri123[QUAD_BATCH_SIZE_3D], cos_tri103[QUAD_BATCH_SIZE_3D];
+    unsigned char zero_tri012[QUAD_BATCH_SIZE_3D];
+    unsigned char zero_tri032[QUAD_BATCH_SIZE_3D];
+    unsigned char zero_tri123[QUAD_BATCH_SIZE_3D];
+    unsigned char zero_tri103[QUAD_BATCH_SIZE_3D];
+
+    gather_quad_coord_batch_3D(vert_coord, quad_vert, num_quad, qcoord);
+
+    compute_cos_min_triangle_angle_batch_3D
+      (qcoord[0], qcoord[1], qcoord[2], max_small_magnitude, 
+       cos_tri012, zero_tri012);
+    compute_cos_min_triangle_angle_batch_3D
+      (qcoord[0], qcoord[3], qcoord[2], max_small_magnitude, 
+       cos_tri032, zero_tri032);
+    compute_cos_min_triangle_angle_batch_3D
+      (qcoord[1], qcoord[2], qcoord[3], max_small_magnitude, 
+       cos_tri123, zero_tri123);
+    compute_cos_min_triangle_angle_batch_3D
+      (qcoord[1], qcoord[0], qcoord[3], max_small_magnitude, 
+       cos_tri103, zero_tri103);
+
+    for (int k = 0; k < QUAD_BATCH_SIZE_3D; k++) {
+      const bool flag_zero_diag02 = (zero_tri012[k] || zero_tri032[k]);
+      const bool flag_zero_diag13 = (zero_tri123[k] || zero_tri103[k]);
+      CTYPE cos_diag02 = 
+        (cos_tri012[k] > cos_tri032[k]) ? cos_tri012[k] : cos_tri032[k];
+      CTYPE cos_diag13 =
+        (cos_tri123[k] > cos_tri103[k]) ? cos_tri123[k] : cos_tri103[k];
+      cos_diag02 = flag_zero_diag02 ? CTYPE(0) : cos_diag02;
+      cos_diag13 = flag_zero_diag13 ? CTYPE(0) : cos_diag13;
+
+      index_tri_vert[k] = 
+        (flag_zero_diag13 || (cos_diag02 < cos_diag13)) ? 0 : 1;
+    }
+  }
+
+
+  /// Compute triangulation vertex which splits the maximum quadrilateral 
+  ///   angle for a batch of quadrilaterals.
+  /// - Same selection as triangulate_quad_split_max_angle.
+  /// @param[out] index_tri_vert[k] Triangulation vertex (0,1,2 or 3) 
+  ///   of quad k.
+  /// @pre num_quad <= QUAD_BATCH_SIZE_3D.
+  template <typename CTYPE, typename VTYPE, typename NTYPE, typename MTYPE>
+  void compute_quad_tri_vert_split_max_angle_batch_3D
+  (const CTYPE * vert_coord, const VTYPE * quad_vert, const NTYPE num_quad,
+   const MTYPE max_small_magnitude,
+   unsigned char index_tri_vert[QUAD_BATCH_SIZE_3D])
+  {
+    const int NUM_VERT_PER_QUAD(4);
+    CTYPE qcoord[4][3][QUAD_BATCH_SIZE_3D];
+    CTYPE cos_angle[4][QUAD_BATCH_SIZE_3D];
+
+    gather_quad_coord_batch_3D(vert_coord, quad_vert, num_quad, qcoord);
+
+    for (int j = 0; j < NUM_VERT_PER_QUAD; j++) {
+      const int jprev = (j+NUM_VERT_PER_QUAD-1)%NUM_VERT_PER_QUAD;
+      const int jnext = (j+1)%NUM_VERT_PER_QUAD;
+      compute_cos_angle_batch_3D
+        (qcoord[j], qcoord[jprev], qcoord[jnext], max_small_magnitude,
+         cos_angle[j]);
+    }
+
+    for (int k = 0; k < QUAD_BATCH_SIZE_3D; k++) {
+      unsigned char jmin = 0;
+      CTYPE min_cos = cos_angle[0][k];
+      for (int j = 1; j < NUM_VERT_PER_QUAD; j++) {
+        const bool flag_less = (cos_angle[j][k] < min_cos);
+        jmin = flag_less ? j : jmin;
+        min_cos = flag_less ? cos_angle[j][k] : min_cos;
+      }
+      index_tri_vert[k] = jmin;
+    }
+  }
+
+
+  /// Store two triangles of quadrilateral quad_vert[] 
+  ///   sharing the diagonal from quad_vert[index_tri_vert].
+  /// - Same triangles and order as 
+  ///   triangulate_polygon(4, quad_vert, index_tri_vert, ...).
+  /// @param[out] tri_vert[] Array of 6 triangle vertices.
+  template <typename VTYPE0, typename VTYPE1>
+  inline void set_quad_triangles
+  (const VTYPE0 quad_vert[], const int index_tri_vert, VTYPE1 tri_vert[])
+  {
+    const VTYPE0 v0 = quad_vert[index_tri_vert];
+    const VTYPE0 v1 = quad_vert[(index_tri_vert+1)%4];
+    const VTYPE0 v2 = quad_vert[(index_tri_vert+2)%4];
+    const VTYPE0 v3 = quad_vert[(index_tri_vert+3)%4];
+
+    tri_vert[0] = v0;
+    tri_vert[1] = v1;
+    tri_vert[2] = v2;
+    tri_vert[3] = v0;
+    tri_vert[4] = v2;
+    tri_vert[5] = v3;
+  }
+
+
+  /// Triangulation method for batched 3D quadrilateral triangulation.
+  typedef enum { QUAD_TRI_UNIFORM_3D, QUAD_TRI_MAX_MIN_ANGLE_3D,
+                 QUAD_TRI_SPLIT_MAX_ANGLE_3D } QUAD_TRI_METHOD_3D;
+
+
+  /// Triangulate a list of quadrilaterals embedded in 3D.
+  /// - Each quadrilateral is split into two triangles.
+  /// - Quadrilaterals are processed in batches of QUAD_BATCH_SIZE_3D.
+  ///   Batches are processed in parallel if OpenMP is enabled.
+  /// - Output is identical to the serial routines
+  ///   triangulate_quad, triangulate_quad_max_min_angle
+  ///   and triangulate_quad_split_max_angle.
+  /// - Add new triangles to vector tri_vert.
+  template <typename CTYPE, typename VTYPE0, typename NTYPE, 
+            typename VTYPE1, typename MTYPE>
+  void triangulate_quad_batch_3D
+  (const CTYPE * vert_coord, const VTYPE0 * quad_vert, const NTYPE num_quad,
+   const QUAD_TRI_METHOD_3D method, const MTYPE max_small_magnitude,
+   std::vector<VTYPE1> & tri_vert, WALL_CPU_TIME * thread_time)
+  {
+    typedef typename std::vector<VTYPE1>::size_type SIZE_TYPE;
+
+    const int NUM_VERT_PER_QUAD(4);
+    const int NUM_TRI_VERT_PER_QUAD(6);
+    const SIZE_TYPE tri_vert_size = tri_vert.size();
+
+    if (num_quad < 1) { return; }
+
+    // Pre-size tri_vert so that each batch writes to its own location.
+    tri_vert.resize(tri_vert_size + NUM_TRI_VERT_PER_QUAD*num_quad);
+    VTYPE1 * first_new_tri_vert = &(tri_vert[tri_vert_size]);
+
+    const long num_batch = 
+      (long(num_quad)+QUAD_BATCH_SIZE_3D-1)/QUAD_BATCH_SIZE_3D;
+
+#pragma omp parallel
+    {
+      IJK::SCOPED_THREAD_TIMER thread_timer(thread_time);
+
+#pragma omp for schedule(static)
+      for (long ibatch = 0; ibatch < num_batch; ibatch++) {
+        const long iquad0 = ibatch*QUAD_BATCH_SIZE_3D;
+        long numq = long(num_quad) - iquad0;
+        if (numq > QUAD_BATCH_SIZE_3D) { numq = QUAD_BATCH_SIZE_3D; }
+
+        const VTYPE0 * batch_quad_vert = quad_vert + iquad0*NUM_VERT_PER_QUAD;
+        unsigned char index_tri_vert[QUAD_BATCH_SIZE_3D] = { 0 };
+
+        if (method == QUAD_TRI_MAX_MIN_ANGLE_3D) {
+          compute_quad_tri_vert_max_min_angle_batch_3D
+            (vert_coord, batch_quad_vert, numq, max_small_magnitude,
+             index_tri_vert);
+        }
+        else if (method == QUAD_TRI_SPLIT_MAX_ANGLE_3D) {
+          compute_quad_tri_vert_split_max_angle_batch_3D
+            (vert_coord, batch_quad_vert, numq, max_small_magnitude,
+             index_tri_vert);
+        }
+
+        for (long k = 0; k < numq; k++) {
+          set_quad_triangles
+            (batch_quad_vert+k*NUM_VERT_PER_QUAD, index_tri_vert[k],
+             first_new_tri_vert + (iquad0+k)*NUM_TRI_VERT_PER_QUAD);
+        }
+      }
+    }
+  }
+
+
+  /// Triangulate a list of quadrilaterals embedded in 3D.
+  /// - C++ STL vector format for vert_coord and quad_vert.
+  template <typename CTYPE, typename VTYPE0, typename VTYPE1, 
+            typename MTYPE>
+  void triangulate_quad_batch_3D
+  (const std::vector<CTYPE> & vert_coord, 
+   const std::vector<VTYPE0> & quad_vert,
+   const QUAD_TRI_METHOD_3D method, const MTYPE max_small_magnitude,
+   std::vector<VTYPE1> & tri_vert, WALL_CPU_TIME * thread_time)
+  {
+    typedef typename std::vector<VTYPE0>::size_type SIZE_TYPE;
+
+    const SIZE_TYPE NUM_VERT_PER_QUAD = 4;
+    const SIZE_TYPE num_quad = quad_vert.size()/NUM_VERT_PER_QUAD;
+
+    triangulate_quad_batch_3D
+      (IJK::vector2pointer(vert_coord), IJK::vector2pointer(quad_vert),
+       num_quad, method, max_small_magnitude, tri_vert, thread_time);
+  }
+
+
+  /// Triangulate a list of quadrilaterals embedded in 3D in place.
+  /// - On input, quad_tri_vert[] is the list of quadrilateral vertices.
+  /// - On output, quad_tri_vert[] is the list of triangle vertices.
+  /// - Triangles are identical and in the same order as the triangles
+  ///   returned by triangulate_quad_batch_3D.
+  /// - Triangles are written into the quadrilateral list.
+  ///   The list grows from 4 to 6 vertices per quadrilateral, 
+  ///   so it is reallocated, and briefly held twice, if its capacity
+  ///   is less than 6 times the number of quadrilaterals.
+  template <typename CTYPE, typename VTYPE, typename MTYPE>
+  void triangulate_quad_batch_3D_in_place
+  (const std::vector<CTYPE> & vert_coord,
+   const QUAD_TRI_METHOD_3D method, const MTYPE max_small_magnitude,
+   std::vector<VTYPE> & quad_tri_vert, WALL_CPU_TIME * thread_time)
+  {
+    typedef typename std::vector<VTYPE>::size_type SIZE_TYPE;
+
+    const int NUM_VERT_PER_QUAD(4);
+    const int NUM_TRI_VERT_PER_QUAD(6);
+    const SIZE_TYPE num_quad = quad_tri_vert.size()/NUM_VERT_PER_QUAD;
+
+    if (num_quad < 1) { 
+      quad_tri_vert.clear();
+      return; 
+    }
+
+    // Select triangulation vertex of each quad.
+    // Uses one byte per quadrilateral.
+    std::vector<unsigned char> index_tri_vert(num_quad, 0);
+
+    if (method != QUAD_TRI_UNIFORM_3D) {
+      const CTYPE * vcoord = IJK::vector2pointer(vert_coord);
+      const VTYPE * quad_vert = IJK::vector2pointer(quad_tri_vert);
+      const long num_batch = 
+        (long(num_quad)+QUAD_BATCH_SIZE_3D-1)/QUAD_BATCH_SIZE_3D;
+
+#pragma omp parallel
+      {
+        IJK::SCOPED_THREAD_TIMER thread_timer(thread_time);
+
+#pragma omp for schedule(static)
+        for (long ibatch = 0; ibatch < num_batch; ibatch++) {
+          const long iquad0 = ibatch*QUAD_BATCH_SIZE_3D;
+          long numq = long(num_quad) - iquad0;
+          if (numq > QUAD_BATCH_SIZE_3D) { numq = QUAD_BATCH_SIZE_3D; }
+
+          const VTYPE * batch_quad_vert = quad_vert + iquad0*NUM_VERT_PER_QUAD;
+          unsigned char batch_index[QUAD_BATCH_SIZE_3D];
+
+          if (method == QUAD_TRI_MAX_MIN_ANGLE_3D) {
+            compute_quad_tri_vert_max_min_angle_batch_3D
+              (vcoord, batch_quad_vert, numq, max_small_magnitude,
+               batch_index);
+          }
+          else {
+            compute_quad_tri_vert_split_max_angle_batch_3D
+              (vcoord, batch_quad_vert, numq, max_small_magnitude,
+               batch_index);
+          }
+
+          for (long k = 0; k < numq; k++)
+            { index_tri_vert[iquad0+k] = batch_index[k]; }
+        }
+      }
+    }
+
+    // Expand quadrilaterals into triangles from last to first.
+    // Triangles of quad iquad are written to locations 
+    //   [6*iquad,6*iquad+5], which only overlap locations of quads
+    //   greater than or equal to iquad.
+    quad_tri_vert.resize(NUM_TRI_VERT_PER_QUAD*num_quad);
+    for (SIZE_TYPE j = num_quad; j > 0; j--) {
+      const SIZE_TYPE iquad = j-1;
+      VTYPE quad_vert[NUM_VERT_PER_QUAD];
+
+      std::copy(quad_tri_vert.begin()+iquad*NUM_VERT_PER_QUAD,
+                quad_tri_vert.begin()+(iquad+1)*NUM_VERT_PER_QUAD,
+                quad_vert);
+      set_quad_triangles
+        (quad_vert, index_tri_vert[iquad], 
+         &(quad_tri_vert[iquad*NUM_TRI_VERT_PER_QUAD]));
+    }
+  }
+
+  ///@}
+
+
   // **************************************************
   /// @name TRIANGULATE PENTAGON
   // **************************************************
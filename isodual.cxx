@@ -29,7 +29,9 @@
 #include "ijktime.txx"
 
 #include "ijkdual.txx"
+#include "ijkdual_collapse.txx"
 #include "ijkdual_extract.txx"
+#include "ijkdual_octree.txx"
 
 #include "isodual.h"
 #include "isodual_datastruct.h"
@@ -48,42 +50,123 @@ using namespace ISODUAL;
 void ISODUAL::dual_contouring
 (const DUALISO_DATA & dualiso_data, const SCALAR_TYPE isovalue, 
  DUAL_ISOSURFACE & dual_isosurface, DUALISO_INFO & dualiso_info)
+{
+  DUALISO_CONTEXT context;
+
+  dual_contouring
+    (dualiso_data, isovalue, dual_isosurface, dualiso_info, context);
+}
+
+
+/// Dual Contouring Algorithm.
+/// Version which reuses tables and scratch buffers in context.
+void ISODUAL::dual_contouring
+(const DUALISO_DATA & dualiso_data, const SCALAR_TYPE isovalue, 
+ DUAL_ISOSURFACE & dual_isosurface, DUALISO_INFO & dualiso_info,
+ DUALISO_CONTEXT & context)
 {
   const int dimension = dualiso_data.ScalarGrid().Dimension();
   const AXIS_SIZE_TYPE * axis_size = dualiso_data.ScalarGrid().AxisSize();
   const bool allow_multiple_isov = dualiso_data.AllowMultipleIsoVertices();
   const bool flag_collapse = dualiso_data.CollapseFlag();
-  const VERTEX_POSITION_METHOD vpos_method = 
-    dualiso_data.VertexPositionMethod();
+  const bool flag_octree = dualiso_data.AdaptiveOctreeFlag();
+  const bool flag_cube_relative_coord = dualiso_data.CubeRelativeCoordFlag();
   
-  float merge_time = 0.0;
   PROCEDURE_ERROR error("dual_contouring");
-
-  clock_t t_start = clock();
+  IJK::WALL_CPU_TIME total_time;
+  IJK::SCOPED_TIMER total_timer(total_time);
 
   if (!dualiso_data.Check(error)) { throw error; };
 
   dual_isosurface.Clear();
   dualiso_info.time.Clear();
+  context.ClearBuffers();
 
-  ISO_MERGE_DATA merge_data(dimension, axis_size);
+  MERGE_DATA & merge_data = context.MergeData(dimension, axis_size);
 
-  if (allow_multiple_isov) {
-    dual_contouring_multi_isov
-      (dualiso_data.ScalarGrid(), isovalue, dualiso_data,
-       dual_isosurface.isopoly_vert, dual_isosurface.isopoly_info, 
-       dual_isosurface.vertex_coord, merge_data, dualiso_info);
+  if (flag_octree) {
+    // Single isosurface vertex in each octree leaf.
+    dual_contouring_octree
+      (dualiso_data, isovalue, dual_isosurface, merge_data, dualiso_info);
+  }
+  else if (allow_multiple_isov) {
+    const IJKDUALTABLE::ISODUAL_CUBE_TABLE_AMBIG & isodual_table =
+      context.IsodualTable(dimension, dualiso_data.SeparateNegFlag());
+
+    if (flag_cube_relative_coord) {
+      IJKDUAL::dual_contouring_multi_isov
+        (dualiso_data.ScalarGrid(), isovalue, isodual_table, dualiso_data,
+         dual_isosurface.isopoly_vert, dual_isosurface.isopoly_info, 
+         context.cube_isov_list, context.iso_vlist,
+         dual_isosurface.cube_relative_coord, merge_data, context,
+         dualiso_info);
+    }
+    else {
+      IJKDUAL::dual_contouring_multi_isov
+        (dualiso_data.ScalarGrid(), isovalue, isodual_table, dualiso_data,
+         dual_isosurface.isopoly_vert, dual_isosurface.isopoly_info, 
+         context.cube_isov_list, context.iso_vlist,
+         dual_isosurface.vertex_coord, merge_data, context,
+         dualiso_info);
+    }
   }
   else {
-    dual_contouring_single_isov
-      (dualiso_data.ScalarGrid(), isovalue, vpos_method, 
-       dual_isosurface.isopoly_vert, dual_isosurface.isopoly_info,
-       dual_isosurface.vertex_coord, merge_data, dualiso_info);
+    if (flag_cube_relative_coord) {
+      dual_contouring_single_isov
+        (dualiso_data.ScalarGrid(), isovalue, dualiso_data, 
+         dual_isosurface.isopoly_vert, dual_isosurface.isopoly_info,
+         dual_isosurface.cube_relative_coord, merge_data, context,
+         dualiso_info);
+    }
+    else {
+      dual_contouring_single_isov
+        (dualiso_data.ScalarGrid(), isovalue, dualiso_data, 
+         dual_isosurface.isopoly_vert, dual_isosurface.isopoly_info,
+         dual_isosurface.vertex_coord, merge_data, context, dualiso_info);
+    }
+  }
+
+  if (flag_collapse) {
+    IJK::SCOPED_TIMER collapse_timer(dualiso_info.time.collapse);
+    // Collapse operates on absolute vertex coordinates.
+    convert_cube_relative_coord(dualiso_data.ScalarGrid(), dual_isosurface);
+    dual_collapse(dualiso_data, dual_isosurface);
   }
 
   // store times
-  clock_t t_end = clock();
-  clock2seconds(t_end-t_start, dualiso_info.time.total);
+  total_timer.Stop();
+  dualiso_info.time.total = total_time;
+}
+
+
+// **************************************************
+// EXTRACT FOR MULTIPLE ISOVALUES
+// **************************************************
+
+/// Extract isosurface polytopes for all isovalues in a single sweep.
+void ISODUAL::extract_dual_isopoly_multi_isovalue
+(const DUALISO_DATA & dualiso_data, 
+ const std::vector<SCALAR_TYPE> & isovalue,
+ DUALISO_CONTEXT & context, DUALISO_INFO & dualiso_info)
+{
+  PROCEDURE_ERROR error("extract_dual_isopoly_multi_isovalue");
+
+  if (!dualiso_data.Check(error)) { throw error; };
+
+  if (dualiso_data.ROIFlag() || dualiso_data.BrickFlag() ||
+      dualiso_data.ExtractActiveCubesFlag()) {
+    error.AddMessage
+      ("Multiple isovalue extraction requires the full grid.");
+    error.AddMessage
+      ("  Region of interest, brick and active cube extraction"
+       " are not supported.");
+    throw error;
+  }
+
+  IJKDUAL::extract_dual_isopoly_multi_isovalue
+    (dualiso_data.ScalarGrid(), isovalue, 
+     dualiso_data.AllowMultipleIsoVertices(), context.multi_isovalue,
+     dualiso_info);
 }
 
 
@@ -143,6 +226,34 @@ void ISODUAL::dual_contouring_multi_isov
 }
 
 
+// Extract isosurface using Dual Contouring algorithm.
+// Allow multiple isosurface vertices per grid cube.
+// Version which returns vertex coordinates relative to grid cubes.
+void ISODUAL::dual_contouring_multi_isov
+(const DUALISO_SCALAR_GRID_BASE & scalar_grid,
+ const SCALAR_TYPE isovalue, 
+ const DUALISO_DATA_FLAGS & param,
+ std::vector<ISO_VERTEX_INDEX> & isopoly_vert,
+ GRID_EDGE_ARRAY & dual_edge,
+ CUBE_RELATIVE_COORD_ARRAY & cube_relative_coord,
+ MERGE_DATA & merge_data, 
+ DUALISO_INFO & dualiso_info)
+{
+  const int dimension = scalar_grid.Dimension();
+  const bool flag_separate_neg = param.SeparateNegFlag();
+  bool flag_always_separate_opposite(true);
+  std::vector<DUAL_ISOVERT> iso_vlist;
+
+  IJKDUALTABLE::ISODUAL_CUBE_TABLE_AMBIG
+    isodual_table(dimension, flag_separate_neg, 
+                  flag_always_separate_opposite);
+
+  IJKDUAL::dual_contouring_multi_isov
+    (scalar_grid, isovalue, isodual_table, param, isopoly_vert,
+     dual_edge, iso_vlist, cube_relative_coord, merge_data, dualiso_info);
+}
+
+
 // Extract isosurface using Dual Contouring algorithm.
 // Single isosurface vertex per grid cube.
 // Returns list of isosurface polytope vertices
@@ -157,41 +268,199 @@ void ISODUAL::dual_contouring_single_isov
  MERGE_DATA & merge_data, 
  DUALISO_INFO & dualiso_info)
 {
-  const int dimension = scalar_grid.Dimension();
-  const COORD_TYPE center_offset = 0.1;
-  PROCEDURE_ERROR error("dual_contouring");
-  clock_t t0, t1, t2, t3;
+  DUALISO_DATA_FLAGS param;
 
-  t0 = clock();
+  param.vertex_position_method = vertex_position_method;
+  dual_contouring_single_isov
+    (scalar_grid, isovalue, param, isopoly_vert, dual_edge, vertex_coord, 
+     merge_data, dualiso_info);
+}
 
-  isopoly_vert.clear();
-  vertex_coord.clear();
-  dualiso_info.time.Clear();
 
-  std::vector<ISO_VERTEX_INDEX> isopoly;
-  extract_dual_isopoly
-    (scalar_grid, isovalue, isopoly, dual_edge, dualiso_info);
+namespace {
+
+  // Extract isosurface using Dual Contouring algorithm.
+  // Single isosurface vertex per grid cube.
+  // COORD_ARRAY_TYPE is COORD_ARRAY or CUBE_RELATIVE_COORD_ARRAY.
+  template <typename COORD_ARRAY_TYPE>
+  void dual_contouring_single_isov_T
+  (const DUALISO_SCALAR_GRID_BASE & scalar_grid,
+   const SCALAR_TYPE isovalue, 
+   const DUALISO_DATA_FLAGS & param,
+   std::vector<ISO_VERTEX_INDEX> & isopoly_vert,
+   GRID_EDGE_ARRAY & dual_edge,
+   COORD_ARRAY_TYPE & vertex_coord,
+   MERGE_DATA & merge_data, 
+   DUALISO_CONTEXT & context,
+   DUALISO_INFO & dualiso_info)
+  {
+    const int DIM3(3);
+    const int NUM_VERT_PER_QUAD(4);
+    const int NUM_VERT_PER_TRI_PAIR(6);
+    const VERTEX_POSITION_METHOD vertex_position_method = 
+      param.VertexPositionMethod();
+    IJK::WALL_CPU_TIME total_time;
+    IJK::SCOPED_TIMER total_timer(total_time);
+
+    isopoly_vert.clear();
+    dualiso_info.time.Clear();
+
+    std::vector<VERTEX_INDEX> & isopoly = context.isopoly;
+    if (context.multi_isovalue.Contains(isovalue, false)) {
+      // Polytopes extracted in a single sweep for multiple isovalues.
+      context.multi_isovalue.Take
+        (isovalue, isopoly, NULL, dual_edge, dualiso_info);
+    }
+    else if (param.ROIFlag()) {
+      extract_dual_isopoly_in_roi
+        (scalar_grid, isovalue, param.ROI(), isopoly, dual_edge, 
+         dualiso_info);
+    }
+    else if (param.BrickFlag()) {
+      extract_dual_isopoly_in_brick
+        (scalar_grid, isovalue, param.BrickOwnedBox(), isopoly, 
+         dual_edge, dualiso_info);
+    }
+    else if (param.ExtractActiveCubesFlag()) {
+      extract_dual_isopoly_in_cubes
+        (scalar_grid, isovalue, context.active_cube, isopoly, 
+         dual_edge, dualiso_info);
+    }
+    else if (param.ExtractIncrementalFlag()) {
+      extract_dual_isopoly_incremental
+        (scalar_grid, isovalue, param.ExtractBlockLength(), 
+         isopoly, dual_edge, context.incremental, dualiso_info);
+    }
+    else if (param.ExtractTwoPassFlag()) {
+      extract_dual_isopoly_two_pass
+        (scalar_grid, isovalue, isopoly, dual_edge, dualiso_info);
+    }
+    else if (param.ExtractInBlocksFlag()) {
+      extract_dual_isopoly_in_blocks
+        (scalar_grid, isovalue, param.ExtractBlockLength(), 
+         isopoly, dual_edge, dualiso_info);
+    }
+    else {
+      extract_dual_isopoly
+        (scalar_grid, isovalue, isopoly, dual_edge, dualiso_info);
+    }
+
+    // Quadrilaterals output as triangles are triangulated in place.
+    // Reserve room for two triangles per quadrilateral.
+    // (See convert_quad_to_tri_in_place.)
+    if (param.UseTriangleMesh() && !param.flag_tri4_quad && 
+        scalar_grid.Dimension() == DIM3)
+      { isopoly_vert.reserve
+          ((isopoly.size()/NUM_VERT_PER_QUAD)*NUM_VERT_PER_TRI_PAIR); }
+
+    // Single isosurface vertex per cube, so iso_vlist is the cube list.
+    std::vector<VERTEX_INDEX> & iso_vlist = context.cube_list;
+    IJK::SCOPED_TIMER merge_timer(dualiso_info.time.merge);
+    merge_identical(isopoly, iso_vlist, isopoly_vert, merge_data);
+    merge_timer.Stop();
+
+    // Each cube in iso_vlist contains some isosurface polytope vertex.
+    dualiso_info.scalar.num_non_empty_cubes = iso_vlist.size();
+
+    // Position functions resize vertex_coord.
+    IJK::SCOPED_TIMER position_timer(dualiso_info.time.position);
+    if (vertex_position_method == CUBE_CENTER) {
+      position_all_dual_isovertices_cube_center
+        (scalar_grid, iso_vlist, vertex_coord);
+    }
+    else {
+      // default
+      position_all_dual_isovertices_centroid
+        (scalar_grid, isovalue, iso_vlist, vertex_coord);
+    }
+    position_timer.Stop();
+
+    // store times
+    total_timer.Stop();
+    dualiso_info.time.total = total_time;
+  }
 
-  t1 = clock();
+}
 
-  std::vector<ISO_VERTEX_INDEX> iso_vlist;
-  merge_identical(isopoly, iso_vlist, isopoly_vert, merge_data);
-  t2 = clock();
 
-  if (vertex_position_method == CUBE_CENTER) {
-    position_all_dual_isovertices_cube_center
-      (scalar_grid, iso_vlist, vertex_coord);
-  }
-  else {
-    // default
-    position_all_dual_isovertices_centroid
-      (scalar_grid, isovalue, iso_vlist, vertex_coord);
-  }
-  t3 = clock();
+// Extract isosurface using Dual Contouring algorithm.
+// Single isosurface vertex per grid cube.
+// Version with DUALISO_DATA_FLAGS parameter.
+void ISODUAL::dual_contouring_single_isov
+(const DUALISO_SCALAR_GRID_BASE & scalar_grid,
+ const SCALAR_TYPE isovalue, 
+ const DUALISO_DATA_FLAGS & param,
+ std::vector<ISO_VERTEX_INDEX> & isopoly_vert,
+ GRID_EDGE_ARRAY & dual_edge,
+ COORD_ARRAY & vertex_coord,
+ MERGE_DATA & merge_data, 
+ DUALISO_INFO & dualiso_info)
+{
+  DUALISO_CONTEXT context;
 
-  // store times
-  clock2seconds(t1-t0, dualiso_info.time.extract);
-  clock2seconds(t2-t1, dualiso_info.time.merge);
-  clock2seconds(t3-t2, dualiso_info.time.position);
-  clock2seconds(t3-t0, dualiso_info.time.total);
+  dual_contouring_single_isov_T
+    (scalar_grid, isovalue, param, isopoly_vert, dual_edge, vertex_coord,
+     merge_data, context, dualiso_info);
+}
+
+
+// Extract isosurface using Dual Contouring algorithm.
+// Single isosurface vertex per grid cube.
+// Version which reuses scratch buffers in context.
+void ISODUAL::dual_contouring_single_isov
+(const DUALISO_SCALAR_GRID_BASE & scalar_grid,
+ const SCALAR_TYPE isovalue, 
+ const DUALISO_DATA_FLAGS & param,
+ std::vector<ISO_VERTEX_INDEX> & isopoly_vert,
+ GRID_EDGE_ARRAY & dual_edge,
+ COORD_ARRAY & vertex_coord,
+ MERGE_DATA & merge_data, 
+ DUALISO_CONTEXT & context,
+ DUALISO_INFO & dualiso_info)
+{
+  dual_contouring_single_isov_T
+    (scalar_grid, isovalue, param, isopoly_vert, dual_edge, vertex_coord,
+     merge_data, context, dualiso_info);
+}
+
+
+// Extract isosurface using Dual Contouring algorithm.
+// Single isosurface vertex per grid cube.
+// Version which returns vertex coordinates relative to grid cubes.
+void ISODUAL::dual_contouring_single_isov
+(const DUALISO_SCALAR_GRID_BASE & scalar_grid,
+ const SCALAR_TYPE isovalue, 
+ const DUALISO_DATA_FLAGS & param,
+ std::vector<ISO_VERTEX_INDEX> & isopoly_vert,
+ GRID_EDGE_ARRAY & dual_edge,
+ CUBE_RELATIVE_COORD_ARRAY & cube_relative_coord,
+ MERGE_DATA & merge_data, 
+ DUALISO_INFO & dualiso_info)
+{
+  DUALISO_CONTEXT context;
+
+  dual_contouring_single_isov_T
+    (scalar_grid, isovalue, param, isopoly_vert, dual_edge, 
+     cube_relative_coord, merge_data, context, dualiso_info);
+}
+
+
+// Extract isosurface using Dual Contouring algorithm.
+// Single isosurface vertex per grid cube.
+// Version which returns vertex coordinates relative to grid cubes
+//   and reuses scratch buffers in context.
+void ISODUAL::dual_contouring_single_isov
+(const DUALISO_SCALAR_GRID_BASE & scalar_grid,
+ const SCALAR_TYPE isovalue, 
+ const DUALISO_DATA_FLAGS & param,
+ std::vector<ISO_VERTEX_INDEX> & isopoly_vert,
+ GRID_EDGE_ARRAY & dual_edge,
+ CUBE_RELATIVE_COORD_ARRAY & cube_relative_coord,
+ MERGE_DATA & merge_data, 
+ DUALISO_CONTEXT & context,
+ DUALISO_INFO & dualiso_info)
+{
+  dual_contouring_single_isov_T
+    (scalar_grid, isovalue, param, isopoly_vert, dual_edge, 
+     cube_relative_coord, merge_data, context, dualiso_info);
 }
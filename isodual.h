@@ -47,10 +47,47 @@ namespace ISODUAL {
 // **************************************************
 
   /// Dual Contouring Algorithm.
+  /// - If dualiso_data.ROIFlag() is true, constructs only the isosurface
+  ///   in region of interest dualiso_data.ROI().  (See SetROI().)
+  ///   Vertex coordinates are in the coordinate frame of the full grid.
   void dual_contouring
     (const DUALISO_DATA & dualiso_data, const SCALAR_TYPE isovalue, 
      DUAL_ISOSURFACE & dual_isosurface, DUALISO_INFO & dualiso_info);
 
+  /// Dual Contouring Algorithm.
+  /// Version which reuses tables and scratch buffers in context.
+  /// - Merge data and lookup tables are recreated only when
+  ///   the grid dimensions or flags change.
+  /// - Repeated calls on the same grid with the same dual_isosurface
+  ///   reuse the grid-sized and isosurface-sized buffers.
+  ///   Allocation is amortized: no grid-sized allocations after
+  ///   the first call.  Each call still makes small allocations,
+  ///   the largest being lists of grid facet vertices.
+  /// - If dualiso_data.ExtractIncrementalFlag() is true, polytopes
+  ///   of grid blocks whose signs did not change since the previous
+  ///   call with context are reused.
+  /// - If dualiso_data.ExtractActiveCubesFlag() is true, polytopes
+  ///   are extracted only from the cubes in context.active_cube.
+  /// - If context.multi_isovalue contains polytopes for isovalue,
+  ///   they are used in place of extraction.
+  void dual_contouring
+    (const DUALISO_DATA & dualiso_data, const SCALAR_TYPE isovalue, 
+     DUAL_ISOSURFACE & dual_isosurface, DUALISO_INFO & dualiso_info,
+     DUALISO_CONTEXT & context);
+
+  /// Extract isosurface polytopes for all isovalues in a single sweep
+  ///   of the grid and store them in context.multi_isovalue.
+  /// - Each grid scalar value is read once, not once per isovalue.
+  /// - The next call to dual_contouring with context and one
+  ///   of the isovalues uses the stored polytopes.  Merging,
+  ///   splitting and positioning are done per isovalue.
+  /// - Stores polytopes for all isovalues at once.
+  /// - ROI, brick and active cube extraction are not supported.
+  void extract_dual_isopoly_multi_isovalue
+    (const DUALISO_DATA & dualiso_data, 
+     const std::vector<SCALAR_TYPE> & isovalue,
+     DUALISO_CONTEXT & context, DUALISO_INFO & dualiso_info);
+
 
 // **************************************************
 // DUAL CONTOURING
@@ -104,6 +141,19 @@ namespace ISODUAL {
    MERGE_DATA & merge_data, 
    DUALISO_INFO & dualiso_info);
 
+  /// Extract isosurface using Dual Contouring algorithm.
+  /// Allow multiple isosurface vertices per grid cube.
+  /// Version which returns vertex coordinates relative to grid cubes.
+  void dual_contouring_multi_isov
+  (const DUALISO_SCALAR_GRID_BASE & scalar_grid,
+   const SCALAR_TYPE isovalue, 
+   const DUALISO_DATA_FLAGS & param,
+   std::vector<ISO_VERTEX_INDEX> & isopoly_vert,
+   GRID_EDGE_ARRAY & dual_edge,
+   CUBE_RELATIVE_COORD_ARRAY & cube_relative_coord,
+   MERGE_DATA & merge_data, 
+   DUALISO_INFO & dualiso_info);
+
   /// Extract isosurface using Dual Contouring algorithm
   /// Single isosurface vertex per grid cube.
   /// Returns list of isosurface polytope vertices
@@ -117,6 +167,67 @@ namespace ISODUAL {
    COORD_ARRAY & vertex_coord,
    MERGE_DATA & merge_data, 
    DUALISO_INFO & dualiso_info);
+
+  /// Extract isosurface using Dual Contouring algorithm
+  /// Single isosurface vertex per grid cube.
+  /// Version with DUALISO_DATA_FLAGS parameter.
+  /// - Uses param.VertexPositionMethod().
+  /// - Extracts in grid blocks if param.ExtractInBlocksFlag() is true.
+  /// - Extracts in two passes if param.ExtractTwoPassFlag() is true.
+  /// - Extracts incrementally if param.ExtractIncrementalFlag() is true.
+  ///   Versions without a context keep no polytopes between calls.
+  /// - Extracts only in param.ROI() if param.ROIFlag() is true.
+  void dual_contouring_single_isov
+  (const DUALISO_SCALAR_GRID_BASE & scalar_grid,
+   const SCALAR_TYPE isovalue, 
+   const DUALISO_DATA_FLAGS & param,
+   std::vector<ISO_VERTEX_INDEX> & isopoly_vert,
+   GRID_EDGE_ARRAY & dual_edge,
+   COORD_ARRAY & vertex_coord,
+   MERGE_DATA & merge_data, 
+   DUALISO_INFO & dualiso_info);
+
+  /// Extract isosurface using Dual Contouring algorithm
+  /// Single isosurface vertex per grid cube.
+  /// Version which reuses scratch buffers in context.
+  void dual_contouring_single_isov
+  (const DUALISO_SCALAR_GRID_BASE & scalar_grid,
+   const SCALAR_TYPE isovalue, 
+   const DUALISO_DATA_FLAGS & param,
+   std::vector<ISO_VERTEX_INDEX> & isopoly_vert,
+   GRID_EDGE_ARRAY & dual_edge,
+   COORD_ARRAY & vertex_coord,
+   MERGE_DATA & merge_data, 
+   DUALISO_CONTEXT & context,
+   DUALISO_INFO & dualiso_info);
+
+  /// Extract isosurface using Dual Contouring algorithm
+  /// Single isosurface vertex per grid cube.
+  /// Version which returns vertex coordinates relative to grid cubes.
+  void dual_contouring_single_isov
+  (const DUALISO_SCALAR_GRID_BASE & scalar_grid,
+   const SCALAR_TYPE isovalue, 
+   const DUALISO_DATA_FLAGS & param,
+   std::vector<ISO_VERTEX_INDEX> & isopoly_vert,
+   GRID_EDGE_ARRAY & dual_edge,
+   CUBE_RELATIVE_COORD_ARRAY & cube_relative_coord,
+   MERGE_DATA & merge_data, 
+   DUALISO_INFO & dualiso_info);
+
+  /// Extract isosurface using Dual Contouring algorithm
+  /// Single isosurface vertex per grid cube.
+  /// Version which returns vertex coordinates relative to grid cubes
+  ///   and reuses scratch buffers in context.
+  void dual_contouring_single_isov
+  (const DUALISO_SCALAR_GRID_BASE & scalar_grid,
+   const SCALAR_TYPE isovalue, 
+   const DUALISO_DATA_FLAGS & param,
+   std::vector<ISO_VERTEX_INDEX> & isopoly_vert,
+   GRID_EDGE_ARRAY & dual_edge,
+   CUBE_RELATIVE_COORD_ARRAY & cube_relative_coord,
+   MERGE_DATA & merge_data, 
+   DUALISO_CONTEXT & context,
+   DUALISO_INFO & dualiso_info);
 }
 
 #endif
@@ -25,12 +25,18 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <string>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
 #include "ijkcommand_line.txx"
 #include "ijkIO.txx"
 #include "ijkmesh.txx"
+#include "ijkqmesh.txx"
 #include "ijkstring.txx"
 #include "ijkprint.txx"
 
@@ -62,13 +68,21 @@ namespace {
      TRI4_CENTROID_OPT,
      QEI_INTERPOLATE_SCALAR_OPT, QEI_INTERPOLATE_COORD_OPT, 
      QEI_AVERAGE_OPT,
+     COLLAPSE_OPT, COLLAPSE_MAX_DIST_OPT, COLLAPSE_MAX_LEVEL_OPT,
+     OCTREE_OPT, OCTREE_MAX_LEVEL_OPT,
+     EXTRACT_BLOCKS_OPT, EXTRACT_TWO_PASS_OPT, EXTRACT_MULTI_ISOVALUE_OPT,
+     ROI_OPT,
+     CUBE_RELATIVE_COORD_OPT,
+     VCACHE_OPT, VCACHE_SIZE_OPT,
+     MESHLETS_OPT, MESHLET_MAX_VERT_OPT, MESHLET_MAX_TRI_OPT,
      COLOR_VERT_OPT,
      HELP_OPT, HELP_ALL_OPT, USAGE_OPT, ALL_OPTIONS_OPT,
-     OFF_OPT, IV_OPT, PLY_OPT,
+     OFF_OPT, IV_OPT, PLY_OPT, QMESH_OPT, QMESH_BITS_OPT,
      OUTPUT_FILENAME_OPT, OUTPUT_FILENAME_PREFIX_OPT, STDOUT_OPT, 
      LABEL_WITH_ISOVALUE_OPT,
      NO_WRITE_OPT, SILENT_OPT, NO_WARN_OPT,
-     INFO_OPT, TIME_OPT, OUT_ISOV_OPT, UNKNOWN_OPT} OPTION_TYPE;
+     INFO_OPT, TIME_OPT, TIME_JSON_OPT, STATS_JSON_OPT, OUT_ISOV_OPT, 
+     UNKNOWN_OPT} OPTION_TYPE;
 
   typedef enum {
     REGULAR_OPTG, EXTENDED_OPTG, QDUAL_OPTG, TESTING_OPTG
@@ -249,6 +263,13 @@ namespace {
        "Output in Stanford Polygon File Format (PLY).");
     options.AddToHelpMessage
       (PLY_OPT, "(Allowed only with 3D scalar data.)");
+
+    options.AddOptionNoArg
+      (QMESH_OPT, "QMESH_OPT", REGULAR_OPTG, "-qmesh", 
+       "Output in quantized binary mesh format (.qmesh).");
+    options.AddToHelpMessage
+      (QMESH_OPT, 
+       "Vertex coordinates are quantized relative to grid cubes.");
     options.AddUsageOptionEndOr(REGULAR_OPTG);
 
     options.AddUsageOptionNewline(REGULAR_OPTG);
@@ -425,6 +446,137 @@ namespace {
     options.AddUsageOptionEndOr(EXTENDED_OPTG);
     options.AddUsageOptionNewline(EXTENDED_OPTG);
 
+    options.AddOptionNoArg
+      (COLLAPSE_OPT, "COLLAPSE_OPT", EXTENDED_OPTG, "-collapse",
+       "Collapse isosurface vertices in blocks of grid cubes");
+    options.AddToHelpMessage
+      (COLLAPSE_OPT, 
+       "where the isosurface is approximately planar.");
+
+    options.AddOption1Arg
+      (COLLAPSE_MAX_DIST_OPT, "COLLAPSE_MAX_DIST_OPT", EXTENDED_OPTG,
+       "-collapse_max_dist", "{D}",
+       "Collapse isosurface vertices only if all vertices");
+    options.AddToHelpMessage
+      (COLLAPSE_MAX_DIST_OPT, 
+       "are within distance {D} of the approximating plane.",
+       "Distance is in grid units.  (Default 0.1.)");
+
+    options.AddOption1Arg
+      (COLLAPSE_MAX_LEVEL_OPT, "COLLAPSE_MAX_LEVEL_OPT", EXTENDED_OPTG,
+       "-collapse_max_level", "{L}",
+       "Collapse isosurface vertices in blocks of at most");
+    options.AddToHelpMessage
+      (COLLAPSE_MAX_LEVEL_OPT, "2^L x 2^L x 2^L grid cubes.  (Default 3.)");
+
+    options.AddUsageOptionNewline(EXTENDED_OPTG);
+
+    options.AddOption1Arg
+      (OCTREE_OPT, "OCTREE_OPT", EXTENDED_OPTG, "-octree", "{E}",
+       "Adaptive octree.  Extract isosurface from octree leaves");
+    options.AddToHelpMessage
+      (OCTREE_OPT, 
+       "with a single vertex in each leaf.  Octant is a leaf if the",
+       "scalar field is within {E} of a linear function.");
+
+    options.AddOption1Arg
+      (OCTREE_MAX_LEVEL_OPT, "OCTREE_MAX_LEVEL_OPT", EXTENDED_OPTG,
+       "-octree_max_level", "{L}",
+       "Octree leaves have at most 2^L x 2^L x 2^L grid cubes.");
+    options.AddToHelpMessage(OCTREE_MAX_LEVEL_OPT, "(Default 4.)");
+
+    options.AddUsageOptionNewline(EXTENDED_OPTG);
+
+    options.AddOption1Arg
+      (EXTRACT_BLOCKS_OPT, "EXTRACT_BLOCKS_OPT", EXTENDED_OPTG,
+       "-extract_blocks", "{L}",
+       "Extract isosurface in blocks of L x L x L grid cubes,");
+    options.AddToHelpMessage
+      (EXTRACT_BLOCKS_OPT,
+       "visiting blocks in Morton order.  Isosurface vertices",
+       "are numbered in spatially coherent order.");
+
+    options.AddOptionNoArg
+      (EXTRACT_TWO_PASS_OPT, "EXTRACT_TWO_PASS_OPT", EXTENDED_OPTG,
+       "-extract_two_pass",
+       "Extract isosurface in two passes over grid slabs.");
+    options.AddToHelpMessage
+      (EXTRACT_TWO_PASS_OPT,
+       "First pass counts bipolar edges.  Second pass writes",
+       "polygons into preallocated arrays.  Slabs are processed",
+       "in parallel.  Output does not depend on number of threads.");
+
+    options.AddOptionNoArg
+      (EXTRACT_MULTI_ISOVALUE_OPT, "EXTRACT_MULTI_ISOVALUE_OPT", 
+       EXTENDED_OPTG, "-extract_multi_isovalue",
+       "Extract isosurfaces for all isovalues in a single sweep");
+    options.AddToHelpMessage
+      (EXTRACT_MULTI_ISOVALUE_OPT,
+       "of the grid.  Each grid edge is read once.  Uses more memory,",
+       "since polygons of all isovalues are stored at once.");
+
+    options.AddOption
+      (ROI_OPT, "ROI_OPT", EXTENDED_OPTG,
+       "-roi", 6, "{x0 y0 z0 x1 y1 z1}",
+       "Construct isosurface only in region of interest, the box");
+    options.AddToHelpMessage
+      (ROI_OPT,
+       "of grid vertices from (x0,y0,z0) to (x1,y1,z1).",
+       "The grid is not copied.  Vertex coordinates are in the",
+       "coordinate frame of the full grid.");
+
+    options.AddOptionNoArg
+      (CUBE_RELATIVE_COORD_OPT, "CUBE_RELATIVE_COORD_OPT", EXTENDED_OPTG,
+       "-cube_relative_coord",
+       "Store isosurface vertex coordinates as grid cube index");
+    options.AddToHelpMessage
+      (CUBE_RELATIVE_COORD_OPT,
+       "plus 16 bit fixed point offsets within the cube.",
+       "Convert to absolute coordinates before rescaling.");
+
+    options.AddUsageOptionNewline(EXTENDED_OPTG);
+
+    options.AddOptionNoArg
+      (VCACHE_OPT, "VCACHE_OPT", EXTENDED_OPTG, "-vcache",
+       "Reorder isosurface triangles and vertices for locality");
+    options.AddToHelpMessage
+      (VCACHE_OPT, "in a GPU vertex cache.  Requires -trimesh.");
+
+    options.AddOption1Arg
+      (VCACHE_SIZE_OPT, "VCACHE_SIZE_OPT", EXTENDED_OPTG,
+       "-vcache_size", "{S}",
+       "Reorder for a vertex cache with {S} vertices.  (Default 32.)");
+
+    options.AddUsageOptionNewline(EXTENDED_OPTG);
+
+    options.AddOption1Arg
+      (MESHLETS_OPT, "MESHLETS_OPT", EXTENDED_OPTG,
+       "-meshlets", "{meshlet_filename}",
+       "Write isosurface triangles as meshlets to binary file");
+    options.AddToHelpMessage
+      (MESHLETS_OPT, "{meshlet_filename}.  Requires -trimesh.  Implies -vcache.");
+
+    options.AddOption1Arg
+      (MESHLET_MAX_VERT_OPT, "MESHLET_MAX_VERT_OPT", EXTENDED_OPTG,
+       "-meshlet_max_vert", "{N}",
+       "Meshlets have at most {N} vertices.  (Default 64.)");
+
+    options.AddOption1Arg
+      (MESHLET_MAX_TRI_OPT, "MESHLET_MAX_TRI_OPT", EXTENDED_OPTG,
+       "-meshlet_max_tri", "{N}",
+       "Meshlets have at most {N} triangles.  (Default 124.)");
+
+    options.AddUsageOptionNewline(EXTENDED_OPTG);
+
+
+    options.AddOption1Arg
+      (QMESH_BITS_OPT, "QMESH_BITS_OPT", EXTENDED_OPTG,
+       "-qmesh_bits", "{B}",
+       "Quantize .qmesh coordinates to {B} bits per axis");
+    options.AddToHelpMessage
+      (QMESH_BITS_OPT, "relative to each grid cube.  (1 to 16.  Default 16.)");
+
+    options.AddUsageOptionNewline(EXTENDED_OPTG);
 
     options.AddOption1Arg
       (OUT_ISOV_OPT, "OUT_ISOV_OPT", EXTENDED_OPTG, 
@@ -432,6 +584,26 @@ namespace {
        "Write information about isosurface vertices");
     options.AddToHelpMessage
       (OUT_ISOV_OPT, "to file {output_filename}.");
+
+    options.AddUsageOptionNewline(EXTENDED_OPTG);
+
+    options.AddOption1Arg
+      (TIME_JSON_OPT, "TIME_JSON_OPT", EXTENDED_OPTG, 
+       "-time_json", "{json_filename}", 
+       "Write wall clock and CPU time of each stage");
+    options.AddToHelpMessage
+      (TIME_JSON_OPT, "to JSON file {json_filename}.");
+
+    options.AddOption1Arg
+      (STATS_JSON_OPT, "STATS_JSON_OPT", EXTENDED_OPTG, 
+       "-stats_json", "{json_filename}", 
+       "Write isosurface statistics, stage times, peak memory,");
+    options.AddToHelpMessage
+      (STATS_JSON_OPT, "bytes read and written, and throughput");
+    options.AddToHelpMessage
+      (STATS_JSON_OPT, "for each isovalue and for all isovalues");
+    options.AddToHelpMessage
+      (STATS_JSON_OPT, "to JSON file {json_filename}.");
   }
 
 };
@@ -443,6 +615,7 @@ void create_output_file_type_list(OUTPUT_FILE_TYPE_LIST & list)
   list.push_back(make_pair(OFF, ".off"));
   list.push_back(make_pair(IV, ".iv"));
   list.push_back(make_pair(PLY, ".ply"));
+  list.push_back(make_pair(QMESH, ".qmesh"));
 }
 
 
@@ -572,6 +745,94 @@ bool process_option
     io_info.is_qei_method_set = true;
     break;
 
+  case COLLAPSE_OPT:
+    io_info.flag_dual_collapse = true;
+    break;
+
+  case COLLAPSE_MAX_DIST_OPT:
+    io_info.max_collapse_distance = get_arg_float(iarg, argc, argv, error);
+    io_info.flag_dual_collapse = true;
+    iarg++;
+    break;
+
+  case COLLAPSE_MAX_LEVEL_OPT:
+    io_info.max_collapse_level = get_arg_int(iarg, argc, argv, error);
+    io_info.flag_dual_collapse = true;
+    iarg++;
+    break;
+
+  case OCTREE_OPT:
+    io_info.max_octree_linear_error = get_arg_float(iarg, argc, argv, error);
+    io_info.flag_adaptive_octree = true;
+    iarg++;
+    break;
+
+  case OCTREE_MAX_LEVEL_OPT:
+    io_info.max_octree_level = get_arg_int(iarg, argc, argv, error);
+    io_info.flag_adaptive_octree = true;
+    iarg++;
+    break;
+
+  case EXTRACT_BLOCKS_OPT:
+    io_info.extract_block_length = get_arg_int(iarg, argc, argv, error);
+    io_info.flag_extract_in_blocks = true;
+    iarg++;
+    break;
+
+  case EXTRACT_TWO_PASS_OPT:
+    io_info.flag_extract_two_pass = true;
+    break;
+
+  case EXTRACT_MULTI_ISOVALUE_OPT:
+    io_info.flag_extract_multi_isovalue = true;
+    break;
+
+  case ROI_OPT:
+    {
+      const int DIM3(3);
+      io_info.roi.SetDimension(DIM3);
+      for (int d = 0; d < DIM3; d++) {
+        io_info.roi.SetMinCoord
+          (d, get_arg_int(iarg+d, argc, argv, error));
+        io_info.roi.SetMaxCoord
+          (d, get_arg_int(iarg+DIM3+d, argc, argv, error));
+      }
+      io_info.flag_roi = true;
+      iarg += 2*DIM3;
+    }
+    break;
+
+  case CUBE_RELATIVE_COORD_OPT:
+    io_info.flag_cube_relative_coord = true;
+    break;
+
+  case VCACHE_OPT:
+    io_info.flag_reorder_vertex_cache = true;
+    break;
+
+  case VCACHE_SIZE_OPT:
+    io_info.vertex_cache_size = get_arg_int(iarg, argc, argv, error);
+    io_info.flag_reorder_vertex_cache = true;
+    iarg++;
+    break;
+
+  case MESHLETS_OPT:
+    iarg++;
+    if (iarg >= argc) usage_error();
+    io_info.meshlet_filename = argv[iarg];
+    io_info.flag_reorder_vertex_cache = true;
+    break;
+
+  case MESHLET_MAX_VERT_OPT:
+    io_info.meshlet_max_vert = get_arg_int(iarg, argc, argv, error);
+    iarg++;
+    break;
+
+  case MESHLET_MAX_TRI_OPT:
+    io_info.meshlet_max_tri = get_arg_int(iarg, argc, argv, error);
+    iarg++;
+    break;
+
   case COLOR_VERT_OPT:
     io_info.flag_color_vert = true;
     break;
@@ -591,6 +852,16 @@ bool process_option
     io_info.is_file_format_set = true;
     break;
 
+  case QMESH_OPT:
+    io_info.flag_output_qmesh = true;
+    io_info.is_file_format_set = true;
+    break;
+
+  case QMESH_BITS_OPT:
+    io_info.qmesh_num_bits = get_arg_int(iarg, argc, argv, error);
+    iarg++;
+    break;
+
   case OUTPUT_FILENAME_OPT:
     iarg++;
     if (iarg >= argc) usage_error();
@@ -627,6 +898,18 @@ bool process_option
     io_info.flag_report_time = true;
     break;
 
+  case TIME_JSON_OPT:
+    iarg++;
+    if (iarg >= argc) usage_error();
+    io_info.time_json_filename = argv[iarg];
+    break;
+
+  case STATS_JSON_OPT:
+    iarg++;
+    if (iarg >= argc) usage_error();
+    io_info.stats_json_filename = argv[iarg];
+    break;
+
   case INFO_OPT:
     io_info.flag_report_info = true;
     break;
@@ -712,6 +995,96 @@ void process_io_info(IO_INFO_TYPE & io_info)
     }
   }
 
+  if (io_info.flag_dual_collapse && io_info.max_collapse_distance < 0) {
+    cerr << "Error.  Collapse distance must be non-negative." << endl;
+    exit(230);
+  }
+
+  if (io_info.flag_adaptive_octree) {
+    if (io_info.max_octree_linear_error < 0) {
+      cerr << "Error.  Octree linear error must be non-negative." << endl;
+      exit(230);
+    }
+
+    if (io_info.max_octree_level < 0) {
+      cerr << "Error.  Octree level must be non-negative." << endl;
+      exit(230);
+    }
+  }
+
+  if (io_info.qmesh_num_bits < 1 || io_info.qmesh_num_bits > 16) {
+    cerr << "Error.  Number of .qmesh bits must be in range [1,16]." << endl;
+    exit(230);
+  }
+
+  if (io_info.flag_extract_in_blocks && io_info.extract_block_length < 1) {
+    cerr << "Error.  Extraction block length must be positive." << endl;
+    exit(230);
+  }
+
+  if (io_info.flag_extract_in_blocks && io_info.flag_extract_two_pass) {
+    cerr << "Error.  Options -extract_blocks and -extract_two_pass"
+         << " cannot be used together." << endl;
+    exit(230);
+  }
+
+  if (io_info.flag_roi) {
+    for (int d = 0; d < io_info.roi.Dimension(); d++) {
+      if (io_info.roi.MinCoord(d) < 0 || 
+          io_info.roi.MinCoord(d) >= io_info.roi.MaxCoord(d)) {
+        cerr << "Error.  Region of interest coordinates must satisfy"
+             << " 0 <= x0 < x1, 0 <= y0 < y1 and 0 <= z0 < z1." << endl;
+        exit(230);
+      }
+    }
+
+    if (io_info.flag_subsample || io_info.flag_supersample) {
+      cerr << "Error.  Option -roi cannot be used with -subsample"
+           << " or -supersample." << endl;
+      exit(230);
+    }
+
+    if (io_info.flag_extract_multi_isovalue) {
+      cerr << "Error.  Option -roi cannot be used with"
+           << " -extract_multi_isovalue." << endl;
+      exit(230);
+    }
+
+    if (io_info.flag_extract_in_blocks || io_info.flag_extract_two_pass) {
+      cerr << "Error.  Option -roi cannot be used with -extract_blocks"
+           << " or -extract_two_pass." << endl;
+      exit(230);
+    }
+  }
+
+  if (io_info.flag_reorder_vertex_cache && !io_info.use_triangle_mesh) {
+    cerr << "Error.  Options -vcache and -meshlets require -trimesh." << endl;
+    exit(230);
+  }
+
+  if (io_info.flag_reorder_vertex_cache && io_info.vertex_cache_size < 1) {
+    cerr << "Error.  Vertex cache size must be positive." << endl;
+    exit(230);
+  }
+
+  if (io_info.meshlet_filename != "") {
+    if (io_info.meshlet_max_vert < 3 || io_info.meshlet_max_vert > 256) {
+      cerr << "Error.  Meshlets must have between 3 and 256 vertices."
+           << endl;
+      exit(230);
+    }
+
+    if (io_info.meshlet_max_tri < 1) {
+      cerr << "Error.  Meshlets must have at least one triangle." << endl;
+      exit(230);
+    }
+
+    if (io_info.isovalue.size() > 1) {
+      cerr << "Error.  Cannot use -meshlets with multiple isovalues." << endl;
+      exit(230);
+    }
+  }
+
   if (io_info.flag_subsample && io_info.subsample_resolution <= 1) {
     cerr << "Error.  Subsample resolution must be an integer greater than 1."
          << endl;
@@ -822,6 +1195,42 @@ bool ISODUAL::check_input
     return(false);
   }
 
+  if (io_info.flag_roi) {
+    if (io_info.roi.Dimension() != scalar_grid.Dimension()) {
+      error.AddMessage
+        ("Error.  Option -roi requires a grid of dimension ",
+         io_info.roi.Dimension(), ".");
+      error.AddMessage
+        ("  Grid has dimension ", scalar_grid.Dimension(), ".");
+      return(false);
+    }
+
+    for (int d = 0; d < scalar_grid.Dimension(); d++) {
+      if (io_info.roi.MaxCoord(d) >= scalar_grid.AxisSize(d)) {
+        error.AddMessage
+          ("Error.  Region of interest maximum coordinate ", d, 
+           " equals ", io_info.roi.MaxCoord(d), ".");
+        error.AddMessage
+          ("  Maximum coordinate ", d, " must be less than grid axis size ",
+           scalar_grid.AxisSize(d), ".");
+        return(false);
+      }
+    }
+  }
+
+  // Isosurface vertices are merged using grid edge indices.
+  const double num_grid_edges = 
+    double(scalar_grid.Dimension())*scalar_grid.NumVertices();
+  if (num_grid_edges > double(std::numeric_limits<VERTEX_INDEX>::max())) {
+    error.AddMessage
+      ("Error.  Number of grid edges ", num_grid_edges, 
+       " exceeds maximum grid index ", 
+       std::numeric_limits<VERTEX_INDEX>::max(), ".");
+    error.AddMessage
+      ("  Recompile with a 64-bit index type (cmake -DISODUAL_64BIT_INDEX=ON).");
+    return(false);
+  }
+
   return(true);
 }
 
@@ -833,7 +1242,7 @@ void ISODUAL::read_nrrd_file
 (const char * input_filename, DUALISO_SCALAR_GRID & scalar_grid, 
  NRRD_HEADER & nrrd_header, IO_TIME & io_time)
 {
-  ELAPSED_TIME wall_time;
+  IJK::SCOPED_TIMER timer(io_time.read_nrrd_time);
   GRID_NRRD_IN<int, AXIS_SIZE_TYPE> nrrd_in;
   IJK::PROCEDURE_ERROR error("read_nrrd_file");
 
@@ -846,8 +1255,6 @@ void ISODUAL::read_nrrd_file
   for (int d = 0; d < scalar_grid.Dimension(); d++) {
     scalar_grid.SetSpacing(d, grid_spacing[d]);
   };
-
-  io_time.read_nrrd_time = wall_time.getElapsed();
 }
 
 void ISODUAL::read_nrrd_file
@@ -876,10 +1283,72 @@ namespace {
 // WRITE_DUAL_MESH
 // **************************************************
 
+namespace {
+
+  // Return false and set error if extraction grid is not set.
+  bool check_extraction_grid
+  (const OUTPUT_INFO & output_info, IJK::ERROR & error)
+  {
+    const int dimension = output_info.dimension;
+
+    if (int(output_info.extraction_grid_axis_size.size()) != dimension ||
+        int(output_info.extraction_grid_spacing.size()) != dimension) {
+      error.AddMessage
+        ("Programming error.  Extraction grid not set in output_info.");
+      error.AddMessage
+        ("  Call OUTPUT_INFO::SetExtractionGrid before writing .qmesh file.");
+      return(false);
+    }
+
+    return(true);
+  }
+
+  // Write isosurface in quantized mesh format.
+  // All polygons have numv_per_poly vertices.
+  void write_qmesh
+  (std::ostream & out, const OUTPUT_INFO & output_info,
+   const vector<COORD_TYPE> & vertex_coord,
+   const int numv_per_poly, const vector<ISO_VERTEX_INDEX> & poly_vert)
+  {
+    IJK::PROCEDURE_ERROR error("write_qmesh");
+
+    if (!check_extraction_grid(output_info, error)) { throw error; }
+
+    ijkoutQMESH
+      (out, output_info.dimension, 
+       vector2pointer(output_info.extraction_grid_axis_size),
+       vector2pointer(output_info.extraction_grid_spacing),
+       output_info.qmesh_num_bits, numv_per_poly, vertex_coord, poly_vert);
+  }
+
+  // Write isosurface of quadrilaterals and triangles 
+  //   in quantized mesh format.
+  void write_qmesh
+  (std::ostream & out, const OUTPUT_INFO & output_info,
+   const vector<COORD_TYPE> & vertex_coord,
+   const vector<ISO_VERTEX_INDEX> & quad_vert, 
+   const vector<ISO_VERTEX_INDEX> & tri_vert,
+   const bool flag_reorder_quad_vertices)
+  {
+    IJK::PROCEDURE_ERROR error("write_qmesh");
+
+    if (!check_extraction_grid(output_info, error)) { throw error; }
+
+    ijkoutQuadTriQMESH
+      (out, output_info.dimension, 
+       vector2pointer(output_info.extraction_grid_axis_size),
+       vector2pointer(output_info.extraction_grid_spacing),
+       output_info.qmesh_num_bits, vertex_coord, quad_vert, tri_vert,
+       flag_reorder_quad_vertices);
+  }
+
+}
+
+
 // Write dual mesh with output format output_format.
 void ISODUAL::write_dual_mesh
 (const OUTPUT_INFO & output_info, const OUTPUT_FORMAT output_format,
- const vector<COORD_TYPE> & vertex_coord, const vector<VERTEX_INDEX> & plist)
+ const vector<COORD_TYPE> & vertex_coord, const vector<ISO_VERTEX_INDEX> & plist)
 {
   const int dimension = output_info.dimension;
   const int numv_per_simplex = output_info.num_vertices_per_isopoly;
@@ -951,6 +1420,34 @@ void ISODUAL::write_dual_mesh
       ("Illegal dimension. OpenInventor format is only for dimension 3.");
     break;
 
+  case QMESH:
+    {
+      const std::vector<ISO_VERTEX_INDEX> empty_list;
+      std::ostream * out = &cout;
+
+      if (!flag_use_stdout) {
+        ofilename = output_info.output_qmesh_filename;
+        output_file.open(ofilename.c_str(), ios::out | ios::binary);
+        if (!output_file.good()) {
+          error.AddMessage("Unable to open file ", ofilename, ".");
+          throw error;
+        }
+        out = &output_file;
+      }
+
+      if (dimension == 3) {
+        write_qmesh(*out, output_info, vertex_coord, plist, empty_list,
+                    flag_reorder_quad_vertices);
+      }
+      else {
+        write_qmesh
+          (*out, output_info, vertex_coord, numv_per_simplex, plist);
+      }
+
+      if (!flag_use_stdout) { output_file.close(); }
+    }
+    break;
+
   default:
     throw error("Illegal output format.");
     break;
@@ -964,7 +1461,7 @@ void ISODUAL::write_dual_mesh
 // Write dual mesh.
 void ISODUAL::write_dual_mesh
 (const OUTPUT_INFO & output_info,
- const vector<COORD_TYPE> & vertex_coord, const vector<VERTEX_INDEX> & plist)
+ const vector<COORD_TYPE> & vertex_coord, const vector<ISO_VERTEX_INDEX> & plist)
 {
   IJK::PROCEDURE_ERROR error("write_dual_mesh");
 
@@ -998,27 +1495,35 @@ void ISODUAL::write_dual_mesh
       throw error;
     }
   }
+
+  if (output_info.flag_output_qmesh) {
+    if (output_info.output_qmesh_filename != "") {
+      write_dual_mesh(output_info, QMESH, vertex_coord, plist);
+    }
+    else {
+      error.AddMessage("Programming error. .qmesh file name not set.");
+      throw error;
+    }
+  }
 }
 
 
 // Write dual mesh and record output time.
 void ISODUAL::write_dual_mesh
 (const OUTPUT_INFO & output_info,
- const vector<COORD_TYPE> & vertex_coord, const vector<VERTEX_INDEX> & plist,
+ const vector<COORD_TYPE> & vertex_coord, const vector<ISO_VERTEX_INDEX> & plist,
  IO_TIME & io_time)
 {
-  ELAPSED_TIME wall_time;
+  IJK::SCOPED_TIMER timer(io_time.write_time);
 
   write_dual_mesh(output_info, vertex_coord, plist);
-
-  io_time.write_time += wall_time.getElapsed();
 }
 
 
 // Write dual mesh and color facets with output format output_format.
 void ISODUAL::write_dual_mesh_color
 (const OUTPUT_INFO & output_info, const OUTPUT_FORMAT output_format,
- const vector<COORD_TYPE> & vertex_coord, const vector<VERTEX_INDEX> & plist,
+ const vector<COORD_TYPE> & vertex_coord, const vector<ISO_VERTEX_INDEX> & plist,
  const COLOR_TYPE * front_color, const COLOR_TYPE * back_color)
 {
   const int dimension = output_info.dimension;
@@ -1071,7 +1576,7 @@ void ISODUAL::write_dual_mesh_color
 
 void ISODUAL::write_dual_mesh_color
 (const OUTPUT_INFO & output_info, 
- const vector<COORD_TYPE> & vertex_coord, const vector<VERTEX_INDEX> & plist,
+ const vector<COORD_TYPE> & vertex_coord, const vector<ISO_VERTEX_INDEX> & plist,
  const COLOR_TYPE * front_color, const COLOR_TYPE * back_color)
 {
   IJK::PROCEDURE_ERROR error("write_dual_mesh_color");
@@ -1109,20 +1614,25 @@ void ISODUAL::write_dual_mesh_color
       throw error;
     }
   }
+
+  if (output_info.flag_output_qmesh) {
+    cerr << "Warning: Writing mesh with colored faces not implemented"
+         << endl
+         << "  for .qmesh format." << endl;
+    cerr << "Skipping output of .qmesh format." << endl;
+  }
 }
 
 void ISODUAL::write_dual_mesh_color
 (const OUTPUT_INFO & output_info,
- const vector<COORD_TYPE> & vertex_coord, const vector<VERTEX_INDEX> & plist,
+ const vector<COORD_TYPE> & vertex_coord, const vector<ISO_VERTEX_INDEX> & plist,
  const COLOR_TYPE * front_color, const COLOR_TYPE * back_color,
  IO_TIME & io_time)
 {
-  ELAPSED_TIME wall_time;
+  IJK::SCOPED_TIMER timer(io_time.write_time);
 
   write_dual_mesh_color
     (output_info, vertex_coord, plist, front_color, back_color);
-
-  io_time.write_time += wall_time.getElapsed();
 }
 
 
@@ -1130,7 +1640,7 @@ void ISODUAL::write_dual_mesh_color
 void ISODUAL::write_dual_tri_mesh
 (const OUTPUT_INFO & output_info, const OUTPUT_FORMAT output_format,
  const std::vector<COORD_TYPE> & vertex_coord,
- const std::vector<VERTEX_INDEX> & tri_vert)
+ const std::vector<ISO_VERTEX_INDEX> & tri_vert)
 {
   const int NUMV_PER_QUAD = 4;
   const int NUMV_PER_TRI = 3;
@@ -1182,6 +1692,23 @@ void ISODUAL::write_dual_tri_mesh
     ijkoutIV(dimension, vertex_coord, tri_vert);
     break;
 
+  case QMESH:
+    if (!flag_use_stdout) {
+      ofilename = output_info.output_qmesh_filename;
+      output_file.open(ofilename.c_str(), ios::out | ios::binary);
+      if (!output_file.good()) {
+        error.AddMessage("Unable to open file ", ofilename, ".");
+        throw error;
+      }
+      write_qmesh(output_file, output_info, vertex_coord, 
+                  NUMV_PER_TRI, tri_vert);
+      output_file.close();
+    }
+    else {
+      write_qmesh(cout, output_info, vertex_coord, NUMV_PER_TRI, tri_vert);
+    }
+    break;
+
   default:
     throw error("Illegal output format.");
     break;
@@ -1199,7 +1726,7 @@ void ISODUAL::write_dual_tri_mesh
 void ISODUAL::write_dual_tri_mesh
 (const OUTPUT_INFO & output_info,
  const std::vector<COORD_TYPE> & vertex_coord,
- const std::vector<VERTEX_INDEX> & tri_vert)
+ const std::vector<ISO_VERTEX_INDEX> & tri_vert)
 {
   IJK::PROCEDURE_ERROR error("write_dual_tri_mesh");
 
@@ -1233,20 +1760,85 @@ void ISODUAL::write_dual_tri_mesh
       throw error;
     }
   }
+
+  if (output_info.flag_output_qmesh) {
+    if (output_info.output_qmesh_filename != "") {
+      write_dual_tri_mesh(output_info, QMESH, vertex_coord, tri_vert);
+    }
+    else {
+      error.AddMessage("Programming error. .qmesh file name not set.");
+      throw error;
+    }
+  }
 }
 
 
 void ISODUAL::write_dual_tri_mesh
 (const OUTPUT_INFO & output_info,
  const vector<COORD_TYPE> & vertex_coord,
- const vector<VERTEX_INDEX> & tri_vert,
+ const vector<ISO_VERTEX_INDEX> & tri_vert,
  IO_TIME & io_time)
 {
-  ELAPSED_TIME wall_time;
+  IJK::SCOPED_TIMER timer(io_time.write_time);
 
   write_dual_tri_mesh(output_info, vertex_coord, tri_vert);
 
-  io_time.write_time += wall_time.getElapsed();
+  if (output_info.meshlet_filename != "") 
+    { write_dual_tri_meshlets(output_info, vertex_coord, tri_vert, io_time); }
+}
+
+
+// Write dual isosurface triangular mesh as meshlets.
+void ISODUAL::write_dual_tri_meshlets
+(const OUTPUT_INFO & output_info,
+ const std::vector<COORD_TYPE> & vertex_coord,
+ const std::vector<ISO_VERTEX_INDEX> & tri_vert)
+{
+  const int dimension = output_info.dimension;
+  const string & ofilename = output_info.meshlet_filename;
+  std::vector< MESHLET<ISO_VERTEX_INDEX> > meshlet;
+  std::vector<ISO_VERTEX_INDEX> meshlet_vert;
+  std::vector<unsigned char> meshlet_tri_vert;
+  ofstream output_file;
+  PROCEDURE_ERROR error("write_dual_tri_meshlets");
+
+  if (dimension != 3) {
+    error.AddMessage("Programming error.  Illegal dimension ", dimension, ".");
+    error.AddMessage("   Routine only allowed for dimension 3.");
+    throw error;
+  }
+
+  split_triangles_into_meshlets
+    (tri_vert, output_info.meshlet_max_vert, output_info.meshlet_max_tri,
+     meshlet, meshlet_vert, meshlet_tri_vert);
+
+  output_file.open(ofilename.c_str(), ios::out | ios::binary);
+  if (!output_file.good()) {
+    error.AddMessage("Unable to open file ", ofilename, ".");
+    throw error;
+  }
+
+  ijkoutMeshletBinary
+    (output_file, dimension, vertex_coord, meshlet, meshlet_vert, 
+     meshlet_tri_vert);
+  output_file.close();
+
+  if (!output_info.flag_silent) {
+    cout << "Wrote " << meshlet.size() << " meshlets to file: " 
+         << ofilename << endl;
+  }
+}
+
+
+void ISODUAL::write_dual_tri_meshlets
+(const OUTPUT_INFO & output_info,
+ const std::vector<COORD_TYPE> & vertex_coord,
+ const std::vector<ISO_VERTEX_INDEX> & tri_vert,
+ IO_TIME & io_time)
+{
+  IJK::SCOPED_TIMER timer(io_time.write_meshlet_time);
+
+  write_dual_tri_meshlets(output_info, vertex_coord, tri_vert);
 }
 
 /// Write dual isosurface mesh of quad and triangles.
@@ -1255,14 +1847,14 @@ void ISODUAL::write_dual_tri_mesh
 void ISODUAL::write_dual_quad_tri_mesh
 (const OUTPUT_INFO & output_info, const OUTPUT_FORMAT output_format,
  const std::vector<COORD_TYPE> & vertex_coord,
- const std::vector<VERTEX_INDEX> & quad_vert,
- const std::vector<VERTEX_INDEX> & tri_vert)
+ const std::vector<ISO_VERTEX_INDEX> & quad_vert,
+ const std::vector<ISO_VERTEX_INDEX> & tri_vert)
 {
   const int NUMV_PER_QUAD = 4;
   const int NUMV_PER_TRI = 3;
   const int dimension = output_info.dimension;
   const bool flag_use_stdout = output_info.flag_use_stdout;
-  std::vector<VERTEX_INDEX> quad_vert2;
+  std::vector<ISO_VERTEX_INDEX> quad_vert2;
   ofstream output_file;
   string ofilename;
   PROCEDURE_ERROR error("write_dual_quad_tri_mesh");
@@ -1312,6 +1904,24 @@ void ISODUAL::write_dual_quad_tri_mesh
         ("Illegal dimension. PLY format is only for dimension 3.");
     break;
 
+    case QMESH:
+      if (!flag_use_stdout) {
+        ofilename = output_info.output_qmesh_filename;
+        output_file.open(ofilename.c_str(), ios::out | ios::binary);
+        if (!output_file.good()) {
+          error.AddMessage("Unable to open file ", ofilename, ".");
+          throw error;
+        }
+        write_qmesh(output_file, output_info, vertex_coord, 
+                    quad_vert2, tri_vert, false);
+        output_file.close();
+      }
+      else {
+        write_qmesh(cout, output_info, vertex_coord, 
+                    quad_vert2, tri_vert, false);
+      }
+      break;
+
     default:
       throw error("Illegal output format.");
       break;
@@ -1327,8 +1937,8 @@ void ISODUAL::write_dual_quad_tri_mesh
 void ISODUAL::write_dual_quad_tri_mesh
 (const OUTPUT_INFO & output_info,
  const std::vector<COORD_TYPE> & vertex_coord,
- const std::vector<VERTEX_INDEX> & quad_vert,
- const std::vector<VERTEX_INDEX> & tri_vert)
+ const std::vector<ISO_VERTEX_INDEX> & quad_vert,
+ const std::vector<ISO_VERTEX_INDEX> & tri_vert)
 {
   IJK::PROCEDURE_ERROR error("write_dual_quad_tri_mesh");
 
@@ -1354,6 +1964,17 @@ void ISODUAL::write_dual_quad_tri_mesh
     }
   }
 
+  if (output_info.flag_output_qmesh) {
+    if (output_info.output_qmesh_filename != "") {
+      write_dual_quad_tri_mesh
+        (output_info, QMESH, vertex_coord, quad_vert, tri_vert);
+    }
+    else {
+      error.AddMessage("Programming error. .qmesh file name not set.");
+      throw error;
+    }
+  }
+
   if (output_info.flag_output_iv) {
     cerr << "Warning: Writing quad/tri mesh not implemented"
          << endl
@@ -1367,15 +1988,13 @@ void ISODUAL::write_dual_quad_tri_mesh
 void ISODUAL::write_dual_quad_tri_mesh
 (const OUTPUT_INFO & output_info,
  const std::vector<COORD_TYPE> & vertex_coord,
- const std::vector<VERTEX_INDEX> & quad_vert,
- const std::vector<VERTEX_INDEX> & tri_vert,
+ const std::vector<ISO_VERTEX_INDEX> & quad_vert,
+ const std::vector<ISO_VERTEX_INDEX> & tri_vert,
  IO_TIME & io_time)
 {
-  ELAPSED_TIME wall_time;
+  IJK::SCOPED_TIMER timer(io_time.write_time);
 
   write_dual_quad_tri_mesh(output_info, vertex_coord, quad_vert, tri_vert);
-
-  io_time.write_time += wall_time.getElapsed();
 }
 
 
@@ -1387,7 +2006,7 @@ void ISODUAL::write_dual_quad_tri_mesh
 void ISODUAL::write_dual_tri_mesh_color_vertices
 (const OUTPUT_INFO & output_info, const OUTPUT_FORMAT output_format,
  const std::vector<COORD_TYPE> & vertex_coord,
- const std::vector<VERTEX_INDEX> & tri_vert,
+ const std::vector<ISO_VERTEX_INDEX> & tri_vert,
  const COLOR_TYPE * front_color, const COLOR_TYPE * back_color)
 {
   const int NUMV_PER_QUAD = 4;
@@ -1438,7 +2057,7 @@ void ISODUAL::write_dual_tri_mesh_color_vertices
 void ISODUAL::write_dual_tri_mesh_color_vertices
 (const OUTPUT_INFO & output_info,
  const std::vector<COORD_TYPE> & vertex_coord,
- const std::vector<VERTEX_INDEX> & tri_vert,
+ const std::vector<ISO_VERTEX_INDEX> & tri_vert,
  const COLOR_TYPE * front_color, const COLOR_TYPE * back_color)
 {
   IJK::PROCEDURE_ERROR error("write_dual_tri_mesh_color_vertices");
@@ -1469,21 +2088,27 @@ void ISODUAL::write_dual_tri_mesh_color_vertices
          << endl;
     cerr << "Skipping output of OpenInventor .iv format." << endl;
   }
+
+  if (output_info.flag_output_qmesh) {
+    cerr << "Warning: Writing tri mesh with colored vertices not"
+         << endl
+         << "  implemented for .qmesh format." 
+         << endl;
+    cerr << "Skipping output of .qmesh format." << endl;
+  }
 }
 
 void ISODUAL::write_dual_tri_mesh_color_vertices
 (const OUTPUT_INFO & output_info,
  const std::vector<COORD_TYPE> & vertex_coord,
- const std::vector<VERTEX_INDEX> & tri_vert,
+ const std::vector<ISO_VERTEX_INDEX> & tri_vert,
  const COLOR_TYPE * front_color, const COLOR_TYPE * back_color,
  IO_TIME & io_time)
 {
-  ELAPSED_TIME wall_time;
+  IJK::SCOPED_TIMER timer(io_time.write_time);
 
   write_dual_tri_mesh_color_vertices
     (output_info, vertex_coord, tri_vert, front_color, back_color);
-
-  io_time.write_time += wall_time.getElapsed();
 }
 
 
@@ -1493,15 +2118,15 @@ void ISODUAL::write_dual_tri_mesh_color_vertices
 void ISODUAL::write_dual_quad_tri_mesh_color_vertices
 (const OUTPUT_INFO & output_info, const OUTPUT_FORMAT output_format,
  const std::vector<COORD_TYPE> & vertex_coord,
- const std::vector<VERTEX_INDEX> & quad_vert,
- const std::vector<VERTEX_INDEX> & tri_vert,
+ const std::vector<ISO_VERTEX_INDEX> & quad_vert,
+ const std::vector<ISO_VERTEX_INDEX> & tri_vert,
  const COLOR_TYPE * front_color, const COLOR_TYPE * back_color)
 {
   const int NUMV_PER_QUAD = 4;
   const int NUMV_PER_TRI = 3;
   const int dimension = output_info.dimension;
   const bool flag_use_stdout = output_info.flag_use_stdout;
-  std::vector<VERTEX_INDEX> quad_vert2;
+  std::vector<ISO_VERTEX_INDEX> quad_vert2;
   ofstream output_file;
   string ofilename;
   PROCEDURE_ERROR error("write_dual_quad_tri_mesh_color_vertices");
@@ -1551,8 +2176,8 @@ void ISODUAL::write_dual_quad_tri_mesh_color_vertices
 void ISODUAL::write_dual_quad_tri_mesh_color_vertices
 (const OUTPUT_INFO & output_info,
  const std::vector<COORD_TYPE> & vertex_coord,
- const std::vector<VERTEX_INDEX> & quad_vert,
- const std::vector<VERTEX_INDEX> & tri_vert,
+ const std::vector<ISO_VERTEX_INDEX> & quad_vert,
+ const std::vector<ISO_VERTEX_INDEX> & tri_vert,
  const COLOR_TYPE * front_color, const COLOR_TYPE * back_color)
 {
   IJK::PROCEDURE_ERROR error("write_dual_quad_tri_mesh_color_vertices");
@@ -1584,23 +2209,29 @@ void ISODUAL::write_dual_quad_tri_mesh_color_vertices
          << endl;
     cerr << "Skipping output of OpenInventor .iv format." << endl;
   }
+
+  if (output_info.flag_output_qmesh) {
+    cerr << "Warning: Writing quad/tri mesh with colored vertices not"
+         << endl
+         << "  implemented for .qmesh format." 
+         << endl;
+    cerr << "Skipping output of .qmesh format." << endl;
+  }
 }
 
 
 void ISODUAL::write_dual_quad_tri_mesh_color_vertices
 (const OUTPUT_INFO & output_info,
  const std::vector<COORD_TYPE> & vertex_coord,
- const std::vector<VERTEX_INDEX> & quad_vert,
- const std::vector<VERTEX_INDEX> & tri_vert,
+ const std::vector<ISO_VERTEX_INDEX> & quad_vert,
+ const std::vector<ISO_VERTEX_INDEX> & tri_vert,
  const COLOR_TYPE * front_color, const COLOR_TYPE * back_color,
  IO_TIME & io_time)
 {
-  ELAPSED_TIME wall_time;
+  IJK::SCOPED_TIMER timer(io_time.write_time);
 
   write_dual_quad_tri_mesh_color_vertices
     (output_info, vertex_coord, quad_vert, tri_vert, front_color, back_color);
-
-  io_time.write_time += wall_time.getElapsed();
 }
 
 
@@ -1727,8 +2358,9 @@ void ISODUAL::report_num_cubes
 (const DUALISO_GRID & full_scalar_grid, const IO_INFO & io_info, 
  const DUALISO_GRID & dualiso_data_grid)
 {
-  const int num_grid_cubes = full_scalar_grid.ComputeNumCubes();
-  const int num_cubes_in_dualiso_data = dualiso_data_grid.ComputeNumCubes();
+  const VERTEX_INDEX num_grid_cubes = full_scalar_grid.ComputeNumCubes();
+  const VERTEX_INDEX num_cubes_in_dualiso_data = 
+    dualiso_data_grid.ComputeNumCubes();
 
   if (!io_info.flag_use_stdout && !io_info.flag_silent) {
 
@@ -1774,30 +2406,69 @@ void ISODUAL::warn_non_manifold(const IO_INFO & io_info)
 // REPORT TIMING INFORMATION
 // **************************************************
 
+namespace {
+
+  /// Report wall clock and CPU time.
+  /// - Report number of threads and maximum thread time
+  ///   if t records time in parallel regions.
+  void report_wall_cpu_time
+  (const char * label, const IJK::WALL_CPU_TIME & t)
+  {
+    cout << label << t.wall << " seconds (wall), "
+         << t.cpu << " seconds (cpu)." << endl;
+    if (t.thread_wall.size() > 0) {
+      cout << "      Parallel regions: " << t.thread_wall.size()
+           << " threads, max thread time " << t.MaxThreadWall()
+           << " seconds (wall)." << endl;
+    }
+  }
+
+}
+
 void ISODUAL::report_dualiso_time
 (const IO_INFO & io_info, const DUALISO_TIME & dualiso_time, 
  const char * mesh_type_string)
 {
-  cout << "CPU time to run isodual: " 
-       << dualiso_time.total << " seconds." << endl;
-  cout << "    Time to extract " << mesh_type_string << " triangles: "
-       << dualiso_time.extract << " seconds." << endl;
-  cout << "    Time to merge identical "
-       << mesh_type_string << " vertices: " 
-       << dualiso_time.merge << " seconds." << endl;
-  cout << "    Time to position "
-       << mesh_type_string << " vertices: "
-       << dualiso_time.position << " seconds." << endl;
+  const string mesh_type(mesh_type_string);
+
+  report_wall_cpu_time("Time to run isodual: ", dualiso_time.total);
+  report_wall_cpu_time
+    (("    Time to extract " + mesh_type + " polygons: ").c_str(), 
+     dualiso_time.extract);
+  report_wall_cpu_time
+    (("    Time to merge identical " + mesh_type + " vertices: ").c_str(),
+     dualiso_time.merge);
+  if (io_info.allow_multiple_iso_vertices) {
+    report_wall_cpu_time
+      ("    Time to compute cube isosurface table indices: ",
+       dualiso_time.classify);
+    report_wall_cpu_time
+      (("    Time to split " + mesh_type + " vertices: ").c_str(),
+       dualiso_time.split);
+  }
+  report_wall_cpu_time
+    (("    Time to position " + mesh_type + " vertices: ").c_str(),
+     dualiso_time.position);
   if (io_info.flag_dual_collapse) {
-    cout << "    Time to merge " << mesh_type_string << " vertices: "
-         << dualiso_time.collapse << " seconds." << endl;
+    report_wall_cpu_time
+      (("    Time to collapse " + mesh_type + " vertices: ").c_str(),
+       dualiso_time.collapse);
+  }
+  report_wall_cpu_time
+    (("    Time to rescale " + mesh_type + " vertices: ").c_str(),
+     dualiso_time.rescale);
+  if (io_info.UseTriangleMesh()) {
+    report_wall_cpu_time
+      (("    Time to triangulate " + mesh_type + ": ").c_str(),
+       dualiso_time.triangulate);
   }
 }
 
 
 void ISODUAL::report_time
 (const IO_INFO & io_info, const IO_TIME & io_time, 
- const DUALISO_TIME & dualiso_time, const double total_elapsed_time)
+ const DUALISO_TIME & dualiso_time, 
+ const IJK::WALL_CPU_TIME & total_elapsed_time)
 {
   const char * ISOSURFACE_STRING = "isosurface";
   const char * INTERVAL_VOLUME_STRING = "interval volume";
@@ -1805,19 +2476,270 @@ void ISODUAL::report_time
   
   mesh_type_string = ISOSURFACE_STRING;
 
-  cout << "Time to read file " << io_info.input_filename << ": "
-       << io_time.read_nrrd_time << " seconds." << endl;
+  const string read_label = 
+    "Time to read file " + io_info.input_filename + ": ";
+  report_wall_cpu_time(read_label.c_str(), io_time.read_nrrd_time);
 
   report_dualiso_time(io_info, dualiso_time, mesh_type_string);
   if (!io_info.flag_nowrite) {
-    cout << "Time to write "
-         << mesh_type_string << ": " 
-         << io_time.write_time << " seconds." << endl;
+    const string write_label = 
+      "Time to write " + string(mesh_type_string) + ": ";
+    report_wall_cpu_time(write_label.c_str(), io_time.write_time);
+    if (io_info.meshlet_filename != "") {
+      report_wall_cpu_time
+        ("    Time to write meshlets: ", io_time.write_meshlet_time);
+    }
   };
-  cout << "Total elapsed time: " << total_elapsed_time
-       << " seconds." << endl;
+  report_wall_cpu_time("Total elapsed time: ", total_elapsed_time);
 }
 
+
+void ISODUAL::write_time_json
+(const IO_INFO & io_info, const IO_TIME & io_time, 
+ const DUALISO_TIME & dualiso_time, 
+ const IJK::WALL_CPU_TIME & total_elapsed_time)
+{
+  IJK::PROCEDURE_ERROR error("write_time_json");
+
+  ofstream json_file(io_info.time_json_filename.c_str(), ios::out);
+  if (!json_file.good()) {
+    error.AddMessage
+      ("Unable to open file ", io_info.time_json_filename, ".");
+    throw error;
+  }
+
+  json_file << "{" << endl;
+  json_file << "  \"read\": ";
+  io_time.read_nrrd_time.WriteJSON(json_file);
+  json_file << "," << endl;
+  json_file << "  \"isodual\": ";
+  dualiso_time.WriteJSON(json_file);
+  json_file << "," << endl;
+  json_file << "  \"write\": ";
+  io_time.write_time.WriteJSON(json_file);
+  json_file << "," << endl;
+  if (io_info.meshlet_filename != "") {
+    json_file << "  \"write_meshlets\": ";
+    io_time.write_meshlet_time.WriteJSON(json_file);
+    json_file << "," << endl;
+  }
+  json_file << "  \"total\": ";
+  total_elapsed_time.WriteJSON(json_file);
+  json_file << endl << "}" << endl;
+
+  json_file.close();
+}
+
+// **************************************************
+// REPORT RUN STATISTICS
+// **************************************************
+
+ISODUAL::ISOVALUE_STATS::ISOVALUE_STATS()
+{
+  isovalue = 0;
+  num_isov = 0;
+  num_isopoly = 0;
+  num_tri = 0;
+  num_bytes_written = 0;
+}
+
+
+VERTEX_INDEX ISODUAL::ISOVALUE_STATS::NumTriangles() const
+{
+  if (dualiso_info.scalar.Dimension() == 3) 
+    { return(num_tri + 2*num_isopoly); }
+  else
+    { return(num_tri); }
+}
+
+
+long long ISODUAL::get_file_size(const std::string & filename)
+{
+  ifstream in(filename.c_str(), ios::in | ios::binary | ios::ate);
+  if (!in.good()) { return(0); }
+
+  const streamoff num_bytes = in.tellg();
+  if (num_bytes < 0) { return(0); }
+
+  return(num_bytes);
+}
+
+
+long long ISODUAL::get_output_file_size(const OUTPUT_INFO & output_info)
+{
+  long long num_bytes = 0;
+
+  if (output_info.flag_nowrite || output_info.flag_use_stdout) 
+    { return(0); }
+
+  if (output_info.flag_output_off) 
+    { num_bytes += get_file_size(output_info.output_off_filename); }
+  if (output_info.flag_output_ply) 
+    { num_bytes += get_file_size(output_info.output_ply_filename); }
+  if (output_info.flag_output_iv) 
+    { num_bytes += get_file_size(output_info.output_iv_filename); }
+  if (output_info.flag_output_qmesh) 
+    { num_bytes += get_file_size(output_info.output_qmesh_filename); }
+  if (output_info.meshlet_filename != "") 
+    { num_bytes += get_file_size(output_info.meshlet_filename); }
+
+  return(num_bytes);
+}
+
+
+long long ISODUAL::get_peak_rss()
+{
+#if defined(__unix__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) { return(-1); }
+
+#ifdef __APPLE__
+  // ru_maxrss is in bytes.
+  return(usage.ru_maxrss);
+#else
+  // ru_maxrss is in kilobytes.
+  return(1024*(long long)(usage.ru_maxrss));
+#endif
+
+#else
+  return(-1);
+#endif
+}
+
+
+namespace {
+
+  /// Write string as JSON string, escaping quotes and backslashes.
+  void write_json_string(std::ostream & out, const std::string & s)
+  {
+    out << "\"";
+    for (size_t i = 0; i < s.size(); i++) {
+      const char c = s[i];
+      if (c == '"' || c == '\\') { out << '\\' << c; }
+      else if (c == '\n') { out << "\\n"; }
+      else if (c == '\t') { out << "\\t"; }
+      else { out << c; }
+    }
+    out << "\"";
+  }
+
+
+  /// Write number of objects processed per second.
+  /// - Write null if seconds is zero.
+  void write_json_rate
+  (std::ostream & out, const double count, const double seconds)
+  {
+    if (seconds > 0) { out << count/seconds; }
+    else { out << "null"; }
+  }
+
+
+  /// Write isosurface statistics as JSON members.
+  /// - Throughput is computed from the wall clock time 
+  ///   to construct, rescale and triangulate the isosurface.
+  void write_isovalue_stats_json
+  (std::ostream & out, const ISOVALUE_STATS & stats, const char * indent)
+  {
+    const DUALISO_TIME & dualiso_time = stats.dualiso_info.time;
+    const double construct_wall_time = dualiso_time.total.wall;
+
+    out << indent << "\"num_isov\": " << stats.num_isov << "," << endl;
+    out << indent << "\"num_isopoly\": " << stats.num_isopoly << "," << endl;
+    out << indent << "\"num_tri\": " << stats.num_tri << "," << endl;
+    out << indent << "\"bytes_written\": " << stats.num_bytes_written 
+        << "," << endl;
+    out << indent << "\"write_time\": ";
+    stats.write_time.WriteJSON(out);
+    out << "," << endl;
+    out << indent << "\"dualiso_info\": ";
+    stats.dualiso_info.WriteJSON(out);
+    out << "," << endl;
+    out << indent << "\"throughput\": {\"cubes_per_sec\": ";
+    write_json_rate(out, stats.dualiso_info.grid.num_cubes, 
+                    construct_wall_time);
+    out << ", \"bipolar_edges_per_sec\": ";
+    write_json_rate(out, stats.dualiso_info.scalar.num_bipolar_edges, 
+                    construct_wall_time);
+    out << ", \"triangles_per_sec\": ";
+    write_json_rate(out, stats.NumTriangles(), construct_wall_time);
+    out << "}" << endl;
+  }
+
+}
+
+
+void ISODUAL::write_stats_json
+(const IO_INFO & io_info, const IO_TIME & io_time, 
+ const RUN_STATS & run_stats,
+ const IJK::WALL_CPU_TIME & total_elapsed_time)
+{
+  const char * indent2 = "  ";
+  const char * indent6 = "      ";
+  const long long peak_rss = get_peak_rss();
+  IJK::PROCEDURE_ERROR error("write_stats_json");
+
+  ofstream json_file(io_info.stats_json_filename.c_str(), ios::out);
+  if (!json_file.good()) {
+    error.AddMessage
+      ("Unable to open file ", io_info.stats_json_filename, ".");
+    throw error;
+  }
+
+  ISOVALUE_STATS aggregate_stats;
+  for (size_t i = 0; i < run_stats.isovalue_stats.size(); i++) {
+    const ISOVALUE_STATS & stats = run_stats.isovalue_stats[i];
+    if (i == 0) 
+      { aggregate_stats.dualiso_info = stats.dualiso_info; }
+    else 
+      { aggregate_stats.dualiso_info.Add(stats.dualiso_info); }
+    aggregate_stats.num_isov += stats.num_isov;
+    aggregate_stats.num_isopoly += stats.num_isopoly;
+    aggregate_stats.num_tri += stats.num_tri;
+    aggregate_stats.write_time.Add(stats.write_time);
+    aggregate_stats.num_bytes_written += stats.num_bytes_written;
+  }
+
+  json_file << "{" << endl;
+  json_file << indent2 << "\"input_filename\": ";
+  write_json_string(json_file, io_info.input_filename);
+  json_file << "," << endl;
+  json_file << indent2 << "\"bytes_read\": " 
+            << run_stats.num_bytes_read << "," << endl;
+  json_file << indent2 << "\"read_time\": ";
+  io_time.read_nrrd_time.WriteJSON(json_file);
+  json_file << "," << endl;
+
+  json_file << indent2 << "\"isovalues\": [" << endl;
+  for (size_t i = 0; i < run_stats.isovalue_stats.size(); i++) {
+    const ISOVALUE_STATS & stats = run_stats.isovalue_stats[i];
+    json_file << "    {" << endl;
+    json_file << indent6 << "\"isovalue\": " << stats.isovalue 
+              << "," << endl;
+    write_isovalue_stats_json(json_file, stats, indent6);
+    json_file << "    }";
+    if (i+1 < run_stats.isovalue_stats.size()) { json_file << ","; }
+    json_file << endl;
+  }
+  json_file << indent2 << "]," << endl;
+
+  json_file << indent2 << "\"aggregate\": {" << endl;
+  json_file << "    \"num_isovalues\": " 
+            << run_stats.isovalue_stats.size() << "," << endl;
+  write_isovalue_stats_json(json_file, aggregate_stats, "    ");
+  json_file << indent2 << "}," << endl;
+
+  json_file << indent2 << "\"peak_rss_bytes\": ";
+  if (peak_rss >= 0) { json_file << peak_rss; }
+  else { json_file << "null"; }
+  json_file << "," << endl;
+  json_file << indent2 << "\"total_time\": ";
+  total_elapsed_time.WriteJSON(json_file);
+  json_file << endl << "}" << endl;
+
+  json_file.close();
+}
+
+
 // **************************************************
 // USAGE/HELP MESSAGES
 // **************************************************
@@ -1944,6 +2866,8 @@ void ISODUAL::IO_INFO::Init()
   flag_output_off = false;
   flag_output_ply = false;
   flag_output_iv = false;
+  flag_output_qmesh = false;
+  qmesh_num_bits = 16;
   are_output_filenames_set = false;
   flag_report_time = false;
   flag_report_info = false;
@@ -1953,6 +2877,8 @@ void ISODUAL::IO_INFO::Init()
   flag_no_warn = false;
   flag_subsample = false;
   flag_report_all_isov = false;
+  meshlet_max_vert = 64;
+  meshlet_max_tri = 124;
   subsample_resolution = 2;
   flag_supersample = false;
   supersample_resolution = 2;
@@ -1973,6 +2899,7 @@ int ISODUAL::IO_INFO::NumOutputFormats() const
   if (flag_output_off) { num_output_formats++; }
   if (flag_output_ply) { num_output_formats++; }
   if (flag_output_iv) { num_output_formats++; }
+  if (flag_output_qmesh) { num_output_formats++; }
 
   return(num_output_formats);
 }
@@ -2001,6 +2928,10 @@ void ISODUAL::IO_INFO::SetOutputFormat(const OUTPUT_FORMAT output_format)
     flag_output_iv = true;
     break;
 
+  case QMESH:
+    flag_output_qmesh = true;
+    break;
+
   default:
     error.AddMessage
       ("Programming error. Unable to set output format to ",
@@ -2035,6 +2966,12 @@ void ISODUAL::IO_INFO::SetOutputFilename(const char * output_filename)
     are_output_filenames_set = true;
   }
 
+  if (flag_output_qmesh) {
+    output_qmesh_filename = output_filename;
+    num_output_formats++;
+    are_output_filenames_set = true;
+  }
+
   if (num_output_formats > 1) {
     error.AddMessage
       ("Programming error.  More than one output format is set.");
@@ -2065,6 +3002,10 @@ void ISODUAL::IO_INFO::SetOutputFilename
     output_iv_filename = output_filename;
     break;
 
+  case QMESH:
+    output_qmesh_filename = output_filename;
+    break;
+
   default:
     error.AddMessage
       ("Programming error.  Unknown file type ",
@@ -2108,6 +3049,7 @@ void ISODUAL::IO_INFO::ConstructOutputFilenames(const int i)
   output_off_filename = ofilename + ".off";
   output_ply_filename = ofilename + ".ply";
   output_iv_filename = ofilename + ".iv";
+  output_qmesh_filename = ofilename + ".qmesh";
 }
 
 
@@ -2128,6 +3070,15 @@ void ISODUAL::OUTPUT_INFO::Init()
 }
 
 
+void ISODUAL::OUTPUT_INFO::SetExtractionGrid
+(const int dimension, const AXIS_SIZE_TYPE * axis_size,
+ const COORD_TYPE * spacing)
+{
+  extraction_grid_axis_size.assign(axis_size, axis_size+dimension);
+  extraction_grid_spacing.assign(spacing, spacing+dimension);
+}
+
+
 void ISODUAL::OUTPUT_INFO::SetDimension(const int d)
 {
   IJK::PROCEDURE_ERROR error("OUTPUT_INFO::SetDimension");
@@ -47,7 +47,7 @@ namespace ISODUAL {
   //! Nrrd header.
   typedef IJK::NRRD_DATA<int, AXIS_SIZE_TYPE> NRRD_HEADER; 
 
-  typedef enum { OFF, IV, PLY } OUTPUT_FORMAT;    //!< Output format.
+  typedef enum { OFF, IV, PLY, QMESH } OUTPUT_FORMAT;    //!< Output format.
 
 
   // **************************************************
@@ -71,12 +71,17 @@ namespace ISODUAL {
     std::string output_off_filename;
     std::string output_ply_filename;
     std::string output_iv_filename;
+    std::string output_qmesh_filename;
     bool are_output_filenames_set;
     std::string isotable_directory;
     bool flag_output_off;    ///< Output Geomview .off file.
     bool flag_output_ply;    ///< Output PLY file.
     bool flag_output_iv;     ///< Output OpenInventor file.
+    bool flag_output_qmesh;  ///< Output quantized binary mesh file.
+    int qmesh_num_bits;      ///< Bits per quantized coordinate.
     bool flag_report_time;
+    std::string time_json_filename;  ///< JSON file for timing information.
+    std::string stats_json_filename; ///< JSON file for run statistics.
     bool flag_report_info;
     bool flag_use_stdout;
     bool flag_nowrite;
@@ -85,6 +90,9 @@ namespace ISODUAL {
     bool flag_subsample;
     bool flag_report_all_isov;
     std::string report_isov_filename;
+    std::string meshlet_filename;  ///< Binary meshlet file.
+    int meshlet_max_vert;          ///< Maximum vertices per meshlet.
+    int meshlet_max_tri;           ///< Maximum triangles per meshlet.
     int subsample_resolution;
     bool flag_supersample;
     int supersample_resolution;
@@ -163,52 +171,60 @@ namespace ISODUAL {
     int grow_factor;
     int shrink_factor;
 
+    /// Axis sizes and spacing of the grid used for isosurface extraction.
+    /// Isosurface vertices lie in cubes of this grid.
+    std::vector<AXIS_SIZE_TYPE> extraction_grid_axis_size;
+    COORD_ARRAY extraction_grid_spacing;
+
     OUTPUT_INFO() { Init(); };
     ~OUTPUT_INFO() { Init(); };
 
     void SetDimension(const int d);
+
+    /// Set extraction grid axis sizes and spacing.
+    void SetExtractionGrid
+    (const int dimension, const AXIS_SIZE_TYPE * axis_size,
+     const COORD_TYPE * spacing);
   };
 
   // **************************************************
   // TIMING FUNCTIONS/CLASSES
   // **************************************************
 
-  /// Elapsed CPU time.
-  class ELAPSED_CPU_TIME {
-
-  protected:
-    clock_t t;
-
-  public:
-    ELAPSED_CPU_TIME() { t = clock(); };
-
-    clock_t getElapsed() {
-      clock_t old_t = t;
-      t = clock();
-      return(t - old_t);
-    };
+  /// IO time.
+  struct IO_TIME {
+    IJK::WALL_CPU_TIME read_nrrd_time;  ///< Time to read nrrd file.
+    IJK::WALL_CPU_TIME write_time;      ///< Time to write output.
+    IJK::WALL_CPU_TIME write_meshlet_time;  ///< Time to write meshlets.
   };
 
-  /// Elapsed wall time.
-  class ELAPSED_TIME {
-
-  protected:
-    time_t t;
-
-  public:
-    ELAPSED_TIME() { time(&t);  };
+  // **************************************************
+  // RUN STATISTICS
+  // **************************************************
 
-    double getElapsed() {
-      time_t old_t = t;
-      time(&t);
-      return(difftime(t,old_t));
-    };
+  /// Statistics for the isosurface of a single isovalue.
+  struct ISOVALUE_STATS {
+    SCALAR_TYPE isovalue;
+    DUALISO_INFO dualiso_info;
+    VERTEX_INDEX num_isov;      ///< Number of output isosurface vertices.
+    VERTEX_INDEX num_isopoly;   ///< Number of output isosurface polygons.
+    VERTEX_INDEX num_tri;       ///< Number of output triangles.
+    IJK::WALL_CPU_TIME write_time;  ///< Time to write isosurface.
+    long long num_bytes_written;    ///< Number of bytes written.
+
+    ISOVALUE_STATS();
+
+    /// Number of triangles in output isosurface.
+    /// - In 3D, each quadrilateral counts as two triangles.
+    VERTEX_INDEX NumTriangles() const;
   };
 
-  /// IO time.
-  struct IO_TIME {
-    double read_nrrd_time;  ///< Wall time to read nrrd file.
-    double write_time;      ///< Wall time to write output.
+  /// Statistics for a run of isodual.
+  struct RUN_STATS {
+    long long num_bytes_read;   ///< Number of bytes read.
+    std::vector<ISOVALUE_STATS> isovalue_stats;
+
+    RUN_STATS() { num_bytes_read = 0; };
   };
 
   // **************************************************
@@ -274,40 +290,40 @@ namespace ISODUAL {
   void write_dual_mesh
   (const OUTPUT_INFO & output_info, const OUTPUT_FORMAT output_format,
    const std::vector<COORD_TYPE> & vertex_coord, 
-   const std::vector<VERTEX_INDEX> & plist);
+   const std::vector<ISO_VERTEX_INDEX> & plist);
 
   /// Write dual mesh.
   void write_dual_mesh
     (const OUTPUT_INFO & output_info,
      const std::vector<COORD_TYPE> & vertex_coord, 
-     const std::vector<VERTEX_INDEX> & slist);
+     const std::vector<ISO_VERTEX_INDEX> & slist);
 
   /// Write dual mesh and record output time.
   void write_dual_mesh
     (const OUTPUT_INFO & output_info,
      const std::vector<COORD_TYPE> & vertex_coord, 
-     const std::vector<VERTEX_INDEX> & slist,
+     const std::vector<ISO_VERTEX_INDEX> & slist,
      IO_TIME & io_time);
 
   /// Write dual mesh and color facets with output format output_format.
   void write_dual_mesh_color
   (const OUTPUT_INFO & output_info, const OUTPUT_FORMAT output_format,
    const std::vector<COORD_TYPE> & vertex_coord, 
-   const std::vector<VERTEX_INDEX> & plist,
+   const std::vector<ISO_VERTEX_INDEX> & plist,
    const COLOR_TYPE * front_color, const COLOR_TYPE * back_color);
 
   /// Write dual mesh and color facets.
   void write_dual_mesh_color
     (const OUTPUT_INFO & output_info,
      const std::vector<COORD_TYPE> & vertex_coord, 
-     const std::vector<VERTEX_INDEX> & slist,
+     const std::vector<ISO_VERTEX_INDEX> & slist,
      const COLOR_TYPE * front_color, const COLOR_TYPE * back_color);
 
   /// Write dual mesh, color facets, and record output time.
   void write_dual_mesh_color
     (const OUTPUT_INFO & output_info,
      const std::vector<COORD_TYPE> & vertex_coord, 
-     const std::vector<VERTEX_INDEX> & slist, 
+     const std::vector<ISO_VERTEX_INDEX> & slist, 
      const COLOR_TYPE * front_color, const COLOR_TYPE * back_color,
      IO_TIME & io_time);
 
@@ -320,7 +336,7 @@ namespace ISODUAL {
   void write_dual_tri_mesh
   (const OUTPUT_INFO & output_info, const OUTPUT_FORMAT output_format,
    const std::vector<COORD_TYPE> & vertex_coord,
-   const std::vector<VERTEX_INDEX> & tri_vert);
+   const std::vector<ISO_VERTEX_INDEX> & tri_vert);
 
   /// Write dual isosurface triangular mesh.
   /// @param output_info Output information.
@@ -330,14 +346,32 @@ namespace ISODUAL {
   void write_dual_tri_mesh
   (const OUTPUT_INFO & output_info,
    const std::vector<COORD_TYPE> & vertex_coord,
-   const std::vector<VERTEX_INDEX> & tri_vert);
+   const std::vector<ISO_VERTEX_INDEX> & tri_vert);
 
   /// Write dual isosurface triangular mesh.
-  /// Record write time.
+  /// Write meshlets if output_info.meshlet_filename is set.
+  /// Record write time, including the time to write meshlets.
   void write_dual_tri_mesh
   (const OUTPUT_INFO & output_info,
    const std::vector<COORD_TYPE> & vertex_coord,
-   const std::vector<VERTEX_INDEX> & tri_vert,
+   const std::vector<ISO_VERTEX_INDEX> & tri_vert,
+   IO_TIME & io_time);
+
+  /// Write dual isosurface triangular mesh as meshlets
+  ///   to binary file output_info.meshlet_filename.
+  /// - Each meshlet has at most output_info.meshlet_max_vert vertices
+  ///   and output_info.meshlet_max_tri triangles.
+  void write_dual_tri_meshlets
+  (const OUTPUT_INFO & output_info,
+   const std::vector<COORD_TYPE> & vertex_coord,
+   const std::vector<ISO_VERTEX_INDEX> & tri_vert);
+
+  /// Write dual isosurface triangular mesh as meshlets.
+  /// Record write time.
+  void write_dual_tri_meshlets
+  (const OUTPUT_INFO & output_info,
+   const std::vector<COORD_TYPE> & vertex_coord,
+   const std::vector<ISO_VERTEX_INDEX> & tri_vert,
    IO_TIME & io_time);
 
   /// Write dual isosurface mesh of quad and triangles.
@@ -347,8 +381,8 @@ namespace ISODUAL {
   void write_dual_quad_tri_mesh
   (const OUTPUT_INFO & output_info, const OUTPUT_FORMAT output_format,
    const std::vector<COORD_TYPE> & vertex_coord,
-   const std::vector<VERTEX_INDEX> & quad_vert,
-   const std::vector<VERTEX_INDEX> & tri_vert);
+   const std::vector<ISO_VERTEX_INDEX> & quad_vert,
+   const std::vector<ISO_VERTEX_INDEX> & tri_vert);
 
   /// Write dual isosurface mesh of quad and triangles.
   /// @param output_info Output information.
@@ -356,15 +390,15 @@ namespace ISODUAL {
   void write_dual_quad_tri_mesh
   (const OUTPUT_INFO & output_info,
    const std::vector<COORD_TYPE> & vertex_coord,
-   const std::vector<VERTEX_INDEX> & quad_vert,
-   const std::vector<VERTEX_INDEX> & tri_vert);
+   const std::vector<ISO_VERTEX_INDEX> & quad_vert,
+   const std::vector<ISO_VERTEX_INDEX> & tri_vert);
 
   /// Write dual isosurface mesh of quad and triangles and record output time.
   void write_dual_quad_tri_mesh
   (const OUTPUT_INFO & output_info,
    const std::vector<COORD_TYPE> & vertex_coord,
-   const std::vector<VERTEX_INDEX> & quad_vert,
-   const std::vector<VERTEX_INDEX> & tri_vert,
+   const std::vector<ISO_VERTEX_INDEX> & quad_vert,
+   const std::vector<ISO_VERTEX_INDEX> & tri_vert,
    IO_TIME & io_time);
 
   /// Write dual isosurface triangular mesh and color vertices
@@ -377,7 +411,7 @@ namespace ISODUAL {
   void write_dual_tri_mesh_color_vertices
   (const OUTPUT_INFO & output_info, const OUTPUT_FORMAT output_format,
    const std::vector<COORD_TYPE> & vertex_coord,
-   const std::vector<VERTEX_INDEX> & tri_vert,
+   const std::vector<ISO_VERTEX_INDEX> & tri_vert,
    const COLOR_TYPE * front_color, const COLOR_TYPE * back_color);
 
   /// Write dual isosurface triangular mesh, color vertices.
@@ -388,7 +422,7 @@ namespace ISODUAL {
   void write_dual_tri_mesh_color_vertices
   (const OUTPUT_INFO & output_info,
    const std::vector<COORD_TYPE> & vertex_coord,
-   const std::vector<VERTEX_INDEX> & tri_vert,
+   const std::vector<ISO_VERTEX_INDEX> & tri_vert,
    const COLOR_TYPE * front_color, const COLOR_TYPE * back_color);
 
   /// Write dual isosurface triangular mesh, color vertices 
@@ -396,7 +430,7 @@ namespace ISODUAL {
   void write_dual_tri_mesh_color_vertices
   (const OUTPUT_INFO & output_info,
    const std::vector<COORD_TYPE> & vertex_coord,
-   const std::vector<VERTEX_INDEX> & tri_vert,
+   const std::vector<ISO_VERTEX_INDEX> & tri_vert,
    const COLOR_TYPE * front_color, const COLOR_TYPE * back_color,
    IO_TIME & io_time);
 
@@ -408,8 +442,8 @@ namespace ISODUAL {
   void write_dual_quad_tri_mesh_color_vertices
   (const OUTPUT_INFO & output_info, const OUTPUT_FORMAT output_format,
    const std::vector<COORD_TYPE> & vertex_coord,
-   const std::vector<VERTEX_INDEX> & quad_vert,
-   const std::vector<VERTEX_INDEX> & tri_vert,
+   const std::vector<ISO_VERTEX_INDEX> & quad_vert,
+   const std::vector<ISO_VERTEX_INDEX> & tri_vert,
    const COLOR_TYPE * front_color, const COLOR_TYPE * back_color);
 
   /// Write dual isosurface mesh of quad and triangles and color vertices.
@@ -418,8 +452,8 @@ namespace ISODUAL {
   void write_dual_quad_tri_mesh_color_vertices
   (const OUTPUT_INFO & output_info,
    const std::vector<COORD_TYPE> & vertex_coord,
-   const std::vector<VERTEX_INDEX> & quad_vert,
-   const std::vector<VERTEX_INDEX> & tri_vert,
+   const std::vector<ISO_VERTEX_INDEX> & quad_vert,
+   const std::vector<ISO_VERTEX_INDEX> & tri_vert,
    const COLOR_TYPE * front_color, const COLOR_TYPE * back_color);
 
   /// Write dual isosurface mesh of quad and triangles, color vertices,
@@ -427,8 +461,8 @@ namespace ISODUAL {
   void write_dual_quad_tri_mesh_color_vertices
   (const OUTPUT_INFO & output_info,
    const std::vector<COORD_TYPE> & vertex_coord,
-   const std::vector<VERTEX_INDEX> & quad_vert,
-   const std::vector<VERTEX_INDEX> & tri_vert,
+   const std::vector<ISO_VERTEX_INDEX> & quad_vert,
+   const std::vector<ISO_VERTEX_INDEX> & tri_vert,
    const COLOR_TYPE * front_color, const COLOR_TYPE * back_color,
    IO_TIME & io_time);
 
@@ -480,7 +514,39 @@ namespace ISODUAL {
 
   void report_time
     (const IO_INFO & io_info, const IO_TIME & io_time, 
-     const DUALISO_TIME & dualiso_time, const double total_elapsed_time);
+     const DUALISO_TIME & dualiso_time, 
+     const IJK::WALL_CPU_TIME & total_elapsed_time);
+
+  /// Write timing information to file io_info.time_json_filename
+  ///   as a JSON object.
+  void write_time_json
+    (const IO_INFO & io_info, const IO_TIME & io_time, 
+     const DUALISO_TIME & dualiso_time, 
+     const IJK::WALL_CPU_TIME & total_elapsed_time);
+
+
+  // **************************************************
+  // REPORT RUN STATISTICS
+  // **************************************************
+
+  /// Return size of file in bytes.  Return 0 if file cannot be opened.
+  long long get_file_size(const std::string & filename);
+
+  /// Return total size in bytes of isosurface files in output_info.
+  long long get_output_file_size(const OUTPUT_INFO & output_info);
+
+  /// Return peak resident set size of the process in bytes.
+  /// Return -1 if peak resident set size is not available.
+  long long get_peak_rss();
+
+  /// Write run statistics to file io_info.stats_json_filename
+  ///   as a JSON object.
+  /// - Includes statistics for each isovalue and aggregated statistics.
+  /// - Throughput is computed from wall clock time.
+  void write_stats_json
+    (const IO_INFO & io_info, const IO_TIME & io_time, 
+     const RUN_STATS & run_stats,
+     const IJK::WALL_CPU_TIME & total_elapsed_time);
 
 
   // **************************************************
@@ -0,0 +1,514 @@
+/// \file isodual_brick.cxx
+/// Dual contouring of one brick of a decomposed grid.
+
+/*
+  IJK: Isosurface Jeneration Kode
+  Copyright (C) 2017 Rephael Wenger
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License
+  (LGPL) as published by the Free Software Foundation; either
+  version 2.1 of the License, or any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <unordered_map>
+
+#include "ijkIO.txx"
+#include "ijkdual_position.txx"
+#include "ijkdual_triangulate.txx"
+
+#include "isodual.h"
+#include "isodualIO.h"
+#include "isodual_brick.h"
+
+using namespace IJK;
+using namespace ISODUAL;
+
+
+// **************************************************
+// CLASS BRICK_INFO
+// **************************************************
+
+void ISODUAL::BRICK_INFO::Set
+(const int dimension, const AXIS_SIZE_TYPE * global_axis_size,
+ const GRID_BOX & owned_box)
+{
+  this->global_axis_size.assign
+    (global_axis_size, global_axis_size+dimension);
+  this->owned_box = owned_box;
+
+  offset.resize(dimension);
+  for (int d = 0; d < dimension; d++)
+    { offset[d] = std::max(owned_box.MinCoord(d)-1, VERTEX_INDEX(0)); }
+}
+
+void ISODUAL::BRICK_INFO::GetBrickBox(GRID_BOX & brick_box) const
+{
+  const int dimension = Dimension();
+
+  brick_box.SetDimension(dimension);
+  for (int d = 0; d < dimension; d++) {
+    brick_box.SetMinCoord
+      (d, std::max(owned_box.MinCoord(d)-1, VERTEX_INDEX(0)));
+    brick_box.SetMaxCoord
+      (d, std::min(owned_box.MaxCoord(d)+1,
+                   VERTEX_INDEX(global_axis_size[d]-1)));
+  }
+}
+
+GLOBAL_ISOV_INDEX ISODUAL::BRICK_INFO::GlobalCubeIndex
+(const DUALISO_GRID & brick_grid, const VERTEX_INDEX cube_index) const
+{
+  const int dimension = Dimension();
+  std::vector<long> coord(dimension);
+  GLOBAL_ISOV_INDEX global_index = 0;
+  GLOBAL_ISOV_INDEX increment = 1;
+
+  brick_grid.ComputeCoord(cube_index, &(coord.front()));
+  for (int d = 0; d < dimension; d++) {
+    global_index += (coord[d]+offset[d])*increment;
+    increment *= global_axis_size[d];
+  }
+
+  return(global_index);
+}
+
+bool ISODUAL::BRICK_INFO::Check
+(const DUALISO_GRID & brick_grid, IJK::ERROR & error) const
+{
+  const int dimension = Dimension();
+
+  if (dimension < 1) {
+    error.AddMessage("Brick global axis sizes are not set.");
+    return(false);
+  }
+
+  if (brick_grid.Dimension() != dimension ||
+      int(offset.size()) != dimension ||
+      owned_box.Dimension() != dimension) {
+    error.AddMessage
+      ("Brick grid dimension ", brick_grid.Dimension(),
+       " does not match global grid dimension ", dimension, ".");
+    return(false);
+  }
+
+  for (int d = 0; d < dimension; d++) {
+    if (owned_box.MinCoord(d) < 0 ||
+        owned_box.MinCoord(d) > owned_box.MaxCoord(d) ||
+        owned_box.MaxCoord(d) >= global_axis_size[d]) {
+      error.AddMessage
+        ("Illegal owned box coordinate ", d, " range [",
+         owned_box.MinCoord(d), ",", owned_box.MaxCoord(d), "].");
+      error.AddMessage
+        ("  Range must be contained in [0,", global_axis_size[d]-1, "].");
+      return(false);
+    }
+  }
+
+  GRID_BOX brick_box;
+  GetBrickBox(brick_box);
+  for (int d = 0; d < dimension; d++) {
+    const VERTEX_INDEX brick_max = offset[d]+brick_grid.AxisSize(d)-1;
+    if (brick_box.MinCoord(d) < offset[d] ||
+        brick_box.MaxCoord(d) > brick_max) {
+      error.AddMessage
+        ("Brick grid coordinate ", d, " range [", offset[d], ",",
+         brick_max, "] does not contain owned box");
+      error.AddMessage
+        ("  plus ghost layer [", brick_box.MinCoord(d), ",",
+         brick_box.MaxCoord(d), "].");
+      return(false);
+    }
+  }
+
+  return(true);
+}
+
+
+// **************************************************
+// CLASS BRICK_MESH
+// **************************************************
+
+void ISODUAL::BRICK_MESH::Clear()
+{
+  dimension = 0;
+  num_vert_per_poly = 0;
+  vertex_id.clear();
+  vertex_coord.clear();
+  poly_vert.clear();
+}
+
+
+// **************************************************
+// BRICK DUAL CONTOURING
+// **************************************************
+
+namespace {
+
+  bool check_brick_flags
+  (const DUALISO_DATA & dualiso_data, IJK::ERROR & error)
+  {
+    if (dualiso_data.AllowMultipleIsoVertices()) {
+      if (dualiso_data.SplitNonManifoldFlag() ||
+          dualiso_data.SelectSplitFlag() ||
+          dualiso_data.ConnectAmbiguousFlag()) {
+        error.AddMessage
+          ("Brick contouring with multiple isosurface vertices per cube");
+        error.AddMessage
+          ("  does not support splitting non-manifold vertices"
+           " or selecting ambiguous configurations.");
+        return(false);
+      }
+    }
+
+    if (dualiso_data.CollapseFlag() || dualiso_data.AdaptiveOctreeFlag() ||
+        dualiso_data.flag_tri4_quad || dualiso_data.ReorderVertexCacheFlag()) {
+      error.AddMessage
+        ("Brick contouring does not support collapse, adaptive octree,");
+      error.AddMessage
+        ("  tri4 triangulation or vertex cache reordering.");
+      return(false);
+    }
+
+    if (dualiso_data.ROIFlag()) {
+      error.AddMessage
+        ("Brick contouring does not support a region of interest.");
+      return(false);
+    }
+
+    return(true);
+  }
+
+}
+
+
+void ISODUAL::dual_contouring_brick
+(DUALISO_DATA & dualiso_data, const SCALAR_TYPE isovalue,
+ const BRICK_INFO & brick, BRICK_MESH & mesh,
+ DUALISO_INFO & dualiso_info, DUALISO_CONTEXT & context)
+{
+  const DUALISO_SCALAR_GRID_BASE & brick_grid = dualiso_data.ScalarGrid();
+  const int dimension = brick_grid.Dimension();
+  const int num_facet_vertices = brick_grid.NumFacetVertices();
+  IJK::PROCEDURE_ERROR error("dual_contouring_brick");
+
+  mesh.Clear();
+
+  if (!brick.Check(brick_grid, error)) { throw error; }
+  if (!check_brick_flags(dualiso_data, error)) { throw error; }
+
+  if (dualiso_data.UseTriangleMesh() && dimension != 3) {
+    error.AddMessage("Illegal dimension ", dimension, ".");
+    error.AddMessage("  Triangulation requires dimension 3.");
+    throw error;
+  }
+
+  // Owned box in brick grid coordinates.
+  GRID_BOX owned_box(dimension);
+  for (int d = 0; d < dimension; d++) {
+    owned_box.SetMinMaxCoord
+      (d, brick.owned_box.MinCoord(d)-brick.offset[d],
+       brick.owned_box.MaxCoord(d)-brick.offset[d]);
+  }
+  dualiso_data.SetBrickOwnedBox(owned_box);
+
+  DUAL_ISOSURFACE dual_isosurface(dimension, num_facet_vertices);
+  dual_contouring
+    (dualiso_data, isovalue, dual_isosurface, dualiso_info, context);
+  convert_cube_relative_coord(brick_grid, dual_isosurface);
+
+  // Global isosurface vertex indices from global cube indices.
+  const VERTEX_INDEX numv = dual_isosurface.NumIsoVert();
+  mesh.vertex_id.resize(numv);
+  if (dualiso_data.AllowMultipleIsoVertices()) {
+    const GLOBAL_ISOV_INDEX max_isov_per_cube =
+      brick_grid.NumCubeVertices()/2;
+
+    if (VERTEX_INDEX(context.iso_vlist.size()) != numv) {
+      error.AddMessage
+        ("Programming error.  Isosurface vertex list size ",
+         context.iso_vlist.size(), " does not match number of vertices ",
+         numv, ".");
+      throw error;
+    }
+
+    for (VERTEX_INDEX i = 0; i < numv; i++) {
+      const DUAL_ISOVERT & isov = context.iso_vlist[i];
+      mesh.vertex_id[i] =
+        brick.GlobalCubeIndex(brick_grid, isov.cube_index)*max_isov_per_cube
+        + isov.patch_index;
+    }
+  }
+  else {
+    if (VERTEX_INDEX(context.cube_list.size()) != numv) {
+      error.AddMessage
+        ("Programming error.  Cube list size ", context.cube_list.size(),
+         " does not match number of vertices ", numv, ".");
+      throw error;
+    }
+
+    for (VERTEX_INDEX i = 0; i < numv; i++) {
+      mesh.vertex_id[i] =
+        brick.GlobalCubeIndex(brick_grid, context.cube_list[i]);
+    }
+  }
+
+  // Translate to global grid coordinates.
+  COORD_ARRAY & vertex_coord = dual_isosurface.vertex_coord;
+  for (VERTEX_INDEX i = 0; i < numv; i++) {
+    for (int d = 0; d < dimension; d++)
+      { vertex_coord[i*dimension+d] += brick.offset[d]; }
+  }
+  rescale_vertex_coord
+    (dimension, brick_grid.SpacingPtrConst(), vertex_coord);
+
+  mesh.dimension = dimension;
+  if (dualiso_data.UseTriangleMesh()) {
+    convert_quad_to_tri_in_place
+      (dualiso_data, dual_isosurface, (IJK::WALL_CPU_TIME *) NULL);
+    mesh.num_vert_per_poly = 3;
+    mesh.poly_vert.swap(dual_isosurface.tri_vert);
+  }
+  else {
+    mesh.num_vert_per_poly = dual_isosurface.NumVerticesPerIsoPoly();
+    mesh.poly_vert.swap(dual_isosurface.isopoly_vert);
+  }
+  mesh.vertex_coord.swap(vertex_coord);
+}
+
+
+void ISODUAL::dual_contouring_brick
+(DUALISO_DATA & dualiso_data, const SCALAR_TYPE isovalue,
+ const BRICK_INFO & brick, BRICK_MESH & mesh,
+ DUALISO_INFO & dualiso_info)
+{
+  DUALISO_CONTEXT context;
+
+  dual_contouring_brick
+    (dualiso_data, isovalue, brick, mesh, dualiso_info, context);
+}
+
+
+void ISODUAL::copy_brick
+(const DUALISO_SCALAR_GRID_BASE & global_grid, const BRICK_INFO & brick,
+ DUALISO_SCALAR_GRID & brick_grid)
+{
+  const int dimension = global_grid.Dimension();
+  IJK::PROCEDURE_ERROR error("copy_brick");
+
+  if (brick.Dimension() != dimension) {
+    error.AddMessage
+      ("Brick dimension ", brick.Dimension(),
+       " does not match grid dimension ", dimension, ".");
+    throw error;
+  }
+
+  GRID_BOX brick_box;
+  brick.GetBrickBox(brick_box);
+
+  std::vector<AXIS_SIZE_TYPE> axis_size(dimension);
+  for (int d = 0; d < dimension; d++) {
+    if (brick.offset[d] != brick_box.MinCoord(d)) {
+      error.AddMessage
+        ("Brick offset ", brick.offset[d], " in direction ", d,
+         " does not match owned box plus ghost layer.");
+      throw error;
+    }
+    axis_size[d] = brick_box.MaxCoord(d)-brick_box.MinCoord(d)+1;
+  }
+
+  brick_grid.SetSize(dimension, &(axis_size.front()));
+  brick_grid.SetSpacing(global_grid.SpacingPtrConst());
+  brick_grid.CopyRegion(global_grid, brick_box, 0);
+}
+
+
+// **************************************************
+// MERGE BRICK MESHES
+// **************************************************
+
+void ISODUAL::merge_brick_meshes
+(const std::vector<BRICK_MESH> & brick_mesh, BRICK_MESH & mesh,
+ VERTEX_INDEX & num_shared)
+{
+  std::unordered_map<GLOBAL_ISOV_INDEX, ISO_VERTEX_INDEX> merged_index;
+  std::vector<ISO_VERTEX_INDEX> new_index;
+  IJK::PROCEDURE_ERROR error("merge_brick_meshes");
+
+  mesh.Clear();
+  num_shared = 0;
+
+  if (brick_mesh.size() == 0) { return; }
+
+  const int dimension = brick_mesh[0].dimension;
+  mesh.dimension = dimension;
+  mesh.num_vert_per_poly = brick_mesh[0].num_vert_per_poly;
+
+  for (std::size_t j = 0; j < brick_mesh.size(); j++) {
+    const BRICK_MESH & bmesh = brick_mesh[j];
+
+    if (bmesh.dimension != mesh.dimension ||
+        bmesh.num_vert_per_poly != mesh.num_vert_per_poly) {
+      error.AddMessage
+        ("Brick mesh ", j, " dimension or number of polygon vertices");
+      error.AddMessage("  does not match brick mesh 0.");
+      throw error;
+    }
+
+    new_index.resize(bmesh.NumVertices());
+    for (VERTEX_INDEX i = 0; i < bmesh.NumVertices(); i++) {
+      const GLOBAL_ISOV_INDEX id = bmesh.vertex_id[i];
+      auto iter = merged_index.find(id);
+      if (iter == merged_index.end()) {
+        new_index[i] = mesh.NumVertices();
+        merged_index[id] = new_index[i];
+        mesh.vertex_id.push_back(id);
+        mesh.vertex_coord.insert
+          (mesh.vertex_coord.end(), bmesh.vertex_coord.begin()+i*dimension,
+           bmesh.vertex_coord.begin()+(i+1)*dimension);
+      }
+      else {
+        new_index[i] = iter->second;
+        num_shared++;
+      }
+    }
+
+    for (std::size_t k = 0; k < bmesh.poly_vert.size(); k++)
+      { mesh.poly_vert.push_back(new_index[bmesh.poly_vert[k]]); }
+  }
+}
+
+
+// **************************************************
+// READ/WRITE BRICK MESHES
+// **************************************************
+
+void ISODUAL::write_brick_mesh
+(const std::string & filename, const BRICK_MESH & mesh)
+{
+  const int dimension = mesh.dimension;
+  std::ofstream output_file;
+  IJK::PROCEDURE_ERROR error("write_brick_mesh");
+
+  output_file.open(filename.c_str(), std::ios::out);
+  if (!output_file.good()) {
+    error.AddMessage("Unable to open output file ", filename, ".");
+    throw error;
+  }
+
+  output_file << std::setprecision
+    (std::numeric_limits<COORD_TYPE>::max_digits10);
+  output_file << "ISODUAL_BRICK_MESH" << std::endl;
+  output_file << mesh.dimension << " " << mesh.num_vert_per_poly
+              << std::endl;
+  output_file << mesh.NumVertices() << " " << mesh.NumPoly() << std::endl;
+
+  for (VERTEX_INDEX i = 0; i < mesh.NumVertices(); i++) {
+    output_file << mesh.vertex_id[i];
+    for (int d = 0; d < dimension; d++)
+      { output_file << " " << mesh.vertex_coord[i*dimension+d]; }
+    output_file << std::endl;
+  }
+
+  for (VERTEX_INDEX ip = 0; ip < mesh.NumPoly(); ip++) {
+    for (int k = 0; k < mesh.num_vert_per_poly; k++) {
+      if (k > 0) { output_file << " "; }
+      output_file << mesh.poly_vert[ip*mesh.num_vert_per_poly+k];
+    }
+    output_file << std::endl;
+  }
+
+  if (!output_file.good()) {
+    error.AddMessage("Error writing output file ", filename, ".");
+    throw error;
+  }
+  output_file.close();
+}
+
+
+void ISODUAL::read_brick_mesh
+(const std::string & filename, BRICK_MESH & mesh)
+{
+  std::ifstream input_file;
+  std::string header;
+  VERTEX_INDEX numv, num_poly;
+  IJK::PROCEDURE_ERROR error("read_brick_mesh");
+
+  mesh.Clear();
+
+  input_file.open(filename.c_str(), std::ios::in);
+  if (!input_file.good()) {
+    error.AddMessage("Unable to open input file ", filename, ".");
+    throw error;
+  }
+
+  input_file >> header;
+  if (header != "ISODUAL_BRICK_MESH") {
+    error.AddMessage("File ", filename, " is not a brick mesh file.");
+    throw error;
+  }
+
+  input_file >> mesh.dimension >> mesh.num_vert_per_poly;
+  input_file >> numv >> num_poly;
+  if (!input_file.good() || mesh.dimension < 1 ||
+      mesh.num_vert_per_poly < 1 || numv < 0 || num_poly < 0) {
+    error.AddMessage("Illegal brick mesh header in file ", filename, ".");
+    throw error;
+  }
+
+  mesh.vertex_id.resize(numv);
+  mesh.vertex_coord.resize(numv*mesh.dimension);
+  for (VERTEX_INDEX i = 0; i < numv; i++) {
+    input_file >> mesh.vertex_id[i];
+    for (int d = 0; d < mesh.dimension; d++)
+      { input_file >> mesh.vertex_coord[i*mesh.dimension+d]; }
+  }
+
+  mesh.poly_vert.resize(num_poly*mesh.num_vert_per_poly);
+  for (std::size_t k = 0; k < mesh.poly_vert.size(); k++) {
+    input_file >> mesh.poly_vert[k];
+    if (mesh.poly_vert[k] < 0 || mesh.poly_vert[k] >= numv) {
+      error.AddMessage
+        ("Illegal polygon vertex ", mesh.poly_vert[k],
+         " in file ", filename, ".");
+      throw error;
+    }
+  }
+
+  if (input_file.fail()) {
+    error.AddMessage("Error reading brick mesh file ", filename, ".");
+    throw error;
+  }
+  input_file.close();
+}
+
+
+void ISODUAL::write_brick_mesh_off
+(const std::string & filename, const BRICK_MESH & mesh)
+{
+  std::ofstream output_file;
+  IJK::PROCEDURE_ERROR error("write_brick_mesh_off");
+
+  output_file.open(filename.c_str(), std::ios::out);
+  if (!output_file.good()) {
+    error.AddMessage("Unable to open output file ", filename, ".");
+    throw error;
+  }
+
+  ijkoutOFF(output_file, mesh.dimension, mesh.num_vert_per_poly,
+            mesh.vertex_coord, mesh.poly_vert);
+  output_file.close();
+}
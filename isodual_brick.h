@@ -0,0 +1,192 @@
+/// \file isodual_brick.h
+/// Dual contouring of one brick of a decomposed grid.
+/// Isosurface vertices have global indices, so brick meshes
+///   can be merged without duplicating vertices along brick seams.
+
+/*
+  IJK: Isosurface Jeneration Kode
+  Copyright (C) 2017 Rephael Wenger
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License
+  (LGPL) as published by the Free Software Foundation; either
+  version 2.1 of the License, or any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef _ISODUAL_BRICK_
+#define _ISODUAL_BRICK_
+
+#include <string>
+#include <vector>
+
+#include "ijk.txx"
+
+#include "isodual_types.h"
+#include "isodual_datastruct.h"
+
+
+/// isodual brick classes and routines.
+namespace ISODUAL {
+
+  /// Global isosurface vertex index.
+  /// - Single isosurface vertex per cube: Global index of the grid cube.
+  /// - Multiple isosurface vertices per cube:
+  ///     (global cube index)*(max isosurface vertices per cube)
+  ///     + (isosurface patch index in cube).
+  typedef long long GLOBAL_ISOV_INDEX;
+
+
+  // **************************************************
+  // BRICK INFO
+  // **************************************************
+
+  /// Location of a brick in a decomposed grid.
+  /// - Bricks own disjoint boxes of grid vertices which cover
+  ///   the decomposed (global) grid.
+  /// - A brick grid contains the owned box plus a one vertex
+  ///   ghost layer, clipped to the global grid.
+  class BRICK_INFO {
+
+  public:
+    /// Axis sizes of the global grid.
+    std::vector<AXIS_SIZE_TYPE> global_axis_size;
+
+    /// Global coordinates of vertex 0 of the brick grid.
+    std::vector<VERTEX_INDEX> offset;
+
+    /// Global coordinates of grid vertices owned by the brick.
+    GRID_BOX owned_box;
+
+  public:
+    int Dimension() const
+      { return(global_axis_size.size()); }
+
+    /// Set global_axis_size and owned_box and set offset
+    ///   to the lowest vertex of the owned box plus ghost layer.
+    void Set(const int dimension, const AXIS_SIZE_TYPE * global_axis_size,
+             const GRID_BOX & owned_box);
+
+    /// Return box of global grid vertices needed by brick.
+    /// Owned box plus one vertex ghost layer, clipped to the global grid.
+    void GetBrickBox(GRID_BOX & brick_box) const;
+
+    /// Return global index of brick_grid cube cube_index.
+    GLOBAL_ISOV_INDEX GlobalCubeIndex
+      (const DUALISO_GRID & brick_grid, const VERTEX_INDEX cube_index) const;
+
+    /// Return false and set error message if brick information is not
+    ///   consistent or brick_grid does not contain the owned box
+    ///   plus ghost layer.
+    bool Check(const DUALISO_GRID & brick_grid, IJK::ERROR & error) const;
+  };
+
+
+  // **************************************************
+  // BRICK MESH
+  // **************************************************
+
+  /// Isosurface mesh of a brick, or of merged bricks.
+  class BRICK_MESH {
+
+  public:
+    int dimension;
+    int num_vert_per_poly;
+
+    /// vertex_id[i] = Global index of isosurface vertex i.
+    std::vector<GLOBAL_ISOV_INDEX> vertex_id;
+
+    /// Vertex coordinates in the global grid, scaled by grid spacing.
+    COORD_ARRAY vertex_coord;
+
+    /// Polygon vertices.  Indices into vertex_id and vertex_coord.
+    std::vector<ISO_VERTEX_INDEX> poly_vert;
+
+  public:
+    BRICK_MESH() { Clear(); };
+
+    VERTEX_INDEX NumVertices() const
+    { return(vertex_id.size()); };
+    VERTEX_INDEX NumPoly() const
+    { return((num_vert_per_poly > 0) ?
+             poly_vert.size()/num_vert_per_poly : 0); };
+
+    void Clear();
+  };
+
+
+  // **************************************************
+  // BRICK DUAL CONTOURING
+  // **************************************************
+
+  /// Construct isosurface polytopes dual to grid edges owned by brick.
+  /// - dualiso_data.ScalarGrid() is the brick grid.
+  /// - Sets the brick owned box in dualiso_data.
+  /// - Isosurface vertices in different bricks with the same
+  ///   global index have the same coordinates.
+  /// - Multiple isosurface vertices per cube require
+  ///   dualiso_data.SplitNonManifoldFlag(), SelectSplitFlag() and
+  ///   ConnectAmbiguousFlag() to be false, since those depend
+  ///   on neighboring cubes which may be outside the brick.
+  /// - Collapse, adaptive octree, tri4 triangulation and
+  ///   vertex cache reordering are not supported.
+  void dual_contouring_brick
+    (DUALISO_DATA & dualiso_data, const SCALAR_TYPE isovalue,
+     const BRICK_INFO & brick, BRICK_MESH & mesh,
+     DUALISO_INFO & dualiso_info, DUALISO_CONTEXT & context);
+
+  /// Construct isosurface polytopes dual to grid edges owned by brick.
+  /// Version without context.
+  void dual_contouring_brick
+    (DUALISO_DATA & dualiso_data, const SCALAR_TYPE isovalue,
+     const BRICK_INFO & brick, BRICK_MESH & mesh,
+     DUALISO_INFO & dualiso_info);
+
+  /// Copy brick (owned box plus ghost layer) from global grid.
+  /// - Used to simulate decomposed grids from a single volume.
+  void copy_brick
+    (const DUALISO_SCALAR_GRID_BASE & global_grid, const BRICK_INFO & brick,
+     DUALISO_SCALAR_GRID & brick_grid);
+
+
+  // **************************************************
+  // MERGE BRICK MESHES
+  // **************************************************
+
+  /// Merge brick meshes into a single mesh.
+  /// - Vertices with the same global index are merged.
+  /// - Merged vertices are in order of first appearance.
+  /// @param[out] num_shared Number of vertices appearing
+  ///   in more than one brick mesh.
+  void merge_brick_meshes
+    (const std::vector<BRICK_MESH> & brick_mesh, BRICK_MESH & mesh,
+     VERTEX_INDEX & num_shared);
+
+
+  // **************************************************
+  // READ/WRITE BRICK MESHES
+  // **************************************************
+
+  /// Write brick mesh, including global vertex indices.
+  void write_brick_mesh
+    (const std::string & filename, const BRICK_MESH & mesh);
+
+  /// Read brick mesh written by write_brick_mesh.
+  void read_brick_mesh
+    (const std::string & filename, BRICK_MESH & mesh);
+
+  /// Write brick mesh in Geomview .off format.
+  void write_brick_mesh_off
+    (const std::string & filename, const BRICK_MESH & mesh);
+
+}
+
+#endif
@@ -0,0 +1,303 @@
+/// \file isodual_brick_main.cxx
+/// Dual contour one brick of a decomposed grid.
+/// Writes a brick mesh with global isosurface vertex indices.
+
+/*
+  IJK: Isosurface Jeneration Kode
+  Copyright (C) 2017 Rephael Wenger
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License
+  (LGPL) as published by the Free Software Foundation; either
+  version 2.1 of the License, or any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "ijkcommand_line.txx"
+
+#include "isodualIO.h"
+#include "isodual_brick.h"
+
+using namespace IJK;
+
+// Not "using namespace ISODUAL", since isodualIO.h declares
+//   usage_error() and help() for isodual.
+using ISODUAL::SCALAR_TYPE;
+using ISODUAL::GRID_BOX;
+using ISODUAL::DUALISO_DATA_FLAGS;
+using ISODUAL::DUALISO_DATA;
+using ISODUAL::DUALISO_SCALAR_GRID;
+using ISODUAL::DUALISO_INFO;
+using ISODUAL::NRRD_HEADER;
+using ISODUAL::IO_TIME;
+using ISODUAL::BRICK_INFO;
+using ISODUAL::BRICK_MESH;
+
+using namespace std;
+
+// global constants
+const int DIM3(3);
+
+// global variables
+SCALAR_TYPE isovalue;
+std::string input_filename;
+std::string output_filename;
+int owned_coord[2*DIM3];
+int offset[DIM3];
+int global_axis_size[DIM3];
+bool is_owned_set = false;
+bool is_offset_set = false;
+bool is_global_size_set = false;
+bool flag_crop = false;
+bool flag_verbose = false;
+DUALISO_DATA_FLAGS flags;
+
+// local subroutines
+void parse_command_line(int argc, char **argv);
+void get_arg_int_list
+  (const int iarg, const int argc, char **argv, const int n, int * list);
+void usage_error();
+void help();
+void memory_exhaustion();
+
+
+// **************************************************
+// MAIN
+// **************************************************
+
+int main(int argc, char **argv)
+{
+  try {
+
+    std::set_new_handler(memory_exhaustion);
+
+    parse_command_line(argc, argv);
+
+    DUALISO_SCALAR_GRID input_grid;
+    NRRD_HEADER nrrd_header;
+    IO_TIME io_time;
+    read_nrrd_file(input_filename, input_grid, nrrd_header, io_time);
+
+    if (input_grid.Dimension() != DIM3) {
+      cerr << "Error.  Brick contouring requires a 3D grid." << endl;
+      exit(20);
+    }
+
+    GRID_BOX owned_box(DIM3);
+    owned_box.SetMinCoord(owned_coord);
+    owned_box.SetMaxCoord(owned_coord+DIM3);
+
+    BRICK_INFO brick;
+    DUALISO_DATA dualiso_data;
+    if (flag_crop) {
+      // Input is the global grid.  Copy owned box plus ghost layer.
+      DUALISO_SCALAR_GRID brick_grid;
+      brick.Set(DIM3, input_grid.AxisSize(), owned_box);
+      copy_brick(input_grid, brick, brick_grid);
+      dualiso_data.SetScalarGrid(brick_grid, false, 1, false, 1);
+    }
+    else {
+      brick.global_axis_size.assign(global_axis_size, global_axis_size+DIM3);
+      brick.offset.assign(offset, offset+DIM3);
+      brick.owned_box = owned_box;
+      dualiso_data.SetScalarGrid(input_grid, false, 1, false, 1);
+    }
+    dualiso_data.Set(flags);
+
+    BRICK_MESH mesh;
+    DUALISO_INFO dualiso_info(DIM3);
+    dual_contouring_brick
+      (dualiso_data, isovalue, brick, mesh, dualiso_info);
+    write_brick_mesh(output_filename, mesh);
+
+    if (flag_verbose) {
+      cout << "Brick " << input_filename << ": " << mesh.NumVertices()
+           << " vertices, " << mesh.NumPoly() << " polygons." << endl;
+    }
+  }
+  catch (ERROR & error) {
+    if (error.NumMessages() == 0) {
+      cerr << "Unknown error." << endl;
+    }
+    else { error.Print(cerr); }
+    cerr << "Exiting." << endl;
+    exit(20);
+  }
+  catch (...) {
+    cerr << "Unknown error." << endl;
+    exit(50);
+  };
+
+}
+
+void memory_exhaustion()
+{
+  cerr << "Error: Out of memory.  Terminating program." << endl;
+  exit(10);
+}
+
+
+// **************************************************
+// PARSE COMMAND LINE
+// **************************************************
+
+void parse_command_line(int argc, char **argv)
+{
+  int iarg = 1;
+
+  // Multiple isosurface vertices per cube without splitting
+  //   non-manifold vertices, so vertices depend only on their cube.
+  flags.flag_split_non_manifold = false;
+
+  while (iarg < argc && argv[iarg][0] == '-') {
+    std::string s = argv[iarg];
+
+    if (s == "-own") {
+      get_arg_int_list(iarg, argc, argv, 2*DIM3, owned_coord);
+      iarg += 2*DIM3;
+      is_owned_set = true;
+    }
+    else if (s == "-offset") {
+      get_arg_int_list(iarg, argc, argv, DIM3, offset);
+      iarg += DIM3;
+      is_offset_set = true;
+    }
+    else if (s == "-global_size") {
+      get_arg_int_list(iarg, argc, argv, DIM3, global_axis_size);
+      iarg += DIM3;
+      is_global_size_set = true;
+    }
+    else if (s == "-crop")
+      { flag_crop = true; }
+    else if (s == "-single_isov")
+      { flags.allow_multiple_iso_vertices = false; }
+    else if (s == "-sep_pos")
+      { flags.flag_separate_neg = false; }
+    else if (s == "-cube_center")
+      { flags.vertex_position_method = IJKDUAL::CUBE_CENTER; }
+    else if (s == "-trimesh")
+      { flags.use_triangle_mesh = true; }
+    else if (s == "-verbose")
+      { flag_verbose = true; }
+    else if (s == "-help")
+      { help(); }
+    else {
+      cerr << "Usage error.  Illegal parameter: " << s << endl;
+      usage_error();
+    }
+    iarg++;
+  }
+
+  if (iarg+3 != argc) { usage_error(); }
+
+  if (!IJK::string2val(argv[iarg], isovalue)) {
+    cerr << "Usage error.  Illegal isovalue: " << argv[iarg] << endl;
+    exit(230);
+  }
+  input_filename = argv[iarg+1];
+  output_filename = argv[iarg+2];
+
+  if (!is_owned_set) {
+    cerr << "Usage error.  Missing option -own." << endl;
+    usage_error();
+  }
+
+  if (flag_crop) {
+    if (is_offset_set || is_global_size_set) {
+      cerr << "Usage error.  Option -crop cannot be used with -offset"
+           << " or -global_size." << endl;
+      exit(230);
+    }
+  }
+  else if (!is_offset_set || !is_global_size_set) {
+    cerr << "Usage error.  Options -offset and -global_size are required"
+         << " without -crop." << endl;
+    exit(230);
+  }
+}
+
+/// Get n integer arguments following option argv[iarg].
+void get_arg_int_list
+(const int iarg, const int argc, char **argv, const int n, int * list)
+{
+  if (iarg+n >= argc) { usage_error(); }
+
+  for (int i = 0; i < n; i++) {
+    if (!IJK::string2val(argv[iarg+1+i], list[i])) {
+      cerr << "Usage error.  Illegal argument for option " << argv[iarg]
+           << ": " << argv[iarg+1+i] << endl;
+      exit(230);
+    }
+  }
+}
+
+void usage_msg(std::ostream & out)
+{
+  out << "Usage: isodual_brick [OPTIONS] -own {x0 y0 z0 x1 y1 z1}"
+      << " {isovalue} {input nrrd file}" << endl;
+  out << "         {output brick mesh file}" << endl;
+  out << "OPTIONS:" << endl;
+  out << "  [-offset {x y z} -global_size {nx ny nz} | -crop]" << endl;
+  out << "  [-single_isov] [-sep_pos] [-cube_center] [-trimesh]"
+      << " [-verbose] [-help]" << endl;
+}
+
+void usage_error()
+{
+  usage_msg(cerr);
+  exit(10);
+}
+
+void help()
+{
+  usage_msg(cout);
+  cout << endl;
+  cout << "isodual_brick - Dual contour one brick of a decomposed grid."
+       << endl;
+  cout << "  The brick owns grid vertices (x0,y0,z0) to (x1,y1,z1)"
+       << " of the global grid." << endl;
+  cout << "  The input brick contains the owned vertices plus a one vertex"
+       << endl;
+  cout << "  ghost layer, clipped to the global grid." << endl;
+  cout << "  The brick constructs the isosurface polygons dual to grid"
+       << " edges" << endl;
+  cout << "  whose lowest endpoint it owns.  Isosurface vertices are"
+       << " identified" << endl;
+  cout << "  by global grid cube indices, so isodual_brick_merge can merge"
+       << endl;
+  cout << "  brick meshes without duplicating vertices along brick seams."
+       << endl;
+  cout << "  Multiple isosurface vertices per cube are not split"
+       << " to remove" << endl;
+  cout << "  non-manifold edges, since splitting depends on neighboring"
+       << " cubes." << endl;
+  cout << endl;
+  cout << "  -own {x0 y0 z0 x1 y1 z1}: Global coordinates of owned grid"
+       << " vertices." << endl;
+  cout << "  -offset {x y z}: Global coordinates of brick vertex 0." << endl;
+  cout << "  -global_size {nx ny nz}: Axis sizes of the global grid." << endl;
+  cout << "  -crop: Input is the global grid.  Copy the brick from it."
+       << endl;
+  cout << "     Simulates a decomposed grid from a single volume." << endl;
+  cout << "  -single_isov: Single isosurface vertex per grid cube." << endl;
+  cout << "  -sep_pos: Separate positive vertices." << endl;
+  cout << "  -cube_center: Position isosurface vertices at cube centers."
+       << endl;
+  cout << "  -trimesh: Output triangle mesh." << endl;
+  cout << "  -verbose: Report number of vertices and polygons." << endl;
+  cout << "  -help: Print this help message." << endl;
+  exit(0);
+}
@@ -0,0 +1,158 @@
+/// \file isodual_brick_merge_main.cxx
+/// Merge brick meshes written by isodual_brick.
+
+/*
+  IJK: Isosurface Jeneration Kode
+  Copyright (C) 2017 Rephael Wenger
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License
+  (LGPL) as published by the Free Software Foundation; either
+  version 2.1 of the License, or any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "isodual_brick.h"
+
+using namespace IJK;
+using namespace ISODUAL;
+
+using namespace std;
+
+// global variables
+std::string output_filename;
+std::vector<std::string> brick_filename;
+bool flag_brick_output = false;
+
+// local subroutines
+void parse_command_line(int argc, char **argv);
+void usage_error();
+void help();
+void memory_exhaustion();
+
+
+// **************************************************
+// MAIN
+// **************************************************
+
+int main(int argc, char **argv)
+{
+  try {
+
+    std::set_new_handler(memory_exhaustion);
+
+    parse_command_line(argc, argv);
+
+    std::vector<BRICK_MESH> brick_mesh(brick_filename.size());
+    for (int j = 0; j < int(brick_filename.size()); j++)
+      { read_brick_mesh(brick_filename[j], brick_mesh[j]); }
+
+    BRICK_MESH mesh;
+    VERTEX_INDEX num_shared;
+    merge_brick_meshes(brick_mesh, mesh, num_shared);
+
+    if (flag_brick_output)
+      { write_brick_mesh(output_filename, mesh); }
+    else
+      { write_brick_mesh_off(output_filename, mesh); }
+
+    cout << "Merged " << brick_mesh.size() << " bricks: "
+         << mesh.NumVertices() << " vertices, "
+         << mesh.NumPoly() << " polygons." << endl;
+    cout << "Merged " << num_shared << " vertices shared by bricks." << endl;
+  }
+  catch (ERROR & error) {
+    if (error.NumMessages() == 0) {
+      cerr << "Unknown error." << endl;
+    }
+    else { error.Print(cerr); }
+    cerr << "Exiting." << endl;
+    exit(20);
+  }
+  catch (...) {
+    cerr << "Unknown error." << endl;
+    exit(50);
+  };
+
+}
+
+void memory_exhaustion()
+{
+  cerr << "Error: Out of memory.  Terminating program." << endl;
+  exit(10);
+}
+
+
+// **************************************************
+// PARSE COMMAND LINE
+// **************************************************
+
+void parse_command_line(int argc, char **argv)
+{
+  int iarg = 1;
+
+  while (iarg < argc && argv[iarg][0] == '-') {
+    std::string s = argv[iarg];
+
+    if (s == "-brick")
+      { flag_brick_output = true; }
+    else if (s == "-help")
+      { help(); }
+    else {
+      cerr << "Usage error.  Illegal parameter: " << s << endl;
+      usage_error();
+    }
+    iarg++;
+  }
+
+  if (iarg+2 > argc) { usage_error(); }
+
+  output_filename = argv[iarg];
+  iarg++;
+
+  for (; iarg < argc; iarg++)
+    { brick_filename.push_back(argv[iarg]); }
+}
+
+void usage_msg(std::ostream & out)
+{
+  out << "Usage: isodual_brick_merge [-brick] [-help] {output file}"
+      << " {brick1 brick2 ...}" << endl;
+}
+
+void usage_error()
+{
+  usage_msg(cerr);
+  exit(10);
+}
+
+void help()
+{
+  usage_msg(cout);
+  cout << endl;
+  cout << "isodual_brick_merge - Merge brick meshes written by isodual_brick."
+       << endl;
+  cout << "  Vertices with the same global index are merged, so vertices"
+       << endl;
+  cout << "  along brick seams are not duplicated." << endl;
+  cout << "  Writes the merged mesh in Geomview .off format." << endl;
+  cout << endl;
+  cout << "  -brick: Write the merged mesh as a brick mesh"
+       << " with global indices." << endl;
+  cout << "  -help: Print this help message." << endl;
+  exit(0);
+}
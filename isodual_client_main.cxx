@@ -0,0 +1,275 @@
+/// \file isodual_client_main.cxx
+/// Client for the resident isosurface server.
+/// Sends a batch of isosurface requests and reports or writes the meshes.
+
+/*
+  IJK: Isosurface Jeneration Kode
+  Copyright (C) 2017 Rephael Wenger
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License
+  (LGPL) as published by the Free Software Foundation; either
+  version 2.1 of the License, or any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "ijkcommand_line.txx"
+#include "ijktime.txx"
+
+#include "isodual_server.h"
+
+using namespace IJK;
+using namespace ISODUAL;
+
+using namespace std;
+
+// global variables
+std::string socket_path;
+std::vector<std::string> volume_id;
+std::vector<SCALAR_TYPE> isovalue;
+unsigned int request_flags = 0;
+int num_repeat = 1;
+std::string off_prefix;
+
+// local subroutines
+void parse_command_line(int argc, char **argv);
+void usage_error();
+void help();
+
+
+// **************************************************
+// MAIN
+// **************************************************
+
+int main(int argc, char **argv)
+{
+  try {
+
+    parse_command_line(argc, argv);
+
+    std::vector<ISODUAL_REQUEST> request;
+    for (int j = 0; j < int(volume_id.size()); j++) {
+      for (int i = 0; i < int(isovalue.size()); i++) {
+        request.push_back
+          (ISODUAL_REQUEST(volume_id[j], isovalue[i], request_flags));
+      }
+    }
+
+    const int fd = connect_isodual_server(socket_path);
+
+    std::vector<ISODUAL_MESH> mesh;
+    for (int k = 0; k < num_repeat; k++) {
+      IJK::WALL_CPU_TIME batch_time;
+      IJK::SCOPED_TIMER batch_timer(batch_time);
+      const auto batch_start = std::chrono::steady_clock::now();
+
+      // Report previews of progressive requests as they arrive.
+      auto report_preview = 
+        [&](const int i, const int subsample_resolution, 
+            const ISODUAL_MESH & preview_mesh)
+        {
+          const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - batch_start;
+          cout << "  Preview " << i << "  subsample " << subsample_resolution
+               << ": " << preview_mesh.NumVertices() << " vertices, "
+               << preview_mesh.NumPoly() << " polygons at "
+               << elapsed.count() << " seconds." << endl;
+
+          if (off_prefix != "" && preview_mesh.status == 0) {
+            std::string s, s2;
+            IJK::val2string(i, s);
+            IJK::val2string(subsample_resolution, s2);
+            write_isodual_mesh_off
+              (off_prefix + "." + s + ".s" + s2 + ".off", preview_mesh);
+          }
+        };
+
+      send_request_batch(fd, request, report_preview, mesh);
+      batch_timer.Stop();
+
+      cout << "Batch " << k << ": " << request.size() << " requests in "
+           << batch_time.wall << " seconds." << endl;
+    }
+
+    close_isodual_server(fd);
+
+    int num_errors = 0;
+    for (int i = 0; i < int(mesh.size()); i++) {
+      cout << request[i].volume_id << "  isovalue " << request[i].isovalue
+           << ": ";
+      if (mesh[i].status != 0) {
+        cout << "Error." << endl;
+        cout << mesh[i].message;
+        num_errors++;
+        continue;
+      }
+
+      cout << mesh[i].NumVertices() << " vertices, "
+           << mesh[i].NumPoly() << " polygons." << endl;
+
+      if (off_prefix != "") {
+        std::string s;
+        IJK::val2string(i, s);
+        write_isodual_mesh_off(off_prefix + "." + s + ".off", mesh[i]);
+      }
+    }
+
+    if (num_errors > 0) { exit(1); }
+  }
+  catch (ERROR & error) {
+    if (error.NumMessages() == 0) {
+      cerr << "Unknown error." << endl;
+    }
+    else { error.Print(cerr); }
+    cerr << "Exiting." << endl;
+    exit(20);
+  }
+  catch (...) {
+    cerr << "Unknown error." << endl;
+    exit(50);
+  };
+
+}
+
+
+// **************************************************
+// PARSE COMMAND LINE
+// **************************************************
+
+void parse_command_line(int argc, char **argv)
+{
+  int iarg = 1;
+
+  while (iarg < argc && argv[iarg][0] == '-') {
+    std::string s = argv[iarg];
+
+    if (s == "-trimesh")
+      { request_flags |= REQUEST_TRIANGULATE; }
+    else if (s == "-single_isov")
+      { request_flags |= REQUEST_SINGLE_ISOV; }
+    else if (s == "-multi_isov")
+      { request_flags |= REQUEST_NO_SPLIT_NON_MANIFOLD; }
+    else if (s == "-sep_pos")
+      { request_flags |= REQUEST_SEPARATE_POS; }
+    else if (s == "-cube_center")
+      { request_flags |= REQUEST_POSITION_CUBE_CENTER; }
+    else if (s == "-extract_two_pass")
+      { request_flags |= REQUEST_EXTRACT_TWO_PASS; }
+    else if (s == "-extract_incremental")
+      { request_flags |= REQUEST_EXTRACT_INCREMENTAL; }
+    else if (s == "-progressive")
+      { request_flags |= REQUEST_PROGRESSIVE; }
+    else if (s == "-volume") {
+      iarg++;
+      if (iarg >= argc) { usage_error(); }
+      volume_id.push_back(argv[iarg]);
+    }
+    else if (s == "-repeat") {
+      num_repeat = get_arg_int(iarg, argc, argv);
+      iarg++;
+
+      if (num_repeat < 1) {
+        cerr << "Usage error.  Number of repeats must be at least 1." << endl;
+        exit(230);
+      }
+    }
+    else if (s == "-off") {
+      iarg++;
+      if (iarg >= argc) { usage_error(); }
+      off_prefix = argv[iarg];
+    }
+    else if (s == "-help")
+      { help(); }
+    else {
+      cerr << "Usage error.  Illegal parameter: " << s << endl;
+      usage_error();
+    }
+    iarg++;
+  }
+
+  if (iarg+3 > argc) { usage_error(); }
+
+  socket_path = argv[iarg];
+  iarg++;
+  volume_id.insert(volume_id.begin(), argv[iarg]);
+  iarg++;
+
+  for (; iarg < argc; iarg++) {
+    float x;
+    if (!IJK::string2val(argv[iarg], x)) {
+      cerr << "Usage error.  Illegal isovalue: " << argv[iarg] << endl;
+      exit(230);
+    }
+    isovalue.push_back(x);
+  }
+}
+
+void usage_msg(std::ostream & out)
+{
+  out << "Usage: isodual_client [OPTIONS] {socket path} {volume}"
+      << " {isovalue1 isovalue2 ...}" << endl;
+  out << "OPTIONS:" << endl;
+  out << "  [-trimesh] [-single_isov | -multi_isov] [-sep_pos]"
+      << " [-cube_center]" << endl;
+  out << "  [-extract_two_pass] [-extract_incremental] [-progressive]"
+      << endl;
+  out << "  [-volume {volume}] [-repeat {N}] [-off {prefix}] [-help]"
+      << endl;
+}
+
+void usage_error()
+{
+  usage_msg(cerr);
+  exit(10);
+}
+
+void help()
+{
+  usage_msg(cout);
+  cout << endl;
+  cout << "isodual_client - Request isosurfaces from isodual_server." << endl;
+  cout << "  Sends one batch with a request for each volume and isovalue."
+       << endl;
+  cout << "  Volumes are nrrd file paths relative to the server"
+       << " data directory." << endl;
+  cout << endl;
+  cout << "  -trimesh: Return triangle meshes." << endl;
+  cout << "  -single_isov: Single isosurface vertex per grid cube." << endl;
+  cout << "  -multi_isov: Multiple isosurface vertices per grid cube."
+       << "  Do not split" << endl;
+  cout << "     non-manifold vertices." << endl;
+  cout << "  -sep_pos: Separate positive vertices." << endl;
+  cout << "  -cube_center: Position isosurface vertices at cube centers."
+       << endl;
+  cout << "  -extract_two_pass: Extract using two passes." << endl;
+  cout << "  -extract_incremental: Extract in blocks and reuse polytopes"
+       << " of blocks" << endl;
+  cout << "     whose signs did not change since the previous request"
+       << endl;
+  cout << "     on the same volume and isovalue." << endl;
+  cout << "  -progressive: Contour coarse to fine.  The server sends"
+       << " previews" << endl;
+  cout << "     from grids subsampled at resolutions "
+       << PROGRESSIVE_MAX_RESOLUTION << ", ..., 2" << endl;
+  cout << "     before the full resolution mesh." << endl;
+  cout << "  -volume {volume}: Add volume to the batch." << endl;
+  cout << "  -repeat {N}: Send the batch N times on one connection." << endl;
+  cout << "  -off {prefix}: Write mesh i to {prefix}.{i}.off." << endl;
+  cout << "     Write previews to {prefix}.{i}.s{subsample}.off." << endl;
+  cout << "  -help: Print this help message." << endl;
+  exit(0);
+}
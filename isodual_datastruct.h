@@ -44,6 +44,7 @@ namespace ISODUAL {
   // **************************************************
 
   typedef IJKDUAL::DUAL_ISOVERT DUAL_ISOVERT;
+  typedef IJKDUAL::CUBE_RELATIVE_COORD_ARRAY CUBE_RELATIVE_COORD_ARRAY;
 
 
   // **************************************************
@@ -88,6 +89,16 @@ namespace ISODUAL {
 
   typedef IJKDUAL::MERGE_DATA MERGE_DATA;
 
+
+  // **************************************************
+  // DUALISO CONTEXT
+  // **************************************************
+
+  typedef IJKDUAL::DUALISO_CONTEXT DUALISO_CONTEXT;
+  typedef IJKDUAL::INCREMENTAL_EXTRACT_DATA INCREMENTAL_EXTRACT_DATA;
+  typedef IJKDUAL::DUALISO_MINMAX_REGIONS DUALISO_MINMAX_REGIONS;
+  typedef IJKDUAL::MULTI_ISOVALUE_EXTRACT_DATA MULTI_ISOVALUE_EXTRACT_DATA;
+
 }
 
 #endif
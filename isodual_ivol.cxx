@@ -0,0 +1,253 @@
+/// \file isodual_ivol.cxx
+/// Dual contouring of interval volumes.
+
+/*
+  IJK: Isosurface Jeneration Kode
+  Copyright (C) 2017 Rephael Wenger
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License
+  (LGPL) as published by the Free Software Foundation; either
+  version 2.1 of the License, or any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <algorithm>
+#include <fstream>
+
+#include "ijkIO.txx"
+#include "ijkdual_extract.txx"
+#include "ijkdual_position.txx"
+
+#include "isodual_ivol.h"
+
+using namespace IJK;
+using namespace IJKDUAL;
+using namespace ISODUAL;
+
+
+// **************************************************
+// DUAL INTERVAL VOLUME
+// **************************************************
+
+ISODUAL::DUAL_INTERVAL_VOLUME::DUAL_INTERVAL_VOLUME(const int dimension)
+{
+  this->dimension = dimension;
+}
+
+void ISODUAL::DUAL_INTERVAL_VOLUME::Clear()
+{
+  ivolpoly_vert.clear();
+  dual_vertex.clear();
+  cube_list.clear();
+  vertex_coord.clear();
+  axis_size.clear();
+}
+
+
+// **************************************************
+// INTERVAL VOLUME DUAL CONTOURING
+// **************************************************
+
+namespace {
+
+  bool check_ivol_flags
+  (const DUALISO_DATA & dualiso_data, IJK::ERROR & error)
+  {
+    if (dualiso_data.ROIFlag() || dualiso_data.BrickFlag() ||
+        dualiso_data.ExtractActiveCubesFlag()) {
+      error.AddMessage
+        ("Interval volume contouring does not support a region of interest,");
+      error.AddMessage("  bricks or active cube lists.");
+      return(false);
+    }
+
+    return(true);
+  }
+
+}
+
+
+void ISODUAL::dual_contouring_interval_volume
+(const DUALISO_DATA & dualiso_data,
+ const SCALAR_TYPE isovalue0, const SCALAR_TYPE isovalue1,
+ DUAL_INTERVAL_VOLUME & ivol, DUALISO_INFO & dualiso_info)
+{
+  const DUALISO_SCALAR_GRID_BASE & scalar_grid = dualiso_data.ScalarGrid();
+  const int dimension = scalar_grid.Dimension();
+  IJK::PROCEDURE_ERROR error("dual_contouring_interval_volume");
+  IJK::WALL_CPU_TIME total_time;
+  IJK::SCOPED_TIMER total_timer(total_time);
+
+  if (!dualiso_data.Check(error)) { throw error; };
+  if (!check_ivol_flags(dualiso_data, error)) { throw error; }
+
+  if (!(isovalue0 < isovalue1)) {
+    error.AddMessage
+      ("Lower isovalue ", isovalue0, " is not less than upper isovalue ",
+       isovalue1, ".");
+    throw error;
+  }
+
+  ivol.Clear();
+  ivol.dimension = dimension;
+  ivol.axis_size.assign
+    (scalar_grid.AxisSize(), scalar_grid.AxisSize()+dimension);
+  dualiso_info.time.Clear();
+
+  std::vector<VERTEX_INDEX> ivolpoly;
+  extract_dual_ivolpoly
+    (scalar_grid, isovalue0, isovalue1, ivolpoly, ivol.dual_vertex,
+     dualiso_info);
+
+  IJK::SCOPED_TIMER merge_timer(dualiso_info.time.merge);
+  ISO_MERGE_DATA merge_data(dimension, scalar_grid.AxisSize());
+  merge_identical(ivolpoly, ivol.cube_list, ivol.ivolpoly_vert, merge_data);
+  merge_timer.Stop();
+
+  dualiso_info.scalar.num_non_empty_cubes = ivol.cube_list.size();
+
+  IJK::SCOPED_TIMER position_timer(dualiso_info.time.position);
+  if (dualiso_data.VertexPositionMethod() == CUBE_CENTER) {
+    position_all_dual_isovertices_cube_center
+      (scalar_grid, ivol.cube_list, ivol.vertex_coord);
+  }
+  else {
+    position_all_dual_ivol_vertices_centroid
+      (scalar_grid, isovalue0, isovalue1, ivol.cube_list, ivol.vertex_coord);
+  }
+  position_timer.Stop();
+
+  // store times
+  total_timer.Stop();
+  dualiso_info.time.total = total_time;
+}
+
+
+void ISODUAL::get_interval_volume_boundary
+(const DUAL_INTERVAL_VOLUME & ivol,
+ std::vector<ISO_VERTEX_INDEX> & boundary_vert)
+{
+  const int dimension = ivol.Dimension();
+  const int numv_per_poly = ivol.NumVerticesPerPoly();
+  const VERTEX_INDEX num_poly = ivol.NumPoly();
+  IJK::PROCEDURE_ERROR error("get_interval_volume_boundary");
+
+  boundary_vert.clear();
+  if (num_poly == 0) { return; }
+
+  if (int(ivol.axis_size.size()) != dimension) {
+    error.AddMessage("Programming error.  Interval volume axis sizes",
+                     " are not set.");
+    throw error;
+  }
+
+  // Facet 2*(ip*dimension+d)+side of polytope ip is orthogonal
+  //   to direction d.  Its vertices are the polytope vertices
+  //   whose d'th bit equals side.
+  // Facet 2*(ip*dimension+d)+1 is dual to grid edge (iv,iv+increment[d])
+  //   where iv = dual_vertex[ip].  It is shared with the polytope
+  //   dual to iv+increment[d], if there is one.
+  // dual_vertex[] is increasing, so one merge of dual_vertex[] with
+  //   dual_vertex[]+increment[d] finds all shared facets orthogonal
+  //   to direction d in linear time.
+  std::vector<bool> is_shared(num_poly*2*dimension, false);
+  VERTEX_INDEX increment = 1;
+  for (int d = 0; d < dimension; d++) {
+    VERTEX_INDEX ip1 = 0;
+    for (VERTEX_INDEX ip0 = 0; ip0 < num_poly; ip0++) {
+      const VERTEX_INDEX iv1 = ivol.dual_vertex[ip0] + increment;
+      while (ip1 < num_poly && ivol.dual_vertex[ip1] < iv1)
+        { ip1++; }
+      if (ip1 == num_poly) { break; }
+
+      if (ivol.dual_vertex[ip1] == iv1) {
+        is_shared[2*(ip0*dimension+d)+1] = true;
+        is_shared[2*(ip1*dimension+d)] = true;
+      }
+    }
+    increment *= ivol.axis_size[d];
+  }
+
+  for (VERTEX_INDEX ip = 0; ip < num_poly; ip++) {
+    const ISO_VERTEX_INDEX * poly_vert =
+      &(ivol.ivolpoly_vert[ip*numv_per_poly]);
+    for (int d = 0; d < dimension; d++) {
+      for (int side = 0; side < 2; side++) {
+        if (is_shared[2*(ip*dimension+d)+side]) { continue; }
+
+        for (int k = 0; k < numv_per_poly; k++) {
+          if (((k >> d) & 1) == side)
+            { boundary_vert.push_back(poly_vert[k]); }
+        }
+
+        if (dimension == 3) {
+          // Counter-clockwise order of cube facet vertices (0,1,3,2)
+          //   gives normal direction +d for d = 0,2 and -d for d = 1.
+          //   The outward normal is -d for side 0 and +d for side 1.
+          if ((d%2 == 0) != (side == 1)) {
+            std::swap(boundary_vert[boundary_vert.size()-3],
+                      boundary_vert[boundary_vert.size()-2]);
+          }
+        }
+      }
+    }
+  }
+}
+
+
+// **************************************************
+// WRITE INTERVAL VOLUMES
+// **************************************************
+
+void ISODUAL::write_interval_volume_off
+(const std::string & filename, const DUAL_INTERVAL_VOLUME & ivol)
+{
+  std::ofstream output_file;
+  IJK::PROCEDURE_ERROR error("write_interval_volume_off");
+
+  output_file.open(filename.c_str(), std::ios::out);
+  if (!output_file.good()) {
+    error.AddMessage("Unable to open output file ", filename, ".");
+    throw error;
+  }
+
+  ijkoutOFF(output_file, ivol.Dimension(), ivol.NumVerticesPerPoly(),
+            ivol.vertex_coord, ivol.ivolpoly_vert);
+  output_file.close();
+}
+
+
+void ISODUAL::write_interval_volume_boundary_off
+(const std::string & filename, const DUAL_INTERVAL_VOLUME & ivol)
+{
+  const int DIM3(3);
+  std::ofstream output_file;
+  IJK::PROCEDURE_ERROR error("write_interval_volume_boundary_off");
+
+  if (ivol.Dimension() != DIM3) {
+    error.AddMessage("Illegal dimension ", ivol.Dimension(), ".");
+    error.AddMessage("  Interval volume boundary requires dimension 3.");
+    throw error;
+  }
+
+  std::vector<ISO_VERTEX_INDEX> boundary_vert;
+  get_interval_volume_boundary(ivol, boundary_vert);
+
+  output_file.open(filename.c_str(), std::ios::out);
+  if (!output_file.good()) {
+    error.AddMessage("Unable to open output file ", filename, ".");
+    throw error;
+  }
+
+  ijkoutQuadOFF(output_file, DIM3, ivol.vertex_coord, boundary_vert, true);
+  output_file.close();
+}
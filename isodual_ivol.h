@@ -0,0 +1,146 @@
+/// \file isodual_ivol.h
+/// Dual contouring of interval volumes.
+/// Constructs the volume mesh between two isovalues
+///   directly on the scalar grid.
+
+/*
+  IJK: Isosurface Jeneration Kode
+  Copyright (C) 2017 Rephael Wenger
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License
+  (LGPL) as published by the Free Software Foundation; either
+  version 2.1 of the License, or any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef _ISODUAL_IVOL_
+#define _ISODUAL_IVOL_
+
+#include <string>
+#include <vector>
+
+#include "isodual_types.h"
+#include "isodual_datastruct.h"
+
+
+/// isodual interval volume classes and routines.
+namespace ISODUAL {
+
+  // **************************************************
+  // DUAL INTERVAL VOLUME
+  // **************************************************
+
+  /// Interval volume mesh constructed by dual contouring.
+  /// - Each polytope is dual to a grid vertex in the interval volume.
+  ///   Polytopes are hexahedra in 3D and hypercubes in dimension d.
+  /// - Each vertex lies in a grid cube.
+  class DUAL_INTERVAL_VOLUME {
+
+  public:
+    int dimension;
+
+    /// Axis sizes of the grid containing the interval volume.
+    std::vector<AXIS_SIZE_TYPE> axis_size;
+
+    /// ivolpoly_vert[ip*NumVerticesPerPoly()+k] =
+    ///   k'th vertex of polytope ip.
+    /// Polytope vertices are listed in the order of grid cube vertices.
+    std::vector<ISO_VERTEX_INDEX> ivolpoly_vert;
+
+    /// dual_vertex[ip] = Grid vertex dual to polytope ip.
+    /// Increasing in ip.
+    std::vector<VERTEX_INDEX> dual_vertex;
+
+    /// cube_list[iv] = Grid cube containing vertex iv.
+    std::vector<VERTEX_INDEX> cube_list;
+
+    /// vertex_coord[iv*dimension+d] = d'th coordinate of vertex iv.
+    COORD_ARRAY vertex_coord;
+
+  public:
+    DUAL_INTERVAL_VOLUME(const int dimension);
+
+    int Dimension() const { return(dimension); };
+    int NumVerticesPerPoly() const { return(1L << dimension); };
+    VERTEX_INDEX NumVertices() const
+    { return(cube_list.size()); };
+    VERTEX_INDEX NumPoly() const
+    { return(dual_vertex.size()); };
+
+    void Clear();
+  };
+
+
+  // **************************************************
+  // INTERVAL VOLUME DUAL CONTOURING
+  // **************************************************
+
+  /// Construct interval volume between isovalue0 and isovalue1.
+  /// - The interval volume contains grid vertices with scalar values
+  ///   in [isovalue0,isovalue1).  Each interior grid vertex
+  ///   in the interval volume is dual to one polytope.
+  /// - Away from the grid boundary, boundary facets of the interval
+  ///   volume have the same vertex cubes as the dual isosurface 
+  ///   polytopes of isovalue0 and isovalue1 with a single isosurface
+  ///   vertex per cube.  The match is only combinatorial.
+  ///   Vertex positions differ, since each vertex is positioned
+  ///   using both isovalues.
+  /// - Constructed on dualiso_data.ScalarGrid() without lifting
+  ///   the grid to dimension+1.
+  /// - Vertices are positioned at cube centers if
+  ///   dualiso_data.VertexPositionMethod() is CUBE_CENTER.
+  ///   Otherwise vertices are positioned at the centroid of
+  ///   the intersections of cube edges with both isovalues.
+  /// - Vertex coordinates are grid coordinates, not scaled
+  ///   by grid spacing.
+  /// - Region of interest, brick and active cube flags
+  ///   are not supported.
+  /// @pre isovalue0 < isovalue1.
+  void dual_contouring_interval_volume
+    (const DUALISO_DATA & dualiso_data,
+     const SCALAR_TYPE isovalue0, const SCALAR_TYPE isovalue1,
+     DUAL_INTERVAL_VOLUME & ivol, DUALISO_INFO & dualiso_info);
+
+  /// Get boundary facets of the interval volume.
+  /// - A facet is a boundary facet if it is a facet
+  ///   of exactly one polytope.
+  /// - Shared facets are matched by their dual grid edges
+  ///   in time linear in the number of polytopes.
+  /// - Facet vertices are in the order of grid cube facet vertices.
+  ///   In 3D, boundary quadrilaterals are oriented with normals
+  ///   pointing out of the interval volume when their vertices
+  ///   are listed in counter-clockwise order, i.e., as reordered
+  ///   by ijkoutQuadOFF.
+  /// @param[out] boundary_vert[] boundary_vert[j*numv+k] =
+  ///   k'th vertex of boundary facet j where numv is the number
+  ///   of vertices per facet.
+  void get_interval_volume_boundary
+    (const DUAL_INTERVAL_VOLUME & ivol,
+     std::vector<ISO_VERTEX_INDEX> & boundary_vert);
+
+
+  // **************************************************
+  // WRITE INTERVAL VOLUMES
+  // **************************************************
+
+  /// Write interval volume polytopes in Geomview .off format.
+  void write_interval_volume_off
+    (const std::string & filename, const DUAL_INTERVAL_VOLUME & ivol);
+
+  /// Write interval volume boundary in Geomview .off format.
+  /// @pre ivol.Dimension() == 3.
+  void write_interval_volume_boundary_off
+    (const std::string & filename, const DUAL_INTERVAL_VOLUME & ivol);
+
+}
+
+#endif
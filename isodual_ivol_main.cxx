@@ -0,0 +1,221 @@
+/// \file isodual_ivol_main.cxx
+/// Dual contour the interval volume between two isovalues.
+
+/*
+  IJK: Isosurface Jeneration Kode
+  Copyright (C) 2017 Rephael Wenger
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License
+  (LGPL) as published by the Free Software Foundation; either
+  version 2.1 of the License, or any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "ijkcommand_line.txx"
+
+#include "isodualIO.h"
+#include "isodual_ivol.h"
+
+using namespace IJK;
+
+// Not "using namespace ISODUAL", since isodualIO.h declares
+//   usage_error() and help() for isodual.
+using ISODUAL::SCALAR_TYPE;
+using ISODUAL::DUALISO_DATA_FLAGS;
+using ISODUAL::DUALISO_DATA;
+using ISODUAL::DUALISO_SCALAR_GRID;
+using ISODUAL::DUALISO_INFO;
+using ISODUAL::NRRD_HEADER;
+using ISODUAL::IO_TIME;
+using ISODUAL::DUAL_INTERVAL_VOLUME;
+
+using namespace std;
+
+// global variables
+SCALAR_TYPE isovalue0;
+SCALAR_TYPE isovalue1;
+std::string input_filename;
+std::string output_filename;
+bool flag_boundary = false;
+bool flag_verbose = false;
+DUALISO_DATA_FLAGS flags;
+
+// local subroutines
+void parse_command_line(int argc, char **argv);
+void usage_error();
+void help();
+void memory_exhaustion();
+
+
+// **************************************************
+// MAIN
+// **************************************************
+
+int main(int argc, char **argv)
+{
+  try {
+
+    std::set_new_handler(memory_exhaustion);
+
+    parse_command_line(argc, argv);
+
+    DUALISO_SCALAR_GRID input_grid;
+    NRRD_HEADER nrrd_header;
+    IO_TIME io_time;
+    read_nrrd_file(input_filename, input_grid, nrrd_header, io_time);
+
+    const int dimension = input_grid.Dimension();
+    if (flag_boundary && dimension != 3) {
+      cerr << "Error.  Option -boundary requires a 3D grid." << endl;
+      exit(20);
+    }
+
+    DUALISO_DATA dualiso_data;
+    dualiso_data.SetScalarGrid(input_grid, false, 1, false, 1);
+    dualiso_data.Set(flags);
+
+    DUAL_INTERVAL_VOLUME ivol(dimension);
+    DUALISO_INFO dualiso_info(dimension);
+    dual_contouring_interval_volume
+      (dualiso_data, isovalue0, isovalue1, ivol, dualiso_info);
+    ISODUAL::rescale_vertex_coord
+      (dimension, input_grid.SpacingPtrConst(), ivol.vertex_coord);
+
+    if (flag_boundary)
+      { write_interval_volume_boundary_off(output_filename, ivol); }
+    else
+      { write_interval_volume_off(output_filename, ivol); }
+
+    if (flag_verbose) {
+      cout << "Interval volume [" << isovalue0 << "," << isovalue1
+           << "): " << ivol.NumVertices() << " vertices, "
+           << ivol.NumPoly() << " polytopes." << endl;
+      cout << "Time: " << dualiso_info.time.total.wall
+           << " seconds." << endl;
+    }
+  }
+  catch (ERROR & error) {
+    if (error.NumMessages() == 0) {
+      cerr << "Unknown error." << endl;
+    }
+    else { error.Print(cerr); }
+    cerr << "Exiting." << endl;
+    exit(20);
+  }
+  catch (...) {
+    cerr << "Unknown error." << endl;
+    exit(50);
+  };
+
+}
+
+void memory_exhaustion()
+{
+  cerr << "Error: Out of memory.  Terminating program." << endl;
+  exit(10);
+}
+
+
+// **************************************************
+// PARSE COMMAND LINE
+// **************************************************
+
+void parse_command_line(int argc, char **argv)
+{
+  int iarg = 1;
+
+  while (iarg < argc && argv[iarg][0] == '-') {
+    std::string s = argv[iarg];
+
+    if (s == "-cube_center")
+      { flags.vertex_position_method = IJKDUAL::CUBE_CENTER; }
+    else if (s == "-boundary")
+      { flag_boundary = true; }
+    else if (s == "-verbose")
+      { flag_verbose = true; }
+    else if (s == "-help")
+      { help(); }
+    else {
+      cerr << "Usage error.  Illegal parameter: " << s << endl;
+      usage_error();
+    }
+    iarg++;
+  }
+
+  if (iarg+4 != argc) { usage_error(); }
+
+  if (!IJK::string2val(argv[iarg], isovalue0)) {
+    cerr << "Usage error.  Illegal isovalue: " << argv[iarg] << endl;
+    exit(230);
+  }
+  if (!IJK::string2val(argv[iarg+1], isovalue1)) {
+    cerr << "Usage error.  Illegal isovalue: " << argv[iarg+1] << endl;
+    exit(230);
+  }
+  input_filename = argv[iarg+2];
+  output_filename = argv[iarg+3];
+
+  if (!(isovalue0 < isovalue1)) {
+    cerr << "Usage error.  Lower isovalue " << isovalue0
+         << " must be less than upper isovalue " << isovalue1 << "." << endl;
+    exit(230);
+  }
+}
+
+void usage_msg(std::ostream & out)
+{
+  out << "Usage: isodual_ivol [-cube_center] [-boundary] [-verbose] [-help]"
+      << endl;
+  out << "         {isovalue0} {isovalue1} {input nrrd file}"
+      << " {output off file}" << endl;
+}
+
+void usage_error()
+{
+  usage_msg(cerr);
+  exit(10);
+}
+
+void help()
+{
+  usage_msg(cout);
+  cout << endl;
+  cout << "isodual_ivol - Dual contour the interval volume between"
+       << " two isovalues." << endl;
+  cout << "  The interval volume contains grid vertices with scalar values"
+       << endl;
+  cout << "  in [isovalue0,isovalue1).  Each interior grid vertex in the"
+       << endl;
+  cout << "  interval volume is dual to one hexahedron whose vertices lie"
+       << endl;
+  cout << "  in the grid cubes around the grid vertex.  The interval volume"
+       << endl;
+  cout << "  is constructed on the input grid without lifting it to"
+       << " one higher" << endl;
+  cout << "  dimension.  Hexahedra are written in Geomview .off format"
+       << " with" << endl;
+  cout << "  vertices in the order of grid cube vertices." << endl;
+  cout << endl;
+  cout << "  -cube_center: Position vertices at cube centers." << endl;
+  cout << "     Default: centroid of the intersections of cube edges"
+       << " with both isovalues." << endl;
+  cout << "  -boundary: Write boundary quadrilaterals"
+       << " of the interval volume." << endl;
+  cout << "  -verbose: Report number of vertices and polytopes." << endl;
+  cout << "  -help: Print this help message." << endl;
+  exit(0);
+}
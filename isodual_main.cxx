@@ -27,6 +27,7 @@
 #include "isodualIO.h"
 #include "isodual.h"
 
+#include "ijkdual_position.txx"
 #include "ijkdual_triangulate.txx"
 
 using namespace IJK;
@@ -39,7 +40,7 @@ using namespace std;
 void memory_exhaustion();
 void construct_isosurface
 (const IO_INFO & io_info, const DUALISO_DATA & dualiso_data,
- DUALISO_TIME & dualiso_time, IO_TIME & io_time);
+ DUALISO_TIME & dualiso_time, IO_TIME & io_time, RUN_STATS & run_stats);
 
 
 // **************************************************
@@ -48,11 +49,12 @@ void construct_isosurface
 
 int main(int argc, char **argv)
 {
-  time_t start_time;
-  time(&start_time);
+  IJK::WALL_CPU_TIME total_elapsed_time;
+  IJK::SCOPED_TIMER total_timer(total_elapsed_time);
 
   DUALISO_TIME dualiso_time;
-  IO_TIME io_time = {0.0, 0.0};
+  IO_TIME io_time;
+  RUN_STATS run_stats;
   IO_INFO io_info;
   IJK::ERROR error;
 
@@ -66,6 +68,7 @@ int main(int argc, char **argv)
     NRRD_HEADER nrrd_header;
     read_nrrd_file
       (io_info.input_filename, full_scalar_grid,  nrrd_header, io_time);
+    run_stats.num_bytes_read = get_file_size(io_info.input_filename);
 
     if (!check_input(io_info, full_scalar_grid, error)) 
       { throw(error); };
@@ -83,18 +86,24 @@ int main(int argc, char **argv)
     warn_non_manifold(io_info);
     report_num_cubes(full_scalar_grid, io_info, dualiso_data);
 
-    construct_isosurface(io_info, dualiso_data, dualiso_time, io_time);
+    construct_isosurface
+      (io_info, dualiso_data, dualiso_time, io_time, run_stats);
 
-    if (io_info.flag_report_time) {
-
-      time_t end_time;
-      time(&end_time);
-      double total_elapsed_time = difftime(end_time, start_time);
+    total_timer.Stop();
 
+    if (io_info.flag_report_time) {
       cout << endl;
       report_time(io_info, io_time, dualiso_time, total_elapsed_time);
     };
 
+    if (io_info.time_json_filename != "") {
+      write_time_json(io_info, io_time, dualiso_time, total_elapsed_time);
+    }
+
+    if (io_info.stats_json_filename != "") {
+      write_stats_json(io_info, io_time, run_stats, total_elapsed_time);
+    }
+
   } 
   catch (ERROR & error) {
     if (error.NumMessages() == 0) {
@@ -115,18 +124,32 @@ int main(int argc, char **argv)
 template <typename DUALISO_DATA_TYPE, typename DUAL_ISOSURFACE_TYPE>
 void rescale_and_triangulate
 (const IO_INFO & io_info, const DUALISO_DATA_TYPE & dualiso_data,
- const SCALAR_TYPE isovalue, DUAL_ISOSURFACE_TYPE & dual_isosurface);
+ const SCALAR_TYPE isovalue, DUAL_ISOSURFACE_TYPE & dual_isosurface,
+ DUALISO_TIME & dualiso_time);
 
 
 void construct_isosurface
 (const IO_INFO & io_info, const DUALISO_DATA & dualiso_data,
- DUALISO_TIME & dualiso_time, IO_TIME & io_time)
+ DUALISO_TIME & dualiso_time, IO_TIME & io_time, RUN_STATS & run_stats)
 {
   const int dimension = dualiso_data.ScalarGrid().Dimension();
   const int num_facet_vertices = dualiso_data.ScalarGrid().NumFacetVertices();
-  const int num_cubes = dualiso_data.ScalarGrid().ComputeNumCubes();
+  const VERTEX_INDEX num_cubes = dualiso_data.ScalarGrid().ComputeNumCubes();
+
+  // Tables and scratch buffers are reused for each isovalue.
+  DUALISO_CONTEXT context;
+
+  if (dualiso_data.ExtractMultiIsovalueFlag() && 
+      io_info.isovalue.size() > 1) {
+    // Single sweep extraction.  dual_contouring uses the stored polytopes.
+    DUALISO_INFO sweep_info(dimension);
+    extract_dual_isopoly_multi_isovalue
+      (dualiso_data, io_info.isovalue, context, sweep_info);
+    dualiso_time.extract.Add(sweep_info.time.extract);
+    dualiso_time.total.Add(sweep_info.time.extract);
+  }
 
-  io_time.write_time = 0;
+  io_time.write_time.Clear();
   for (unsigned int i = 0; i < io_info.isovalue.size(); i++) {
 
     const SCALAR_TYPE isovalue = io_info.isovalue[i];
@@ -136,17 +159,42 @@ void construct_isosurface
     // Dual contouring.  
     DUAL_ISOSURFACE dual_isosurface(dimension, num_facet_vertices);
 
-    dual_contouring(dualiso_data, isovalue, dual_isosurface, dualiso_info);
-    dualiso_time.Add(dualiso_info.time);
+    dual_contouring
+      (dualiso_data, isovalue, dual_isosurface, dualiso_info, context);
 
-    rescale_and_triangulate(io_info, dualiso_data, isovalue, dual_isosurface);
+    rescale_and_triangulate
+      (io_info, dualiso_data, isovalue, dual_isosurface, dualiso_info.time);
+    dualiso_time.Add(dualiso_info.time);
 
     OUTPUT_INFO output_info;
     set_output_info(io_info, i, output_info);
     output_info.SetDimension(dimension);
+    output_info.SetExtractionGrid
+      (dimension, dualiso_data.ScalarGrid().AxisSize(), 
+       dualiso_data.ScalarGrid().SpacingPtrConst());
 
+    const IJK::WALL_CPU_TIME write_time0 = io_time.write_time;
     output_dual_isosurface
       (output_info, dualiso_data, dual_isosurface, dualiso_info, io_time);
+
+    ISOVALUE_STATS stats;
+    stats.isovalue = isovalue;
+    stats.dualiso_info = dualiso_info;
+    stats.num_isov = dual_isosurface.NumIsoVert();
+    // Count polygons as written by output_dual_isosurface.
+    if (output_info.use_triangle_mesh) 
+      { stats.num_tri = dual_isosurface.tri_vert.size()/3; }
+    else if (output_info.flag_dual_collapse || 
+             output_info.flag_adaptive_octree) {
+      stats.num_isopoly = dual_isosurface.NumIsoPoly();
+      stats.num_tri = dual_isosurface.tri_vert.size()/3;
+    }
+    else
+      { stats.num_isopoly = dual_isosurface.NumIsoPoly(); }
+    stats.write_time.wall = io_time.write_time.wall - write_time0.wall;
+    stats.write_time.cpu = io_time.write_time.cpu - write_time0.cpu;
+    stats.num_bytes_written = get_output_file_size(output_info);
+    run_stats.isovalue_stats.push_back(stats);
   }
 }
 
@@ -154,26 +202,57 @@ void construct_isosurface
 template <typename DUALISO_DATA_TYPE, typename DUAL_ISOSURFACE_TYPE>
 void rescale_and_triangulate
 (const IO_INFO & io_info, const DUALISO_DATA_TYPE & dualiso_data,
- const SCALAR_TYPE isovalue, DUAL_ISOSURFACE_TYPE & dual_isosurface)
+ const SCALAR_TYPE isovalue, DUAL_ISOSURFACE_TYPE & dual_isosurface,
+ DUALISO_TIME & dualiso_time)
 {
   const int dimension = dualiso_data.ScalarGrid().Dimension();
 
+  // dualiso_time.total covers rescaling and triangulation.
+  IJK::SCOPED_TIMER total_timer(dualiso_time.total);
+
+  // Convert cube relative coordinates before adding vertices
+  //   and rescaling.
+  IJK::SCOPED_TIMER convert_timer(dualiso_time.rescale);
+  convert_cube_relative_coord(dualiso_data.ScalarGrid(), dual_isosurface);
+  convert_timer.Stop();
+
   if (dualiso_data.flag_tri4_quad) {
+    // Vertices added for tri4 triangulation count as triangulation time.
+    IJK::SCOPED_TIMER add_isov_timer(dualiso_time.triangulate);
     if (dualiso_data.tri4_position_method == TRI4_CENTROID) {
-      add_isov_at_poly_centroids(dualiso_data, dual_isosurface); 
+      add_isov_at_poly_centroids
+        (dualiso_data, dual_isosurface, &dualiso_time.triangulate); 
     }
     else {
-      add_isov_on_grid_edges(dualiso_data, isovalue, dual_isosurface); 
+      add_isov_on_grid_edges
+        (dualiso_data, isovalue, dual_isosurface, 
+         &dualiso_time.triangulate); 
     }
   }
 
   // Rescale before triangulation.
+  IJK::SCOPED_TIMER rescale_timer(dualiso_time.rescale);
   rescale_vertex_coord
     (dimension, dualiso_data.ScalarGrid().SpacingPtrConst(),
      dual_isosurface.vertex_coord);
+  rescale_timer.Stop();
+
+  if (dimension == 3 && dualiso_data.UseTriangleMesh()) {
+    IJK::SCOPED_TIMER triangulate_timer(dualiso_time.triangulate);
 
-  if (dimension == 3 && dualiso_data.UseTriangleMesh()) 
-    { convert_quad_to_tri(dualiso_data, dual_isosurface); }
+    if (dualiso_data.flag_tri4_quad) {
+      convert_quad_to_tri
+        (dualiso_data, dual_isosurface, &dualiso_time.triangulate); 
+    }
+    else {
+      // Quadrilaterals are not output.  Replace them by triangles.
+      convert_quad_to_tri_in_place
+        (dualiso_data, dual_isosurface, &dualiso_time.triangulate); 
+    }
+
+    if (dualiso_data.ReorderVertexCacheFlag()) 
+      { reorder_isosurface_for_vertex_cache(dualiso_data, dual_isosurface); }
+  }
 }
 
 void memory_exhaustion()
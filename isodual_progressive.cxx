@@ -0,0 +1,355 @@
+/// \file isodual_progressive.cxx
+/// Progressive coarse-to-fine dual contouring.
+
+/*
+  IJK: Isosurface Jeneration Kode
+  Copyright (C) 2017 Rephael Wenger
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License
+  (LGPL) as published by the Free Software Foundation; either
+  version 2.1 of the License, or any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <algorithm>
+
+#include "isodual.h"
+#include "isodual_progressive.h"
+
+using namespace IJK;
+using namespace ISODUAL;
+
+
+// **************************************************
+// CLASS PROGRESSIVE_DATA
+// **************************************************
+
+bool ISODUAL::PROGRESSIVE_DATA::Matches
+(const DUALISO_SCALAR_GRID_BASE & scalar_grid) const
+{
+  if (!is_set) { return(false); }
+  if (int(axis_size.size()) != scalar_grid.Dimension()) { return(false); }
+
+  for (int d = 0; d < scalar_grid.Dimension(); d++) {
+    if (axis_size[d] != scalar_grid.AxisSize(d)) { return(false); }
+  }
+
+  return(true);
+}
+
+void ISODUAL::PROGRESSIVE_DATA::Set
+(const DUALISO_SCALAR_GRID_BASE & scalar_grid, const int max_resolution)
+{
+  const int dimension = scalar_grid.Dimension();
+  IJK::PROCEDURE_ERROR error("PROGRESSIVE_DATA::Set");
+
+  if (max_resolution < 1 || (max_resolution & (max_resolution-1)) != 0) {
+    error.AddMessage("Illegal maximum resolution ", max_resolution, ".");
+    error.AddMessage("  Maximum resolution must be a power of 2.");
+    throw error;
+  }
+
+  Clear();
+
+  for (int s = max_resolution; s >= 2; s = s/2) {
+
+    // Skip levels whose subsampled grid has no cubes.
+    bool flag_has_cubes = (dimension > 0);
+    for (int d = 0; d < dimension; d++) {
+      if ((long(scalar_grid.AxisSize(d))-1)/s < 1)
+        { flag_has_cubes = false; }
+    }
+    if (!flag_has_cubes) { continue; }
+
+    level.emplace_back();
+    level.back().subsample_resolution = s;
+    level.back().dualiso_data.SetScalarGrid(scalar_grid, true, s, false, 1);
+  }
+
+  if (!level.empty()) {
+    coarse_minmax.ComputeMinMax
+      (scalar_grid, level.front().subsample_resolution);
+  }
+
+  axis_size.assign
+    (scalar_grid.AxisSize(), scalar_grid.AxisSize()+dimension);
+  is_set = true;
+}
+
+void ISODUAL::PROGRESSIVE_DATA::Clear()
+{
+  level.clear();
+  axis_size.clear();
+  is_set = false;
+}
+
+
+// **************************************************
+// ACTIVE CUBES
+// **************************************************
+
+namespace {
+
+  // Return true if s is in the range of scalar values of the block
+  //   of full grid vertices with coordinates in [coord[d], coord[d]+L].
+  // Same test as the block min and max test in extraction.
+  bool is_block_active
+  (const DUALISO_SCALAR_GRID_BASE & full_grid, const SCALAR_TYPE s,
+   const std::vector<long> & coord, const int L)
+  {
+    const int dimension = full_grid.Dimension();
+    std::vector<long> c(coord);
+    bool flag_below = false;
+    bool flag_above = false;
+
+    VERTEX_INDEX row_start = 0;
+    for (int d = 0; d < dimension; d++)
+      { row_start += coord[d]*full_grid.AxisIncrement(d); }
+
+    while (true) {
+      for (VERTEX_INDEX iv = row_start; iv <= row_start+L; iv++) {
+        if (full_grid.Scalar(iv) < s) { flag_below = true; }
+        else { flag_above = true; }
+      }
+      if (flag_below && flag_above) { return(true); }
+
+      // Next row in block, lexicographic order.
+      int d = 1;
+      while (d < dimension) {
+        c[d]++;
+        row_start += full_grid.AxisIncrement(d);
+        if (c[d] <= coord[d]+L) { break; }
+        row_start -= (c[d]-coord[d])*full_grid.AxisIncrement(d);
+        c[d] = coord[d];
+        d++;
+      }
+      if (d >= dimension) { break; }
+    }
+
+    return(false);
+  }
+
+  // Apply f(coord) to each cube of grid with coord[d] in
+  //   [coord_min[d], coord_end[d]).
+  template <typename FTYPE>
+  void for_each_cube_in_range
+  (const int dimension, const std::vector<long> & coord_min,
+   const std::vector<long> & coord_end, FTYPE & f)
+  {
+    std::vector<long> coord(coord_min);
+
+    if (dimension < 1) { return; }
+    for (int d = 0; d < dimension; d++)
+      { if (coord_min[d] >= coord_end[d]) { return; } }
+
+    while (true) {
+      f(coord);
+
+      int d = 0;
+      while (d < dimension) {
+        coord[d]++;
+        if (coord[d] < coord_end[d]) { break; }
+        coord[d] = coord_min[d];
+        d++;
+      }
+      if (d >= dimension) { break; }
+    }
+  }
+
+  // Get active cubes of the coarsest level from coarse_minmax.
+  void get_coarse_active_cubes
+  (const DUALISO_GRID & level_grid, const SCALAR_TYPE isovalue,
+   const DUALISO_MINMAX_REGIONS & coarse_minmax,
+   std::vector<VERTEX_INDEX> & active_cube)
+  {
+    const int dimension = level_grid.Dimension();
+    std::vector<long> coord_min(dimension, 0);
+    std::vector<long> coord_end(dimension);
+
+    active_cube.clear();
+
+    for (int d = 0; d < dimension; d++)
+      { coord_end[d] = long(level_grid.AxisSize(d))-1; }
+
+    auto add_if_active =
+      [&](const std::vector<long> & coord)
+      {
+        // Region of coarse_minmax with the same coordinates as the cube.
+        const VERTEX_INDEX iregion = coarse_minmax.ComputeVertexIndex(coord);
+        if (coarse_minmax.Max(iregion) < isovalue ||
+            coarse_minmax.Min(iregion) >= isovalue) { return; }
+        active_cube.push_back(level_grid.ComputeVertexIndex(coord));
+      };
+
+    for_each_cube_in_range(dimension, coord_min, coord_end, add_if_active);
+  }
+
+  // Get active cubes of a level from the active cubes of the
+  //   previous (coarser) level.
+  // - Cube c of the level is in cube c/2 of the previous level.
+  // - Cubes of the level which are not in any cube of the previous level
+  //   are also tested.
+  // - Cube c is active if the full grid block [c*L, c*L+L] is active,
+  //   where L is the level resolution.
+  void get_fine_active_cubes
+  (const DUALISO_SCALAR_GRID_BASE & full_grid, const SCALAR_TYPE isovalue,
+   const DUALISO_GRID & coarse_grid,
+   const std::vector<VERTEX_INDEX> & coarse_active_cube,
+   const DUALISO_GRID & level_grid, const int level_resolution,
+   std::vector<VERTEX_INDEX> & active_cube)
+  {
+    const int dimension = level_grid.Dimension();
+    std::vector<long> coarse_num_cubes(dimension);
+    std::vector<long> num_cubes(dimension);
+    std::vector<long> coord(dimension);
+    std::vector<long> coord_min(dimension);
+    std::vector<long> coord_end(dimension);
+    std::vector<long> full_coord(dimension);
+
+    active_cube.clear();
+
+    for (int d = 0; d < dimension; d++) {
+      coarse_num_cubes[d] = long(coarse_grid.AxisSize(d))-1;
+      num_cubes[d] = long(level_grid.AxisSize(d))-1;
+    }
+
+    auto add_if_active =
+      [&](const std::vector<long> & coord)
+      {
+        for (int d = 0; d < dimension; d++)
+          { full_coord[d] = coord[d]*level_resolution; }
+        if (is_block_active
+            (full_grid, isovalue, full_coord, level_resolution))
+          { active_cube.push_back(level_grid.ComputeVertexIndex(coord)); }
+      };
+
+    // Children of active cubes of the previous level.
+    for (std::size_t i = 0; i < coarse_active_cube.size(); i++) {
+      coarse_grid.ComputeCoord(coarse_active_cube[i], &(coord.front()));
+      for (int d = 0; d < dimension; d++) {
+        coord_min[d] = 2*coord[d];
+        coord_end[d] = std::min(2*coord[d]+2, num_cubes[d]);
+      }
+      for_each_cube_in_range(dimension, coord_min, coord_end, add_if_active);
+    }
+
+    // Cubes with coord[d] = 2*coarse_num_cubes[d] are not in any cube
+    //   of the previous level.  Process each such cube once,
+    //   using the first such d.
+    for (int d0 = 0; d0 < dimension; d0++) {
+      if (2*coarse_num_cubes[d0] >= num_cubes[d0]) { continue; }
+      for (int d = 0; d < dimension; d++) {
+        coord_min[d] = 0;
+        coord_end[d] = num_cubes[d];
+        if (d < d0)
+          { coord_end[d] = std::min(coord_end[d], 2*coarse_num_cubes[d]); }
+      }
+      coord_min[d0] = 2*coarse_num_cubes[d0];
+      for_each_cube_in_range(dimension, coord_min, coord_end, add_if_active);
+    }
+
+    // Sort for locality in the scalar grid.
+    std::sort(active_cube.begin(), active_cube.end());
+  }
+
+}
+
+
+// **************************************************
+// PROGRESSIVE DUAL CONTOURING
+// **************************************************
+
+void ISODUAL::dual_contouring_progressive
+(DUALISO_DATA & dualiso_data, const SCALAR_TYPE isovalue,
+ PROGRESSIVE_DATA & progressive,
+ const PROGRESSIVE_LEVEL_FUNCTION & level_function,
+ DUAL_ISOSURFACE & dual_isosurface, DUALISO_INFO & dualiso_info,
+ DUALISO_CONTEXT & context)
+{
+  const DUALISO_SCALAR_GRID_BASE & full_grid = dualiso_data.ScalarGrid();
+  const int dimension = full_grid.Dimension();
+  const int num_facet_vertices = full_grid.NumFacetVertices();
+  IJK::PROCEDURE_ERROR error("dual_contouring_progressive");
+
+  if (!progressive.Matches(full_grid)) {
+    error.AddMessage("Programming error.  Progressive data not set for grid.");
+    throw error;
+  }
+
+  if (dualiso_data.ROIFlag() || dualiso_data.BrickFlag()) {
+    error.AddMessage
+      ("Progressive contouring does not support region of interest"
+       " or brick mode.");
+    throw error;
+  }
+
+  const DUALISO_GRID * coarse_grid = NULL;
+  const std::vector<VERTEX_INDEX> * coarse_active_cube = NULL;
+  for (std::list<PROGRESSIVE_LEVEL>::iterator level_iter =
+         progressive.level.begin();
+       level_iter != progressive.level.end(); level_iter++) {
+
+    PROGRESSIVE_LEVEL & level = *level_iter;
+    const DUALISO_SCALAR_GRID_BASE & level_grid =
+      level.dualiso_data.ScalarGrid();
+
+    if (coarse_grid == NULL) {
+      get_coarse_active_cubes
+        (level_grid, isovalue, progressive.coarse_minmax,
+         level.context.active_cube);
+    }
+    else {
+      get_fine_active_cubes
+        (full_grid, isovalue, *coarse_grid, *coarse_active_cube,
+         level_grid, level.subsample_resolution, level.context.active_cube);
+    }
+
+    level.dualiso_data.Set(dualiso_data);
+    level.dualiso_data.flag_extract_active_cubes = true;
+
+    DUAL_ISOSURFACE level_isosurface(dimension, num_facet_vertices);
+    DUALISO_INFO level_info(dimension);
+    dual_contouring
+      (level.dualiso_data, isovalue, level_isosurface, level_info,
+       level.context);
+
+    level_function
+      (level.subsample_resolution, level.dualiso_data, level_isosurface);
+
+    coarse_grid = &level_grid;
+    coarse_active_cube = &(level.context.active_cube);
+  }
+
+  if (coarse_grid == NULL) {
+    // No subsampled levels.  Contour full grid.
+    dual_contouring
+      (dualiso_data, isovalue, dual_isosurface, dualiso_info, context);
+    return;
+  }
+
+  get_fine_active_cubes
+    (full_grid, isovalue, *coarse_grid, *coarse_active_cube,
+     full_grid, 1, context.active_cube);
+
+  const bool flag_extract_active_cubes =
+    dualiso_data.flag_extract_active_cubes;
+  dualiso_data.flag_extract_active_cubes = true;
+  try {
+    dual_contouring
+      (dualiso_data, isovalue, dual_isosurface, dualiso_info, context);
+  }
+  catch (...) {
+    dualiso_data.flag_extract_active_cubes = flag_extract_active_cubes;
+    throw;
+  }
+  dualiso_data.flag_extract_active_cubes = flag_extract_active_cubes;
+}
@@ -0,0 +1,138 @@
+/// \file isodual_progressive.h
+/// Progressive coarse-to-fine dual contouring.
+/// Contours subsampled grids, coarsest first, then the full grid.
+
+/*
+  IJK: Isosurface Jeneration Kode
+  Copyright (C) 2017 Rephael Wenger
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License
+  (LGPL) as published by the Free Software Foundation; either
+  version 2.1 of the License, or any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef _ISODUAL_PROGRESSIVE_
+#define _ISODUAL_PROGRESSIVE_
+
+#include <functional>
+#include <list>
+
+#include "isodual_types.h"
+#include "isodual_datastruct.h"
+
+
+/// isodual progressive contouring classes and routines.
+namespace ISODUAL {
+
+  /// Default subsample resolution of the coarsest progressive level.
+  const int PROGRESSIVE_MAX_RESOLUTION = 8;
+
+
+  // **************************************************
+  // PROGRESSIVE DATA
+  // **************************************************
+
+  /// One subsampled level of progressive contouring.
+  class PROGRESSIVE_LEVEL {
+
+  public:
+    int subsample_resolution;
+
+    /// Grid subsampled at subsample_resolution.
+    DUALISO_DATA dualiso_data;
+
+    /// Tables and buffers of the level.
+    /// context.active_cube is the list of active cubes of the level.
+    DUALISO_CONTEXT context;
+  };
+
+
+  /// Subsampled grids kept between progressive contouring calls.
+  /// - Levels have subsample resolutions max_resolution,
+  ///   max_resolution/2, ..., 2.  Levels whose subsampled grid
+  ///   has no cubes are omitted.
+  /// - Data is valid only for the scalar grid given to Set().
+  class PROGRESSIVE_DATA {
+
+  protected:
+    std::vector<AXIS_SIZE_TYPE> axis_size;
+    bool is_set;
+
+  public:
+    /// Subsampled levels, coarsest first.
+    std::list<PROGRESSIVE_LEVEL> level;
+
+    /// Min and max scalar values of the full grid in the blocks
+    ///   of grid cubes forming the cubes of the coarsest level.
+    /// Does not depend on the isovalue.
+    DUALISO_MINMAX_REGIONS coarse_minmax;
+
+  public:
+    PROGRESSIVE_DATA() { is_set = false; };
+
+    bool IsSet() const { return(is_set); };
+
+    /// Return true if data was set for a grid with the axis sizes
+    ///   of scalar_grid.
+    bool Matches(const DUALISO_SCALAR_GRID_BASE & scalar_grid) const;
+
+    /// Subsample scalar_grid and compute coarse_minmax.
+    /// @pre max_resolution is a power of 2.
+    void Set(const DUALISO_SCALAR_GRID_BASE & scalar_grid,
+             const int max_resolution);
+
+    /// Free subsampled grids.
+    void Clear();
+  };
+
+
+  // **************************************************
+  // PROGRESSIVE DUAL CONTOURING
+  // **************************************************
+
+  /// Function called on the isosurface of each subsampled level.
+  /// - Vertex coordinates are in the coordinates of the subsampled grid
+  ///   dualiso_data.ScalarGrid(), before rescaling by grid spacing.
+  typedef std::function<void
+    (const int subsample_resolution, const DUALISO_DATA & dualiso_data,
+     DUAL_ISOSURFACE & dual_isosurface)>
+  PROGRESSIVE_LEVEL_FUNCTION;
+
+  /// Progressive dual contouring.
+  /// - Contours each level of progressive, coarsest first,
+  ///   and calls level_function on its isosurface.
+  ///   Then contours dualiso_data and returns dual_isosurface.
+  /// - Each level extracts isosurface polytopes only from active cubes,
+  ///   i.e., cubes whose full resolution scalar values
+  ///   span the isovalue.  Cubes of the coarsest level are tested
+  ///   using progressive.coarse_minmax.  Cubes of finer levels are
+  ///   tested only if they lie in an active cube of the previous level.
+  /// - Each level has the same isosurface as contouring the
+  ///   subsampled grid with dual_contouring.  dual_isosurface is
+  ///   the same as the isosurface returned by dual_contouring,
+  ///   up to the order of polytopes and vertices.
+  /// - Flags of dualiso_data are used on all levels.
+  ///   ROI and brick flags are not supported.
+  /// - dualiso_data.flag_extract_active_cubes is set while contouring
+  ///   the full grid and restored on return.
+  /// @pre progressive.Set() was called on dualiso_data.ScalarGrid().
+  void dual_contouring_progressive
+    (DUALISO_DATA & dualiso_data, const SCALAR_TYPE isovalue,
+     PROGRESSIVE_DATA & progressive,
+     const PROGRESSIVE_LEVEL_FUNCTION & level_function,
+     DUAL_ISOSURFACE & dual_isosurface, DUALISO_INFO & dualiso_info,
+     DUALISO_CONTEXT & context);
+
+}
+
+#endif
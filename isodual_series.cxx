@@ -0,0 +1,363 @@
+/// \file isodual_series.cxx
+/// Contour a time series of volumes.
+
+/*
+  IJK: Isosurface Jeneration Kode
+  Copyright (C) 2017 Rephael Wenger
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License
+  (LGPL) as published by the Free Software Foundation; either
+  version 2.1 of the License, or any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <algorithm>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "isodualIO.h"
+#include "isodual_series.h"
+
+using namespace IJK;
+using namespace ISODUAL;
+
+
+// **************************************************
+// CLASS SERIES_PARAM
+// **************************************************
+
+// Return maximum time step number.
+// - Files added directly to filename are numbered by position.
+int ISODUAL::SERIES_PARAM::MaxTimeStep() const
+{
+  return(std::max(max_time_step, int(filename.size())-1));
+}
+
+
+std::string ISODUAL::SERIES_PARAM::OutputFilename
+(const int time_step, const int isovalue_index) const
+{
+  std::ostringstream output_filename;
+
+  // Pad time step with zeros so files sort in time step order.
+  int width = 1;
+  for (int k = MaxTimeStep(); k >= 10; k = k/10)
+    { width++; }
+
+  output_filename << off_prefix << "."
+                  << std::setw(width) << std::setfill('0') << time_step;
+  if (isovalue.size() > 1)
+    { output_filename << "." << isovalue_index; }
+  output_filename << ".off";
+
+  return(output_filename.str());
+}
+
+
+// **************************************************
+// CLASS SERIES_STATS
+// **************************************************
+
+void ISODUAL::SERIES_STATS::Clear()
+{
+  num_frames = 0;
+  num_errors = 0;
+  num_vertices = 0;
+  num_poly = 0;
+  num_reused_blocks = 0;
+  num_extracted_blocks = 0;
+  total_time.Clear();
+  read_time.Clear();
+  contour_time.Clear();
+  write_time.Clear();
+}
+
+double ISODUAL::SERIES_STATS::FramesPerSecond() const
+{
+  if (total_time.wall <= 0) { return(0); }
+  return(num_frames/total_time.wall);
+}
+
+void ISODUAL::SERIES_STATS::Print(std::ostream & out) const
+{
+  out << "Time steps: " << num_frames;
+  if (num_errors > 0)
+    { out << "  (" << num_errors << " with errors)"; }
+  out << std::endl;
+  out << "Isosurface vertices: " << num_vertices
+      << "  Isosurface polygons: " << num_poly << std::endl;
+  if (num_reused_blocks+num_extracted_blocks > 0) {
+    out << "Incremental extraction: " << num_reused_blocks
+        << " blocks reused, " << num_extracted_blocks 
+        << " blocks extracted." << std::endl;
+  }
+  out << "Read stage:     " << read_time.wall << " seconds." << std::endl;
+  out << "Contour stage:  " << contour_time.wall << " seconds." << std::endl;
+  out << "Write stage:    " << write_time.wall << " seconds." << std::endl;
+  out << "Total time:     " << total_time.wall << " seconds." << std::endl;
+  out << "Frames per second: " << FramesPerSecond() << std::endl;
+}
+
+
+// **************************************************
+// PIPELINE STAGES
+// **************************************************
+
+namespace {
+
+  typedef BOUNDED_QUEUE<SERIES_FRAME *> FRAME_QUEUE;
+
+  void set_frame_error(const IJK::ERROR & error, SERIES_FRAME & frame)
+  {
+    std::ostringstream message;
+
+    frame.status = 1;
+    error.Print(message);
+    frame.message = message.str();
+  }
+
+  void set_frame_error(const char * message, SERIES_FRAME & frame)
+  {
+    frame.status = 1;
+    frame.message = message;
+    frame.message += "\n";
+  }
+
+  void read_frame
+  (const SERIES_PARAM & param, const int step, SERIES_FRAME & frame)
+  {
+    frame.step = step;
+    frame.time_step = param.TimeStep(step);
+    frame.filename = param.filename[step];
+    frame.status = 0;
+    frame.message.clear();
+
+    try {
+      DUALISO_SCALAR_GRID full_scalar_grid;
+      NRRD_HEADER nrrd_header;
+      IO_TIME io_time;
+
+      read_nrrd_file(frame.filename, full_scalar_grid, nrrd_header, io_time);
+      frame.dualiso_data.SetScalarGrid
+        (full_scalar_grid, false, 1, false, 1);
+    }
+    catch (IJK::ERROR & error) {
+      set_frame_error(error, frame);
+    }
+    catch (std::exception & e) {
+      set_frame_error(e.what(), frame);
+    }
+    catch (...) {
+      set_frame_error("Unknown error.", frame);
+    }
+  }
+
+  void contour_frame
+  (const SERIES_PARAM & param, std::vector<DUALISO_CONTEXT> & context,
+   SERIES_FRAME & frame)
+  {
+    frame.mesh.resize(param.isovalue.size());
+    for (int i = 0; i < int(frame.mesh.size()); i++)
+      { frame.mesh[i].Clear(); }
+    frame.num_reused_blocks = 0;
+    frame.num_extracted_blocks = 0;
+
+    if (frame.status != 0) { return; }
+
+    try {
+      for (int i = 0; i < int(param.isovalue.size()); i++) {
+        const ISODUAL_REQUEST request
+          (frame.filename, param.isovalue[i], param.flags);
+        process_request
+          (request, frame.dualiso_data, context[i], frame.mesh[i]);
+
+        if (request.Flag(REQUEST_EXTRACT_INCREMENTAL)) {
+          const INCREMENTAL_EXTRACT_DATA & incremental = 
+            context[i].incremental;
+          frame.num_reused_blocks += incremental.num_reused_blocks;
+          frame.num_extracted_blocks += incremental.num_extracted_blocks;
+        }
+      }
+    }
+    catch (IJK::ERROR & error) {
+      set_frame_error(error, frame);
+    }
+    catch (std::exception & e) {
+      set_frame_error(e.what(), frame);
+    }
+    catch (...) {
+      set_frame_error("Unknown error.", frame);
+    }
+  }
+
+  void write_frame
+  (const SERIES_PARAM & param, SERIES_FRAME & frame, SERIES_STATS & stats)
+  {
+    if (frame.status == 0 && param.off_prefix != "") {
+      try {
+        for (int i = 0; i < int(frame.mesh.size()); i++) {
+          write_isodual_mesh_off
+            (param.OutputFilename(frame.time_step, i), frame.mesh[i]);
+        }
+      }
+      catch (IJK::ERROR & error) {
+        set_frame_error(error, frame);
+      }
+      catch (std::exception & e) {
+        set_frame_error(e.what(), frame);
+      }
+      catch (...) {
+        set_frame_error("Unknown error.", frame);
+      }
+    }
+
+    stats.num_frames++;
+    if (frame.status != 0) {
+      stats.num_errors++;
+      std::cerr << "Error in time step " << frame.time_step
+                << " (" << frame.filename << ")." << std::endl;
+      std::cerr << frame.message;
+      return;
+    }
+
+    long num_vertices = 0;
+    long num_poly = 0;
+    for (int i = 0; i < int(frame.mesh.size()); i++) {
+      num_vertices += frame.mesh[i].NumVertices();
+      num_poly += frame.mesh[i].NumPoly();
+    }
+    stats.num_vertices += num_vertices;
+    stats.num_poly += num_poly;
+    stats.num_reused_blocks += frame.num_reused_blocks;
+    stats.num_extracted_blocks += frame.num_extracted_blocks;
+
+    if (param.flag_verbose) {
+      std::cout << "Time step " << frame.time_step << " (" << frame.filename
+                << "): " << num_vertices << " vertices, "
+                << num_poly << " polygons." << std::endl;
+    }
+  }
+
+  void run_read_stage
+  (const SERIES_PARAM & param, FRAME_QUEUE & free_queue,
+   FRAME_QUEUE & read_queue, IJK::WALL_CPU_TIME & read_time)
+  {
+    for (int step = 0; step < int(param.filename.size()); step++) {
+      SERIES_FRAME * frame;
+      free_queue.Pop(frame);
+
+      IJK::SCOPED_TIMER timer(read_time);
+      read_frame(param, step, *frame);
+      timer.Stop();
+
+      read_queue.Push(frame);
+    }
+    read_queue.Close();
+  }
+
+  void run_contour_stage
+  (const SERIES_PARAM & param, FRAME_QUEUE & read_queue,
+   FRAME_QUEUE & write_queue, IJK::WALL_CPU_TIME & contour_time)
+  {
+    // Tables, scratch buffers and incremental extraction data 
+    //   are reused across time steps.  One context per isovalue.
+    std::vector<DUALISO_CONTEXT> context(param.isovalue.size());
+    SERIES_FRAME * frame;
+
+    while (read_queue.Pop(frame)) {
+      IJK::SCOPED_TIMER timer(contour_time);
+      contour_frame(param, context, *frame);
+      timer.Stop();
+
+      write_queue.Push(frame);
+    }
+    write_queue.Close();
+  }
+
+}
+
+
+// **************************************************
+// RUN TIME SERIES
+// **************************************************
+
+void ISODUAL::run_isodual_series
+(const SERIES_PARAM & param, SERIES_STATS & stats)
+{
+  const int queue_size = std::max(param.queue_size, 1);
+  // One frame per stage plus frames waiting in the two queues.
+  const int num_frames = 2*queue_size+3;
+  IJK::PROCEDURE_ERROR error("run_isodual_series");
+
+  if (param.isovalue.size() == 0) {
+    error.AddMessage("Programming error.  No isovalues.");
+    throw error;
+  }
+
+  stats.Clear();
+  IJK::SCOPED_TIMER total_timer(stats.total_time);
+
+  std::vector<SERIES_FRAME> frame(num_frames);
+  FRAME_QUEUE free_queue(num_frames);
+  FRAME_QUEUE read_queue(queue_size);
+  FRAME_QUEUE write_queue(queue_size);
+
+  for (int i = 0; i < num_frames; i++)
+    { free_queue.Push(&(frame[i])); }
+
+  std::thread read_thread
+    (run_read_stage, std::cref(param), std::ref(free_queue),
+     std::ref(read_queue), std::ref(stats.read_time));
+  std::thread contour_thread
+    (run_contour_stage, std::cref(param), std::ref(read_queue),
+     std::ref(write_queue), std::ref(stats.contour_time));
+
+  // Write stage runs on the calling thread.
+  SERIES_FRAME * next_frame;
+  while (write_queue.Pop(next_frame)) {
+    IJK::SCOPED_TIMER timer(stats.write_time);
+    write_frame(param, *next_frame, stats);
+    timer.Stop();
+
+    free_queue.Push(next_frame);
+  }
+
+  read_thread.join();
+  contour_thread.join();
+  total_timer.Stop();
+}
+
+
+// **************************************************
+// SERIES PATTERN
+// **************************************************
+
+bool ISODUAL::expand_series_pattern
+(const std::string & pattern, const int step, std::string & filename)
+{
+  const std::string::size_type iend = pattern.find_last_of('#');
+  if (iend == std::string::npos) { return(false); }
+
+  std::string::size_type ibegin = iend;
+  while (ibegin > 0 && pattern[ibegin-1] == '#')
+    { ibegin--; }
+
+  const int width = iend+1-ibegin;
+  std::ostringstream s;
+  s << std::setw(width) << std::setfill('0') << step;
+
+  filename = pattern.substr(0, ibegin) + s.str() + pattern.substr(iend+1);
+  return(true);
+}
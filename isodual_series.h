@@ -0,0 +1,234 @@
+/// \file isodual_series.h
+/// Contour a time series of volumes.
+/// Reading, contouring and writing run as a three stage pipeline.
+
+/*
+  IJK: Isosurface Jeneration Kode
+  Copyright (C) 2017 Rephael Wenger
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License
+  (LGPL) as published by the Free Software Foundation; either
+  version 2.1 of the License, or any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef _ISODUAL_SERIES_
+#define _ISODUAL_SERIES_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ijk.txx"
+#include "ijktime.txx"
+
+#include "isodual_types.h"
+#include "isodual_datastruct.h"
+#include "isodual_server.h"
+
+
+/// isodual time series classes and routines.
+namespace ISODUAL {
+
+  // **************************************************
+  // BOUNDED QUEUE
+  // **************************************************
+
+  /// Queue with bounded size shared by pipeline threads.
+  /// - Push blocks while the queue is full.
+  /// - Pop blocks while the queue is empty and not closed.
+  template <typename ETYPE>
+  class BOUNDED_QUEUE {
+
+  protected:
+    std::deque<ETYPE> element;
+    int max_size;
+    bool is_closed;
+    std::mutex queue_mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+
+  public:
+    BOUNDED_QUEUE(const int max_size)
+      { this->max_size = max_size; is_closed = false; };
+
+    /// Add x to the back of the queue.
+    void Push(const ETYPE & x);
+
+    /// Remove element from the front of the queue and return it in x.
+    /// Return false if the queue is closed and empty.
+    bool Pop(ETYPE & x);
+
+    /// Close queue.  No more elements will be pushed.
+    void Close();
+  };
+
+
+  // **************************************************
+  // SERIES FRAME AND STATISTICS
+  // **************************************************
+
+  /// One time step passing through the pipeline.
+  class SERIES_FRAME {
+
+  public:
+    int step;                  ///< Index into SERIES_PARAM::filename.
+    int time_step;             ///< Time step number.  (See TimeStep().)
+    std::string filename;      ///< Input nrrd file.
+    DUALISO_DATA dualiso_data;
+    int status;                ///< Zero if the volume was read.
+    std::string message;       ///< Error message if status is non-zero.
+    std::vector<ISODUAL_MESH> mesh;  ///< One mesh per isovalue.
+
+    // Incremental extraction blocks, summed over isovalues.
+    long num_reused_blocks;      ///< Blocks with unchanged signs.
+    long num_extracted_blocks;   ///< Blocks extracted again.
+
+  public:
+    SERIES_FRAME() 
+      { step = 0; time_step = 0; status = 0; num_reused_blocks = 0; 
+        num_extracted_blocks = 0; };
+  };
+
+  /// Time series parameters.
+  class SERIES_PARAM {
+
+  public:
+    std::vector<std::string> filename;  ///< Input file for each time step.
+    std::vector<int> time_step;  ///< Time step number of filename[k].
+    std::vector<SCALAR_TYPE> isovalue;
+    unsigned int flags;        ///< Bitwise or of ISODUAL_REQUEST_FLAG.
+    std::string off_prefix;    ///< If not empty, write meshes to .off files.
+    int queue_size;            ///< Maximum frames waiting between stages.
+    bool flag_verbose;         ///< Report each time step.
+
+  protected:
+    int max_time_step;         ///< Maximum time step number added by AddFile.
+
+  public:
+    SERIES_PARAM() 
+      { flags = 0; queue_size = 2; flag_verbose = false; max_time_step = 0; };
+
+    /// Add input file with time step number time_step.
+    void AddFile(const std::string & filename, const int time_step)
+      { this->filename.push_back(filename);
+        this->time_step.push_back(time_step); 
+        if (time_step > max_time_step) { max_time_step = time_step; } };
+
+    /// Add input file numbered by its position in the series.
+    void AddFile(const std::string & filename)
+      { AddFile(filename, this->filename.size()); };
+
+    /// Return time step number of filename[k].
+    /// - Pattern files are numbered by the pattern number.
+    /// - Returns k if no time step number was set for filename[k].
+    int TimeStep(const int k) const
+      { return((k < int(time_step.size())) ? time_step[k] : k); };
+
+    /// Return maximum time step number.
+    int MaxTimeStep() const;
+
+    /// Return output filename for time step number and isovalue index.
+    /// - Time step is padded with zeros to the width of MaxTimeStep().
+    std::string OutputFilename
+      (const int time_step, const int isovalue_index) const;
+  };
+
+  /// Time series statistics.
+  class SERIES_STATS {
+
+  public:
+    long num_frames;           ///< Number of time steps processed.
+    long num_errors;           ///< Number of time steps with errors.
+    long num_vertices;         ///< Total isosurface vertices.
+    long num_poly;             ///< Total isosurface polygons.
+    long num_reused_blocks;    ///< Total blocks reused by incremental mode.
+    long num_extracted_blocks; ///< Total blocks extracted by incremental mode.
+    IJK::WALL_CPU_TIME total_time;
+    IJK::WALL_CPU_TIME read_time;     ///< Time spent in read stage.
+    IJK::WALL_CPU_TIME contour_time;  ///< Time spent in contour stage.
+    IJK::WALL_CPU_TIME write_time;    ///< Time spent in write stage.
+
+  public:
+    SERIES_STATS() { Clear(); };
+
+    /// Return time steps per second of wall clock time.
+    double FramesPerSecond() const;
+
+    void Clear();
+    void Print(std::ostream & out) const;
+  };
+
+
+  // **************************************************
+  // RUN TIME SERIES
+  // **************************************************
+
+  /// Contour each time step in param.filename.
+  /// - Reads step t+1, contours step t and writes step t-1 concurrently.
+  /// - One DUALISO_CONTEXT per isovalue is reused across all time steps.
+  ///   With REQUEST_EXTRACT_INCREMENTAL, polytopes of grid blocks
+  ///   whose signs did not change since the previous time step are reused.
+  /// - At most 2*param.queue_size+3 volumes are in memory at once.
+  /// - Errors in a time step are reported and counted in stats.num_errors.
+  void run_isodual_series
+    (const SERIES_PARAM & param, SERIES_STATS & stats);
+
+  /// Replace the last run of '#' characters in pattern
+  ///   with the zero padded time step.
+  /// Return false if pattern has no '#' characters.
+  bool expand_series_pattern
+    (const std::string & pattern, const int step, std::string & filename);
+
+
+  // **************************************************
+  // BOUNDED QUEUE MEMBER FUNCTIONS
+  // **************************************************
+
+  template <typename ETYPE>
+  void BOUNDED_QUEUE<ETYPE>::Push(const ETYPE & x)
+  {
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    while (int(element.size()) >= max_size)
+      { not_full.wait(lock); }
+    element.push_back(x);
+    not_empty.notify_one();
+  }
+
+  template <typename ETYPE>
+  bool BOUNDED_QUEUE<ETYPE>::Pop(ETYPE & x)
+  {
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    while (element.empty() && !is_closed)
+      { not_empty.wait(lock); }
+
+    if (element.empty()) { return(false); }
+
+    x = element.front();
+    element.pop_front();
+    not_full.notify_one();
+    return(true);
+  }
+
+  template <typename ETYPE>
+  void BOUNDED_QUEUE<ETYPE>::Close()
+  {
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    is_closed = true;
+    not_empty.notify_all();
+  }
+
+}
+
+#endif
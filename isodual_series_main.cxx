@@ -0,0 +1,276 @@
+/// \file isodual_series_main.cxx
+/// Contour a time series of volumes.
+/// Overlaps reading, contouring and writing of consecutive time steps.
+
+/*
+  IJK: Isosurface Jeneration Kode
+  Copyright (C) 2017 Rephael Wenger
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License
+  (LGPL) as published by the Free Software Foundation; either
+  version 2.1 of the License, or any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "ijkcommand_line.txx"
+
+#include "isodual_series.h"
+
+using namespace IJK;
+using namespace ISODUAL;
+
+using namespace std;
+
+// global variables
+SERIES_PARAM series_param;
+
+// local subroutines
+void parse_command_line(int argc, char **argv);
+void read_list_file(const char * list_filename);
+void usage_error();
+void help();
+void memory_exhaustion();
+
+
+// **************************************************
+// MAIN
+// **************************************************
+
+int main(int argc, char **argv)
+{
+  try {
+
+    std::set_new_handler(memory_exhaustion);
+
+    parse_command_line(argc, argv);
+
+    SERIES_STATS stats;
+    run_isodual_series(series_param, stats);
+    stats.Print(cout);
+
+    if (stats.num_errors > 0) { exit(1); }
+  }
+  catch (ERROR & error) {
+    if (error.NumMessages() == 0) {
+      cerr << "Unknown error." << endl;
+    }
+    else { error.Print(cerr); }
+    cerr << "Exiting." << endl;
+    exit(20);
+  }
+  catch (...) {
+    cerr << "Unknown error." << endl;
+    exit(50);
+  };
+
+}
+
+void memory_exhaustion()
+{
+  cerr << "Error: Out of memory.  Terminating program." << endl;
+  exit(10);
+}
+
+void read_list_file(const char * list_filename)
+{
+  ifstream list_file(list_filename, ios::in);
+  if (!list_file.good()) {
+    cerr << "Unable to open list file " << list_filename << "." << endl;
+    exit(30);
+  }
+
+  std::string s;
+  while (getline(list_file, s)) {
+    // Skip blank lines and comments.
+    const std::string::size_type i = s.find_first_not_of(" \t\r");
+    if (i == std::string::npos || s[i] == '#') { continue; }
+
+    const std::string::size_type j = s.find_last_not_of(" \t\r");
+    series_param.AddFile(s.substr(i, j+1-i));
+  }
+}
+
+
+// **************************************************
+// PARSE COMMAND LINE
+// **************************************************
+
+void parse_command_line(int argc, char **argv)
+{
+  int iarg = 1;
+
+  while (iarg < argc && argv[iarg][0] == '-') {
+    std::string s = argv[iarg];
+
+    if (s == "-trimesh")
+      { series_param.flags |= REQUEST_TRIANGULATE; }
+    else if (s == "-single_isov")
+      { series_param.flags |= REQUEST_SINGLE_ISOV; }
+    else if (s == "-multi_isov")
+      { series_param.flags |= REQUEST_NO_SPLIT_NON_MANIFOLD; }
+    else if (s == "-sep_pos")
+      { series_param.flags |= REQUEST_SEPARATE_POS; }
+    else if (s == "-cube_center")
+      { series_param.flags |= REQUEST_POSITION_CUBE_CENTER; }
+    else if (s == "-extract_two_pass")
+      { series_param.flags |= REQUEST_EXTRACT_TWO_PASS; }
+    else if (s == "-extract_incremental")
+      { series_param.flags |= REQUEST_EXTRACT_INCREMENTAL; }
+    else if (s == "-isovalue") {
+      iarg++;
+      if (iarg >= argc) { usage_error(); }
+      float x;
+      if (!IJK::string2val(argv[iarg], x)) {
+        cerr << "Usage error.  Illegal isovalue: " << argv[iarg] << endl;
+        exit(230);
+      }
+      series_param.isovalue.push_back(x);
+    }
+    else if (s == "-list") {
+      iarg++;
+      if (iarg >= argc) { usage_error(); }
+      read_list_file(argv[iarg]);
+    }
+    else if (s == "-pattern") {
+      if (iarg+3 >= argc) { usage_error(); }
+      const std::string pattern = argv[iarg+1];
+      const int first = get_arg_int(iarg+1, argc, argv);
+      const int last = get_arg_int(iarg+2, argc, argv);
+      iarg += 3;
+
+      for (int t = first; t <= last; t++) {
+        std::string filename;
+        if (!expand_series_pattern(pattern, t, filename)) {
+          cerr << "Usage error.  Pattern " << pattern
+               << " has no '#' characters." << endl;
+          exit(230);
+        }
+        series_param.AddFile(filename, t);
+      }
+    }
+    else if (s == "-off") {
+      iarg++;
+      if (iarg >= argc) { usage_error(); }
+      series_param.off_prefix = argv[iarg];
+    }
+    else if (s == "-queue_size") {
+      series_param.queue_size = get_arg_int(iarg, argc, argv);
+      iarg++;
+
+      if (series_param.queue_size < 1) {
+        cerr << "Usage error.  Queue size must be at least 1." << endl;
+        exit(230);
+      }
+    }
+    else if (s == "-verbose")
+      { series_param.flag_verbose = true; }
+    else if (s == "-help")
+      { help(); }
+    else {
+      cerr << "Usage error.  Illegal parameter: " << s << endl;
+      usage_error();
+    }
+    iarg++;
+  }
+
+  if (iarg >= argc) { usage_error(); }
+
+  float x;
+  if (!IJK::string2val(argv[iarg], x)) {
+    cerr << "Usage error.  Illegal isovalue: " << argv[iarg] << endl;
+    exit(230);
+  }
+  series_param.isovalue.insert(series_param.isovalue.begin(), x);
+  iarg++;
+
+  for (; iarg < argc; iarg++)
+    { series_param.AddFile(argv[iarg]); }
+
+  if (series_param.filename.size() == 0) {
+    cerr << "Usage error.  No input files." << endl;
+    exit(230);
+  }
+}
+
+void usage_msg(std::ostream & out)
+{
+  out << "Usage: isodual_series [OPTIONS] {isovalue} {file1 file2 ...}"
+      << endl;
+  out << "OPTIONS:" << endl;
+  out << "  [-trimesh] [-single_isov | -multi_isov] [-sep_pos]"
+      << " [-cube_center]" << endl;
+  out << "  [-extract_two_pass] [-extract_incremental]"
+      << " [-isovalue {isovalue}]" << endl;
+  out << "  [-list {list file}] [-pattern {pattern} {first} {last}]" << endl;
+  out << "  [-off {prefix}] [-queue_size {N}] [-verbose] [-help]" << endl;
+}
+
+void usage_error()
+{
+  usage_msg(cerr);
+  exit(10);
+}
+
+void help()
+{
+  usage_msg(cout);
+  cout << endl;
+  cout << "isodual_series - Dual contour a time series of volumes."
+       << endl;
+  cout << "  Each time step is a nrrd file.  Reading time step t+1,"
+       << endl;
+  cout << "  contouring time step t and writing time step t-1 run"
+       << " concurrently." << endl;
+  cout << "  Reports aggregate time steps (frames) per second." << endl;
+  cout << endl;
+  cout << "  -trimesh: Output triangle meshes." << endl;
+  cout << "  -single_isov: Single isosurface vertex per grid cube." << endl;
+  cout << "  -multi_isov: Multiple isosurface vertices per grid cube."
+       << "  Do not split" << endl;
+  cout << "     non-manifold vertices." << endl;
+  cout << "  -sep_pos: Separate positive vertices." << endl;
+  cout << "  -cube_center: Position isosurface vertices at cube centers."
+       << endl;
+  cout << "  -extract_two_pass: Extract using two passes." << endl;
+  cout << "  -extract_incremental: Extract in blocks and reuse polytopes"
+       << " of blocks" << endl;
+  cout << "     whose signs did not change since the previous time step."
+       << endl;
+  cout << "  -isovalue {isovalue}: Add isovalue." << endl;
+  cout << "  -list {list file}: Add time steps listed in list file,"
+       << endl;
+  cout << "     one file name per line.  Lines starting with '#'"
+       << " are ignored." << endl;
+  cout << "  -pattern {pattern} {first} {last}: Add time steps first"
+       << " to last." << endl;
+  cout << "     The last run of '#' in pattern is replaced by the"
+       << " zero padded" << endl;
+  cout << "     time step.  Example: -pattern data.###.nrrd 0 99" << endl;
+  cout << "  -off {prefix}: Write time step t to {prefix}.{t}.off." << endl;
+  cout << "     Pattern files are numbered by the pattern number,"
+       << " other files" << endl;
+  cout << "     by their position in the series." << endl;
+  cout << "     With multiple isovalues, write {prefix}.{t}.{i}.off." << endl;
+  cout << "     Without -off, meshes are constructed but not written."
+       << endl;
+  cout << "  -queue_size {N}: At most N time steps wait between stages."
+       << "  (Default 2.)" << endl;
+  cout << "  -verbose: Report each time step." << endl;
+  cout << "  -help: Print this help message." << endl;
+  exit(0);
+}
@@ -0,0 +1,898 @@
+/// \file isodual_server.cxx
+/// Resident isosurface server and client.
+
+/*
+  IJK: Isosurface Jeneration Kode
+  Copyright (C) 2017 Rephael Wenger
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License
+  (LGPL) as published by the Free Software Foundation; either
+  version 2.1 of the License, or any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "ijkIO.txx"
+#include "ijkdual_position.txx"
+#include "ijkdual_triangulate.txx"
+
+#include "isodual.h"
+#include "isodualIO.h"
+#include "isodual_server.h"
+
+using namespace IJK;
+using namespace ISODUAL;
+
+typedef unsigned int UINT32;
+typedef int INT32;
+typedef unsigned long long UINT64;
+
+
+// **************************************************
+// CLASS ISODUAL_MESH
+// **************************************************
+
+void ISODUAL::ISODUAL_MESH::Clear()
+{
+  status = 0;
+  message.clear();
+  dimension = 0;
+  num_vert_per_poly = 0;
+  vertex_coord.clear();
+  poly_vert.clear();
+}
+
+
+// **************************************************
+// CLASS VOLUME_CACHE
+// **************************************************
+
+namespace {
+
+  // Set canonical_path to the canonical absolute path of path.
+  // - Resolves symbolic links, "." and "..".
+  // - Return false if path does not exist.
+  bool get_canonical_path
+  (const std::string & path, std::string & canonical_path)
+  {
+    char * s = realpath(path.c_str(), NULL);
+    if (s == NULL) { return(false); }
+    canonical_path = s;
+    free(s);
+    return(true);
+  }
+
+}
+
+ISODUAL::VOLUME_CACHE::VOLUME_CACHE
+(const int max_num_volumes, const std::string & data_directory)
+{
+  IJK::PROCEDURE_ERROR error("VOLUME_CACHE");
+  struct stat directory_stat;
+
+  if (max_num_volumes < 1) {
+    error.AddMessage("Illegal maximum number of volumes ",
+                     max_num_volumes, ".");
+    error.AddMessage("  Maximum number of volumes must be at least 1.");
+    throw error;
+  }
+
+  if (!get_canonical_path(data_directory, this->data_directory) ||
+      stat(this->data_directory.c_str(), &directory_stat) != 0 ||
+      !S_ISDIR(directory_stat.st_mode)) {
+    error.AddMessage("Data directory ", data_directory, 
+                     " does not exist or is not a directory.");
+    throw error;
+  }
+
+  this->max_num_volumes = max_num_volumes;
+  num_loads = 0;
+}
+
+std::string ISODUAL::VOLUME_CACHE::VolumePath
+(const std::string & volume_id) const
+{
+  IJK::PROCEDURE_ERROR error("VOLUME_CACHE::VolumePath");
+  std::string path;
+
+  // Canonical path resolves "..", "." and symbolic links,
+  //   so a prefix test confines volumes to data_directory.
+  std::string prefix = data_directory;
+  if (prefix.empty() || prefix[prefix.size()-1] != '/')
+    { prefix += '/'; }
+
+  if (volume_id.empty() || volume_id[0] == '/') {
+    error.AddMessage("Illegal volume id \"", volume_id, "\".");
+    error.AddMessage
+      ("  Volume id must be a path relative to the data directory.");
+    throw error;
+  }
+
+  if (!get_canonical_path(prefix + volume_id, path)) {
+    error.AddMessage("Unable to find volume ", volume_id, ".");
+    throw error;
+  }
+
+  if (path.compare(0, prefix.size(), prefix) != 0) {
+    error.AddMessage("Illegal volume id \"", volume_id, "\".");
+    error.AddMessage("  Volume is not in the data directory.");
+    throw error;
+  }
+
+  return(path);
+}
+
+void ISODUAL::VOLUME_CACHE::EvictLRU()
+{
+  if (volume_list.empty()) { return; }
+
+  RESIDENT_VOLUME * volume = volume_list.back();
+  volume_map.erase(volume->volume_id);
+  volume_list.pop_back();
+  delete volume;
+}
+
+RESIDENT_VOLUME & ISODUAL::VOLUME_CACHE::Get(const std::string & volume_id)
+{
+  std::map<std::string, VOLUME_LIST::iterator>::iterator map_iter =
+    volume_map.find(volume_id);
+
+  if (map_iter != volume_map.end()) {
+    // Move to front of LRU list.  Splice does not invalidate iterators.
+    volume_list.splice
+      (volume_list.begin(), volume_list, map_iter->second);
+    return(*volume_list.front());
+  }
+
+  RESIDENT_VOLUME * volume = new RESIDENT_VOLUME;
+  try {
+    DUALISO_SCALAR_GRID full_scalar_grid;
+    NRRD_HEADER nrrd_header;
+    IO_TIME io_time;
+
+    read_nrrd_file
+      (VolumePath(volume_id), full_scalar_grid, nrrd_header, io_time);
+
+    volume->volume_id = volume_id;
+    volume->dualiso_data.SetScalarGrid
+      (full_scalar_grid, false, 1, false, 1);
+  }
+  catch (...) {
+    delete volume;
+    throw;
+  }
+
+  // Evict only after the read succeeds, so a bad volume id
+  //   does not remove resident volumes.
+  while (int(volume_list.size()) >= max_num_volumes)
+    { EvictLRU(); }
+
+  volume_list.push_front(volume);
+  volume_map[volume_id] = volume_list.begin();
+  num_loads++;
+
+  return(*volume);
+}
+
+void ISODUAL::VOLUME_CACHE::Clear()
+{
+  while (!volume_list.empty())
+    { EvictLRU(); }
+}
+
+
+// **************************************************
+// PROCESS REQUESTS
+// **************************************************
+
+namespace {
+
+  // Set dualiso_data flags from request flags.
+  // Throw error if request is illegal for dualiso_data.
+  void set_request_flags
+  (const ISODUAL_REQUEST & request, DUALISO_DATA & dualiso_data)
+  {
+    const int dimension = dualiso_data.ScalarGrid().Dimension();
+    const bool flag_triangulate = request.Flag(REQUEST_TRIANGULATE);
+    DUALISO_DATA_FLAGS flags;
+    IJK::PROCEDURE_ERROR error("process_request");
+
+    if (flag_triangulate && dimension != 3) {
+      error.AddMessage("Illegal dimension ", dimension, ".");
+      error.AddMessage("  Triangulation requires dimension 3.");
+      throw error;
+    }
+
+    flags.allow_multiple_iso_vertices = !request.Flag(REQUEST_SINGLE_ISOV);
+    flags.flag_split_non_manifold =
+      !request.Flag(REQUEST_NO_SPLIT_NON_MANIFOLD);
+    flags.flag_separate_neg = !request.Flag(REQUEST_SEPARATE_POS);
+    if (request.Flag(REQUEST_POSITION_CUBE_CENTER))
+      { flags.vertex_position_method = IJKDUAL::CUBE_CENTER; }
+    flags.flag_extract_two_pass = request.Flag(REQUEST_EXTRACT_TWO_PASS);
+    flags.flag_extract_incremental = 
+      request.Flag(REQUEST_EXTRACT_INCREMENTAL);
+    flags.use_triangle_mesh = flag_triangulate;
+    dualiso_data.Set(flags);
+  }
+
+  // Set mesh from dual_isosurface constructed on dualiso_data.
+  // Rescales coordinates by the spacing of dualiso_data.ScalarGrid().
+  void set_mesh
+  (const DUALISO_DATA & dualiso_data, DUAL_ISOSURFACE & dual_isosurface,
+   ISODUAL_MESH & mesh)
+  {
+    const int dimension = dualiso_data.ScalarGrid().Dimension();
+
+    convert_cube_relative_coord(dualiso_data.ScalarGrid(), dual_isosurface);
+    rescale_vertex_coord
+      (dimension, dualiso_data.ScalarGrid().SpacingPtrConst(),
+       dual_isosurface.vertex_coord);
+
+    mesh.Clear();
+    mesh.dimension = dimension;
+    if (dualiso_data.UseTriangleMesh()) {
+      convert_quad_to_tri_in_place
+        (dualiso_data, dual_isosurface, (IJK::WALL_CPU_TIME *) NULL);
+      mesh.num_vert_per_poly = 3;
+      mesh.poly_vert.swap(dual_isosurface.tri_vert);
+    }
+    else {
+      mesh.num_vert_per_poly = dual_isosurface.NumVerticesPerIsoPoly();
+      mesh.poly_vert.swap(dual_isosurface.isopoly_vert);
+    }
+    mesh.vertex_coord.swap(dual_isosurface.vertex_coord);
+  }
+
+}
+
+
+// Construct mesh for a single request on a resident volume.
+void ISODUAL::process_request
+(const ISODUAL_REQUEST & request, RESIDENT_VOLUME & volume,
+ ISODUAL_MESH & mesh)
+{
+  process_request(request, volume, ISODUAL_PREVIEW_FUNCTION(), mesh);
+}
+
+void ISODUAL::process_request
+(const ISODUAL_REQUEST & request, RESIDENT_VOLUME & volume,
+ const ISODUAL_PREVIEW_FUNCTION & preview, ISODUAL_MESH & mesh)
+{
+  if (!request.Flag(REQUEST_PROGRESSIVE)) {
+    process_request(request, volume.dualiso_data, volume.context, mesh);
+    return;
+  }
+
+  DUALISO_DATA & dualiso_data = volume.dualiso_data;
+  const int dimension = dualiso_data.ScalarGrid().Dimension();
+  const int num_facet_vertices = dualiso_data.ScalarGrid().NumFacetVertices();
+  DUALISO_INFO dualiso_info(dimension);
+
+  mesh.Clear();
+  set_request_flags(request, dualiso_data);
+
+  if (!volume.progressive.Matches(dualiso_data.ScalarGrid())) {
+    volume.progressive.Set
+      (dualiso_data.ScalarGrid(), PROGRESSIVE_MAX_RESOLUTION);
+  }
+
+  auto send_level = 
+    [&](const int subsample_resolution, const DUALISO_DATA & level_data,
+        DUAL_ISOSURFACE & level_isosurface)
+    {
+      if (!preview) { return; }
+
+      ISODUAL_MESH preview_mesh;
+      set_mesh(level_data, level_isosurface, preview_mesh);
+      preview(subsample_resolution, preview_mesh);
+    };
+
+  DUAL_ISOSURFACE dual_isosurface(dimension, num_facet_vertices);
+  dual_contouring_progressive
+    (dualiso_data, request.isovalue, volume.progressive, send_level,
+     dual_isosurface, dualiso_info, volume.context);
+
+  set_mesh(dualiso_data, dual_isosurface, mesh);
+}
+
+void ISODUAL::process_request
+(const ISODUAL_REQUEST & request, DUALISO_DATA & dualiso_data,
+ DUALISO_CONTEXT & context, ISODUAL_MESH & mesh)
+{
+  const int dimension = dualiso_data.ScalarGrid().Dimension();
+  const int num_facet_vertices = dualiso_data.ScalarGrid().NumFacetVertices();
+  DUALISO_INFO dualiso_info(dimension);
+  IJK::PROCEDURE_ERROR error("process_request");
+
+  mesh.Clear();
+
+  if (request.Flag(REQUEST_PROGRESSIVE)) {
+    error.AddMessage("Progressive requests require a resident volume.");
+    throw error;
+  }
+
+  set_request_flags(request, dualiso_data);
+
+  DUAL_ISOSURFACE dual_isosurface(dimension, num_facet_vertices);
+  dual_contouring
+    (dualiso_data, request.isovalue, dual_isosurface, dualiso_info,
+     context);
+
+  set_mesh(dualiso_data, dual_isosurface, mesh);
+}
+
+
+namespace {
+
+  void set_mesh_error(const IJK::ERROR & error, ISODUAL_MESH & mesh)
+  {
+    std::ostringstream message;
+
+    mesh.Clear();
+    mesh.status = 1;
+    error.Print(message);
+    mesh.message = message.str();
+  }
+
+  void set_mesh_error(const char * message, ISODUAL_MESH & mesh)
+  {
+    mesh.Clear();
+    mesh.status = 1;
+    mesh.message = message;
+    mesh.message += "\n";
+  }
+
+}
+
+
+// Construct meshes for a batch of requests.
+void ISODUAL::process_request_batch
+(const std::vector<ISODUAL_REQUEST> & request, VOLUME_CACHE & cache,
+ std::vector<ISODUAL_MESH> & mesh)
+{
+  process_request_batch
+    (request, cache, ISODUAL_BATCH_PREVIEW_FUNCTION(), mesh);
+}
+
+void ISODUAL::process_request_batch
+(const std::vector<ISODUAL_REQUEST> & request, VOLUME_CACHE & cache,
+ const ISODUAL_BATCH_PREVIEW_FUNCTION & preview,
+ std::vector<ISODUAL_MESH> & mesh)
+{
+  // Volume ids in order of first appearance.
+  std::vector<std::string> volume_id;
+  std::map<std::string, std::vector<int> > request_index;
+
+  mesh.resize(request.size());
+
+  for (int i = 0; i < int(request.size()); i++) {
+    const std::string & id = request[i].volume_id;
+    if (request_index.find(id) == request_index.end())
+      { volume_id.push_back(id); }
+    request_index[id].push_back(i);
+  }
+
+  for (int j = 0; j < int(volume_id.size()); j++) {
+    const std::vector<int> & index = request_index[volume_id[j]];
+
+    RESIDENT_VOLUME * volume = NULL;
+    try {
+      volume = &(cache.Get(volume_id[j]));
+    }
+    catch (IJK::ERROR & error) {
+      for (int k = 0; k < int(index.size()); k++)
+        { set_mesh_error(error, mesh[index[k]]); }
+      continue;
+    }
+    catch (std::exception & e) {
+      for (int k = 0; k < int(index.size()); k++)
+        { set_mesh_error(e.what(), mesh[index[k]]); }
+      continue;
+    }
+    catch (...) {
+      for (int k = 0; k < int(index.size()); k++)
+        { set_mesh_error("Unknown error.", mesh[index[k]]); }
+      continue;
+    }
+
+    for (int k = 0; k < int(index.size()); k++) {
+      const int i = index[k];
+      auto preview_request = 
+        [&](const int subsample_resolution, const ISODUAL_MESH & mesh_s)
+        {
+          if (preview) { preview(i, subsample_resolution, mesh_s); }
+        };
+
+      try {
+        process_request(request[i], *volume, preview_request, mesh[i]);
+      }
+      catch (IJK::ERROR & error) {
+        set_mesh_error(error, mesh[i]);
+      }
+      catch (std::exception & e) {
+        set_mesh_error(e.what(), mesh[i]);
+      }
+      catch (...) {
+        set_mesh_error("Unknown error.", mesh[i]);
+      }
+    }
+  }
+}
+
+
+// **************************************************
+// SOCKET INPUT/OUTPUT
+// **************************************************
+
+namespace {
+
+  volatile sig_atomic_t flag_stop_server = 0;
+
+  void stop_server_handler(int)
+  {
+    flag_stop_server = 1;
+  }
+
+  // Write num_bytes bytes.  Return false if write fails.
+  bool write_all(const int fd, const void * buffer, const size_t num_bytes)
+  {
+    const char * p = (const char *) buffer;
+    size_t num_left = num_bytes;
+
+    while (num_left > 0) {
+      ssize_t n = write(fd, p, num_left);
+      if (n < 0) {
+        if (errno == EINTR && !flag_stop_server) { continue; }
+        return(false);
+      }
+      p += n;
+      num_left -= n;
+    }
+
+    return(true);
+  }
+
+  // Read num_bytes bytes.  Return false on end of file or read failure.
+  bool read_all(const int fd, void * buffer, const size_t num_bytes)
+  {
+    char * p = (char *) buffer;
+    size_t num_left = num_bytes;
+
+    while (num_left > 0) {
+      ssize_t n = read(fd, p, num_left);
+      if (n < 0) {
+        if (errno == EINTR && !flag_stop_server) { continue; }
+        return(false);
+      }
+      if (n == 0) { return(false); }
+      p += n;
+      num_left -= n;
+    }
+
+    return(true);
+  }
+
+  template <typename T>
+  bool write_value(const int fd, const T x)
+  { return(write_all(fd, &x, sizeof(T))); }
+
+  template <typename T>
+  bool read_value(const int fd, T & x)
+  { return(read_all(fd, &x, sizeof(T))); }
+
+  bool write_string(const int fd, const std::string & s)
+  {
+    if (!write_value(fd, UINT32(s.size()))) { return(false); }
+    return(write_all(fd, s.data(), s.size()));
+  }
+
+  bool read_string
+  (const int fd, const UINT32 max_length, std::string & s)
+  {
+    UINT32 length;
+
+    if (!read_value(fd, length)) { return(false); }
+    if (length > max_length) { return(false); }
+    s.resize(length);
+    if (length == 0) { return(true); }
+    return(read_all(fd, &(s[0]), length));
+  }
+
+  bool write_mesh(const int fd, const ISODUAL_MESH & mesh)
+  {
+    if (!write_value(fd, INT32(mesh.status))) { return(false); }
+
+    if (mesh.status != 0)
+      { return(write_string(fd, mesh.message)); }
+
+    if (!write_value(fd, UINT32(mesh.dimension))) { return(false); }
+    if (!write_value(fd, UINT32(mesh.num_vert_per_poly))) { return(false); }
+    if (!write_value(fd, UINT32(sizeof(ISO_VERTEX_INDEX)))) { return(false); }
+    if (!write_value(fd, UINT64(mesh.NumVertices()))) { return(false); }
+    if (!write_value(fd, UINT64(mesh.NumPoly()))) { return(false); }
+    if (!write_all(fd, IJK::vector2pointer(mesh.vertex_coord),
+                   mesh.vertex_coord.size()*sizeof(COORD_TYPE)))
+      { return(false); }
+    return(write_all(fd, IJK::vector2pointer(mesh.poly_vert),
+                     mesh.poly_vert.size()*sizeof(ISO_VERTEX_INDEX)));
+  }
+
+  // Read array of vertex indices stored as type ITYPE.
+  template <typename ITYPE>
+  bool read_index_array
+  (const int fd, const UINT64 num_indices, std::vector<ISO_VERTEX_INDEX> & list)
+  {
+    std::vector<ITYPE> list2(num_indices);
+
+    if (num_indices > 0) {
+      if (!read_all(fd, &(list2.front()), num_indices*sizeof(ITYPE)))
+        { return(false); }
+    }
+
+    list.resize(num_indices);
+    for (UINT64 i = 0; i < num_indices; i++)
+      { list[i] = ISO_VERTEX_INDEX(list2[i]); }
+
+    return(true);
+  }
+
+  bool read_mesh(const int fd, ISODUAL_MESH & mesh)
+  {
+    INT32 status;
+    UINT32 dimension, num_vert_per_poly, index_size;
+    UINT64 numv, num_poly;
+
+    mesh.Clear();
+    if (!read_value(fd, status)) { return(false); }
+    mesh.status = status;
+
+    if (status != 0)
+      { return(read_string(fd, UINT32(-1), mesh.message)); }
+
+    if (!read_value(fd, dimension)) { return(false); }
+    if (!read_value(fd, num_vert_per_poly)) { return(false); }
+    if (!read_value(fd, index_size)) { return(false); }
+    if (!read_value(fd, numv)) { return(false); }
+    if (!read_value(fd, num_poly)) { return(false); }
+
+    mesh.dimension = dimension;
+    mesh.num_vert_per_poly = num_vert_per_poly;
+    mesh.vertex_coord.resize(numv*dimension);
+    if (mesh.vertex_coord.size() > 0) {
+      if (!read_all(fd, &(mesh.vertex_coord.front()),
+                    mesh.vertex_coord.size()*sizeof(COORD_TYPE)))
+        { return(false); }
+    }
+
+    const UINT64 num_indices = num_poly*num_vert_per_poly;
+    if (index_size == 4)
+      { return(read_index_array<INT32>(fd, num_indices, mesh.poly_vert)); }
+    else if (index_size == 8)
+      { return(read_index_array<long long>
+               (fd, num_indices, mesh.poly_vert)); }
+    else
+      { return(false); }
+  }
+
+  // Read request batch.  Return false on end of file or protocol error.
+  bool read_request_batch
+  (const int fd, std::vector<ISODUAL_REQUEST> & request)
+  {
+    UINT32 magic, num_requests;
+
+    request.clear();
+    if (!read_value(fd, magic)) { return(false); }
+    if (magic != ISODUAL_REQUEST_MAGIC) { return(false); }
+    if (!read_value(fd, num_requests)) { return(false); }
+    if (num_requests > ISODUAL_MAX_BATCH_SIZE) { return(false); }
+
+    request.resize(num_requests);
+    for (UINT32 i = 0; i < num_requests; i++) {
+      UINT32 flags;
+      float isovalue;
+      if (!read_value(fd, flags)) { return(false); }
+      if (!read_value(fd, isovalue)) { return(false); }
+      if (!read_string(fd, ISODUAL_MAX_VOLUME_ID_LENGTH,
+                       request[i].volume_id))
+        { return(false); }
+      request[i].flags = flags;
+      request[i].isovalue = isovalue;
+    }
+
+    return(true);
+  }
+
+  bool write_preview
+  (const int fd, const int request_index, const int subsample_resolution,
+   const ISODUAL_MESH & mesh)
+  {
+    if (!write_value(fd, UINT32(ISODUAL_PREVIEW_MAGIC))) { return(false); }
+    if (!write_value(fd, UINT32(request_index))) { return(false); }
+    if (!write_value(fd, UINT32(subsample_resolution))) { return(false); }
+    return(write_mesh(fd, mesh));
+  }
+
+  bool write_reply(const int fd, const std::vector<ISODUAL_MESH> & mesh)
+  {
+    if (!write_value(fd, UINT32(ISODUAL_REPLY_MAGIC))) { return(false); }
+    if (!write_value(fd, UINT32(mesh.size()))) { return(false); }
+
+    for (int i = 0; i < int(mesh.size()); i++) {
+      if (!write_mesh(fd, mesh[i])) { return(false); }
+    }
+
+    return(true);
+  }
+
+  // Set socket address.  Throw error if socket_path is too long.
+  void set_socket_address
+  (const std::string & socket_path, struct sockaddr_un & address)
+  {
+    IJK::PROCEDURE_ERROR error("set_socket_address");
+
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+      error.AddMessage("Socket path ", socket_path, " is too long.");
+      error.AddMessage("  Socket path must have fewer than ",
+                       sizeof(address.sun_path), " characters.");
+      throw error;
+    }
+    std::strcpy(address.sun_path, socket_path.c_str());
+  }
+
+  void add_errno_message(const char * s, IJK::ERROR & error)
+  {
+    error.AddMessage(s, std::strerror(errno), ".");
+  }
+
+  // Serve requests on connection fd until client closes the connection.
+  void serve_connection
+  (const int fd, VOLUME_CACHE & cache, const bool flag_verbose)
+  {
+    std::vector<ISODUAL_REQUEST> request;
+    std::vector<ISODUAL_MESH> mesh;
+
+    while (!flag_stop_server && read_request_batch(fd, request)) {
+
+      // Send previews of progressive requests as soon as they are built.
+      bool flag_write_ok = true;
+      auto send_preview = 
+        [&](const int i, const int subsample_resolution,
+            const ISODUAL_MESH & preview_mesh)
+        {
+          if (flag_write_ok) {
+            flag_write_ok = 
+              write_preview(fd, i, subsample_resolution, preview_mesh);
+          }
+        };
+
+      process_request_batch(request, cache, send_preview, mesh);
+      if (!flag_write_ok) { return; }
+      if (!write_reply(fd, mesh)) { return; }
+
+      if (flag_verbose) {
+        std::cout << "Batch of " << request.size() << " requests.  "
+                  << cache.NumVolumes() << " resident volumes.  "
+                  << cache.NumLoads() << " volume reads." << std::endl;
+      }
+    }
+  }
+
+}
+
+
+// **************************************************
+// SERVER AND CLIENT
+// **************************************************
+
+// Run server on Unix domain socket socket_path.
+void ISODUAL::run_isodual_server
+(const std::string & socket_path, VOLUME_CACHE & cache,
+ const bool flag_verbose)
+{
+  IJK::PROCEDURE_ERROR error("run_isodual_server");
+  struct sockaddr_un address;
+  struct stat socket_stat;
+
+  set_socket_address(socket_path, address);
+
+  // Remove socket left by a previous server.  Never remove other files.
+  if (lstat(socket_path.c_str(), &socket_stat) == 0) {
+    if (!S_ISSOCK(socket_stat.st_mode)) {
+      error.AddMessage("File ", socket_path, " exists and is not a socket.");
+      throw error;
+    }
+    unlink(socket_path.c_str());
+  }
+
+  const int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd < 0) {
+    add_errno_message("Unable to create socket. ", error);
+    throw error;
+  }
+
+  if (bind(listen_fd, (struct sockaddr *) &address, sizeof(address)) < 0 ||
+      listen(listen_fd, 8) < 0) {
+    add_errno_message("Unable to listen on socket. ", error);
+    error.AddMessage("  Socket path: ", socket_path);
+    close(listen_fd);
+    throw error;
+  }
+
+  // Stop on SIGINT or SIGTERM.  No SA_RESTART, so accept and read
+  //   return EINTR and the server can remove its socket.
+  struct sigaction action;
+  std::memset(&action, 0, sizeof(action));
+  action.sa_handler = stop_server_handler;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+
+  // Client may close the connection before the reply is written.
+  signal(SIGPIPE, SIG_IGN);
+
+  flag_stop_server = 0;
+  while (!flag_stop_server) {
+    const int fd = accept(listen_fd, NULL, NULL);
+    if (fd < 0) {
+      if (errno == EINTR) { continue; }
+      add_errno_message("Accept failed. ", error);
+      close(listen_fd);
+      unlink(socket_path.c_str());
+      throw error;
+    }
+
+    serve_connection(fd, cache, flag_verbose);
+    close(fd);
+  }
+
+  close(listen_fd);
+  unlink(socket_path.c_str());
+}
+
+
+// Connect to server at socket_path.
+int ISODUAL::connect_isodual_server(const std::string & socket_path)
+{
+  IJK::PROCEDURE_ERROR error("connect_isodual_server");
+  struct sockaddr_un address;
+
+  set_socket_address(socket_path, address);
+
+  const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    add_errno_message("Unable to create socket. ", error);
+    throw error;
+  }
+
+  if (connect(fd, (struct sockaddr *) &address, sizeof(address)) < 0) {
+    add_errno_message("Unable to connect to server. ", error);
+    error.AddMessage("  Socket path: ", socket_path);
+    close(fd);
+    throw error;
+  }
+
+  return(fd);
+}
+
+
+// Send request batch and receive meshes.
+void ISODUAL::send_request_batch
+(const int fd, const std::vector<ISODUAL_REQUEST> & request,
+ std::vector<ISODUAL_MESH> & mesh)
+{
+  send_request_batch(fd, request, ISODUAL_BATCH_PREVIEW_FUNCTION(), mesh);
+}
+
+void ISODUAL::send_request_batch
+(const int fd, const std::vector<ISODUAL_REQUEST> & request,
+ const ISODUAL_BATCH_PREVIEW_FUNCTION & preview,
+ std::vector<ISODUAL_MESH> & mesh)
+{
+  IJK::PROCEDURE_ERROR error("send_request_batch");
+  UINT32 magic(0), num_meshes;
+
+  mesh.clear();
+
+  if (request.size() > ISODUAL_MAX_BATCH_SIZE) {
+    error.AddMessage("Too many requests in batch.");
+    error.AddMessage("  Maximum batch size is ", ISODUAL_MAX_BATCH_SIZE, ".");
+    throw error;
+  }
+
+  bool flag_ok = write_value(fd, UINT32(ISODUAL_REQUEST_MAGIC)) &&
+    write_value(fd, UINT32(request.size()));
+  for (int i = 0; flag_ok && i < int(request.size()); i++) {
+    flag_ok = write_value(fd, UINT32(request[i].flags)) &&
+      write_value(fd, float(request[i].isovalue)) &&
+      write_string(fd, request[i].volume_id);
+  }
+
+  if (!flag_ok) {
+    add_errno_message("Unable to send requests to server. ", error);
+    throw error;
+  }
+
+  // Previews of progressive requests precede the reply.
+  ISODUAL_MESH preview_mesh;
+  while (read_value(fd, magic) && magic == ISODUAL_PREVIEW_MAGIC) {
+    UINT32 request_index, subsample_resolution;
+    if (!read_value(fd, request_index) || request_index >= request.size() ||
+        !read_value(fd, subsample_resolution) || 
+        !read_mesh(fd, preview_mesh)) {
+      error.AddMessage("Illegal preview from server.");
+      throw error;
+    }
+
+    if (preview)
+      { preview(request_index, subsample_resolution, preview_mesh); }
+  }
+
+  if (magic != ISODUAL_REPLY_MAGIC ||
+      !read_value(fd, num_meshes) || num_meshes != request.size()) {
+    error.AddMessage("Illegal reply from server.");
+    throw error;
+  }
+
+  mesh.resize(num_meshes);
+  for (UINT32 i = 0; i < num_meshes; i++) {
+    if (!read_mesh(fd, mesh[i])) {
+      error.AddMessage("Unable to read mesh ", i, " from server.");
+      throw error;
+    }
+  }
+}
+
+
+// Close connection to server.
+void ISODUAL::close_isodual_server(const int fd)
+{
+  close(fd);
+}
+
+
+// **************************************************
+// WRITE MESH
+// **************************************************
+
+void ISODUAL::write_isodual_mesh_off
+(const std::string & filename, const ISODUAL_MESH & mesh)
+{
+  std::ofstream output_file;
+  IJK::PROCEDURE_ERROR error("write_isodual_mesh_off");
+
+  output_file.open(filename.c_str(), std::ios::out);
+  if (!output_file.good()) {
+    error.AddMessage("Unable to open output file ", filename, ".");
+    throw error;
+  }
+
+  ijkoutOFF(output_file, mesh.dimension, mesh.num_vert_per_poly,
+            mesh.vertex_coord, mesh.poly_vert);
+  output_file.close();
+}
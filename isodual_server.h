@@ -0,0 +1,318 @@
+/// \file isodual_server.h
+/// Resident isosurface server and client.
+/// Requests and meshes are sent over a Unix domain socket.
+
+/*
+  IJK: Isosurface Jeneration Kode
+  Copyright (C) 2017 Rephael Wenger
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License
+  (LGPL) as published by the Free Software Foundation; either
+  version 2.1 of the License, or any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef _ISODUAL_SERVER_
+#define _ISODUAL_SERVER_
+
+#include <functional>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ijk.txx"
+
+#include "isodual_types.h"
+#include "isodual_datastruct.h"
+#include "isodual_progressive.h"
+
+
+/// isodual server classes and routines.
+///
+/// Protocol.  All integers and floats are in the native byte order
+///   of the host, since client and server share a Unix domain socket.
+/// - Request batch:
+///   - uint32 ISODUAL_REQUEST_MAGIC
+///   - uint32 number of requests
+///   - For each request: uint32 flags, float isovalue,
+///     uint32 length of volume id, volume id characters.
+/// - Reply:
+///   - uint32 ISODUAL_REPLY_MAGIC
+///   - uint32 number of meshes (equals number of requests)
+///   - For each mesh, in request order:
+///     - int32 status.  Zero if the mesh was constructed.
+///     - If status is non-zero: uint32 message length, message characters.
+///     - If status is zero: uint32 dimension, uint32 vertices per polygon,
+///       uint32 bytes per vertex index, uint64 number of vertices,
+///       uint64 number of polygons, float vertex coordinates,
+///       polygon vertex indices.
+/// - Preview.  Sent for each subsampled level of a progressive request
+///   as soon as the level is constructed, before the reply:
+///   - uint32 ISODUAL_PREVIEW_MAGIC
+///   - uint32 request index, uint32 subsample resolution
+///   - Mesh, in the same format as a reply mesh.
+/// A client may send any number of request batches on one connection.
+namespace ISODUAL {
+
+  // **************************************************
+  // PROTOCOL CONSTANTS
+  // **************************************************
+
+  const unsigned int ISODUAL_REQUEST_MAGIC = 0x51524449;  ///< "IDRQ"
+  const unsigned int ISODUAL_REPLY_MAGIC = 0x53524449;    ///< "IDRS"
+  const unsigned int ISODUAL_PREVIEW_MAGIC = 0x56504449;  ///< "IDPV"
+
+  /// Maximum number of requests in a single batch.
+  const unsigned int ISODUAL_MAX_BATCH_SIZE = 4096;
+
+  /// Maximum length of a volume id.
+  const unsigned int ISODUAL_MAX_VOLUME_ID_LENGTH = 4096;
+
+  /// Request flags.
+  typedef enum {
+    REQUEST_TRIANGULATE = 1,         ///< Split quadrilaterals into triangles.
+    REQUEST_SINGLE_ISOV = 2,         ///< Single isosurface vertex per cube.
+    REQUEST_NO_SPLIT_NON_MANIFOLD = 4, ///< Do not split non-manifold vertices.
+    REQUEST_SEPARATE_POS = 8,        ///< Separate positive vertices.
+    REQUEST_POSITION_CUBE_CENTER = 16, ///< Position vertices at cube centers.
+    REQUEST_EXTRACT_TWO_PASS = 32,   ///< Use two pass extraction.
+    REQUEST_EXTRACT_INCREMENTAL = 64, ///< Reuse unchanged block polytopes.
+    REQUEST_PROGRESSIVE = 128        ///< Send coarse-to-fine previews.
+  } ISODUAL_REQUEST_FLAG;
+
+
+  // **************************************************
+  // REQUESTS AND MESHES
+  // **************************************************
+
+  /// Isosurface request.
+  class ISODUAL_REQUEST {
+
+  public:
+    std::string volume_id;     ///< Volume id.  Path of nrrd file
+                               ///<   relative to server data directory.
+    SCALAR_TYPE isovalue;
+    unsigned int flags;        ///< Bitwise or of ISODUAL_REQUEST_FLAG.
+
+  public:
+    ISODUAL_REQUEST() { isovalue = 0; flags = 0; };
+    ISODUAL_REQUEST
+      (const std::string & volume_id, const SCALAR_TYPE isovalue,
+       const unsigned int flags):
+      volume_id(volume_id)
+      { this->isovalue = isovalue; this->flags = flags; };
+
+    bool Flag(const ISODUAL_REQUEST_FLAG f) const
+      { return((flags & f) != 0); };
+  };
+
+  /// Isosurface mesh returned for a request.
+  class ISODUAL_MESH {
+
+  public:
+    int status;                ///< Zero if mesh was constructed.
+    std::string message;       ///< Error message if status is non-zero.
+    int dimension;
+    int num_vert_per_poly;
+    COORD_ARRAY vertex_coord;
+    std::vector<ISO_VERTEX_INDEX> poly_vert;
+
+  public:
+    ISODUAL_MESH() { Clear(); };
+
+    VERTEX_INDEX NumVertices() const
+    { return((dimension > 0) ? vertex_coord.size()/dimension : 0); };
+    VERTEX_INDEX NumPoly() const
+    { return((num_vert_per_poly > 0) ?
+             poly_vert.size()/num_vert_per_poly : 0); };
+
+    void Clear();
+  };
+
+
+  // **************************************************
+  // RESIDENT VOLUME CACHE
+  // **************************************************
+
+  /// Volume kept resident by the server.
+  /// Context keeps merge data, lookup tables and scratch buffers
+  ///   between requests on the volume.
+  class RESIDENT_VOLUME {
+
+  public:
+    std::string volume_id;
+    DUALISO_DATA dualiso_data;
+    DUALISO_CONTEXT context;
+
+    /// Subsampled grids for progressive requests.
+    /// Set by the first progressive request on the volume.
+    PROGRESSIVE_DATA progressive;
+  };
+
+  /// Least recently used cache of resident volumes.
+  class VOLUME_CACHE {
+
+  protected:
+    typedef std::list<RESIDENT_VOLUME *> VOLUME_LIST;
+
+    /// Resident volumes, most recently used first.
+    VOLUME_LIST volume_list;
+    std::map<std::string, VOLUME_LIST::iterator> volume_map;
+    int max_num_volumes;
+    long num_loads;
+
+    /// Canonical path of directory containing the volumes.
+    std::string data_directory;
+
+    void EvictLRU();
+
+    /// Return path of nrrd file for volume_id.
+    /// - Throw error if the file is not in data_directory 
+    ///   or one of its subdirectories.
+    std::string VolumePath(const std::string & volume_id) const;
+
+  private:
+    // Cache owns its volumes.  Copying is not allowed.
+    VOLUME_CACHE(const VOLUME_CACHE &);
+    const VOLUME_CACHE & operator = (const VOLUME_CACHE &);
+
+  public:
+    /// Constructor.
+    /// @param data_directory Directory containing the volumes.
+    ///   Volume ids are paths relative to data_directory.
+    VOLUME_CACHE
+      (const int max_num_volumes, const std::string & data_directory);
+    ~VOLUME_CACHE() { Clear(); };
+
+    // Get functions.
+    int MaxNumVolumes() const { return(max_num_volumes); };
+    int NumVolumes() const { return(volume_list.size()); };
+    long NumLoads() const { return(num_loads); };
+    const std::string & DataDirectory() const
+      { return(data_directory); };
+    bool IsResident(const std::string & volume_id) const
+      { return(volume_map.find(volume_id) != volume_map.end()); };
+
+    /// Return volume with given id, reading it if it is not resident.
+    /// Evicts the least recently used volume if the cache is full.
+    RESIDENT_VOLUME & Get(const std::string & volume_id);
+
+    void Clear();                ///< Free all resident volumes.
+  };
+
+
+  // **************************************************
+  // PROCESS REQUESTS
+  // **************************************************
+
+  /// Function called on the preview mesh of each subsampled level
+  ///   of a progressive request, coarsest first.
+  typedef std::function<void
+    (const int subsample_resolution, const ISODUAL_MESH & mesh)>
+  ISODUAL_PREVIEW_FUNCTION;
+
+  /// Function called on the preview meshes of the progressive
+  ///   requests in a batch.
+  typedef std::function<void
+    (const int request_index, const int subsample_resolution,
+     const ISODUAL_MESH & mesh)>
+  ISODUAL_BATCH_PREVIEW_FUNCTION;
+
+  /// Construct mesh for a single request on a resident volume.
+  void process_request
+    (const ISODUAL_REQUEST & request, RESIDENT_VOLUME & volume,
+     ISODUAL_MESH & mesh);
+
+  /// Construct mesh for a single request on a resident volume.
+  /// - If request.Flag(REQUEST_PROGRESSIVE), contours the volume
+  ///   subsampled at resolutions PROGRESSIVE_MAX_RESOLUTION, ..., 2
+  ///   and calls preview on each mesh before constructing mesh.
+  ///   Each level contours only cubes in active cubes of the
+  ///   previous level.  (See dual_contouring_progressive.)
+  /// - Progressive requests ignore REQUEST_EXTRACT_TWO_PASS and
+  ///   REQUEST_EXTRACT_INCREMENTAL.
+  void process_request
+    (const ISODUAL_REQUEST & request, RESIDENT_VOLUME & volume,
+     const ISODUAL_PREVIEW_FUNCTION & preview, ISODUAL_MESH & mesh);
+
+  /// Construct mesh for a single request on dualiso_data.
+  /// - Only request.isovalue and request.flags are used.
+  /// - Context keeps tables and scratch buffers between calls.
+  /// - Progressive requests are not supported.
+  void process_request
+    (const ISODUAL_REQUEST & request, DUALISO_DATA & dualiso_data,
+     DUALISO_CONTEXT & context, ISODUAL_MESH & mesh);
+
+  /// Construct meshes for a batch of requests.
+  /// - Requests are grouped by volume so each volume is looked up once
+  ///   per batch and its context is reused across the group.
+  /// - mesh[i] is the mesh for request[i].
+  /// - Errors are reported in mesh[i].status and mesh[i].message.
+  void process_request_batch
+    (const std::vector<ISODUAL_REQUEST> & request, VOLUME_CACHE & cache,
+     std::vector<ISODUAL_MESH> & mesh);
+
+  /// Construct meshes for a batch of requests.
+  /// - Version calling preview(i, s, preview_mesh) on the preview meshes
+  ///   of progressive request i.
+  void process_request_batch
+    (const std::vector<ISODUAL_REQUEST> & request, VOLUME_CACHE & cache,
+     const ISODUAL_BATCH_PREVIEW_FUNCTION & preview,
+     std::vector<ISODUAL_MESH> & mesh);
+
+
+  // **************************************************
+  // SERVER AND CLIENT
+  // **************************************************
+
+  /// Run server on Unix domain socket socket_path.
+  /// - Single client.  Serves one connection at a time.
+  ///   Other clients wait in the listen queue until the current
+  ///   client closes its connection.
+  /// - Returns when SIGINT or SIGTERM is received.
+  void run_isodual_server
+    (const std::string & socket_path, VOLUME_CACHE & cache,
+     const bool flag_verbose);
+
+  /// Connect to server at socket_path.  Returns socket file descriptor.
+  int connect_isodual_server(const std::string & socket_path);
+
+  /// Send request batch and receive meshes.
+  /// - Preview meshes of progressive requests are discarded.
+  void send_request_batch
+    (const int fd, const std::vector<ISODUAL_REQUEST> & request,
+     std::vector<ISODUAL_MESH> & mesh);
+
+  /// Send request batch and receive meshes.
+  /// - Calls preview(i, s, preview_mesh) on each preview mesh of
+  ///   progressive request i as soon as it is received.
+  void send_request_batch
+    (const int fd, const std::vector<ISODUAL_REQUEST> & request,
+     const ISODUAL_BATCH_PREVIEW_FUNCTION & preview,
+     std::vector<ISODUAL_MESH> & mesh);
+
+  /// Close connection to server.
+  void close_isodual_server(const int fd);
+
+
+  // **************************************************
+  // WRITE MESH
+  // **************************************************
+
+  /// Write mesh in Geomview .off format.
+  void write_isodual_mesh_off
+    (const std::string & filename, const ISODUAL_MESH & mesh);
+
+}
+
+#endif
@@ -0,0 +1,179 @@
+/// \file isodual_server_main.cxx
+/// Resident isosurface server.
+/// Keeps volumes resident and answers isosurface requests
+///   on a Unix domain socket.
+
+/*
+  IJK: Isosurface Jeneration Kode
+  Copyright (C) 2017 Rephael Wenger
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License
+  (LGPL) as published by the Free Software Foundation; either
+  version 2.1 of the License, or any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "ijkcommand_line.txx"
+
+#include "isodual_server.h"
+
+using namespace IJK;
+using namespace ISODUAL;
+
+using namespace std;
+
+// global variables
+std::string socket_path;
+int max_num_volumes = 4;
+std::string data_directory = ".";
+bool flag_verbose = false;
+
+// local subroutines
+void parse_command_line(int argc, char **argv);
+void usage_error();
+void help();
+void memory_exhaustion();
+
+
+// **************************************************
+// MAIN
+// **************************************************
+
+int main(int argc, char **argv)
+{
+  try {
+
+    std::set_new_handler(memory_exhaustion);
+
+    parse_command_line(argc, argv);
+
+    VOLUME_CACHE cache(max_num_volumes, data_directory);
+
+    if (flag_verbose) {
+      cout << "Serving isosurfaces on " << socket_path
+           << ".  Maximum " << max_num_volumes << " resident volumes."
+           << endl;
+      cout << "Data directory: " << cache.DataDirectory() << endl;
+    }
+
+    run_isodual_server(socket_path, cache, flag_verbose);
+  }
+  catch (ERROR & error) {
+    if (error.NumMessages() == 0) {
+      cerr << "Unknown error." << endl;
+    }
+    else { error.Print(cerr); }
+    cerr << "Exiting." << endl;
+    exit(20);
+  }
+  catch (...) {
+    cerr << "Unknown error." << endl;
+    exit(50);
+  };
+
+}
+
+void memory_exhaustion()
+{
+  cerr << "Error: Out of memory.  Terminating program." << endl;
+  exit(10);
+}
+
+
+// **************************************************
+// PARSE COMMAND LINE
+// **************************************************
+
+void parse_command_line(int argc, char **argv)
+{
+  int iarg = 1;
+
+  while (iarg < argc && argv[iarg][0] == '-') {
+    std::string s = argv[iarg];
+
+    if (s == "-max_volumes") {
+      max_num_volumes = get_arg_int(iarg, argc, argv);
+      iarg++;
+
+      if (max_num_volumes < 1) {
+        cerr << "Usage error.  Maximum number of volumes must be at least 1."
+             << endl;
+        exit(230);
+      }
+    }
+    else if (s == "-data_dir") {
+      iarg++;
+      if (iarg >= argc) { usage_error(); }
+      data_directory = argv[iarg];
+    }
+    else if (s == "-verbose")
+      { flag_verbose = true; }
+    else if (s == "-help")
+      { help(); }
+    else {
+      cerr << "Usage error.  Illegal parameter: " << s << endl;
+      usage_error();
+    }
+    iarg++;
+  }
+
+  if (iarg+1 != argc) { usage_error(); }
+
+  socket_path = argv[iarg];
+}
+
+void usage_msg(std::ostream & out)
+{
+  out << "Usage: isodual_server [OPTIONS] {socket path}" << endl;
+  out << "OPTIONS:" << endl;
+  out << "  [-max_volumes {N}] [-data_dir {D}] [-verbose] [-help]" << endl;
+}
+
+void usage_error()
+{
+  usage_msg(cerr);
+  exit(10);
+}
+
+void help()
+{
+  usage_msg(cout);
+  cout << endl;
+  cout << "isodual_server - Resident dual contouring isosurface server."
+       << endl;
+  cout << "  Reads volumes (nrrd files) on first request and keeps them"
+       << endl;
+  cout << "  resident.  Answers batches of isosurface requests on a Unix"
+       << endl;
+  cout << "  domain socket.  See isodual_server.h for the protocol." << endl;
+  cout << "  Volume ids are nrrd file paths relative to the data directory."
+       << endl;
+  cout << "  Volumes outside the data directory are refused." << endl;
+  cout << "  Single client.  Serves one connection at a time." << endl;
+  cout << "  Other clients wait until the current client disconnects."
+       << endl;
+  cout << "  Stops on SIGINT or SIGTERM." << endl;
+  cout << endl;
+  cout << "  -max_volumes {N}: Keep at most N volumes resident." << endl;
+  cout << "     Least recently used volumes are removed first."
+       << "  (Default 4.)" << endl;
+  cout << "  -data_dir {D}: Read volumes from directory D."
+       << "  (Default current directory.)" << endl;
+  cout << "  -verbose:  Report each request batch." << endl;
+  cout << "  -help:     Print this help message." << endl;
+  exit(0);
+}
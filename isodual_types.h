@@ -33,6 +33,7 @@ namespace ISODUAL {
   // **************************************************
 
   typedef IJKDUAL::SCALAR_TYPE SCALAR_TYPE;
+  typedef IJKDUAL::GRID_SCALAR_TYPE GRID_SCALAR_TYPE;
   typedef IJKDUAL::COORD_TYPE COORD_TYPE;
   typedef IJKDUAL::VERTEX_INDEX VERTEX_INDEX;
   typedef IJKDUAL::AXIS_SIZE_TYPE AXIS_SIZE_TYPE;
@@ -47,6 +48,13 @@ namespace ISODUAL {
   typedef IJKDUAL::SCALAR_ARRAY SCALAR_ARRAY;
 
 
+  // **************************************************
+  // GRID TYPES
+  // **************************************************
+
+  typedef IJKDUAL::GRID_BOX GRID_BOX;
+
+
   // **************************************************
   // ENUMERATED TYPES
   // **************************************************